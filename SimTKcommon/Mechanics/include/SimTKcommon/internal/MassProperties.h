@@ -1310,6 +1310,14 @@ SimTK_SimTKCOMMON_EXPORT ArticulatedInertia_ shift(const Vec3P& s) const;
 /// @see shift() for details
 SimTK_SimTKCOMMON_EXPORT ArticulatedInertia_& shiftInPlace(const Vec3P& s);
 
+/// Add the ABI \a src, rigid-shifted by -s, into this one. This produces the
+/// same result as `*this += src.shift(s)` but without forming the shifted
+/// temporary; it is the basic operation of the tip-to-base articulated body
+/// inertia recursion. 93 flops.
+/// @see shift() for details
+SimTK_SimTKCOMMON_EXPORT ArticulatedInertia_& 
+addShifted(const ArticulatedInertia_& src, const Vec3P& s);
+
 /// Convert the compactly-stored ArticulatedInertia (21 elements) into a 
 /// full SpatialMat with 36 elements.
 const SpatialMatP toSpatialMat() const {
@@ -136,6 +136,19 @@ ArticulatedInertia_<P>::shiftInPlace(const Vec3P& s) {
     return *this;
 }
 
+// Accumulate a shifted ABI without creating a temporary. Here the shifted
+// F' and J' are added directly into this ABI's F and J (93 flops).
+template <class P> ArticulatedInertia_<P>&
+ArticulatedInertia_<P>::addShifted(const ArticulatedInertia_& src, 
+                                   const Vec3P& s) {
+    const Mat33P Fp = src.F + s % src.M;    // 33 flops
+    J += src.J;                             // 6 flops
+    J += halfCrossDiff(s, ~src.F, Fp);      // 39 flops
+    F += Fp;                                // 9 flops
+    M += src.M;                             // 6 flops
+    return *this;
+}
+
 // Instantiate so we catch bugs now.
 template class ArticulatedInertia_<float>;
 template class ArticulatedInertia_<double>;
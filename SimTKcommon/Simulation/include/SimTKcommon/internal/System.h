@@ -284,6 +284,44 @@ void realize(const State& state, Stage stage = Stage::HighestRuntime) const;
 /**@}**/
 
 
+//------------------------------------------------------------------------------
+/**@name                      Binary State snapshots
+
+These methods write a State to a compact binary snapshot and restore it
+again, for checkpoint/restart of long simulations or for sending States to
+other processes running the same %System. A snapshot holds the time, and
+for each Subsystem its name and version, its q, u, and z, and its discrete
+variables (including those that hold event state). Cache entries are not
+saved; realize the restored State before using it.
+
+A snapshot is a sequence of chunks, one per Subsystem, each starting with
+its length so a reader can skip it. The q, u, and z values are aligned so
+that they can be read in place from a memory-mapped file. Snapshots are not
+portable to machines with a different byte order or a different precision
+of Real; that is checked when the snapshot is read. **/
+/**@{**/
+
+/** Write a binary snapshot of `state`, which must have been realized through
+Stage::Model, replacing the contents of `snapshot`. A discrete variable
+whose type isn't supported by BinaryIO is listed in the snapshot without its
+value; see deserializeState(). **/
+void serializeState(const State& state, Array_<char>& snapshot) const;
+
+/** Replace `state` with the State recorded in a snapshot written by
+serializeState(). The `size` bytes at `data` are only read, and may for
+example be a memory-mapped file. The result starts as a copy of the default
+State; Model-stage discrete variables are restored first and the Model
+realized, then the remaining variables and the time are set. The State is
+left realized through Stage::Model.
+
+An exception is thrown if the snapshot doesn't match this %System: the
+Subsystems, their numbers of q, u, and z, and the number and types of their
+discrete variables must be the same. Discrete variables that were written
+without a value keep their default values. **/
+void deserializeState(const char* data, std::size_t size, State& state) const;
+/**@}**/
+
+
 //------------------------------------------------------------------------------
 /**@name                    The Constrained System
 
@@ -693,6 +731,16 @@ void multiplyByNPInv(const State& state, const Vector& dq,
 /** Calculate fq=~pinv(N)*fu in O(n) time (very fast). **/
 void multiplyByNPInvTranspose(const State& state, const Vector& fu, 
                               Vector& fq) const;
+
+/** Calculate an approximation to the ny X ny Jacobian d(ydot)/dy of the
+continuous state derivatives, if the %System knows how, for use in forming
+the iteration matrix of an implicit integrator. This is typically much
+cheaper than differentiating ydot numerically, but it need not be exact; for
+example, a MultibodySystem includes only the derivatives of its force
+elements' force laws. The \a state must be realized through Dynamics stage.
+Returns false, leaving \a dYdotdY unspecified, if the %System can't supply
+the Jacobian for this \a state; that is the default. **/
+bool calcYDotJacobian(const State& state, Matrix& dYdotdY) const;
 /**@}**/
 
 
@@ -720,6 +768,74 @@ or realize(), regardless of whether these routines actually did
 anything when called. **/
 int getNumRealizeCalls() const;
 
+/** Turn on or off timing of the realization of each Stage from Model through
+Report; see getRealizationTimeOfThisStage(). This is off by default because 
+reading the clock can be a noticeable cost for a small System. **/
+void setRealizationTimingEnabled(bool enabled);
+/** Return true if realization timing is enabled. **/
+bool isRealizationTimingEnabled() const;
+/** While realization timing is enabled, the elapsed (wall clock) time spent 
+realizing the given Stage is accumulated here, in seconds. This is the time
+spent in the realize computations of all the Subsystems for that Stage, 
+excluding any earlier stages realized in the same call. Only stages from Model
+through Report are timed. **/
+double getRealizationTimeOfThisStage(Stage) const;
+
+/** Turn on or off profiling of the realization of each Subsystem at each
+Stage from Topology through Report. While profiling is on, the wall clock and
+thread CPU time of each Subsystem realization are accumulated, the calls to
+realize() that found a Stage already realized are counted, and every
+realization is appended to a trace that can be written out with
+writeRealizationTrace(). This is off by default since it reads several clocks
+per Subsystem and Stage, and the trace grows with every realization (about 40
+bytes per event) up to the limit set with setRealizationTraceLimit(), so turn
+it on only around the computations you want to examine. Turning it on or off
+does not clear what has been recorded; resetAllCountersToZero() does, and
+clearRealizationTrace() discards just the trace. **/
+void setRealizationProfilingEnabled(bool enabled);
+/** Return true if realization profiling is enabled. **/
+bool isRealizationProfilingEnabled() const;
+/** While realization profiling is enabled, the elapsed (wall clock) time
+spent realizing the given Subsystem at the given Stage is accumulated here,
+in seconds. This includes the time spent realizing the Subsystem's Measures,
+but not the time spent in other Subsystems. **/
+double getSubsystemRealizationTime(SubsystemIndex, Stage) const;
+/** Like getSubsystemRealizationTime() but accumulates the CPU time used by
+the thread that did the realization; see threadCpuTime(). This excludes time
+spent waiting and, if the Subsystem does its work in parallel, the time used
+by other threads. **/
+double getSubsystemRealizationCPUTime(SubsystemIndex, Stage) const;
+/** Return the number of times the given Subsystem was realized at the given
+Stage while realization profiling was enabled. **/
+int getNumSubsystemRealizations(SubsystemIndex, Stage) const;
+/** Return the number of calls to realize() made while realization profiling
+was enabled that asked for the given Stage when it had already been realized,
+so that the cached results could be used. The calls that had to do the work
+are counted by getNumRealizationsOfThisStage(). Only stages from Instance
+through Report are counted. **/
+int getNumRealizationCacheHits(Stage) const;
+/** Write the realizations recorded while realization profiling was enabled
+in the Chrome trace event JSON format, for viewing with chrome://tracing or
+Perfetto. There is one complete ("X") event per realization of the System or
+of a Subsystem, named by the System or Subsystem and the Stage, on a track
+for the thread that did it, with the thread CPU time as an argument. Times
+are in microseconds from the start of the earliest recorded realization. **/
+void writeRealizationTrace(std::ostream& o) const;
+/** Set the maximum number of realizations kept in the trace written by
+writeRealizationTrace(); once it is full, further realizations are still
+profiled but are not added to the trace. Each event takes about 40 bytes, so
+the default of one million events bounds the trace at about 40MB. A limit of
+zero turns off the trace while keeping the rest of the profile. This does
+not discard events already recorded. **/
+void setRealizationTraceLimit(int maxEvents);
+/** Return the maximum number of realizations kept in the realization trace;
+see setRealizationTraceLimit(). **/
+int getRealizationTraceLimit() const;
+/** Discard the realizations recorded in the trace so far, releasing its
+memory, while leaving the accumulated realization profile and counters
+alone. **/
+void clearRealizationTrace();
+
     // Prescribed motion
 
 /** Return the total number of calls to the System's prescribeQ() method. **/
@@ -1089,7 +1205,7 @@ public:
     ProjectResults& clear() {
         m_exitStatus = Invalid;
         m_anyChangeMade = m_projectionLimitExceeded = false;
-        m_numIterations = 0;
+        m_numIterations = m_numFactorizations = 0;
         m_worstError = -1;
         m_normOnEntrance = m_normOnExit = NaN;
         return *this;
@@ -1099,6 +1215,11 @@ public:
 
     bool getAnyChangeMade()  const {assert(isValid());return m_anyChangeMade;}
     int  getNumIterations()  const {assert(isValid());return m_numIterations;}
+    /** Return the number of times the iteration matrix was factored; with
+    modified Newton iterations this can be less than getNumIterations(), and
+    zero if an earlier projection's factorization was good enough. **/
+    int  getNumFactorizations() const 
+    {   assert(isValid());return m_numFactorizations; }
     Real getNormOnEntrance() const {assert(isValid());return m_normOnEntrance;}
     Real getNormOnExit()     const {assert(isValid());return m_normOnExit;}
     int  getWorstErrorOnEntrance()    const 
@@ -1114,6 +1235,8 @@ public:
     {   m_projectionLimitExceeded=limitExceeded; return *this; }
     ProjectResults& setNumIterations(int numIterations) 
     {   m_numIterations=numIterations; return *this; }
+    ProjectResults& setNumFactorizations(int numFactorizations) 
+    {   m_numFactorizations=numFactorizations; return *this; }
     ProjectResults& setNormOnEntrance(Real norm, int worstError) 
     {   m_normOnEntrance=norm; m_worstError=worstError; return *this; }
     ProjectResults& setNormOnExit(Real norm) 
@@ -1123,6 +1246,7 @@ private:
     bool    m_anyChangeMade;
     bool    m_projectionLimitExceeded;
     int     m_numIterations;
+    int     m_numFactorizations;
     int     m_worstError;       // index of worst error on entrance
     Real    m_normOnEntrance;   // in selected rms or infinity norm
     Real    m_normOnExit;
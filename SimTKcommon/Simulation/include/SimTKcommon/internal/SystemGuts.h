@@ -120,6 +120,13 @@ public:
     void setSystemTopologyCacheVersion(StageVersion topoVersion) const;
     void invalidateSystemTopologyCache() const;
 
+    // While realization profiling is enabled, each Subsystem reports its
+    // realizations here; see System::setRealizationProfilingEnabled().
+    bool isRealizationProfilingEnabled() const;
+    void recordSubsystemRealization(SubsystemIndex, Stage, long long startInNs,
+                                    long long durationInNs, 
+                                    double cpuTime) const;
+
     // Wrap the cloneImpl virtual method.
     System::Guts* clone() const;
 
@@ -147,6 +154,7 @@ public:
                          Vector& u) const;
     void multiplyByNPInvTranspose(const State& state, const Vector& fu, 
                                   Vector& fq) const;
+    bool calcYDotJacobian(const State& state, Matrix& dYdotdY) const;
 
     bool prescribeQ(State&) const;
     bool prescribeU(State&) const;
@@ -206,6 +214,10 @@ protected:
     virtual void multiplyByNPInvTransposeImpl(const State& state, const Vector& fu, 
                                               Vector& fq) const;
 
+    // Default says the System can't supply a Jacobian.
+    virtual bool calcYDotJacobianImpl(const State& state, 
+                                      Matrix& dYdotdY) const {return false;}
+
     // Defaults assume no prescribed motion; hence, no change made.
     virtual bool prescribeQImpl(State&) const {return false;}
     virtual bool prescribeUImpl(State&) const {return false;}
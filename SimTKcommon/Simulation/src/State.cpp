@@ -368,8 +368,11 @@ void PerSubsystemInfo::copyFrom(const PerSubsystemInfo& src, Stage maxStage) {
     for (int i=0; i<=targetStage; ++i)
         stageVersions[i] = src.stageVersions[i];
     // The rest of the stages need to be invalidated in the destination
-    // since we didn't copy any state information from those stages.
-    for (int i=targetStage+1; i<=src.currentStage; ++i)
+    // since we didn't copy any state information from those stages. That
+    // includes stages the source hasn't reached: a copied cache entry may
+    // have been computed before the source was invalidated, and the
+    // destination's own version numbers might happen to match that.
+    for (int i=targetStage+1; i < Stage::NValid; ++i)
         stageVersions[i] = src.stageVersions[i] + 1;
 
     // Subsystem stage should now match what we copied.
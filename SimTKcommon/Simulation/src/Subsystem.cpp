@@ -35,6 +35,7 @@
 #include "SimTKcommon/internal/EventReporter.h"
 #include "SimTKcommon/internal/System.h"
 #include "SimTKcommon/internal/Subsystem.h"
+#include "SimTKcommon/internal/Timing.h"
 
 #include "SimTKcommon/internal/MeasureImplementation.h"
 
@@ -200,12 +201,41 @@ Subsystem::Guts* Subsystem::Guts::clone() const {
     return cloneImpl();
 }
 
+// While the System's realization profiling is enabled, this records the time
+// until it goes out of scope as a realization of the given Subsystem.
+namespace {
+class SubsystemRealizationTimer {
+public:
+    SubsystemRealizationTimer(const Subsystem::Guts& subsys, Stage g)
+    :   system(subsys.isInSystem() && subsys.getSystem().getSystemGuts()
+                                            .isRealizationProfilingEnabled()
+               ? &subsys.getSystem().getSystemGuts() : nullptr),
+        subsysIx(system ? subsys.getMySubsystemIndex() : SubsystemIndex()),
+        stage(g),
+        startCpuTime(system ? threadCpuTime() : 0),
+        startInNs(system ? realTimeInNs() : 0) {}
+    ~SubsystemRealizationTimer() {
+        if (system) 
+            system->recordSubsystemRealization(subsysIx, stage, startInNs, 
+                                               realTimeInNs() - startInNs,
+                                               threadCpuTime() - startCpuTime);
+    }
+private:
+    const System::Guts*     system;
+    const SubsystemIndex    subsysIx;
+    const Stage             stage;
+    const double            startCpuTime;
+    const long long         startInNs;
+};
+}
+
 //------------------------------------------------------------------------------
 //                     REALIZE SUBSYSTEM TOPOLOGY
 //------------------------------------------------------------------------------
 void Subsystem::Guts::realizeSubsystemTopology(State& s) const {
     SimTK_STAGECHECK_EQ_ALWAYS(getStage(s), Stage::Empty, 
         "Subsystem::Guts::realizeSubsystemTopology()");
+    SubsystemRealizationTimer timer(*this, Stage::Topology);
     realizeSubsystemTopologyImpl(s);
 
     // Realize this Subsystem's Measures.
@@ -226,6 +256,7 @@ void Subsystem::Guts::realizeSubsystemModel(State& s) const {
     SimTK_STAGECHECK_GE_ALWAYS(getStage(s), Stage::Topology, 
         "Subsystem::Guts::realizeSubsystemModel()");
     if (getStage(s) < Stage::Model) {
+        SubsystemRealizationTimer timer(*this, Stage::Model);
         realizeSubsystemModelImpl(s);
 
         // Realize this Subsystem's Measures.
@@ -243,6 +274,7 @@ void Subsystem::Guts::realizeSubsystemInstance(const State& s) const {
     SimTK_STAGECHECK_GE_ALWAYS(getStage(s), Stage(Stage::Instance).prev(), 
         "Subsystem::Guts::realizeSubsystemInstance()");
     if (getStage(s) < Stage::Instance) {
+        SubsystemRealizationTimer timer(*this, Stage::Instance);
         realizeSubsystemInstanceImpl(s);
 
         // Realize this Subsystem's Measures.
@@ -260,6 +292,7 @@ void Subsystem::Guts::realizeSubsystemTime(const State& s) const {
     SimTK_STAGECHECK_GE_ALWAYS(getStage(s), Stage(Stage::Time).prev(), 
         "Subsystem::Guts::realizeTime()");
     if (getStage(s) < Stage::Time) {
+        SubsystemRealizationTimer timer(*this, Stage::Time);
         realizeSubsystemTimeImpl(s);
 
         // Realize this Subsystem's Measures.
@@ -277,6 +310,7 @@ void Subsystem::Guts::realizeSubsystemPosition(const State& s) const {
     SimTK_STAGECHECK_GE_ALWAYS(getStage(s), Stage(Stage::Position).prev(), 
         "Subsystem::Guts::realizeSubsystemPosition()");
     if (getStage(s) < Stage::Position) {
+        SubsystemRealizationTimer timer(*this, Stage::Position);
         realizeSubsystemPositionImpl(s);
 
         // Realize this Subsystem's Measures.
@@ -294,6 +328,7 @@ void Subsystem::Guts::realizeSubsystemVelocity(const State& s) const {
     SimTK_STAGECHECK_GE_ALWAYS(getStage(s), Stage(Stage::Velocity).prev(), 
         "Subsystem::Guts::realizeSubsystemVelocity()");
     if (getStage(s) < Stage::Velocity) {
+        SubsystemRealizationTimer timer(*this, Stage::Velocity);
         realizeSubsystemVelocityImpl(s);
 
         // Realize this Subsystem's Measures.
@@ -311,6 +346,7 @@ void Subsystem::Guts::realizeSubsystemDynamics(const State& s) const {
     SimTK_STAGECHECK_GE_ALWAYS(getStage(s), Stage(Stage::Dynamics).prev(), 
         "Subsystem::Guts::realizeSubsystemDynamics()");
     if (getStage(s) < Stage::Dynamics) {
+        SubsystemRealizationTimer timer(*this, Stage::Dynamics);
         realizeSubsystemDynamicsImpl(s);
 
         // Realize this Subsystem's Measures.
@@ -328,6 +364,7 @@ void Subsystem::Guts::realizeSubsystemAcceleration(const State& s) const {
     SimTK_STAGECHECK_GE_ALWAYS(getStage(s), Stage(Stage::Acceleration).prev(), 
         "Subsystem::Guts::realizeSubsystemAcceleration()");
     if (getStage(s) < Stage::Acceleration) {
+        SubsystemRealizationTimer timer(*this, Stage::Acceleration);
         realizeSubsystemAccelerationImpl(s);
 
         // Realize this Subsystem's Measures.
@@ -345,6 +382,7 @@ void Subsystem::Guts::realizeSubsystemReport(const State& s) const {
     SimTK_STAGECHECK_GE_ALWAYS(getStage(s), Stage(Stage::Report).prev(), 
         "Subsystem::Guts::realizeSubsystemReport()");
     if (getStage(s) < Stage::Report) {
+        SubsystemRealizationTimer timer(*this, Stage::Report);
         realizeSubsystemReportImpl(s);
 
         // Realize this Subsystem's Measures.
@@ -36,12 +36,19 @@
 #include "SimTKcommon/internal/SystemGuts.h"
 #include "SimTKcommon/internal/EventHandler.h"
 #include "SimTKcommon/internal/EventReporter.h"
+#include "SimTKcommon/internal/Timing.h"
 
 #include "SystemGutsRep.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
 #include <map>
+#include <mutex>
 #include <set>
+#include <thread>
 
 namespace SimTK {
 
@@ -115,6 +122,34 @@ bool System::getUseUniformBackground() const
 void System::resetAllCountersToZero() {updSystemGuts().updRep().resetAllCounters();}
 int System::getNumRealizationsOfThisStage(Stage g) const {return getSystemGuts().getRep().nRealizationsOfStage[g];}
 int System::getNumRealizeCalls() const {return getSystemGuts().getRep().nRealizeCalls;}
+void System::setRealizationTimingEnabled(bool enabled) {updSystemGuts().updRep().realizationTimingEnabled = enabled;}
+bool System::isRealizationTimingEnabled() const {return getSystemGuts().getRep().realizationTimingEnabled;}
+double System::getRealizationTimeOfThisStage(Stage g) const {return nsToSec(getSystemGuts().getRep().realizationTimeInNs[g]);}
+void System::setRealizationProfilingEnabled(bool enabled) {updSystemGuts().updRep().realizationProfilingEnabled = enabled;}
+bool System::isRealizationProfilingEnabled() const {return getSystemGuts().getRep().realizationProfilingEnabled;}
+double System::getSubsystemRealizationTime(SubsystemIndex i, Stage g) const {return nsToSec(getSystemGuts().getRep().getRealizationProfile(i,g).wallTimeInNs);}
+double System::getSubsystemRealizationCPUTime(SubsystemIndex i, Stage g) const {return getSystemGuts().getRep().getRealizationProfile(i,g).cpuTime;}
+int System::getNumSubsystemRealizations(SubsystemIndex i, Stage g) const {return getSystemGuts().getRep().getRealizationProfile(i,g).numRealizations;}
+int System::getNumRealizationCacheHits(Stage g) const {
+    const auto& rep = getSystemGuts().getRep();
+    std::lock_guard<std::mutex> lock(rep.realizationProfileLock);
+    return rep.nRealizationCacheHits[g];
+}
+void System::setRealizationTraceLimit(int maxEvents) {
+    SimTK_APIARGCHECK1_ALWAYS(maxEvents >= 0, "System",
+        "setRealizationTraceLimit", "Illegal limit %d; must be nonnegative.",
+        maxEvents);
+    auto& rep = updSystemGuts().updRep();
+    std::lock_guard<std::mutex> lock(rep.realizationProfileLock);
+    rep.maxRealizationTraceEvents = maxEvents;
+}
+int System::getRealizationTraceLimit() const {return getSystemGuts().getRep().maxRealizationTraceEvents;}
+void System::clearRealizationTrace() {
+    auto& rep = updSystemGuts().updRep();
+    std::lock_guard<std::mutex> lock(rep.realizationProfileLock);
+    rep.realizationTrace.clear();
+    rep.realizationTrace.shrink_to_fit();
+}
 
 int System::getNumPrescribeQCalls() const {return getSystemGuts().getRep().nPrescribeQCalls;}
 int System::getNumPrescribeUCalls() const {return getSystemGuts().getRep().nPrescribeUCalls;}
@@ -181,6 +216,8 @@ void System::multiplyByNPInv(const State& s, const Vector& dq, Vector& u) const
 {   getSystemGuts().multiplyByNPInv(s,dq,u); }
 void System::multiplyByNPInvTranspose(const State& s, const Vector& fu, Vector& fq) const
 {   getSystemGuts().multiplyByNPInvTranspose(s,fu,fq); }
+bool System::calcYDotJacobian(const State& s, Matrix& dYdotdY) const
+{   return getSystemGuts().calcYDotJacobian(s,dYdotdY); }
 
 bool System::prescribeQ(State& s) const
 {   return getSystemGuts().prescribeQ(s); }
@@ -249,6 +286,221 @@ void System::calcTimeOfNextScheduledReport(const State& s, Real& tNextEvent,
                                           Array_<EventId>& eventIds, bool includeCurrentTime) const
 {   getSystemGuts().calcTimeOfNextScheduledReport(s,tNextEvent,eventIds,includeCurrentTime); }
 
+//------------------------------------------------------------------------------
+//                          BINARY STATE SNAPSHOTS
+//------------------------------------------------------------------------------
+// Snapshot layout. Integers are fixed width in the writer's byte order, which
+// the reader checks with the byte order mark.
+//
+//  header     char[8] magic, uint32 format version, uint32 byte order mark,
+//             uint32 sizeof(Real), uint32 flags (reserved, 0), uint32 number
+//             of subsystems, padding to 8 bytes, Real time
+//  subsystem  uint64 length of the rest of this chunk, String name, String
+//             version, uint32 nq, nu, nz, padding to 8 bytes, Real q[nq],
+//             u[nu], z[nz], uint32 number of discrete variables, and for each
+//             of those: int32 invalidated stage, String type name, uint8 1 if
+//             a value follows, and if so uint64 length of the value followed
+//             by the value as written by AbstractValue::writeBinary().
+namespace {
+const char          SnapshotMagic[8] = {'S','i','m','T','K','S','t','a'};
+const std::uint32_t SnapshotFormatVersion = 1;
+const std::uint32_t SnapshotByteOrderMark = 0x01020304;
+const std::size_t   SnapshotAlignment     = 8;
+
+void writeReals(BinaryWriter& out, const Vector& v) {
+    if (v.size() && v.hasContiguousData())
+        out.writeBytes(&v[0], v.size()*sizeof(Real));
+    else for (int i=0; i < v.size(); ++i) out.write(v[i]);
+}
+
+void readReals(BinaryReader& in, Vector& v) {
+    const char* bytes = in.viewBytes(v.size()*sizeof(Real));
+    if (v.size() && v.hasContiguousData())
+        std::memcpy(&v[0], bytes, v.size()*sizeof(Real));
+    else for (int i=0; i < v.size(); ++i) 
+        std::memcpy(&v[i], bytes + i*sizeof(Real), sizeof(Real));
+}
+
+int countDiscreteVariables(const State& state, SubsystemIndex sx) {
+    int n = 0;
+    while (state.hasDiscreteVar(DiscreteVarKey(sx, DiscreteVariableIndex(n))))
+        ++n;
+    return n;
+}
+
+// Read the chunk for subsystem sx, checking it against the State. The Model
+// pass restores only Model-stage discrete variables, since those determine
+// what other variables the State has. The other pass restores the rest.
+void readSubsystemChunk(BinaryReader& in, SubsystemIndex sx, bool modelPass,
+                        State& state) {
+    const char* where = "System::deserializeState()";
+    std::uint64_t length; in.read(length);
+    const std::size_t chunkEnd = in.tell() + std::size_t(length);
+
+    String name, version; in.read(name); in.read(version);
+    SimTK_ERRCHK4_ALWAYS(   name    == state.getSubsystemName(sx) 
+                         && version == state.getSubsystemVersion(sx), where,
+        "Subsystem %d in the snapshot is %s but in this System it is %s "
+        "(version %s).", (int)sx, (name + " (version " + version + ")").c_str(),
+        state.getSubsystemName(sx).c_str(), 
+        state.getSubsystemVersion(sx).c_str());
+
+    std::uint32_t nq, nu, nz; in.read(nq); in.read(nu); in.read(nz);
+    in.alignTo(SnapshotAlignment);
+    if (modelPass) 
+        in.viewBytes((std::size_t(nq) + nu + nz)*sizeof(Real));
+    else {
+        SimTK_ERRCHK4_ALWAYS(   (int)nq == state.getNQ(sx) 
+                             && (int)nu == state.getNU(sx)
+                             && (int)nz == state.getNZ(sx), where,
+            "Subsystem %d in the snapshot has nq=%d, nu=%d, nz=%d but these "
+            "don't match this System.", (int)sx, (int)nq, (int)nu, (int)nz);
+        readReals(in, state.updQ(sx));
+        readReals(in, state.updU(sx));
+        readReals(in, state.updZ(sx));
+    }
+
+    std::uint32_t ndv; in.read(ndv);
+    SimTK_ERRCHK3_ALWAYS(modelPass 
+                         || (int)ndv == countDiscreteVariables(state, sx), 
+        where, "Subsystem %d in the snapshot has %d discrete variables "
+        "but in this System it has %d.", (int)sx, (int)ndv,
+        countDiscreteVariables(state, sx));
+
+    for (DiscreteVariableIndex dx(0); dx < (int)ndv; ++dx) {
+        std::int32_t stage; in.read(stage);
+        String typeName; in.read(typeName);
+        std::uint8_t hasValue; in.read(hasValue);
+        std::uint64_t valueLength = 0;
+        if (hasValue) in.read(valueLength);
+        const std::size_t valueEnd = in.tell() + std::size_t(valueLength);
+
+        const bool isModelStage = stage <= (int)Stage::Model;
+        if (modelPass && !isModelStage) {in.seek(valueEnd); continue;}
+
+        const DiscreteVarKey key(sx, dx);
+        SimTK_ERRCHK4_ALWAYS(state.hasDiscreteVar(key)
+            && state.getDiscreteVariable(sx, dx).getTypeName() == typeName,
+            where, "Discrete variable %d of subsystem %d in the snapshot has "
+            "type %s but in this System it has type %s.", (int)dx, (int)sx,
+            typeName.c_str(), state.hasDiscreteVar(key) 
+            ? state.getDiscreteVariable(sx, dx).getTypeName().c_str() 
+            : "(none)");
+
+        if (hasValue && modelPass == isModelStage) {
+            state.updDiscreteVariable(sx, dx).readBinary(in);
+            SimTK_ERRCHK2_ALWAYS(in.tell() == valueEnd, where,
+                "The value of discrete variable %d of subsystem %d wasn't "
+                "read back the way it was written.", (int)dx, (int)sx);
+        }
+        in.seek(valueEnd);
+    }
+
+    SimTK_ERRCHK1_ALWAYS(in.tell() == chunkEnd, where,
+        "The snapshot chunk for subsystem %d is corrupt.", (int)sx);
+}
+}
+
+void System::serializeState(const State& state, Array_<char>& snapshot) const
+{
+    SimTK_STAGECHECK_GE_ALWAYS(state.getSystemStage(), Stage::Model,
+                               "System::serializeState()");
+    SimTK_ERRCHK2_ALWAYS(state.getNumSubsystems() == getNumSubsystems(),
+        "System::serializeState()",
+        "The State has %d subsystems but this System has %d.",
+        state.getNumSubsystems(), getNumSubsystems());
+
+    snapshot.clear();
+    BinaryWriter out(snapshot);
+    out.writeBytes(SnapshotMagic, sizeof(SnapshotMagic));
+    out.write(SnapshotFormatVersion);
+    out.write(SnapshotByteOrderMark);
+    out.write(std::uint32_t(sizeof(Real)));
+    out.write(std::uint32_t(0)); // flags
+    out.write(std::uint32_t(getNumSubsystems()));
+    out.alignTo(SnapshotAlignment);
+    out.write(state.getTime());
+
+    for (SubsystemIndex sx(0); sx < getNumSubsystems(); ++sx) {
+        const std::size_t lengthPos = out.size();
+        out.write(std::uint64_t(0)); // filled in below
+        out.write(state.getSubsystemName(sx));
+        out.write(state.getSubsystemVersion(sx));
+
+        const Vector& q = state.getQ(sx);
+        const Vector& u = state.getU(sx);
+        const Vector& z = state.getZ(sx);
+        out.write(std::uint32_t(q.size()));
+        out.write(std::uint32_t(u.size()));
+        out.write(std::uint32_t(z.size()));
+        out.alignTo(SnapshotAlignment);
+        writeReals(out, q); writeReals(out, u); writeReals(out, z);
+
+        const int ndv = countDiscreteVariables(state, sx);
+        out.write(std::uint32_t(ndv));
+        for (DiscreteVariableIndex dx(0); dx < ndv; ++dx) {
+            const DiscreteVarKey key(sx, dx);
+            const AbstractValue& value = state.getDiscreteVariable(sx, dx);
+            out.write(std::int32_t(
+                state.getDiscreteVarInfo(key).getInvalidatedStage()));
+            out.write(value.getTypeName());
+            const bool hasValue = value.isBinarySerializable();
+            out.write(std::uint8_t(hasValue));
+            if (!hasValue) continue;
+
+            const std::size_t valuePos = out.size();
+            out.write(std::uint64_t(0)); // filled in below
+            value.writeBinary(out);
+            const std::uint64_t valueLength = 
+                out.size() - valuePos - sizeof(std::uint64_t);
+            out.overwriteBytes(valuePos, &valueLength, sizeof(valueLength));
+        }
+
+        const std::uint64_t chunkLength = 
+            out.size() - lengthPos - sizeof(std::uint64_t);
+        out.overwriteBytes(lengthPos, &chunkLength, sizeof(chunkLength));
+    }
+}
+
+void System::deserializeState(const char* data, std::size_t size, 
+                              State& state) const
+{
+    const char* where = "System::deserializeState()";
+    BinaryReader in(data, size);
+    SimTK_ERRCHK_ALWAYS(size >= sizeof(SnapshotMagic) 
+        && std::memcmp(in.viewBytes(sizeof(SnapshotMagic)), SnapshotMagic, 
+                       sizeof(SnapshotMagic)) == 0, where,
+        "The data is not a State snapshot.");
+
+    std::uint32_t formatVersion, byteOrderMark, realSize, flags, nsubsys;
+    in.read(formatVersion); in.read(byteOrderMark); in.read(realSize);
+    in.read(flags); in.read(nsubsys);
+    SimTK_ERRCHK1_ALWAYS(formatVersion <= SnapshotFormatVersion, where,
+        "The snapshot has format version %u which is newer than this "
+        "version of Simbody can read.", (unsigned)formatVersion);
+    SimTK_ERRCHK_ALWAYS(byteOrderMark == SnapshotByteOrderMark, where,
+        "The snapshot was written on a machine with a different byte order.");
+    SimTK_ERRCHK2_ALWAYS(realSize == sizeof(Real), where,
+        "The snapshot was written with %u-byte Reals but this build uses "
+        "%u-byte Reals.", (unsigned)realSize, (unsigned)sizeof(Real));
+    SimTK_ERRCHK2_ALWAYS((int)nsubsys == getNumSubsystems(), where,
+        "The snapshot has %d subsystems but this System has %d.",
+        (int)nsubsys, getNumSubsystems());
+    in.alignTo(SnapshotAlignment);
+    Real time; in.read(time);
+    const std::size_t chunksPos = in.tell();
+
+    state = getDefaultState();
+    for (SubsystemIndex sx(0); sx < getNumSubsystems(); ++sx)
+        readSubsystemChunk(in, sx, true, state);
+    realizeModel(state);
+
+    in.seek(chunksPos);
+    for (SubsystemIndex sx(0); sx < getNumSubsystems(); ++sx)
+        readSubsystemChunk(in, sx, false, state);
+    state.setTime(time);
+}
+
 
 
 
@@ -315,6 +567,12 @@ void System::Guts::setSystemTopologyCacheVersion(StageVersion topoVersion) const
 {   getRep().setSystemTopologyCacheVersion(topoVersion); }
 void System::Guts::invalidateSystemTopologyCache() const 
 {   return getRep().invalidateSystemTopologyCache(); } // mutable
+bool System::Guts::isRealizationProfilingEnabled() const 
+{   return getRep().realizationProfilingEnabled; }
+void System::Guts::recordSubsystemRealization
+   (SubsystemIndex subsys, Stage g, long long startInNs, long long durationInNs,
+    double cpuTime) const 
+{   getRep().recordRealization(subsys, g, startInNs, durationInNs, cpuTime); }
 
 const State& System::Guts::getDefaultState() const {
     SimTK_STAGECHECK_TOPOLOGY_REALIZED_ALWAYS(systemTopologyHasBeenRealized(),
@@ -393,6 +651,7 @@ void System::Guts::realizeModel(State& s) const {
         getSystemTopologyCacheVersion(), s.getSystemTopologyStageVersion(),
         "System", getName(), "System::Guts::realizeModel()");
     if (s.getSystemStage() < Stage::Model) {
+        GutsRep::RealizationTimer timer(getRep(), Stage::Model);
         // Allow the subclass to do its processing.
         realizeModelImpl(s);
         // Realize any subsystems that the subclass didn't already take care of.
@@ -415,6 +674,7 @@ void System::Guts::realizeInstance(const State& s) const {
     SimTK_STAGECHECK_GE_ALWAYS(s.getSystemStage(), Stage(Stage::Instance).prev(), 
         "System::Guts::realizeInstance()");
     if (s.getSystemStage() < Stage::Instance) {
+        GutsRep::RealizationTimer timer(getRep(), Stage::Instance);
         realizeInstanceImpl(s);    // take care of the Subsystems
         // Realize any subsystems that the subclass didn't already take care of.
         for (SubsystemIndex i(0); i<getNumSubsystems(); ++i)
@@ -436,6 +696,7 @@ void System::Guts::realizeTime(const State& s) const {
     SimTK_STAGECHECK_GE_ALWAYS(s.getSystemStage(), Stage(Stage::Time).prev(), 
         "System::Guts::realizeTime()");
     if (s.getSystemStage() < Stage::Time) {
+        GutsRep::RealizationTimer timer(getRep(), Stage::Time);
         // Allow the subclass to do processing.
         realizeTimeImpl(s);
         // Realize any subsystems that the subclass didn't already take care of.
@@ -458,6 +719,7 @@ void System::Guts::realizePosition(const State& s) const {
     SimTK_STAGECHECK_GE_ALWAYS(s.getSystemStage(), Stage(Stage::Position).prev(), 
         "System::Guts::realizePosition()");
     if (s.getSystemStage() < Stage::Position) {
+        GutsRep::RealizationTimer timer(getRep(), Stage::Position);
         // Allow the subclass to do processing.
         realizePositionImpl(s);
         // Realize any subsystems that the subclass didn't already take care of.
@@ -480,6 +742,7 @@ void System::Guts::realizeVelocity(const State& s) const {
     SimTK_STAGECHECK_GE_ALWAYS(s.getSystemStage(), Stage(Stage::Velocity).prev(), 
         "System::Guts::realizeVelocity()");
     if (s.getSystemStage() < Stage::Velocity) {
+        GutsRep::RealizationTimer timer(getRep(), Stage::Velocity);
         // Allow the subclass to do processing.
         realizeVelocityImpl(s);
         // Realize any subsystems that the subclass didn't already take care of.
@@ -502,6 +765,7 @@ void System::Guts::realizeDynamics(const State& s) const {
     SimTK_STAGECHECK_GE_ALWAYS(s.getSystemStage(), Stage(Stage::Dynamics).prev(), 
         "System::Guts::realizeDynamics()");
     if (s.getSystemStage() < Stage::Dynamics) {
+        GutsRep::RealizationTimer timer(getRep(), Stage::Dynamics);
         // Allow the subclass to do processing.
         realizeDynamicsImpl(s);
         // Realize any subsystems that the subclass didn't already take care of.
@@ -524,6 +788,7 @@ void System::Guts::realizeAcceleration(const State& s) const {
     SimTK_STAGECHECK_GE_ALWAYS(s.getSystemStage(), Stage(Stage::Acceleration).prev(), 
         "System::Guts::realizeAcceleration()");
     if (s.getSystemStage() < Stage::Acceleration) {
+        GutsRep::RealizationTimer timer(getRep(), Stage::Acceleration);
         // Allow the subclass to do processing.
         realizeAccelerationImpl(s);
         // Realize any subsystems that the subclass didn't already take care of.
@@ -546,6 +811,7 @@ void System::Guts::realizeReport(const State& s) const {
     SimTK_STAGECHECK_GE_ALWAYS(s.getSystemStage(), Stage(Stage::Report).prev(), 
         "System::Guts::realizeReport()");
     if (s.getSystemStage() < Stage::Report) {
+        GutsRep::RealizationTimer timer(getRep(), Stage::Report);
         // Allow the subclass to do processing.
         realizeReportImpl(s);
         // Realize any subsystems that the subclass didn't already take care of.
@@ -589,6 +855,12 @@ void System::Guts::multiplyByNPInvTranspose(const State& s, const Vector& fu,
     return multiplyByNPInvTransposeImpl(s,fu,fq);
 }
 
+bool System::Guts::calcYDotJacobian(const State& s, Matrix& dYdotdY) const {
+    SimTK_STAGECHECK_GE(s.getSystemStage(), Stage::Dynamics,
+        "System::Guts::calcYDotJacobian()");
+    return calcYDotJacobianImpl(s,dYdotdY);
+}
+
 
 
 //------------------------------------------------------------------------------
@@ -776,6 +1048,12 @@ void System::Guts::realize(const State& s, Stage g) const {
     SimTK_STAGECHECK_GE_ALWAYS(s.getSystemStage(), Stage::Model, 
         "System::Guts::realize()");
 
+    if (getRep().realizationProfilingEnabled) {
+        const Stage highestCached = std::min(s.getSystemStage(), g);
+        if (highestCached >= Stage::Instance)
+            getRep().recordRealizationCacheHits(Stage::Instance, highestCached);
+    }
+
     Stage stageNow = Stage::Empty;
     while ((stageNow=s.getSystemStage()) < g) {
         switch (stageNow) {
@@ -1012,7 +1290,109 @@ int System::Guts::calcTimeOfNextScheduledReportImpl
 //==============================================================================
 //                         SYSTEM :: GUTS :: GUTS REP
 //==============================================================================
-// All inline currently.
+// Mostly inline; these are the realization profiling methods.
+
+void System::Guts::GutsRep::recordRealization
+   (SubsystemIndex subsys, Stage g, long long startInNs, long long durationInNs,
+    double cpuTime) const
+{
+    std::lock_guard<std::mutex> lock(realizationProfileLock);
+
+    const std::thread::id me = std::this_thread::get_id();
+    int thread = 0;
+    while (thread < (int)realizationThreads.size() 
+           && realizationThreads[thread] != me)
+        ++thread;
+    if (thread == (int)realizationThreads.size())
+        realizationThreads.push_back(me);
+
+    RealizationTraceEvent event;
+    event.subsys = subsys; event.stage = g;
+    event.startInNs = startInNs; event.durationInNs = durationInNs;
+    event.cpuTime = cpuTime; event.thread = thread;
+    if ((int)realizationTrace.size() < maxRealizationTraceEvents)
+        realizationTrace.push_back(event);
+
+    if (!subsys.isValid())
+        return;
+    const unsigned slot = subsys*Stage::NValid + g;
+    if (realizationProfiles.size() <= slot)
+        realizationProfiles.resize(getNumSubsystems()*Stage::NValid);
+    RealizationProfile& profile = realizationProfiles[slot];
+    profile.wallTimeInNs += durationInNs;
+    profile.cpuTime += cpuTime;
+    ++profile.numRealizations;
+}
+
+void System::Guts::GutsRep::
+recordRealizationCacheHits(Stage lowest, Stage highest) const {
+    std::lock_guard<std::mutex> lock(realizationProfileLock);
+    for (int g = lowest; g <= highest; ++g)
+        ++nRealizationCacheHits[g];
+}
+
+System::Guts::GutsRep::RealizationProfile System::Guts::GutsRep::
+getRealizationProfile(SubsystemIndex subsys, Stage g) const {
+    SimTK_INDEXCHECK_ALWAYS(subsys, getNumSubsystems(),
+        "System::getSubsystemRealizationTime()");
+    std::lock_guard<std::mutex> lock(realizationProfileLock);
+    const unsigned slot = subsys*Stage::NValid + g;
+    return slot < realizationProfiles.size() ? realizationProfiles[slot]
+                                             : RealizationProfile();
+}
+
+
+
+//==============================================================================
+//                            REALIZATION TRACE
+//==============================================================================
+
+namespace {
+// Write a string as a JSON string literal.
+void writeJsonString(std::ostream& o, const String& str) {
+    o << '"';
+    for (char c : str) {
+        if (c == '"' || c == '\\') o << '\\' << c;
+        else if ((unsigned char)c < 0x20) o << ' ';
+        else o << c;
+    }
+    o << '"';
+}
+}
+
+void System::writeRealizationTrace(std::ostream& o) const {
+    const auto& rep = getSystemGuts().getRep();
+    std::lock_guard<std::mutex> lock(rep.realizationProfileLock);
+
+    // The System's own realizations are recorded when they finish, after
+    // the Subsystem realizations they contain, so find the earliest start.
+    long long originInNs = 0;
+    for (unsigned i=0; i < rep.realizationTrace.size(); ++i) {
+        const long long startInNs = rep.realizationTrace[i].startInNs;
+        if (i == 0 || startInNs < originInNs) originInNs = startInNs;
+    }
+
+    const std::ios::fmtflags flags = o.flags();
+    const std::streamsize precision = o.precision();
+    o << std::fixed;
+    o << "{\"traceEvents\":[";
+    for (unsigned i=0; i < rep.realizationTrace.size(); ++i) {
+        const auto& e = rep.realizationTrace[i];
+        const String& who = e.subsys.isValid() 
+            ? rep.getSubsystem(e.subsys).getName() : rep.getName();
+        o << (i ? ",\n" : "\n") << "{\"name\":";
+        writeJsonString(o, who + " " + e.stage.getName());
+        o << ",\"cat\":\"" << (e.subsys.isValid() ? "subsystem" : "system")
+          << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << e.thread
+          << std::setprecision(3)
+          << ",\"ts\":" << (e.startInNs - originInNs)/1e3
+          << ",\"dur\":" << e.durationInNs/1e3
+          << ",\"args\":{\"cpu_us\":" << e.cpuTime*1e6 << "}}";
+    }
+    o << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    o.flags(flags);
+    o.precision(precision);
+}
 
 
 
@@ -37,6 +37,12 @@
 
 #include "SimTKcommon/internal/System.h"
 #include "SimTKcommon/internal/SystemGuts.h"
+#include "SimTKcommon/internal/Timing.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace SimTK {
 
@@ -74,7 +80,10 @@ public:
         useUniformBackground(src.useUniformBackground),
         hasTimeAdvancedEventsFlag(src.hasTimeAdvancedEventsFlag),
         systemTopologyRealized(false),
-        topologyCacheVersion(src.topologyCacheVersion)
+        topologyCacheVersion(src.topologyCacheVersion),
+        realizationTimingEnabled(src.realizationTimingEnabled),
+        realizationProfilingEnabled(src.realizationProfilingEnabled),
+        maxRealizationTraceEvents(src.maxRealizationTraceEvents)
     {
         resetAllCounters();
     }
@@ -200,7 +209,10 @@ private:
     mutable State           defaultState;
 
         // STATISTICS //
-    mutable int nRealizationsOfStage[Stage::NValid];
+    // The realization counts and times are atomic because several threads
+    // may be realizing different States of this System at once (see
+    // MultibodySystem::realizeBatch()).
+    mutable std::atomic<int> nRealizationsOfStage[Stage::NValid];
     mutable int nRealizeCalls; // counts realizeTopology(), realizeModel(), realize()
 
     mutable int nPrescribeQCalls, nPrescribeUCalls;
@@ -214,9 +226,90 @@ private:
     mutable int nHandleEventsCalls;
     mutable int nReportEventsCalls;
 
+    bool realizationTimingEnabled = false;
+    mutable std::atomic<long long> realizationTimeInNs[Stage::NValid];
+
+        // REALIZATION PROFILING //
+
+    // While profiling is enabled, every realization of a Subsystem adds
+    // its times to the profile for that Subsystem and Stage, and every
+    // realization of a Subsystem or of the System as a whole is appended
+    // to the trace. Several threads may be realizing different States of
+    // this System at once, so these are only touched with the lock held.
+    struct RealizationProfile {
+        long long   wallTimeInNs = 0;
+        double      cpuTime = 0;
+        int         numRealizations = 0;
+    };
+    struct RealizationTraceEvent {
+        SubsystemIndex  subsys; // invalid for the System as a whole
+        Stage           stage;
+        long long       startInNs, durationInNs;
+        double          cpuTime;
+        int             thread; // index into realizationThreads
+    };
+
+    bool realizationProfilingEnabled = false;
+    mutable std::mutex realizationProfileLock;
+    // Indexed by subsystem*Stage::NValid + stage; grown as needed.
+    mutable std::vector<RealizationProfile> realizationProfiles;
+    mutable int nRealizationCacheHits[Stage::NValid];
+    mutable std::vector<RealizationTraceEvent> realizationTrace;
+    int maxRealizationTraceEvents = 1000000; // ~40MB
+    mutable std::vector<std::thread::id> realizationThreads;
+
+    // Record a realization of the given Subsystem, or of the whole System
+    // if the index is invalid. Call only when profiling is enabled.
+    void recordRealization(SubsystemIndex subsys, Stage g,
+                           long long startInNs, long long durationInNs,
+                           double cpuTime) const;
+    // Count requests to realize() that found the given stages already
+    // realized.
+    void recordRealizationCacheHits(Stage lowest, Stage highest) const;
+    // Return the profile for a Subsystem and Stage, or a zero profile if
+    // there is none.
+    RealizationProfile getRealizationProfile(SubsystemIndex subsys,
+                                             Stage g) const;
+
+    // While realization timing is enabled, this adds the time until it goes
+    // out of scope to the total for the given Stage. While realization
+    // profiling is enabled it also records a realization of the System.
+    class RealizationTimer {
+    public:
+        RealizationTimer(const GutsRep& rep, Stage g)
+        :   rep(rep), stage(g), 
+            timing(rep.realizationTimingEnabled),
+            profiling(rep.realizationProfilingEnabled),
+            startCpuTime(profiling ? threadCpuTime() : 0),
+            startInNs(timing || profiling ? realTimeInNs() : 0) {}
+        ~RealizationTimer() {
+            if (!(timing || profiling)) return;
+            const long long durationInNs = realTimeInNs() - startInNs;
+            if (timing) rep.realizationTimeInNs[stage] += durationInNs;
+            if (profiling) 
+                rep.recordRealization(SubsystemIndex(), stage, startInNs,
+                    durationInNs, threadCpuTime() - startCpuTime);
+        }
+    private:
+        const GutsRep&  rep;
+        const Stage     stage;
+        const bool      timing, profiling;
+        const double    startCpuTime;
+        const long long startInNs;
+    };
+
     void resetAllCounters() {
+        for (int i=0; i<Stage::NValid; ++i) {
+            nRealizationsOfStage[i] = 0;
+            nHandlerCallsThatChangedStage[i] = 0;
+            realizationTimeInNs[i] = 0;
+        }
+        {std::lock_guard<std::mutex> lock(realizationProfileLock);
         for (int i=0; i<Stage::NValid; ++i)
-            nRealizationsOfStage[i] = nHandlerCallsThatChangedStage[i] = 0;
+            nRealizationCacheHits[i] = 0;
+        realizationProfiles.clear();
+        realizationTrace.clear();
+        realizationThreads.clear();}
         nRealizeCalls = nPrescribeQCalls = nPrescribeUCalls = 0;
         nProjectQCalls = nProjectUCalls = 0;
         nFailedProjectQCalls = nFailedProjectUCalls = 0;
@@ -0,0 +1,209 @@
+#ifndef SimTK_SIMMATRIX_SMALLMATRIX_BATCH_H_
+#define SimTK_SIMMATRIX_SMALLMATRIX_BATCH_H_
+
+/* -------------------------------------------------------------------------- *
+ *                       Simbody(tm): SimTKcommon                             *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors: Michael Sherman                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/**@file
+ * This file defines SymMatBatch and VecBatch, which hold many independent
+ * small fixed-size symmetric systems in "structure of arrays" form so that
+ * they can be factored and solved together.
+ */
+
+#include <cmath>
+#include <vector>
+
+namespace SimTK {
+
+/** A "structure of arrays" batch of n M-vectors, the right hand sides and
+solutions for a SymMatBatch. Element i of all n vectors is stored
+contiguously. **/
+template <int M, class P=Real>
+class VecBatch {
+public:
+    typedef Vec<M,P> VecType;
+
+    VecBatch() : n(0) {}
+    explicit VecBatch(int nvec) : n(0) {resize(nvec);}
+
+    /** Change the number of vectors; contents are lost. **/
+    void resize(int nvec) {n=nvec; data.resize(M*n);}
+    int size() const {return n;}
+
+    /** Copy vector \a v into slot \a k. **/
+    void setVec(int k, const VecType& v)
+    {   for (int i=0; i<M; ++i) data[i*n+k] = v[i]; }
+    /** Return a copy of the vector in slot \a k. **/
+    VecType getVec(int k) const
+    {   VecType v; for (int i=0; i<M; ++i) v[i] = data[i*n+k]; return v; }
+
+    /** Element \a i of all the vectors, as a contiguous array of size(). **/
+    const P* getLane(int i) const {return data.data() + i*n;}
+    P*       updLane(int i)       {return data.data() + i*n;}
+private:
+    int            n;
+    std::vector<P> data;
+};
+
+/** A "structure of arrays" batch of n symmetric positive definite M X M
+matrices, for problems that need thousands of independent 3x3 or 6x6
+solves. Element (i,j) of all n matrices is stored contiguously, so
+factorCholeskyInPlace() and solveInPlace() work on all the matrices in
+lockstep with simple unit-stride loops that the compiler can vectorize;
+there is no per-matrix branching or pivoting. Use setMat() to load the
+matrices, factor once, then solve for as many VecBatch right hand sides as
+needed.
+
+Only the lower triangle is stored. After factoring, the storage holds the
+Cholesky factor L with A=L*~L. A matrix whose factorization fails because it
+is not numerically positive definite is flagged (see isFactorFailed()); its
+slot then holds a meaningless but finite factor so it doesn't disturb the
+other lanes. **/
+template <int M, class P=Real>
+class SymMatBatch {
+public:
+    typedef SymMat<M,P> SymMatType;
+    enum {NLower = M*(M+1)/2};
+
+    SymMatBatch() : n(0), nFailed(0) {}
+    explicit SymMatBatch(int nmat) : n(0), nFailed(0) {resize(nmat);}
+
+    /** Change the number of matrices; contents are lost. **/
+    void resize(int nmat) {
+        n = nmat; nFailed = 0;
+        data.resize(NLower*n); invDiag.resize(M*n); failed.assign(n, 0);
+    }
+    int size() const {return n;}
+
+    /** Copy the lower triangle of \a S into slot \a k. **/
+    void setMat(int k, const SymMatType& S) {
+        for (int i=0; i<M; ++i) for (int j=0; j<=i; ++j)
+            data[index(i,j)*n+k] = S(i,j);
+    }
+    /** Return a copy of what is presently stored in slot \a k: the original
+    matrix before factoring, or L (in the lower triangle) after. **/
+    SymMatType getMat(int k) const {
+        SymMatType S;
+        for (int i=0; i<M; ++i) for (int j=0; j<=i; ++j)
+            S(i,j) = data[index(i,j)*n+k];
+        return S;
+    }
+
+    /** Replace each matrix A by its Cholesky factor L, A=L*~L. Returns the
+    number of matrices that could not be factored. Cost is about M^3/6
+    multiply-adds and M square roots per matrix. **/
+    int factorCholeskyInPlace() {
+        nFailed = 0;
+        for (int k=0; k < n; ++k) failed[k] = 0;
+        for (int j=0; j < M; ++j) {
+            // L(j,j) = sqrt(A(j,j) - sum_m L(j,m)^2)
+            P* ljj = lane(j,j);
+            for (int m=0; m < j; ++m) {
+                const P* ljm = lane(j,m);
+                for (int k=0; k < n; ++k) ljj[k] -= ljm[k]*ljm[k];
+            }
+            P* dj = invDiag.data() + j*n;
+            for (int k=0; k < n; ++k) {
+                const bool ok = ljj[k] > 0;
+                if (!ok) failed[k] = 1;
+                ljj[k] = std::sqrt(ok ? ljj[k] : P(1));
+                dj[k]  = P(1) / ljj[k];
+            }
+            // L(i,j) = (A(i,j) - sum_m L(i,m)*L(j,m)) / L(j,j), i > j
+            for (int i=j+1; i < M; ++i) {
+                P* lij = lane(i,j);
+                for (int m=0; m < j; ++m) {
+                    const P* lim = lane(i,m); const P* ljm = lane(j,m);
+                    for (int k=0; k < n; ++k) lij[k] -= lim[k]*ljm[k];
+                }
+                for (int k=0; k < n; ++k) lij[k] *= dj[k];
+            }
+        }
+        for (int k=0; k < n; ++k) nFailed += failed[k];
+        return nFailed;
+    }
+
+    /** Return true if matrix \a k was not positive definite in the most
+    recent factorCholeskyInPlace(). **/
+    bool isFactorFailed(int k) const {return failed[k] != 0;}
+    int  getNumFactorsFailed() const {return nFailed;}
+
+    /** Overwrite each right hand side b in \a bx with x=A^-1*b, using the
+    factors from factorCholeskyInPlace(). Costs about M^2 multiply-adds per
+    matrix. **/
+    void solveInPlace(VecBatch<M,P>& bx) const {
+        SimTK_ERRCHK2(bx.size()==n, "SymMatBatch::solveInPlace()",
+            "Batch of %d right hand sides doesn't match %d matrices.",
+            bx.size(), n);
+        // Forward: L*y=b.
+        for (int i=0; i < M; ++i) {
+            P* yi = bx.updLane(i);
+            for (int m=0; m < i; ++m) {
+                const P* lim = lane(i,m); const P* ym = bx.getLane(m);
+                for (int k=0; k < n; ++k) yi[k] -= lim[k]*ym[k];
+            }
+            const P* di = invDiag.data() + i*n;
+            for (int k=0; k < n; ++k) yi[k] *= di[k];
+        }
+        // Backward: ~L*x=y.
+        for (int i=M-1; i >= 0; --i) {
+            P* xi = bx.updLane(i);
+            for (int m=i+1; m < M; ++m) {
+                const P* lmi = lane(m,i); const P* xm = bx.getLane(m);
+                for (int k=0; k < n; ++k) xi[k] -= lmi[k]*xm[k];
+            }
+            const P* di = invDiag.data() + i*n;
+            for (int k=0; k < n; ++k) xi[k] *= di[k];
+        }
+    }
+
+    /** Overwrite \a bx with A^-1*bx using only the factor in slot \a k. This
+    is for callers like Gauss-Seidel iterations that factor all their blocks
+    together but must then solve them one at a time. **/
+    void solveInPlace(int k, Vec<M,P>& bx) const {
+        for (int i=0; i < M; ++i) {
+            for (int m=0; m < i; ++m) bx[i] -= lane(i,m)[k]*bx[m];
+            bx[i] *= invDiag[i*n+k];
+        }
+        for (int i=M-1; i >= 0; --i) {
+            for (int m=i+1; m < M; ++m) bx[i] -= lane(m,i)[k]*bx[m];
+            bx[i] *= invDiag[i*n+k];
+        }
+    }
+
+private:
+    // Row-packed lower triangle index of element (i,j), i >= j.
+    static int index(int i, int j) {return i*(i+1)/2 + j;}
+    P*       lane(int i, int j)       {return data.data() + index(i,j)*n;}
+    const P* lane(int i, int j) const {return data.data() + index(i,j)*n;}
+
+    int                         n;
+    int                         nFailed;
+    std::vector<P>              data;    // NLower lanes of n
+    std::vector<P>              invDiag; // M lanes of n; 1/L(j,j)
+    std::vector<unsigned char>  failed;  // n
+};
+
+} //namespace SimTK
+
+#endif //SimTK_SIMMATRIX_SMALLMATRIX_BATCH_H_
@@ -30,6 +30,11 @@
  * defined. Some of them may depend on Lapack also.
  */
 
+#if defined(SimTK_USE_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+    #include <emmintrin.h>
+    #define SimTK_SIMD_SSE2
+#endif
+
 namespace SimTK {
 
     // COMPARISON
@@ -188,6 +193,34 @@ operator*(const Mat<M,N,ME,CS,RS>& m,const Vec<N,E,S>& v) {
     return result;
 }
 
+#ifdef SimTK_SIMD_SSE2
+// Hand-vectorized versions of the 3x3 products that dominate rotation and
+// inertia arithmetic. Mat33 is stored by columns so the top two rows of each
+// column are a single unaligned SSE2 load; the third row is done as a scalar.
+// Every element is summed in the same order as the generic templates above,
+// so results are bitwise identical to the non-SIMD build.
+inline Vec<3,double>
+operator*(const Mat<3,3,double>& m, const Vec<3,double>& v) {
+    const double* a = &m(0,0);
+    __m128d r01 = _mm_mul_pd(_mm_loadu_pd(a), _mm_set1_pd(v[0]));
+    r01 = _mm_add_pd(r01, _mm_mul_pd(_mm_loadu_pd(a+3), _mm_set1_pd(v[1])));
+    r01 = _mm_add_pd(r01, _mm_mul_pd(_mm_loadu_pd(a+6), _mm_set1_pd(v[2])));
+    Vec<3,double> result;
+    _mm_storeu_pd(&result[0], r01);
+    result[2] = a[2]*v[0] + a[5]*v[1] + a[8]*v[2];
+    return result;
+}
+
+// mat33 = mat33 * mat33, one column at a time.
+inline Mat<3,3,double>
+operator*(const Mat<3,3,double>& l, const Mat<3,3,double>& r) {
+    Mat<3,3,double> result;
+    for (int j=0; j<3; ++j)
+        result(j) = l*r(j);
+    return result;
+}
+#endif
+
 // row = row * mat (conforming)
 template <int M, class E, int S, int N, class ME, int CS, int RS> inline
 typename Row<M,E,S>::template Result<Mat<M,N,ME,CS,RS> >::Mul
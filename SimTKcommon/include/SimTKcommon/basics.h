@@ -51,6 +51,7 @@
 #include "SimTKcommon/internal/IteratorRange.h"
 #include "SimTKcommon/internal/Fortran.h"
 #include "SimTKcommon/internal/Array.h"
+#include "SimTKcommon/internal/BinaryIO.h"
 #include "SimTKcommon/internal/StableArray.h"
 #include "SimTKcommon/internal/Value.h"
 #include "SimTKcommon/internal/Stage.h"
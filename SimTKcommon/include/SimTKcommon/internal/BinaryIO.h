@@ -0,0 +1,307 @@
+#ifndef SimTK_SimTKCOMMON_BINARY_IO_H_
+#define SimTK_SimTKCOMMON_BINARY_IO_H_
+
+/* -------------------------------------------------------------------------- *
+ *                       Simbody(tm): SimTKcommon                             *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/** @file
+Compact binary encoding of values, used for example by
+System::serializeState(). Unlike the text methods in Serialize.h the encoding
+is exact and is not portable between machines with different byte order or
+precision; the user of these classes is responsible for recording and
+checking that. **/
+
+#include "SimTKcommon/internal/common.h"
+#include "SimTKcommon/internal/ExceptionMacros.h"
+#include "SimTKcommon/internal/String.h"
+#include "SimTKcommon/internal/Array.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace SimTK {
+
+template <class T, class Enable=void> struct BinaryIO;
+
+//==============================================================================
+//                              BINARY WRITER
+//==============================================================================
+/** Appends the binary encoding of values to the end of a caller-supplied
+array of bytes. **/
+class BinaryWriter {
+public:
+    /** Bytes will be appended to `out`; anything already there is kept. **/
+    explicit BinaryWriter(Array_<char>& out) : m_out(out) {}
+
+    /** Number of bytes in the output array so far, including any that were
+    there when this writer was constructed. **/
+    std::size_t size() const {return m_out.size();}
+
+    /** Append `n` bytes starting at `bytes`. **/
+    void writeBytes(const void* bytes, std::size_t n) {
+        if (n == 0) return;
+        const std::size_t start = m_out.size();
+        m_out.resize(start + n);
+        std::memcpy(m_out.data() + start, bytes, n);
+    }
+
+    /** Replace `n` already-written bytes beginning at offset `pos`. Use this
+    to fill in a length field once the length is known. **/
+    void overwriteBytes(std::size_t pos, const void* bytes, std::size_t n) {
+        SimTK_ERRCHK_ALWAYS(pos + n <= m_out.size(),
+            "BinaryWriter::overwriteBytes()",
+            "Attempted to overwrite bytes that haven't been written.");
+        std::memcpy(m_out.data() + pos, bytes, n);
+    }
+
+    /** Append zero bytes until size() is a multiple of `alignment`. **/
+    void alignTo(std::size_t alignment)
+    {   while (m_out.size() % alignment) m_out.push_back(0); }
+
+    /** Append the encoding of `value` as defined by BinaryIO<T>. **/
+    template <class T> void write(const T& value)
+    {   BinaryIO<T>::write(*this, value); }
+
+private:
+    Array_<char>&   m_out;
+};
+
+
+
+//==============================================================================
+//                              BINARY READER
+//==============================================================================
+/** Decodes values from a caller-owned block of bytes, such as a buffer
+received over the network or a memory-mapped file. Nothing is copied until a
+value is read, and viewBytes() provides access to the bytes in place. Reading
+past the end of the block throws an exception. **/
+class BinaryReader {
+public:
+    BinaryReader(const char* data, std::size_t size)
+    :   m_begin(data), m_end(data + size), m_pos(data) {}
+
+    /** Offset of the next byte to be read. **/
+    std::size_t tell() const {return std::size_t(m_pos - m_begin);}
+    /** Number of bytes that have not been read yet. **/
+    std::size_t remaining() const {return std::size_t(m_end - m_pos);}
+
+    /** Set the offset of the next byte to be read. **/
+    void seek(std::size_t pos) {
+        SimTK_ERRCHK2_ALWAYS(pos <= std::size_t(m_end - m_begin),
+            "BinaryReader::seek()",
+            "Offset %llu is past the end of the %llu byte input.",
+            (unsigned long long)pos,
+            (unsigned long long)(m_end - m_begin));
+        m_pos = m_begin + pos;
+    }
+
+    /** Return a pointer to the next `n` bytes and advance past them. **/
+    const char* viewBytes(std::size_t n) {
+        SimTK_ERRCHK2_ALWAYS(n <= remaining(), "BinaryReader::viewBytes()",
+            "Attempted to read %llu bytes but only %llu remain.",
+            (unsigned long long)n, (unsigned long long)remaining());
+        const char* bytes = m_pos;
+        m_pos += n;
+        return bytes;
+    }
+
+    /** Copy the next `n` bytes to `bytes` and advance past them. **/
+    void readBytes(void* bytes, std::size_t n)
+    {   if (n) std::memcpy(bytes, viewBytes(n), n); }
+
+    /** Skip bytes until tell() is a multiple of `alignment`. **/
+    void alignTo(std::size_t alignment)
+    {   viewBytes((alignment - tell() % alignment) % alignment); }
+
+    /** Decode `value` as defined by BinaryIO<T>. **/
+    template <class T> void read(T& value)
+    {   BinaryIO<T>::read(*this, value); }
+
+private:
+    const char* m_begin;
+    const char* m_end;
+    const char* m_pos;
+};
+
+
+
+//==============================================================================
+//                                BINARY IO
+//==============================================================================
+/** Defines how an object of type `T` is written by BinaryWriter and read
+by BinaryReader. A specialization for a supported type provides
+@code
+    static const bool Supported = true;
+    static void write(BinaryWriter&, const T&);
+    static void read(BinaryReader&, T&);
+@endcode
+Arithmetic types, enums, SimTK small matrices and geometric types, String,
+std::pair, Array_ and Vector_ are supported here. To add your own type,
+specialize %BinaryIO in namespace SimTK; a type whose bytes can be copied as
+they are (no pointers or owned memory) may simply derive its specialization
+from BinaryIOBitwise. Any other type is unsupported; AbstractValue uses
+`Supported` to report whether a Value<T> can be written. **/
+template <class T, class Enable>
+struct BinaryIO {
+    static const bool Supported = false;
+};
+
+/** Base class for BinaryIO specializations of types that are written by
+copying their bytes. **/
+template <class T>
+struct BinaryIOBitwise {
+    static const bool Supported = true;
+    static void write(BinaryWriter& out, const T& value)
+    {   out.writeBytes(&value, sizeof(T)); }
+    static void read(BinaryReader& in, T& value)
+    {   in.readBytes(&value, sizeof(T)); }
+};
+
+/** True if BinaryIO<T> copies bytes, so that an array of `T` can be written
+as a single block. **/
+template <class T>
+struct BinaryIOIsBitwise
+:   std::is_base_of<BinaryIOBitwise<T>, BinaryIO<T>> {};
+
+template <class T>
+struct BinaryIO<T, typename std::enable_if<std::is_arithmetic<T>::value
+                                           || std::is_enum<T>::value>::type>
+:   BinaryIOBitwise<T> {};
+
+// Small matrices are fixed-size arrays of their elements.
+template <int M, class E, int S>
+struct BinaryIO<Vec<M,E,S>,
+                typename std::enable_if<BinaryIOIsBitwise<E>::value>::type>
+:   BinaryIOBitwise<Vec<M,E,S>> {};
+template <int N, class E, int S>
+struct BinaryIO<Row<N,E,S>,
+                typename std::enable_if<BinaryIOIsBitwise<E>::value>::type>
+:   BinaryIOBitwise<Row<N,E,S>> {};
+template <int M, int N, class E, int CS, int RS>
+struct BinaryIO<Mat<M,N,E,CS,RS>,
+                typename std::enable_if<BinaryIOIsBitwise<E>::value>::type>
+:   BinaryIOBitwise<Mat<M,N,E,CS,RS>> {};
+template <int M, class E, int RS>
+struct BinaryIO<SymMat<M,E,RS>,
+                typename std::enable_if<BinaryIOIsBitwise<E>::value>::type>
+:   BinaryIOBitwise<SymMat<M,E,RS>> {};
+
+// Geometric types are built from small matrices.
+template <class P> class Rotation_;
+template <class P> class Transform_;
+template <class P> class Quaternion_;
+template <class P, int S> class UnitVec;
+template <class P> class Inertia_;
+template <class P> class UnitInertia_;
+template <class P> class MassProperties_;
+
+template <class P> struct BinaryIO<Rotation_<P>>
+:   BinaryIOBitwise<Rotation_<P>> {};
+template <class P> struct BinaryIO<Transform_<P>>
+:   BinaryIOBitwise<Transform_<P>> {};
+template <class P> struct BinaryIO<Quaternion_<P>>
+:   BinaryIOBitwise<Quaternion_<P>> {};
+template <class P, int S> struct BinaryIO<UnitVec<P,S>>
+:   BinaryIOBitwise<UnitVec<P,S>> {};
+template <class P> struct BinaryIO<Inertia_<P>>
+:   BinaryIOBitwise<Inertia_<P>> {};
+template <class P> struct BinaryIO<UnitInertia_<P>>
+:   BinaryIOBitwise<UnitInertia_<P>> {};
+template <class P> struct BinaryIO<MassProperties_<P>>
+:   BinaryIOBitwise<MassProperties_<P>> {};
+
+// A String is its length followed by its characters.
+template <>
+struct BinaryIO<String> {
+    static const bool Supported = true;
+    static void write(BinaryWriter& out, const String& s) {
+        out.write(std::uint64_t(s.size()));
+        out.writeBytes(s.data(), s.size());
+    }
+    static void read(BinaryReader& in, String& s) {
+        std::uint64_t n; in.read(n);
+        const char* chars = in.viewBytes(std::size_t(n));
+        s.assign(chars, std::size_t(n));
+    }
+};
+
+template <class A, class B>
+struct BinaryIO<std::pair<A,B>,
+                typename std::enable_if<BinaryIO<A>::Supported
+                                        && BinaryIO<B>::Supported>::type> {
+    static const bool Supported = true;
+    static void write(BinaryWriter& out, const std::pair<A,B>& p)
+    {   out.write(p.first); out.write(p.second); }
+    static void read(BinaryReader& in, std::pair<A,B>& p)
+    {   in.read(p.first); in.read(p.second); }
+};
+
+// Arrays are their length followed by their elements; elements that are
+// written bitwise are written as a single block.
+template <class T, class X>
+struct BinaryIO<Array_<T,X>,
+                typename std::enable_if<BinaryIO<T>::Supported>::type> {
+    static const bool Supported = true;
+    static void write(BinaryWriter& out, const Array_<T,X>& a) {
+        out.write(std::uint64_t(a.size()));
+        if (BinaryIOIsBitwise<T>::value)
+            out.writeBytes(a.data(), a.size()*sizeof(T));
+        else for (const T& elt : a) out.write(elt);
+    }
+    static void read(BinaryReader& in, Array_<T,X>& a) {
+        std::uint64_t n; in.read(n);
+        a.resize(typename Array_<T,X>::size_type(n));
+        if (BinaryIOIsBitwise<T>::value)
+            in.readBytes(a.data(), a.size()*sizeof(T));
+        else for (T& elt : a) in.read(elt);
+    }
+};
+
+template <class E> class Vector_;
+
+template <class E>
+struct BinaryIO<Vector_<E>,
+                typename std::enable_if<BinaryIO<E>::Supported>::type> {
+    static const bool Supported = true;
+    static void write(BinaryWriter& out, const Vector_<E>& v) {
+        const int n = v.size();
+        out.write(std::uint64_t(n));
+        if (BinaryIOIsBitwise<E>::value && n && v.hasContiguousData())
+            out.writeBytes(&v[0], n*sizeof(E));
+        else for (int i=0; i < n; ++i) out.write(v[i]);
+    }
+    static void read(BinaryReader& in, Vector_<E>& v) {
+        std::uint64_t n; in.read(n);
+        v.resize(int(n));
+        if (BinaryIOIsBitwise<E>::value && n && v.hasContiguousData())
+            in.readBytes(&v[0], std::size_t(n)*sizeof(E));
+        else for (int i=0; i < int(n); ++i) in.read(v[i]);
+    }
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SimTKCOMMON_BINARY_IO_H_
@@ -25,6 +25,7 @@
  * -------------------------------------------------------------------------- */
 
 #include "PrivateImplementation.h"
+#include "SimTKcommon/internal/Array.h"
 #include <thread>
 #include <iostream>
  
@@ -112,6 +113,42 @@ public:
      * currently allowed to use.
      */
     int getMaxThreads() const;
+    /**
+     * Change the maximum number of threads this ParallelExecutor may use.
+     * Any worker threads that were already launched are stopped and new ones
+     * are launched the next time they are needed. This must not be called 
+     * while a task is being executed.
+     *
+     * @param maxThreads the maximum number of threads that the 
+     *                   ParallelExecutor is allowed to launch (at least 1)
+     */
+    void setMaxThreads(int maxThreads);
+    /**
+     * Pin the worker threads to particular processors. Worker thread i is 
+     * bound to processor cpus[i % cpus.size()]; an empty list removes the
+     * restriction for threads launched afterwards. This is currently only
+     * implemented on Linux and Windows and is ignored elsewhere. On Windows
+     * the processors are numbered consecutively through all the processor
+     * groups. An index that is negative or beyond what the platform can
+     * address (CPU_SETSIZE on Linux, the number of active processors on
+     * Windows) is an error.
+     */
+    void setThreadAffinity(const Array_<int>& cpus);
+    /**
+     * Get the ParallelExecutor that is shared by all of Simbody's internal
+     * parallel computations (for example, GeneralForceSubsystem and 
+     * MultibodySystem::realizeBatch()) unless they have been given a thread
+     * count of their own. Using one executor throughout keeps the total 
+     * number of worker threads within a single budget. By default it uses
+     * one thread per processor; call setMaxThreads() and setThreadAffinity()
+     * on it to configure that budget. The shared executor is created on 
+     * first use and is never destroyed.
+     *
+     * If a task executed by the shared executor itself calls execute() on
+     * it, or if it is already busy with a task from another thread, the 
+     * new task is executed serially on the calling thread.
+     */
+    static ParallelExecutor& getSharedExecutor();
 };
 
 /**
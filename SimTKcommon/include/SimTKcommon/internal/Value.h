@@ -28,6 +28,7 @@
 
 #include "SimTKcommon/internal/String.h"
 #include "SimTKcommon/internal/Exception.h"
+#include "SimTKcommon/internal/BinaryIO.h"
 
 #include <limits>
 #include <typeinfo>
@@ -73,6 +74,28 @@ public:
     AbstractValue& operator=(const AbstractValue& v) 
     {   compatibleAssign(v); return *this; }
 
+    /** Return true if the contained value can be written with writeBinary()
+    and read back with readBinary(). For a `Value<T>` that is the case when
+    BinaryIO<T> supports type `T`. **/
+    virtual bool isBinarySerializable() const {return false;}
+
+    /** Append the binary encoding of the contained value to `out`. An
+    exception is thrown if isBinarySerializable() is false. **/
+    virtual void writeBinary(BinaryWriter& out) const {
+        SimTK_ERRCHK1_ALWAYS(false, "AbstractValue::writeBinary()",
+            "Values of type %s can't be written in binary.",
+            getTypeName().c_str());
+    }
+
+    /** Replace the contained value with one decoded from `in`, which must
+    have been written by writeBinary() for the same type. An exception is
+    thrown if isBinarySerializable() is false. **/
+    virtual void readBinary(BinaryReader& in) {
+        SimTK_ERRCHK1_ALWAYS(false, "AbstractValue::readBinary()",
+            "Values of type %s can't be read in binary.",
+            getTypeName().c_str());
+    }
+
     /** Retrieve the original (type-erased)`thing` as read-only. The template
     argument must be exactly the non-reference type of the stored `thing`. **/
     template <typename T>
@@ -207,6 +230,18 @@ public:
     contained value of type `T`. Currently just returns the type name. **/
     String getValueAsString() const override 
     {   return "Value<" + getTypeName() + ">"; }
+
+    /** Return true if BinaryIO<T> supports type `T`. **/
+    bool isBinarySerializable() const override 
+    {   return BinaryIO<T>::Supported; }
+
+    /** Write the contained value using BinaryIO<T>. **/
+    void writeBinary(BinaryWriter& out) const override
+    {   writeBinaryHelper(out, IsBinarySerializable()); }
+
+    /** Read the contained value using BinaryIO<T>. **/
+    void readBinary(BinaryReader& in) override
+    {   readBinaryHelper(in, IsBinarySerializable()); }
     
     /** Return true if the given AbstractValue is an object of this type
     `Value<T>`. **/ 
@@ -229,6 +264,17 @@ public:
     static Value& downcast(AbstractValue& value) {return updDowncast(value);}
 
 private:
+    using IsBinarySerializable = 
+        std::integral_constant<bool, BinaryIO<T>::Supported>;
+    void writeBinaryHelper(BinaryWriter& out, std::true_type) const
+    {   BinaryIO<T>::write(out, m_thing); }
+    void writeBinaryHelper(BinaryWriter& out, std::false_type) const
+    {   AbstractValue::writeBinary(out); }
+    void readBinaryHelper(BinaryReader& in, std::true_type)
+    {   BinaryIO<T>::read(in, m_thing); }
+    void readBinaryHelper(BinaryReader& in, std::false_type)
+    {   AbstractValue::readBinary(in); }
+
     T   m_thing;
 };
 
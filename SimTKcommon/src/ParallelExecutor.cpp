@@ -23,19 +23,40 @@
 
 #include "ParallelExecutorImpl.h"
 #include "SimTKcommon/internal/ParallelExecutor.h"
-#include <pthread.h>
 
 #include <iostream>
 #include <string>
 #include <algorithm>
+#include <limits>
+#include <new>
+
+#ifdef __APPLE__
+   #include <sys/sysctl.h>
+   #include <dlfcn.h>
+#elif _WIN32
+   #if !defined(NOMINMAX)
+   #define NOMINMAX
+   #endif
+   #include <windows.h>
+#elif __linux__
+   #include <dlfcn.h>
+   #include <unistd.h>
+   #include <pthread.h>
+   #include <sched.h>
+#else
+  #error "Architecture unsupported"
+#endif
 
 using namespace std;
 
 namespace SimTK {
 
-static void* threadBody(void* args);
+// Number of times an idle thread polls for new work (yielding in between)
+// before blocking on a condition variable. Spinning only helps if there are
+// other cores available to make progress.
+static const int DefaultSpinCount = 2000;
 
-ParallelExecutorImpl::ParallelExecutorImpl() : finished(false) {
+ParallelExecutorImpl::ParallelExecutorImpl() {
 
     //By default, we use the total number of processors available of the
     //computer (including hyperthreads)
@@ -45,7 +66,7 @@ ParallelExecutorImpl::ParallelExecutorImpl() : finished(false) {
 
     ParallelExecutorImpl::init();
 }
-ParallelExecutorImpl::ParallelExecutorImpl(int numThreads) : finished(false) {
+ParallelExecutorImpl::ParallelExecutorImpl(int numThreads) {
 
     // Set the maximum number of threads that we can use
     SimTK_APIARGCHECK_ALWAYS(numThreads > 0, "ParallelExecutorImpl",
@@ -55,82 +76,205 @@ ParallelExecutorImpl::ParallelExecutorImpl(int numThreads) : finished(false) {
     ParallelExecutorImpl::init();
 }
 ParallelExecutorImpl::~ParallelExecutorImpl() {
-    
-    // Notify the threads that they should exit.
-    
-    pthread_mutex_lock(&runLock);
-    finished = true;
-    for (int i = 0; i < (int) threads.size(); ++i)
-        threadInfo[i]->running = true;
-    pthread_cond_broadcast(&runCondition);
-    pthread_mutex_unlock(&runLock);
-    
-    // Wait until all the threads have finished.
-    
-    for (int i = 0; i < (int) threads.size(); ++i)
-        pthread_join(threads[i], NULL);
-    
-    // Clean up threading related objects.
-    
-    pthread_mutex_destroy(&runLock);
-    pthread_cond_destroy(&runCondition);
-    pthread_cond_destroy(&waitCondition);
+    stopThreads();
 }
 ParallelExecutorImpl* ParallelExecutorImpl::clone() const {
-    return new ParallelExecutorImpl(numMaxThreads);
+    ParallelExecutorImpl* copy = new ParallelExecutorImpl(numMaxThreads);
+    copy->affinity = affinity;
+    return copy;
 }
 void ParallelExecutorImpl::init()
 {
-  pthread_mutex_init(&runLock, NULL);
-  pthread_cond_init(&runCondition, NULL);
-  pthread_cond_init(&waitCondition, NULL);
+    finished = false;
+    busy = false;
+    currentTask = nullptr;
+    currentParticipants = 0;
+    ranges = nullptr;
+    generation = 0;
+    finishedThreadCount = 0;
+    spinCount = ParallelExecutor::getNumProcessors() > 1 ? DefaultSpinCount : 0;
+}
+void ParallelExecutorImpl::launchThreads() {
+    rangeStorage.reset(new char[(numMaxThreads+1)*sizeof(WorkRange)]);
+    const std::uintptr_t address = 
+        reinterpret_cast<std::uintptr_t>(rangeStorage.get());
+    ranges = reinterpret_cast<WorkRange*>
+        ((address + CacheLineSize-1) & ~std::uintptr_t(CacheLineSize-1));
+    for (int i = 0; i < numMaxThreads; ++i)
+        new (&ranges[i]) WorkRange{{pack(0, 0)}};
+    threads.reserve(numMaxThreads);
+    for (int i = 0; i < numMaxThreads; ++i) {
+        threads.emplace_back(&ParallelExecutorImpl::workerBody, this, i,
+                             generation.load());
+        applyAffinity(i);
+    }
+}
+void ParallelExecutorImpl::stopThreads() {
+
+    // Notify the threads that they should exit, then wait until they have.
+
+    {   std::lock_guard<std::mutex> lock(runLock);
+        finished = true; }
+    runCondition.notify_all();
+    for (auto& thread : threads)
+        thread.join();
+    threads.clear();
+    finished = false;
+}
+void ParallelExecutorImpl::setMaxThreads(int numThreads) {
+    SimTK_APIARGCHECK_ALWAYS(numThreads > 0, "ParallelExecutor",
+                 "setMaxThreads", "Number of threads must be positive.");
+    SimTK_ERRCHK_ALWAYS(!busy, "ParallelExecutor::setMaxThreads()",
+                 "Can't change the number of threads while executing a task.");
+    if (numThreads == numMaxThreads)
+        return;
+    stopThreads();
+    numMaxThreads = numThreads;
+}
+// The number of processors that setThreadAffinity() can refer to. On
+// Windows they are numbered consecutively through the processor groups.
+static int getNumAddressableProcessors() {
+#if defined(__linux__)
+    return CPU_SETSIZE;
+#elif defined(_WIN32)
+    return (int)GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+#else
+    return std::numeric_limits<int>::max(); // affinity is ignored anyway
+#endif
+}
+void ParallelExecutorImpl::setThreadAffinity(const Array_<int>& cpus) {
+    const int numProcessors = getNumAddressableProcessors();
+    for (int cpu : cpus)
+        SimTK_APIARGCHECK1_ALWAYS(cpu >= 0 && cpu < numProcessors,
+            "ParallelExecutor", "setThreadAffinity", 
+            "Processor index %d is invalid.", cpu);
+    affinity = cpus;
+    for (int i = 0; i < (int)threads.size(); ++i)
+        applyAffinity(i);
+}
+void ParallelExecutorImpl::applyAffinity(int threadIndex) {
+    if (affinity.empty())
+        return;
+    const int cpu = affinity[threadIndex % affinity.size()];
+#if defined(__linux__)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpu, &cpuSet);
+    pthread_setaffinity_np(threads[threadIndex].native_handle(),
+                           sizeof(cpu_set_t), &cpuSet);
+#elif defined(_WIN32)
+    // Find the processor group containing this processor; a group has at
+    // most 64 processors, one per bit of the mask.
+    GROUP_AFFINITY groupAffinity = {};
+    int index = cpu;
+    const WORD numGroups = GetActiveProcessorGroupCount();
+    for (WORD group = 0; group < numGroups; ++group) {
+        const int groupSize = (int)GetActiveProcessorCount(group);
+        if (index < groupSize) {
+            groupAffinity.Group = group;
+            groupAffinity.Mask = KAFFINITY(1) << index;
+            break;
+        }
+        index -= groupSize;
+    }
+    if (groupAffinity.Mask) // else the processor has gone away since
+        SetThreadGroupAffinity(threads[threadIndex].native_handle(),
+                               &groupAffinity, nullptr);
+#else
+    (void)cpu; // not supported on this platform
+#endif
+}
+void ParallelExecutorImpl::executeSerially(ParallelExecutor::Task& task, 
+                                           int times) {
+    task.initialize();
+    for (int i = 0; i < times; ++i)
+        task.execute(i);
+    task.finish();
 }
 void ParallelExecutorImpl::execute(ParallelExecutor::Task& task, int times) {
-  if (min(times, numMaxThreads) == 1) {
-      //(1) NON-PARALLEL CASE:
-      // Nothing is actually going to get done in parallel, so we might as well
-      // just execute the task directly and save the threading overhead.
-      task.initialize();
-      for (int i = 0; i < times; ++i)
-          task.execute(i);
-      task.finish();
-      return;
+    const int participants = min(times, numMaxThreads);
+    if (participants <= 1 || busy.exchange(true)) {
+        //(1) NON-PARALLEL CASE:
+        // Nothing is actually going to get done in parallel, or this executor
+        // is already in use (e.g. we're being called from inside one of its
+        // own tasks), so just execute the task directly on this thread.
+        executeSerially(task, times);
+        return;
     }
-    
+
     //(2) PARALLEL CASE:
     // We launch the maximum number of threads and save them for later use
-    if(threads.size() < (size_t)numMaxThreads)
-    {
-      threads.resize(numMaxThreads);
-      for (int i = 0; i < numMaxThreads; ++i) {
-          threadInfo.push_back(new ThreadInfo(i, this));
-          pthread_create(&threads[i], NULL, threadBody, threadInfo[i]);
-      }
+    if (threads.empty())
+        launchThreads();
+
+    // Give each participating thread an equal contiguous block of indices.
+    {   std::lock_guard<std::mutex> lock(runLock);
+        for (int i = 0; i < participants; ++i) {
+            const int begin = int((long long)times*i/participants);
+            const int end   = int((long long)times*(i+1)/participants);
+            ranges[i].range.store(pack(begin, end), std::memory_order_relaxed);
+        }
+        currentTask = &task;
+        currentParticipants = participants;
+        finishedThreadCount = 0;
+        ++generation; }
+    runCondition.notify_all();
+
+    // Wait for the participants to finish; spin briefly first.
+    for (int i = 0; i < spinCount; ++i) {
+        if (finishedThreadCount.load(std::memory_order_acquire)
+            == participants)
+            break;
+        std::this_thread::yield();
+    }
+    {   std::unique_lock<std::mutex> lock(runLock);
+        waitCondition.wait(lock, 
+            [&]{return finishedThreadCount.load() == participants;}); }
+
+    busy = false;
+}
+
+// Take the next index from the front of this thread's own range.
+bool ParallelExecutorImpl::popFront(int threadIndex, int& index) {
+    std::atomic<std::uint64_t>& mine = ranges[threadIndex].range;
+    std::uint64_t r = mine.load(std::memory_order_acquire);
+    while (beginOf(r) < endOf(r)) {
+        if (mine.compare_exchange_weak(r, pack(beginOf(r)+1, endOf(r)))) {
+            index = beginOf(r);
+            return true;
+        }
     }
+    return false;
+}
 
-  // Initialize fields to execute the new task.
-  pthread_mutex_lock(&runLock);
-  currentTask = &task;
-  currentTaskCount = times;
-  waitingThreadCount = 0;
-  for (int i = 0; i < (int) threadInfo.size(); ++i)
-      threadInfo[i]->running = true;
-
-  // Wake up the worker threads and wait until they finish.
-  pthread_cond_broadcast(&runCondition);
-  do {
-      pthread_cond_wait(&waitCondition, &runLock);
-  } while (waitingThreadCount < (int) threads.size());
-  pthread_mutex_unlock(&runLock);
+// Steal the back half of a victim's remaining range. We execute the first
+// stolen index immediately and make the rest our own range. Our own range is
+// empty at this point, so no other thread will be modifying it.
+bool ParallelExecutorImpl::stealFrom(int victim, int threadIndex, int& index) {
+    std::atomic<std::uint64_t>& theirs = ranges[victim].range;
+    std::uint64_t r = theirs.load(std::memory_order_acquire);
+    while (beginOf(r) < endOf(r)) {
+        const int begin = beginOf(r), end = endOf(r);
+        const int mid = begin + (end-begin)/2;
+        if (theirs.compare_exchange_weak(r, pack(begin, mid))) {
+            index = mid;
+            ranges[threadIndex].range.store(pack(mid+1, end),
+                                            std::memory_order_release);
+            return true;
+        }
+    }
+    return false;
 }
-void ParallelExecutorImpl::incrementWaitingThreads() {
-    pthread_mutex_lock(&runLock);
-    getCurrentTask().finish();
-    waitingThreadCount++;
-    if (waitingThreadCount == (int)threads.size()) {
-        pthread_cond_signal(&waitCondition);
+
+bool ParallelExecutorImpl::claimIndex(int threadIndex, int& index) {
+    if (popFront(threadIndex, index))
+        return true;
+    for (int k = 1; k < currentParticipants; ++k) {
+        const int victim = (threadIndex + k) % currentParticipants;
+        if (stealFrom(victim, threadIndex, index))
+            return true;
     }
-    pthread_mutex_unlock(&runLock);
+    return false;
 }
 
 ThreadLocal<bool> ParallelExecutorImpl::isWorker(false);
@@ -139,34 +283,39 @@ ThreadLocal<bool> ParallelExecutorImpl::isWorker(false);
  * This function contains the code executed by the worker threads.
  */
 
-void* threadBody(void* args) {
+void ParallelExecutorImpl::workerBody(int threadIndex, int startGeneration) {
     ParallelExecutorImpl::isWorker.upd() = true;
-    ThreadInfo& info = *reinterpret_cast<ThreadInfo*>(args);
-    ParallelExecutorImpl& executor = *info.executor;
-    int threadCount = executor.getThreadCount();
-    while (!executor.isFinished()) {
-        
-        // Wait for a Task to come in.
-        
-        pthread_mutex_lock(executor.getLock());
-        while (!info.running) {
-            pthread_cond_wait(executor.getCondition(), executor.getLock());
+    int seenGeneration = startGeneration;
+    while (true) {
+
+        // Wait for a Task to come in; spin briefly first.
+
+        for (int i = 0; i < spinCount; ++i) {
+            if (generation.load(std::memory_order_acquire) != seenGeneration)
+                break;
+            std::this_thread::yield();
         }
-        pthread_mutex_unlock(executor.getLock());
-        if (!executor.isFinished()) {
-            
-            // Execute the task for all the indices belonging to this thread.
-            
-            int count = executor.getCurrentTaskCount();
-            ParallelExecutor::Task& task = executor.getCurrentTask();
-            task.initialize();
-            int index = info.index;
-                        
+        ParallelExecutor::Task* task;
+        int participants;
+        {   std::unique_lock<std::mutex> lock(runLock);
+            runCondition.wait(lock, [&]{return finished
+                                || generation.load() != seenGeneration;});
+            if (finished)
+                return;
+            seenGeneration = generation;
+            task = currentTask;
+            participants = currentParticipants; }
+
+        if (threadIndex >= participants)
+            continue; // not needed for this task
+
+        // Execute the task for all the indices we can claim.
+
+        task->initialize();
+        int index;
+        while (claimIndex(threadIndex, index)) {
             try {
-                while (index < count) {
-                    task.execute(index);
-                    index += threadCount;
-                }
+                task->execute(index);
             }
             catch (const std::exception& ex) {
                 std::cerr <<"The parallel task threw an unhandled exception:"<< std::endl;
@@ -175,12 +324,16 @@ void* threadBody(void* args) {
             catch (...) {
                 std::cerr <<"The parallel task threw an error."<< std::endl;
             }
-            info.running = false;
-            executor.incrementWaitingThreads();
         }
+
+        // finish() calls are synchronized.
+        bool allDone;
+        {   std::lock_guard<std::mutex> lock(runLock);
+            task->finish();
+            allDone = (++finishedThreadCount == participants); }
+        if (allDone)
+            waitCondition.notify_one();
     }
-    delete &info;
-    return 0;
 }
 
 ParallelExecutor::ParallelExecutor() : HandleBase(new ParallelExecutorImpl()) {
@@ -190,25 +343,15 @@ ParallelExecutor::ParallelExecutor(int numThreads) : HandleBase(new ParallelExec
 }
 
 ParallelExecutor* ParallelExecutor::clone() const{
-    return new ParallelExecutor(getMaxThreads());
+    ParallelExecutor* copy = new ParallelExecutor(getMaxThreads());
+    copy->setThreadAffinity(getImpl().getThreadAffinity());
+    return copy;
 }
 
 void ParallelExecutor::execute(Task& task, int times) {
     updImpl().execute(task, times);
 }
 
-#ifdef __APPLE__
-   #include <sys/sysctl.h>
-   #include <dlfcn.h>
-#elif _WIN32
-   #include <windows.h>
-#elif __linux__
-   #include <dlfcn.h>
-   #include <unistd.h>
-#else
-  #error "Architecture unsupported"
-#endif
-
 int ParallelExecutor::getNumProcessors() {
 #ifdef __APPLE__
     int ncpu,retval;
@@ -253,5 +396,17 @@ bool ParallelExecutor::isWorkerThread() {
 int ParallelExecutor::getMaxThreads() const{
     return getImpl().getMaxThreads();
 }
+void ParallelExecutor::setMaxThreads(int maxThreads) {
+    updImpl().setMaxThreads(maxThreads);
+}
+void ParallelExecutor::setThreadAffinity(const Array_<int>& cpus) {
+    updImpl().setThreadAffinity(cpus);
+}
+ParallelExecutor& ParallelExecutor::getSharedExecutor() {
+    // Deliberately never deleted, so that the worker threads do not have to
+    // be joined during static destruction.
+    static ParallelExecutor* shared = new ParallelExecutor();
+    return *shared;
+}
 
 } // namespace SimTK
@@ -28,33 +28,36 @@
 #include "SimTKcommon/internal/ThreadLocal.h"
 #include "SimTKcommon/internal/Array.h"
 
-#include <pthread.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 #include <iostream>
 
 namespace SimTK {
 
-class ParallelExecutorImpl;
-
-/**
- * This class stores per-thread information used while executing a task.
- */
- 
-//TODO: Rewrite the threading class using C++11 std::thread
-
-class ThreadInfo {
-public:
-    ThreadInfo(int index, ParallelExecutorImpl* executor) : index(index), executor(executor), running(false) {
-    }
-    const int index;
-    ParallelExecutorImpl* const executor;
-    bool running;
-};
-
 /**
- * This is the internal implementation class for ParallelExecutor.
+ * This is the internal implementation class for ParallelExecutor. 
+ *
+ * Scheduling is done by range stealing. When a task is executed, each
+ * participating worker thread is given a contiguous block of the indices as
+ * its own range ("deque"). A worker takes indices from the front of its own
+ * range; when that is exhausted it steals the back half of another worker's
+ * remaining range. This keeps all threads busy when the cost of the 
+ * individual invocations is very uneven, while costing only one atomic
+ * operation per index in the balanced case.
+ *
+ * Idle workers and the thread waiting for a task to complete spin briefly
+ * before blocking on a condition variable, which cuts wake-up latency for
+ * short tasks that are executed repeatedly.
+ *
+ * If execute() is called while this executor is already busy (for example, 
+ * from inside a task it is running) the task is executed serially on the
+ * calling thread rather than deadlocking.
  */
-
 class ParallelExecutorImpl : public PIMPLImplementation<ParallelExecutor, ParallelExecutorImpl> {
 public:
     ParallelExecutorImpl();
@@ -62,40 +65,60 @@ public:
     ~ParallelExecutorImpl();
     ParallelExecutorImpl* clone() const;
     void execute(ParallelExecutor::Task& task, int times);
-    int getThreadCount() {
-        return threads.size();
-    }
-    ParallelExecutor::Task& getCurrentTask() {
-        return *currentTask;
-    }
-    int getCurrentTaskCount() {
-        return currentTaskCount;
-    }
-    bool isFinished() {
-        return finished;
-    }
-    pthread_mutex_t* getLock() {
-        return &runLock;
-    }
-    pthread_cond_t* getCondition() {
-        return &runCondition;
-    }
     int getMaxThreads() const{
       return numMaxThreads;
     }
-    void incrementWaitingThreads();
+    void setMaxThreads(int numThreads);
+    void setThreadAffinity(const Array_<int>& cpus);
+    const Array_<int>& getThreadAffinity() const {
+        return affinity;
+    }
     static ThreadLocal<bool> isWorker;
 private:
+    // The begin and end of one worker's remaining range of indices, packed
+    // into a single atomic so that the owner and thieves can update it with
+    // one compare-and-swap. Each is given a cache line of its own to avoid
+    // false sharing between workers.
+    static const int CacheLineSize = 64;
+    struct alignas(CacheLineSize) WorkRange {
+        std::atomic<std::uint64_t> range;
+    };
+    static std::uint64_t pack(int begin, int end) {
+        return (std::uint64_t(std::uint32_t(begin)) << 32) | std::uint32_t(end);
+    }
+    static int beginOf(std::uint64_t r) {return int(std::uint32_t(r >> 32));}
+    static int endOf(std::uint64_t r)   {return int(std::uint32_t(r));}
+
     void init();
+    void launchThreads();
+    void stopThreads();
+    void applyAffinity(int threadIndex);
+    void executeSerially(ParallelExecutor::Task& task, int times);
+    void workerBody(int threadIndex, int startGeneration);
+    bool claimIndex(int threadIndex, int& index);
+    bool popFront(int threadIndex, int& index);
+    bool stealFrom(int victim, int threadIndex, int& index);
+
+    int numMaxThreads;
+    int spinCount;
     bool finished;
-    pthread_mutex_t runLock;
-    pthread_cond_t runCondition, waitCondition;
-    Array_<pthread_t> threads;
-    Array_<ThreadInfo*> threadInfo;
+    std::atomic<bool> busy;
+
+    std::mutex runLock;
+    std::condition_variable runCondition, waitCondition;
+    std::vector<std::thread> threads;
+    // new[] needn't honor WorkRange's alignment, so the ranges are placed
+    // in rangeStorage by hand.
+    std::unique_ptr<char[]> rangeStorage;
+    WorkRange* ranges;
+    Array_<int> affinity;
+
+    // These describe the task currently being executed; they are written
+    // under runLock before workers are woken.
     ParallelExecutor::Task* currentTask;
-    int currentTaskCount;
-    int waitingThreadCount;
-    int numMaxThreads;
+    int currentParticipants;
+    std::atomic<int> generation;
+    std::atomic<int> finishedThreadCount;
 };
 
 } // namespace SimTK
@@ -411,6 +411,119 @@ void testMisc() {
     //cout << "after clear(), State s=" << s;
 }
 
+// Copying a State shares the discrete variable and cache entry values with
+// the source; a value is cloned only when one of the States writes it.
+void testCopyOnWrite() {
+    const SubsystemIndex Sub0(0);
+    State s;
+    s.setNumSubsystems(1);
+    const DiscreteVariableIndex dvx =
+        s.allocateDiscreteVariable(Sub0, Stage::Position, new Value<int>(5));
+    const CacheEntryIndex cx = s.allocateCacheEntry(Sub0,
+        Stage::Model, Stage::Instance, new Value<Real>(1.5));
+    advanceStage(s, Stage::Topology);
+    advanceStage(s, Stage::Model);
+    advanceStage(s, Stage::Instance);
+
+    State copy(s);
+    SimTK_TEST(&copy.getDiscreteVariable(Sub0, dvx) 
+               == &s.getDiscreteVariable(Sub0, dvx));
+    SimTK_TEST(&copy.getCacheEntry(Sub0, cx) == &s.getCacheEntry(Sub0, cx));
+
+    Value<int>::updDowncast(copy.updDiscreteVariable(Sub0, dvx)) = 7;
+    SimTK_TEST(&copy.getDiscreteVariable(Sub0, dvx) 
+               != &s.getDiscreteVariable(Sub0, dvx));
+    SimTK_TEST(Value<int>::downcast(s.getDiscreteVariable(Sub0, dvx)) == 5);
+    SimTK_TEST(Value<int>::downcast(copy.getDiscreteVariable(Sub0, dvx)) == 7);
+
+    // Writing the source detaches it too; the copy keeps the old value.
+    Value<Real>::updDowncast(s.updCacheEntry(Sub0, cx)) = 2.5;
+    SimTK_TEST(Value<Real>::downcast(s.getCacheEntry(Sub0, cx)) == 2.5);
+    SimTK_TEST(Value<Real>::downcast(copy.getCacheEntry(Sub0, cx)) == 1.5);
+
+    // Assignment shares in the same way.
+    State assigned;
+    assigned = copy;
+    SimTK_TEST(&assigned.getDiscreteVariable(Sub0, dvx)
+               == &copy.getDiscreteVariable(Sub0, dvx));
+    SimTK_TEST(Value<int>::downcast(assigned.getDiscreteVariable(Sub0, dvx))
+               == 7);
+}
+
+// A cache entry computed before its depends-on stage was invalidated must not
+// look valid in a copy of the State, even though the copy has never realized
+// that stage itself.
+void testCopyOfInvalidatedCache() {
+    const SubsystemIndex Sub0(0);
+    State s;
+    s.setNumSubsystems(1);
+    const CacheEntryIndex cx = s.allocateLazyCacheEntry(Sub0,
+        Stage::Velocity, new Value<int>(1));
+    for (Stage g = Stage::Topology; g <= Stage::Velocity; g = g.next())
+        advanceStage(s, g);
+    s.markCacheValueRealized(Sub0, cx);
+    SimTK_TEST(s.isCacheValueRealized(Sub0, cx));
+
+    s.invalidateAllCacheAtOrAbove(Stage::Velocity);
+    SimTK_TEST(!s.isCacheValueRealized(Sub0, cx));
+
+    State copy(s);
+    for (Stage g = copy.getSystemStage().next(); g <= Stage::Velocity;
+         g = g.next())
+        advanceStage(copy, g);
+    SimTK_TEST(!copy.isCacheValueRealized(Sub0, cx));
+}
+
+// Discrete variable values of supported types survive a trip through their
+// binary encoding; others say they can't be written.
+void testBinaryValues() {
+    Array_<char> bytes;
+    BinaryWriter out(bytes);
+
+    const Value<int>        i(-3);
+    const Value<Vec3>       v(Vec3(1,2,3));
+    const Value<Transform>  X(Transform(Rotation(0.5, ZAxis), Vec3(4,5,6)));
+    const Value<String>     str("snapshot");
+    const Value< std::pair<Real,bool> >     pr(std::make_pair(Real(0.25),true));
+    const Value< Array_<SpatialVec> >       arr(Array_<SpatialVec>(3, 
+                                                SpatialVec(Vec3(1), Vec3(2))));
+    Array_<String> twoNames; twoNames.push_back("one"); 
+    twoNames.push_back("two");
+    const Value< Array_<String> >           names(twoNames);
+    const Value<Vector>     vec(Vector(Vec3(7,8,9)));
+    const Value<std::string> unsupported("no");
+
+    SimTK_TEST(i.isBinarySerializable() && X.isBinarySerializable()
+               && names.isBinarySerializable() && vec.isBinarySerializable());
+    SimTK_TEST(!unsupported.isBinarySerializable());
+    SimTK_TEST_MUST_THROW(unsupported.writeBinary(out));
+
+    i.writeBinary(out); v.writeBinary(out); X.writeBinary(out);
+    str.writeBinary(out); pr.writeBinary(out); arr.writeBinary(out);
+    names.writeBinary(out); vec.writeBinary(out);
+
+    BinaryReader in(bytes.data(), bytes.size());
+    Value<int> i2; Value<Vec3> v2; Value<Transform> X2; Value<String> str2;
+    Value< std::pair<Real,bool> > pr2; Value< Array_<SpatialVec> > arr2;
+    Value< Array_<String> > names2; Value<Vector> vec2;
+    i2.readBinary(in); v2.readBinary(in); X2.readBinary(in);
+    str2.readBinary(in); pr2.readBinary(in); arr2.readBinary(in);
+    names2.readBinary(in); vec2.readBinary(in);
+    SimTK_TEST(in.remaining() == 0);
+
+    SimTK_TEST(i2.get() == -3);
+    SimTK_TEST(v2.get() == v.get());
+    SimTK_TEST(X2.get().toMat44() == X.get().toMat44());
+    SimTK_TEST(str2.get() == "snapshot");
+    SimTK_TEST(pr2.get() == pr.get());
+    SimTK_TEST(arr2.get() == arr.get());
+    SimTK_TEST(names2.get() == names.get());
+    SimTK_TEST(vec2.get().size() == 3 && vec2.get()[2] == 9);
+
+    // Reading past the end is caught.
+    SimTK_TEST_MUST_THROW(i2.readBinary(in));
+}
+
 // Helper functions for testConsistent().
 // Allocate some part of the state, and alter the stage accordingly.
 // For Q, U, Z.
@@ -536,6 +649,9 @@ int main() {
         //SimTK_SUBTEST(testLowestModified);
         SimTK_SUBTEST(testCacheValidity);
         SimTK_SUBTEST(testMisc);
+        SimTK_SUBTEST(testCopyOnWrite);
+        SimTK_SUBTEST(testCopyOfInvalidatedCache);
+        SimTK_SUBTEST(testBinaryValues);
         SimTK_SUBTEST(testConsistent);
     SimTK_END_TEST();
 }
@@ -33,6 +33,7 @@ SimTK::ReinitOnCopy. */
 #include <utility>
 #include <memory>
 #include <vector>
+#include <thread>
 
 using namespace SimTK;
 using std::cout; using std::endl; using std::string; using std::unique_ptr;
@@ -342,6 +343,38 @@ void testAllocate() {
 
 }
 
+// A clonable object that doesn't update Base's statistics, so that it can be
+// copied on several threads at once.
+class Counter {
+public:
+    explicit Counter(int v) : m_value(v) {}
+    Counter* clone() const {return new Counter(*this);}
+    int m_value;
+};
+
+// Containers sharing an object may be detached and written on different
+// threads. Each must end up with its own copy, and the one that is left as 
+// the only owner writes on the original.
+void testConcurrentDetach() {
+    const int nThreads = 4;
+    for (int rep=0; rep < 100; ++rep) {
+        CloneOnWritePtr<Counter> original(new Counter(0));
+        std::vector<CloneOnWritePtr<Counter>> copies(nThreads, original);
+        original.reset();
+        SimTK_TEST(copies[0].use_count() == nThreads);
+
+        std::vector<std::thread> threads;
+        for (int i=0; i < nThreads; ++i)
+            threads.emplace_back([&copies, i]() {copies[i].upd()->m_value=i+1;});
+        for (auto& t : threads) t.join();
+
+        for (int i=0; i < nThreads; ++i) {
+            SimTK_TEST(copies[i].unique());
+            SimTK_TEST(copies[i].getRef().m_value == i+1);
+        }
+    }
+}
+
 // Call this at the end after all the destructors should have been
 // called for anything allocated in the other tests. The Base class
 // has been counting them.
@@ -636,6 +669,7 @@ int main() {
     SimTK_START_TEST("TestCloneOnWritePtr");
         SimTK_SUBTEST(testEmpty);
         SimTK_SUBTEST(testAllocate);
+        SimTK_SUBTEST(testConcurrentDetach);
         SimTK_SUBTEST(testForLeaks);
 
         SimTK_SUBTEST(testResetOnCopy);
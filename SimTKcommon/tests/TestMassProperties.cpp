@@ -367,6 +367,12 @@ void testArticulatedInertia() {
     SimTK_TEST_EQ(abi.toSpatialMat(), mabiShiftedManually);
 
     SimTK_TEST_EQ(abi.shiftInPlace(-negShiftVec).toSpatialMat(), mabi);
+
+    // Accumulating a shifted ABI must match adding the shifted temporary.
+    ArticulatedInertia accum(mass, Mat33(0), SymMat33(1));
+    const ArticulatedInertia expected = accum + abi.shift(negShiftVec);
+    accum.addShifted(abi, negShiftVec);
+    SimTK_TEST_EQ(accum.toSpatialMat(), expected.toSpatialMat());
 }
 
 void testManualABIShift(const ArticulatedInertia& abi, const Array_<Vec3>& shifts, Real& out) {
@@ -23,6 +23,7 @@
 
 #include "SimTKcommon.h"
 
+#include <atomic>
 #include <iostream>
 
 #define ASSERT(cond) {SimTK_ASSERT_ALWAYS(cond, "Assertion failed");}
@@ -98,11 +99,108 @@ void testResizeThreads() {
         SimTK_TEST(executor.getMaxThreads() == x);
     }
 }
+// Indices near the front are much more expensive than those at the back, so
+// most of the work has to be stolen from the first thread's range.
+class UnevenTask : public ParallelExecutor::Task {
+public:
+    UnevenTask(Array_<int>& flags, std::atomic<int>& count)
+    :   flags(flags), count(count) {}
+    void execute(int index) override {
+        volatile double sum = 0;
+        const int n = index < 10 ? 20000 : 10;
+        for (int i = 0; i < n; ++i)
+            sum += std::sqrt(double(i));
+        flags[index]++;
+        ++count;
+    }
+private:
+    Array_<int>& flags;
+    std::atomic<int>& count;
+};
+
+void testUnevenWork() {
+    const int numFlags = 1000;
+    Array_<int> flags(numFlags);
+    ParallelExecutor executor(4);
+    for (int i = 0; i < 20; ++i) {
+        std::atomic<int> count(0);
+        UnevenTask task(flags, count);
+        for (int j = 0; j < numFlags; ++j)
+            flags[j] = 0;
+        executor.execute(task, numFlags);
+        ASSERT(count == numFlags);
+        for (int j = 0; j < numFlags; ++j)
+            ASSERT(flags[j] == 1);
+    }
+}
+
+// A task that reuses its own executor must not deadlock; the inner call
+// runs serially on the calling worker thread.
+class NestedTask : public ParallelExecutor::Task {
+public:
+    NestedTask(ParallelExecutor& executor, std::atomic<int>& count)
+    :   executor(executor), count(count) {}
+    void execute(int index) override {
+        Array_<int> flags(10, 0);
+        std::atomic<int> innerCount(0);
+        UnevenTask inner(flags, innerCount);
+        executor.execute(inner, 10);
+        ASSERT(innerCount == 10);
+        count += innerCount;
+    }
+private:
+    ParallelExecutor& executor;
+    std::atomic<int>& count;
+};
+
+void testNestedExecution() {
+    ParallelExecutor executor(3);
+    std::atomic<int> count(0);
+    NestedTask task(executor, count);
+    executor.execute(task, 12);
+    ASSERT(count == 120);
+}
+
+void testSharedExecutor() {
+    ParallelExecutor& shared = ParallelExecutor::getSharedExecutor();
+    SimTK_TEST(&shared == &ParallelExecutor::getSharedExecutor());
+    SimTK_TEST(shared.getMaxThreads() == 
+               std::max(ParallelExecutor::getNumProcessors(), 1));
+
+    const int numFlags = 100;
+    Array_<int> flags(numFlags);
+    std::atomic<int> count(0);
+    UnevenTask task(flags, count);
+    for (int threads : {3, 1, 2}) {
+        shared.setMaxThreads(threads);
+        SimTK_TEST(shared.getMaxThreads() == threads);
+        shared.setThreadAffinity(Array_<int>(1, 0));
+        count = 0;
+        for (int j = 0; j < numFlags; ++j)
+            flags[j] = 0;
+        shared.execute(task, numFlags);
+        ASSERT(count == numFlags);
+        for (int j = 0; j < numFlags; ++j)
+            ASSERT(flags[j] == 1);
+    }
+    shared.setThreadAffinity(Array_<int>());
+    shared.setMaxThreads(std::max(ParallelExecutor::getNumProcessors(), 1));
+    SimTK_TEST_MUST_THROW(shared.setMaxThreads(0));
+    SimTK_TEST_MUST_THROW(shared.setThreadAffinity(Array_<int>(1, -1)));
+#if defined(__linux__) || defined(_WIN32)
+    // Beyond what the platform's affinity masks can address.
+    SimTK_TEST_MUST_THROW(shared.setThreadAffinity(Array_<int>(1, 1<<30)));
+#endif
+}
+
 int main() {
     SimTK_START_TEST("TestParallelExecutor");
         SimTK_SUBTEST(testParallelExecution);
         SimTK_SUBTEST(testSingleThreadedExecution);
         SimTK_SUBTEST(testResizeThreads);
+        SimTK_SUBTEST(testUnevenWork);
+        SimTK_SUBTEST(testNestedExecution);
+        SimTK_SUBTEST(testSharedExecutor);
     SimTK_END_TEST();
     return 0;
 }
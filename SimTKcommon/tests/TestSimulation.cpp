@@ -32,6 +32,7 @@
 #include "SimTKcommon/internal/SystemGuts.h"
 
 #include <iostream>
+#include <sstream>
 using std::cout;
 using std::endl;
 
@@ -860,9 +861,107 @@ void testOne() {
     }
 }
 
+// Profiling records each realization of each Subsystem, counts the requests
+// for stages that were already realized, and writes a Chrome trace.
+void testRealizationProfiling() {
+    TestSystem sys;
+    TestSubsystem subsys(sys);
+    ASSERT(!sys.isRealizationProfilingEnabled());
+    sys.setRealizationProfilingEnabled(true);
+    ASSERT(sys.isRealizationProfilingEnabled());
+
+    // This realizes Topology and Model.
+    State state = sys.realizeTopology();
+    sys.realize(state, Stage::Acceleration);
+    sys.realize(state, Stage::Position);
+    sys.realize(state, Stage::Acceleration);
+
+    for (SubsystemIndex sx(0); sx < sys.getNumSubsystems(); ++sx) {
+        for (int g = Stage::Topology; g <= Stage::Acceleration; ++g) {
+            ASSERT(sys.getNumSubsystemRealizations(sx, Stage(g)) == 1);
+            ASSERT(sys.getSubsystemRealizationTime(sx, Stage(g)) >= 0);
+            ASSERT(sys.getSubsystemRealizationCPUTime(sx, Stage(g)) >= 0);
+        }
+        ASSERT(sys.getNumSubsystemRealizations(sx, Stage::Report) == 0);
+    }
+    ASSERT(sys.getNumRealizationCacheHits(Stage::Instance) == 2);
+    ASSERT(sys.getNumRealizationCacheHits(Stage::Position) == 2);
+    ASSERT(sys.getNumRealizationCacheHits(Stage::Velocity) == 1);
+    ASSERT(sys.getNumRealizationCacheHits(Stage::Acceleration) == 1);
+    ASSERT(sys.getNumRealizationCacheHits(Stage::Report) == 0);
+
+    // One event for each Subsystem realization from Topology through 
+    // Acceleration, and one for each System realization from Model through
+    // Acceleration.
+    std::ostringstream trace;
+    sys.writeRealizationTrace(trace);
+    const std::string json = trace.str();
+    ASSERT(json.compare(0, 15, "{\"traceEvents\":") == 0);
+    int nEvents = 0;
+    for (size_t pos = json.find("\"ph\":\"X\""); pos != std::string::npos;
+         pos = json.find("\"ph\":\"X\"", pos+1))
+        ++nEvents;
+    ASSERT(nEvents == 8*sys.getNumSubsystems() + 7);
+    ASSERT(json.find(" Acceleration\"") != std::string::npos);
+
+    // Nothing more is recorded once profiling is off.
+    sys.setRealizationProfilingEnabled(false);
+    state.invalidateAllCacheAtOrAbove(Stage::Position);
+    sys.realize(state, Stage::Acceleration);
+    ASSERT(sys.getNumSubsystemRealizations(SubsystemIndex(1), 
+                                           Stage::Position) == 1);
+
+    sys.resetAllCountersToZero();
+    ASSERT(sys.getNumSubsystemRealizations(SubsystemIndex(1), 
+                                           Stage::Position) == 0);
+    ASSERT(sys.getNumRealizationCacheHits(Stage::Instance) == 0);
+    std::ostringstream empty;
+    sys.writeRealizationTrace(empty);
+    ASSERT(empty.str().find("\"ph\"") == std::string::npos);
+}
+
+// Count the events in a realization trace.
+int countTraceEvents(const System& sys) {
+    std::ostringstream trace;
+    sys.writeRealizationTrace(trace);
+    const std::string json = trace.str();
+    int nEvents = 0;
+    for (size_t pos = json.find("\"ph\":\"X\""); pos != std::string::npos;
+         pos = json.find("\"ph\":\"X\"", pos+1))
+        ++nEvents;
+    return nEvents;
+}
+
+// The trace stops growing at its limit, and can be discarded without losing
+// the rest of the profile.
+void testRealizationTraceLimit() {
+    TestSystem sys;
+    TestSubsystem subsys(sys);
+    sys.setRealizationProfilingEnabled(true);
+    sys.setRealizationTraceLimit(5);
+    ASSERT(sys.getRealizationTraceLimit() == 5);
+
+    State state = sys.realizeTopology();
+    sys.realize(state, Stage::Acceleration);
+    ASSERT(countTraceEvents(sys) == 5);
+    ASSERT(sys.getNumSubsystemRealizations(SubsystemIndex(1),
+                                           Stage::Acceleration) == 1);
+
+    sys.clearRealizationTrace();
+    ASSERT(countTraceEvents(sys) == 0);
+    ASSERT(sys.getNumSubsystemRealizations(SubsystemIndex(1),
+                                           Stage::Acceleration) == 1);
+
+    state.invalidateAllCacheAtOrAbove(Stage::Acceleration);
+    sys.realize(state, Stage::Acceleration);
+    ASSERT(countTraceEvents(sys) == sys.getNumSubsystems() + 1);
+}
+
 int main() {
     try {
         testOne();
+        testRealizationProfiling();
+        testRealizationTraceLimit();
     } catch(const std::exception& e) {
         cout << "exception: " << e.what() << endl;
         return 1;
@@ -45,6 +45,39 @@ void testInverse() {
     SimTK_TEST_EQ_SIZE((-mat)*(-mat).invert(), identity, N);
 }
 
+// Factor and solve a batch of random SPD systems together, and make sure
+// an indefinite one is flagged without disturbing the rest.
+template <int N>
+void testSymMatBatch() {
+    const int nmat = 37; // deliberately not a multiple of a SIMD width
+    SymMatBatch<N> batch(nmat);
+    VecBatch<N> bx(nmat);
+    Array_< SymMat<N> > A(nmat);
+    Array_< Vec<N> >    b(nmat);
+    for (int k=0; k < nmat; ++k) {
+        const Mat<N,N> R = Test::randMat<N,N>();
+        A[k] = SymMat<N>(R*~R) + SymMat<N>(N); // well conditioned
+        b[k] = Test::randVec<N>();
+        batch.setMat(k, A[k]);
+        bx.setVec(k, b[k]);
+    }
+    const int bad = nmat/2;
+    batch.setMat(bad, -A[bad]);
+
+    SimTK_TEST(batch.factorCholeskyInPlace() == 1);
+    SimTK_TEST(batch.isFactorFailed(bad));
+    batch.solveInPlace(bx);
+    for (int k=0; k < nmat; ++k) {
+        if (k == bad) {SimTK_TEST(bx.getVec(k).isFinite()); continue;}
+        SimTK_TEST(!batch.isFactorFailed(k));
+        SimTK_TEST_EQ_SIZE(A[k]*bx.getVec(k), b[k], N);
+        // Solving just this slot must give the same answer.
+        Vec<N> x = b[k];
+        batch.solveInPlace(k, x);
+        SimTK_TEST_EQ_SIZE(x, bx.getVec(k), N);
+    }
+}
+
 void testDotProducts() {
     Vec3 v1(1, 2, 3);
     Vec3 v2(-1, -2, -3);
@@ -485,6 +518,35 @@ void testAppendRowCol() {
 
 }
 
+// Mat33*Vec3 and Mat33*Mat33 may be replaced by hand-vectorized kernels
+// (SimTK_USE_SIMD); check them against the element-by-element definition.
+void testMat33Products() {
+    const Mat33 a( 0.1, -2.3,  4.7,
+                   1e-3, 5.5, -0.3,
+                  -7.1,  0.2,  3.3);
+    const Mat33 b(-1.9,  0.4,  2.2,
+                   6.1, -0.7,  1e4,
+                   0.05, 8.8, -3.6);
+    const Vec3 v(0.3, -1.7, 2.9);
+
+    Vec3 av;
+    for (int i=0; i<3; ++i)
+        av[i] = a(i,0)*v[0] + a(i,1)*v[1] + a(i,2)*v[2];
+    SimTK_TEST_EQ(a*v, av);
+
+    Mat33 ab;
+    for (int i=0; i<3; ++i) for (int j=0; j<3; ++j)
+        ab(i,j) = a(i,0)*b(0,j) + a(i,1)*b(1,j) + a(i,2)*b(2,j);
+    SimTK_TEST_EQ(a*b, ab);
+
+    Mat33 c(a); c *= b;
+    SimTK_TEST_EQ(c, ab);
+
+    const Rotation R1(0.4, UnitVec3(1,2,3)), R2(-1.1, UnitVec3(-2,0,1));
+    Rotation R12(R1); R12 *= R2;
+    SimTK_TEST_EQ(R12.asMat33(), R1.asMat33()*R2.asMat33());
+}
+
 int main() {
     SimTK_START_TEST("TestSmallMatrix");
         SimTK_SUBTEST(testSymMat);
@@ -493,8 +555,11 @@ int main() {
         SimTK_SUBTEST(testInverse<3>);
         SimTK_SUBTEST(testInverse<5>);
         SimTK_SUBTEST(testInverse<10>);
+        SimTK_SUBTEST(testSymMatBatch<3>);
+        SimTK_SUBTEST(testSymMatBatch<6>);
         SimTK_SUBTEST(testDotProducts);
         SimTK_SUBTEST(testCrossProducts);
+        SimTK_SUBTEST(testMat33Products);
         SimTK_SUBTEST(testNumericallyEqual);
         SimTK_SUBTEST(testUnitVec);
         SimTK_SUBTEST(testAppendRowCol);
@@ -0,0 +1,154 @@
+#ifndef SimTK_SIMMATH_SPATIAL_INDEX_H_
+#define SimTK_SIMMATH_SPATIAL_INDEX_H_
+
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon.h"
+#include "simmath/internal/common.h"
+#include "simmath/internal/OrientedBoundingBox.h"
+
+#include <utility>
+
+namespace SimTK {
+
+/**
+ * This class finds which of a set of bounding volumes overlap one another. It
+ * is the broad phase of collision detection shared by the contact subsystems:
+ * each object is given a bound, which may be a sphere, an axis-aligned box,
+ * or an OrientedBoundingBox, and findOverlappingPairs() reports every pair of
+ * objects whose bounds intersect, so that only those need to be examined by
+ * the more expensive narrow phase.
+ *
+ * The bounds are typically updated each time the objects move. The
+ * SweepAndPrune algorithm remembers the order it sorted the objects into last
+ * time, so when the objects have moved only a little the work is close to
+ * linear in the number of objects. Keep the same SpatialIndex from one call
+ * to the next to get that benefit; a new or copied index gives the same
+ * answers, just a little more slowly the first time.
+ */
+class SimTK_SIMMATH_EXPORT SpatialIndex {
+public:
+    /**
+     * The algorithm used to find the overlapping pairs. Whichever is used,
+     * the same set of pairs is found.
+     */
+    enum Algorithm {
+        /** Sort the bounds along one axis and sweep along it, comparing only
+        objects whose extents overlap along that axis. This is the default. */
+        SweepAndPrune = 0,
+        /** Compare every pair of bounds; this is O(n^2) but has no overhead,
+        and is useful for a handful of objects or for checking the others. */
+        BruteForce    = 1
+    };
+
+    /**
+     * Create an empty index using the SweepAndPrune algorithm.
+     */
+    SpatialIndex();
+    /**
+     * Select the algorithm to be used by findOverlappingPairs().
+     */
+    SpatialIndex& setAlgorithm(Algorithm algorithm);
+    /**
+     * Get the algorithm used by findOverlappingPairs().
+     */
+    Algorithm getAlgorithm() const {return algorithm;}
+    /**
+     * Set the number of objects in the index. Objects that are added are
+     * given an empty bound, a sphere of radius zero at the origin, until you
+     * set them. Changing the number of objects discards the sort order
+     * remembered from previous calls.
+     */
+    void resize(int numObjects);
+    /**
+     * Get the number of objects in the index.
+     */
+    int getNumObjects() const {return (int)bounds.size();}
+    /**
+     * Bound an object by a sphere.
+     *
+     * @param object    the object index, 0 <= object < getNumObjects()
+     * @param center    the center of the sphere
+     * @param radius    the radius of the sphere; must not be negative
+     */
+    void setSphere(int object, const Vec3& center, Real radius);
+    /**
+     * Bound an object by a box whose faces are perpendicular to the axes.
+     *
+     * @param object    the object index, 0 <= object < getNumObjects()
+     * @param low       the corner of the box with the smallest coordinates
+     * @param high      the corner of the box with the largest coordinates
+     */
+    void setAABB(int object, const Vec3& low, const Vec3& high);
+    /**
+     * Bound an object by a box with arbitrary position and orientation.
+     *
+     * @param object    the object index, 0 <= object < getNumObjects()
+     * @param box       the bounding box
+     */
+    void setOBB(int object, const OrientedBoundingBox& box);
+    /**
+     * Find every pair of objects whose bounds intersect; bounds that just
+     * touch count as intersecting. The pairs are appended to \p pairs in no
+     * particular order, each pair just once, and never pairing an object
+     * with itself. The order of the two objects within a pair is also
+     * unspecified. This is not const because the index remembers what it
+     * learns about the current positions to speed up the next call.
+     */
+    void findOverlappingPairs(Array_< std::pair<int,int> >& pairs);
+    /**
+     * Determine whether the bounds of two objects intersect.
+     */
+    bool boundsIntersect(int object1, int object2) const;
+
+private:
+    enum BoundType {SphereBound, AABBBound, OBBBound};
+    struct Bound {
+        BoundType           type;
+        Vec3                low, high;  // axis-aligned box enclosing bound
+        Vec3                center;     // sphere only
+        Real                radius;     // sphere only
+        OrientedBoundingBox obb;        // OBB only
+    };
+    struct Extent {
+        Extent() {}
+        Extent(Real start, Real end, int object)
+        :   start(start), end(end), object(object) {}
+        bool operator<(const Extent& e) const {return start < e.start;}
+        Real start, end;    // span along the sweep axis
+        int  object;
+    };
+
+    int chooseSweepAxis() const;
+    void sortExtents(int axis);
+
+    Algorithm               algorithm;
+    Array_<Bound,int>       bounds;
+    int                     axis;       // sweep axis of extents; -1 if none
+    Array_<Extent,int>      extents;    // sorted by start along axis
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SIMMATH_SPATIAL_INDEX_H_
@@ -0,0 +1,208 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon.h"
+#include "simmath/internal/common.h"
+#include "simmath/internal/SpatialIndex.h"
+
+#include <algorithm>
+
+namespace SimTK {
+
+SpatialIndex::SpatialIndex() : algorithm(SweepAndPrune), axis(-1) {
+}
+
+SpatialIndex& SpatialIndex::setAlgorithm(Algorithm algorithm) {
+    this->algorithm = algorithm;
+    return *this;
+}
+
+void SpatialIndex::resize(int numObjects) {
+    SimTK_APIARGCHECK1_ALWAYS(numObjects >= 0, "SpatialIndex", "resize",
+        "Illegal number of objects %d.", numObjects);
+    const int oldSize = bounds.size();
+    bounds.resize(numObjects);
+    for (int i=oldSize; i < numObjects; ++i)
+        setSphere(i, Vec3(0), 0);
+    if (numObjects != oldSize)
+        axis = -1; // no usable order
+}
+
+void SpatialIndex::setSphere(int object, const Vec3& center, Real radius) {
+    SimTK_INDEXCHECK(object, getNumObjects(), "SpatialIndex::setSphere()");
+    Bound& bound = bounds[object];
+    bound.type = SphereBound;
+    bound.center = center;
+    bound.radius = radius;
+    bound.low = center - radius;
+    bound.high = center + radius;
+}
+
+void SpatialIndex::setAABB(int object, const Vec3& low, const Vec3& high) {
+    SimTK_INDEXCHECK(object, getNumObjects(), "SpatialIndex::setAABB()");
+    Bound& bound = bounds[object];
+    bound.type = AABBBound;
+    bound.low = low;
+    bound.high = high;
+}
+
+void SpatialIndex::setOBB(int object, const OrientedBoundingBox& box) {
+    SimTK_INDEXCHECK(object, getNumObjects(), "SpatialIndex::setOBB()");
+    Bound& bound = bounds[object];
+    bound.type = OBBBound;
+    bound.obb = box;
+    Vec3 corners[8];
+    box.getCorners(corners);
+    bound.low = bound.high = corners[0];
+    for (int i=1; i < 8; ++i)
+        for (int j=0; j < 3; ++j) {
+            bound.low[j]  = std::min(bound.low[j],  corners[i][j]);
+            bound.high[j] = std::max(bound.high[j], corners[i][j]);
+        }
+}
+
+// Every bound is first checked against the other's enclosing axis-aligned
+// box, which is exact for pairs of AABBs. Otherwise we go on to the test for
+// the particular pair of bound types, treating an AABB as an OBB if the other
+// one is.
+bool SpatialIndex::boundsIntersect(int object1, int object2) const {
+    const Bound* b1 = &bounds[object1];
+    const Bound* b2 = &bounds[object2];
+    for (int i=0; i < 3; ++i)
+        if (b1->low[i] > b2->high[i] || b2->low[i] > b1->high[i])
+            return false;
+    if (b1->type > b2->type)
+        std::swap(b1, b2); // now SphereBound < AABBBound < OBBBound
+    switch (b1->type) {
+    case SphereBound: {
+        Vec3 nearest;
+        switch (b2->type) {
+        case SphereBound:
+            return (b1->center-b2->center).normSqr()
+                    <= square(b1->radius+b2->radius);
+        case AABBBound:
+            for (int i=0; i < 3; ++i)
+                nearest[i] = clamp(b2->low[i], b1->center[i], b2->high[i]);
+            break;
+        case OBBBound:
+            nearest = b2->obb.findNearestPoint(b1->center);
+            break;
+        }
+        return (nearest-b1->center).normSqr() <= square(b1->radius);
+    }
+    case AABBBound:
+        if (b2->type == AABBBound)
+            return true;
+        return b2->obb.intersectsBox
+           (OrientedBoundingBox(Transform(b1->low), b1->high-b1->low));
+    case OBBBound:
+        return b1->obb.intersectsBox(b2->obb);
+    }
+    return true;
+}
+
+// Pick the axis along which the bounds are most spread out, since that is
+// where a sweep rejects the most pairs. We stick with the axis used last time
+// unless another is much better, though, because changing axes means sorting
+// from scratch.
+int SpatialIndex::chooseSweepAxis() const {
+    const int n = bounds.size();
+    Vec3 average(0);
+    for (const Bound& bound : bounds)
+        average += bound.low + bound.high;
+    if (n) average /= 2*n;
+    Vec3 var(0);
+    for (const Bound& bound : bounds)
+        var += abs((bound.low + bound.high)/2 - average);
+    int best = (var[0] > var[1] ? 0 : 1);
+    if (var[2] > var[best])
+        best = 2;
+    if (axis >= 0 && var[best] < 2*var[axis])
+        best = axis;
+    return best;
+}
+
+// Bring the extents up to date for the current bounds. If they were sorted
+// along the same axis last time, during a simulation the objects will have
+// moved only a little since then, so the old order is nearly right and an
+// insertion sort fixes it in O(n) plus the number of objects that passed one
+// another. If that turns out to be large, the positions must have changed a
+// lot (say, a State was set to a new configuration rather than advanced a
+// step), and we finish with std::sort instead.
+void SpatialIndex::sortExtents(int newAxis) {
+    const int n = bounds.size();
+    if (newAxis != axis || extents.size() != n) {
+        extents.resize(n);
+        for (int i=0; i < n; ++i)
+            extents[i] = Extent(bounds[i].low[newAxis],
+                                bounds[i].high[newAxis], i);
+        std::sort(extents.begin(), extents.end()); // O(n log n)
+        axis = newAxis;
+        return;
+    }
+
+    for (Extent& extent : extents) {
+        extent.start = bounds[extent.object].low[axis];
+        extent.end   = bounds[extent.object].high[axis];
+    }
+    long long movesLeft = 4*(long long)n + 64;
+    for (int i=1; i < n; ++i) {
+        const Extent extent = extents[i];
+        int j = i;
+        for (; j > 0 && extent < extents[j-1]; --j)
+            extents[j] = extents[j-1];
+        extents[j] = extent;
+        if ((movesLeft -= i-j) < 0) {
+            std::sort(extents.begin(), extents.end());
+            return;
+        }
+    }
+}
+
+void SpatialIndex::findOverlappingPairs(Array_< std::pair<int,int> >& pairs) {
+    const int n = bounds.size();
+    if (algorithm == BruteForce) {
+        for (int i=0; i < n; ++i)
+            for (int j=i+1; j < n; ++j)
+                if (boundsIntersect(i, j))
+                    pairs.push_back(std::make_pair(i, j));
+        return;
+    }
+
+    // Sweep along the axis; each object need only be compared with those
+    // that start before it ends.
+    sortExtents(chooseSweepAxis());
+    for (int ex1=0; ex1 < n; ++ex1) {
+        const Extent& extent1 = extents[ex1];
+        for (int ex2=ex1+1; ex2 < n; ++ex2) {
+            const Extent& extent2 = extents[ex2];
+            if (extent2.start > extent1.end)
+                break; // no more objects can overlap with extent1
+            if (boundsIntersect(extent1.object, extent2.object))
+                pairs.push_back(std::make_pair(extent1.object,
+                                               extent2.object));
+        }
+    }
+}
+
+} // namespace SimTK
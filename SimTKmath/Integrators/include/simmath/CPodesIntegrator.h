@@ -73,6 +73,70 @@ public:
      * again with a larger value will fail.
      */
     void setOrderLimit(int order);
+
+    /**
+     * The linear solvers that CPODES can use for the Newton iterations of an implicit method. The dense solver
+     * (the default) forms the full ny x ny iteration matrix from a finite difference Jacobian, which takes ny
+     * derivative evaluations, O(ny^2) memory, and O(ny^3) time to factor. The band solver needs only
+     * upper+lower+1 derivative evaluations and O(ny*(upper+lower)) memory, so it is much cheaper when each state
+     * variable's derivative depends only on nearby state variables, as is true of many independent z's such as
+     * muscle activations. The Krylov solver (GMRES) never forms the matrix at all; each iteration needs one
+     * Jacobian-vector product, by default a single extra derivative evaluation. The linear solver is irrelevant
+     * with functional iteration.
+     */
+    enum LinearSolverType {
+        DenseLinearSolver,
+        BandLinearSolver,
+        KrylovLinearSolver
+    };
+
+    /**
+     * This class supplies Jacobian-vector products for the Krylov linear solver, replacing the difference
+     * quotient CPODES would otherwise use. Derive a concrete class from it and pass it to
+     * setJacobianTimesVector().
+     */
+    class JacobianTimesVector {
+    public:
+        virtual ~JacobianTimesVector() {}
+        /**
+         * Calculate Jv = J*v, where J = d ydot / d y is the Jacobian of the state derivatives with respect to
+         * the continuous state variables. \a state has been realized through Acceleration stage, so its YDot
+         * is available, and both v and Jv have \a state's NY elements. Throw an exception if the product cannot
+         * be calculated.
+         */
+        virtual void multiply(const State& state, const Vector& v, Vector& Jv) const = 0;
+    };
+
+    /**
+     * Use the default dense linear solver; see LinearSolverType. This method must be invoked before the
+     * integrator is initialized.
+     */
+    void setUseDenseLinearSolver();
+    /**
+     * Use a band linear solver, treating the iteration matrix as having the given numbers of nonzero diagonals
+     * above and below the main diagonal; see LinearSolverType. The bandwidths are reduced if necessary to fit
+     * the number of state variables. This method must be invoked before the integrator is initialized.
+     */
+    void setUseBandLinearSolver(int upperBandwidth, int lowerBandwidth);
+    /**
+     * Use the matrix-free Krylov (GMRES) linear solver, without preconditioning; see LinearSolverType.
+     * \a maxKrylovDimension limits the size of the Krylov subspace; zero selects the CPODES default of 5.
+     * This method must be invoked before the integrator is initialized.
+     */
+    void setUseKrylovLinearSolver(int maxKrylovDimension=0);
+    /// Get the linear solver that has been selected.
+    LinearSolverType getLinearSolverType() const;
+    /**
+     * Supply Jacobian-vector products to the Krylov linear solver, or pass null to go back to difference
+     * quotients. The object is not copied and must outlive the integrator. This method must be invoked before
+     * the integrator is initialized.
+     */
+    void setJacobianTimesVector(const JacobianTimesVector* jacobianTimesVector);
+    /**
+     * Get the total number of linear iterations taken by the Krylov linear solver since the last call to
+     * resetAllStatistics(). This is zero for the other linear solvers.
+     */
+    int getNumLinearSolverIterations() const;
 };
 
 } // namespace SimTK
@@ -0,0 +1,137 @@
+#ifndef SimTK_SIMMATH_ENSEMBLE_INTEGRATOR_H_
+#define SimTK_SIMMATH_ENSEMBLE_INTEGRATOR_H_
+
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include "SimTKcommon.h"
+#include "simmath/internal/common.h"
+#include "simmath/Integrator.h"
+
+namespace SimTK {
+
+class EnsembleIntegratorRep;
+
+/**
+ * This class advances many States of the same System together, for example
+ * the perturbed copies of a model used for uncertainty quantification or
+ * Monte-Carlo studies. For example:
+ *
+ * <pre>
+ * EnsembleIntegrator ensemble(system);
+ * ensemble.setAccuracy(1e-4);
+ * ensemble.initialize(initialStates);
+ * for (Real t = tReport; t <= tFinal; t += tReport) {
+ *     ensemble.stepTo(t);
+ *     ensemble.getContinuousStates(y); // one row per member
+ *     ...
+ * }
+ * </pre>
+ *
+ * Each member of the ensemble is advanced with its own Integrator and its own
+ * step sizes, including the handling of events, exactly as a TimeStepper
+ * would do it; stepTo() returns when every member has reached the requested
+ * time (or terminated). The members are distributed over up to
+ * getNumThreads() threads; each member is always advanced on one thread.
+ *
+ * The Integrators (of the type given by setIntegratorType(),
+ * RungeKuttaMersonIntegrator by default) are created once and reused when
+ * initialize() is called again with the same number of members, so repeated
+ * runs don't pay the cost of constructing and sizing them again. Any event
+ * handlers, reporters or user-written force elements in the System must be
+ * safe to invoke concurrently for different States. If advancing any member
+ * throws an exception, the first such exception is rethrown by stepTo()
+ * after the remaining members have been advanced.
+ */
+class SimTK_SIMMATH_EXPORT EnsembleIntegrator {
+public:
+    /// Create an EnsembleIntegrator for the given System. It has no members
+    /// until initialize() is called.
+    explicit EnsembleIntegrator(const System& system);
+    ~EnsembleIntegrator();
+
+    /// Choose the kind of Integrator used to advance each member;
+    /// IntegratorType must be an Integrator with a constructor taking just
+    /// the System. This takes effect at the next initialize().
+    template <class IntegratorType>
+    void setIntegratorType()
+    {   setIntegratorCreator(&createIntegrator<IntegratorType>); }
+
+    /// Set the accuracy used by all the members' Integrators. This takes
+    /// effect at the next initialize(). The default is 1e-3.
+    void setAccuracy(Real accuracy);
+    /// Get the accuracy to be used by the members' Integrators.
+    Real getAccuracy() const;
+
+    /// Set the maximum number of threads to use; 0 (the default) means use
+    /// those of ParallelExecutor::getSharedExecutor() and 1 means advance the
+    /// members one after another on the calling thread.
+    void setNumThreads(int numThreads);
+    /// Get the number of threads set with setNumThreads().
+    int getNumThreads() const;
+
+    /// Start a new run with one member for each of the given States, which
+    /// are copied. Each member's Integrator is initialized with its State
+    /// and the current accuracy.
+    void initialize(const Array_<State>& initStates);
+
+    /// Advance every member to the given time, or until it is terminated by
+    /// an event handler or by reaching its Integrator's final time.
+    void stepTo(Real time);
+
+    /// Get the number of members in the current run.
+    int getNumMembers() const;
+    /// Get the current State of one member.
+    const State& getState(int member) const;
+    /// Return true if the given member has terminated and won't be advanced
+    /// any further.
+    bool isTerminated(int member) const;
+    /// Get the Integrator used for one member, to change its options after
+    /// initialize() or to look at its statistics.
+    const Integrator& getIntegrator(int member) const;
+    /// Get writable access to the Integrator used for one member.
+    Integrator& updIntegrator(int member);
+
+    /// Gather the continuous state variables y=(q,u,z) of all the members
+    /// into \a y, resized to getNumMembers() X ny, with the state of member
+    /// i in row i. Since a Matrix is stored by columns, this places each
+    /// variable's values for the whole ensemble next to each other in memory,
+    /// which is the convenient layout for computing statistics across the
+    /// ensemble.
+    void getContinuousStates(Matrix& y) const;
+
+private:
+    typedef Integrator* (*IntegratorCreator)(const System&);
+    template <class IntegratorType>
+    static Integrator* createIntegrator(const System& system)
+    {   return new IntegratorType(system); }
+    void setIntegratorCreator(IntegratorCreator creator);
+
+    EnsembleIntegratorRep* rep;
+    friend class EnsembleIntegratorRep;
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SIMMATH_ENSEMBLE_INTEGRATOR_H_
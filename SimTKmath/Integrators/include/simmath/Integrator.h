@@ -175,6 +175,19 @@ public:
     /// Get a non-const reference to the advanced state.
     State& updAdvancedState();
 
+    /// Evaluate the continuous state variables y=(q,u,z) at many times within
+    /// the most recent internal step, that is, the interval ending at 
+    /// getAdvancedTime() that contains the time of getState(). Column j of
+    /// \a y is set to y(times[j]). This is much cheaper than stepping to each
+    /// of the times in turn when reports are wanted at a higher rate than
+    /// the integrator's steps: the interpolating polynomial is formed once 
+    /// per step, and then each time costs a few flops per state variable, 
+    /// with no realization of the System. The results are not projected onto
+    /// the constraint manifold, nor are prescribed q's and u's applied. 
+    /// Throws an exception if any time is outside the step, or if the 
+    /// integration method doesn't support this.
+    void interpolateMany(const Array_<Real>& times, Matrix& y);
+
     /// Get the accuracy which is being used for error control.  Usually this is the same value that was
     /// specified to setAccuracy().
     Real getAccuracyInUse() const;
@@ -330,6 +343,14 @@ public:
     /// of whether those iterations led to convergence or to successful steps. This is the sum of
     /// the number of convergent and divergent iterations which are available separately.
     int getNumIterations() const;
+    /// For each continuous state variable in y=(q,u,z), get the number of 
+    /// attempted steps in which that variable had the largest weighted error
+    /// estimate, so was the one limiting the step size. This identifies the
+    /// parts of a model that are responsible for small steps; steps that were
+    /// rejected are counted by getNumErrorTestFailures() and 
+    /// getNumConvergenceTestFailures(). Reset to zero by resetAllStatistics().
+    /// This is empty for integrators that don't provide it.
+    const Array_<int>& getStepLimitingErrorCounts() const;
 
     /// Set the time at which the simulation should end.  The default is infinity.  Some integrators may
     /// not support this option.
@@ -365,6 +386,38 @@ public:
     /// (Advanced) Are we currently using the infinity norm?
     bool isInfinityNormInUse() const;
 
+    /// The rules an error-controlled integrator can use to choose the next
+    /// step size from the error estimates. With k the order of the error 
+    /// estimate, e_n the weighted error of step n divided by the accuracy, 
+    /// and h_n its size:
+    enum StepController {
+        /// h_n+1 = h_n (1/e_n)^(1/k), with hysteresis to avoid small changes.
+        /// This is the default.
+        ElementaryController = 0,
+        /// Gustafsson's PI.3.4 controller, 
+        /// h_n+1 = h_n (1/e_n)^(0.3/k) (e_n-1/e_n)^(0.4/k). It responds 
+        /// more smoothly than the elementary controller and suppresses the 
+        /// step size oscillation seen where the error estimate changes
+        /// rapidly, such as stop-and-go contact.
+        PIController,
+        /// Gustafsson's predictive controller,
+        /// h_n+1 = h_n (1/e_n)^(1/k) (h_n/h_n-1) (e_n-1/e_n)^(1/k). It 
+        /// tracks a steadily changing step size well, reducing rejections.
+        GustafssonController,
+        /// The PI.3.4 controller with a derivative term,
+        /// (e_n-1^2/(e_n e_n-2))^(0.1/k), that further damps oscillation.
+        PIDController
+    };
+    /// (Advanced) Choose how the next step size is chosen after each step
+    /// attempt. Integrators without error control, and CPodesIntegrator 
+    /// which has its own controller, ignore this. For all but the 
+    /// ElementaryController a step is accepted exactly when its weighted 
+    /// error is at most the accuracy, and rejected steps are retried with the
+    /// elementary rule.
+    void setStepController(StepController controller);
+    /// (Advanced) Get the step size controller that is in use.
+    StepController getStepController() const;
+
 
     /// Set the maximum number of steps that may be taken within a single call
     /// to stepTo() or stepBy(). If this many internal steps occur before 
@@ -400,6 +453,21 @@ public:
     /// matrix for efficiency. You can force strict use of a current iteration
     /// matrix recomputed at each iteration if you want.
     void setForceFullNewton(bool forceFullNewton);
+    /// (Advanced) Set whether the trial states used to localize an event
+    /// trigger are realized only through the highest Stage of the trigger 
+    /// functions being localized. Interpolated states are always realized
+    /// through Velocity stage, so for Position- and Velocity-stage triggers,
+    /// such as the witness functions for unilateral contact, this evaluates 
+    /// the triggers without calculating any forces or accelerations. All the
+    /// triggers that transitioned during a step are localized together, each
+    /// trial state serving all of them. The default is "true"; set this false
+    /// to realize every trial state through Acceleration stage, as is needed
+    /// if a trigger function (improperly) uses results that belong to a later
+    /// stage than its own. Integrators that locate events themselves 
+    /// (CPodesIntegrator) ignore this.
+    void setLocalizeEventsAtTriggerStage(bool localizeAtTriggerStage);
+    /// (Advanced) Are event triggers being localized at their own Stage?
+    bool getLocalizeEventsAtTriggerStage() const;
 
     /// OBSOLETE: use getSuccessfulStepStatusString().
     static String successfulStepStatusString(SuccessfulStepStatus stat)
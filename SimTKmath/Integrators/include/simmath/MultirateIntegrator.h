@@ -0,0 +1,106 @@
+#ifndef SimTK_SIMMATH_MULTIRATE_INTEGRATOR_H_
+#define SimTK_SIMMATH_MULTIRATE_INTEGRATOR_H_
+
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include "SimTKcommon.h"
+#include "simmath/internal/common.h"
+#include "simmath/Integrator.h"
+
+namespace SimTK {
+class MultirateIntegratorRep;
+
+/**
+ * This is an explicit, error controlled integrator for systems made of loosely
+ * coupled parts that move on very different time scales, such as a stiff 
+ * gearbox inside a slowly moving vehicle. The state variables are split into
+ * a designated "fast" group and the remaining "slow" ones. Each step advances
+ * the slow variables by one large step of Heun's method (explicit trapezoid
+ * rule) while the fast variables are sub-cycled with several smaller Heun 
+ * steps, during which the slow variables follow their first order prediction
+ * across the large step. The step size is chosen by the error control of 
+ * both groups, with the fast group's error reduced by the sub-cycling.
+ *
+ * Designate the fast variables with addFastQ(), addFastU() and addFastZ(); 
+ * the indices are the System-wide ones, so for a group of mobilizers use 
+ * e.g. MobilizedBody::getFirstQIndex() and getNumQ(), and remember to include
+ * both the q's and the u's of each mobilizer. With no fast variables this is
+ * just Heun's method.
+ *
+ * By default every substep evaluates the derivatives of the whole System, so
+ * a step costs 2*getNumSubsteps() full evaluations and the method is no
+ * cheaper than a single-rate one taking the substep size; only the error
+ * control is decoupled. To get the savings of a multirate method supply a
+ * FastDerivativeFunction with setFastDerivativeFunction(). The substeps then
+ * call it instead of realizing the System, and each step needs only one full
+ * evaluation, at its end, for the slow variables.
+ */
+class SimTK_SIMMATH_EXPORT MultirateIntegrator : public Integrator {
+public:
+    explicit MultirateIntegrator(const System& sys);
+
+    /** Make a generalized coordinate one of the fast variables. **/
+    void addFastQ(QIndex q);
+    /** Make a generalized speed one of the fast variables. **/
+    void addFastU(UIndex u);
+    /** Make an auxiliary state variable one of the fast variables. **/
+    void addFastZ(ZIndex z);
+    /** Make all the state variables slow again. **/
+    void clearFastVariables();
+
+    /** Computes the time derivatives of the fast variables alone. This is
+    called during the substeps in place of a full realization of the System,
+    so it should touch only the fast partition of the model. **/
+    class FastDerivativeFunction {
+    public:
+        virtual ~FastDerivativeFunction() {}
+        /** Fill in the entries of \a ydot (which has the size of the State's
+        y) that belong to the fast variables; the others are ignored. The
+        \a state has its time and all of y set but is realized only through
+        Stage::Time; the slow variables hold their prediction for that time. 
+        If you need higher stages you may realize them, but that forfeits the
+        savings this is for. **/
+        virtual void calcFastDerivatives(const State& state, 
+                                         Vector& ydot) const = 0;
+    };
+
+    /** Use \a fastDerivs to evaluate the fast variables' derivatives during
+    the substeps. The integrator takes over ownership of the object; pass
+    null to go back to evaluating the whole System. **/
+    void setFastDerivativeFunction(FastDerivativeFunction* fastDerivs);
+    /** Return true if a FastDerivativeFunction has been supplied. **/
+    bool hasFastDerivativeFunction() const;
+
+    /** Set the number of substeps the fast variables take for each step of
+    the slow ones. The default is 10. **/
+    void setNumSubsteps(int numSubsteps);
+    /** Get the number of substeps the fast variables take for each step of
+    the slow ones. **/
+    int getNumSubsteps() const;
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SIMMATH_MULTIRATE_INTEGRATOR_H_
@@ -0,0 +1,150 @@
+#ifndef SimTK_SIMMATH_REAL_TIME_STEPPER_H_
+#define SimTK_SIMMATH_REAL_TIME_STEPPER_H_
+
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon.h"
+#include "simmath/internal/common.h"
+#include "simmath/Integrator.h"
+
+namespace SimTK {
+
+class RealTimeStepperRep;
+
+/**
+ * This class advances a System with fixed steps for real-time applications
+ * such as hardware-in-the-loop simulation, and measures how long each step
+ * takes against a deadline. For example:
+ *
+ * <pre>
+ * SemiExplicitEuler2Integrator integ(system);
+ * RealTimeStepper stepper(system, integ);
+ * stepper.setStepSize(0.001);          // 1 kHz; the deadline is 1 ms too
+ * stepper.setPaceToRealTime(true);     // don't run ahead of the wall clock
+ * stepper.initialize(initialState);
+ * while (running) {
+ *     stepper.step();
+ *     ... read outputs from stepper.getState() ...
+ * }
+ * cout << stepper.getNumOverruns() << " overruns, worst "
+ *      << stepper.getMaxLatency() << "s\n";
+ * </pre>
+ *
+ * Each call to step() advances the System by exactly one step of the given
+ * size, handling any events that occur, using the supplied Integrator with
+ * its step size fixed. A method without error control or iteration, such as
+ * SemiExplicitEuler2Integrator or VerletIntegrator, gives the most
+ * predictable cost per step. The latency of a step is the real (wall clock)
+ * time, from realTime(), spent in step() excluding any pacing delay; it is
+ * an overrun if that exceeds the deadline. The latencies are also collected
+ * in a histogram with bins of fixed width.
+ *
+ * The first few steps after initialize() (see setNumWarmUpSteps()) are
+ * excluded from the statistics since they include one-time costs such as
+ * sizing the Integrator's and the State's internal storage. The bookkeeping
+ * done by step() itself never allocates memory.
+ */
+class SimTK_SIMMATH_EXPORT RealTimeStepper {
+public:
+    /// Create a RealTimeStepper to advance a System with the given
+    /// Integrator, which must remain alive while it is in use.
+    RealTimeStepper(const System& system, Integrator& integrator);
+    ~RealTimeStepper();
+
+    /// Set the fixed step size (in simulated time). This takes effect at the
+    /// next initialize(). The default is 0.001.
+    void setStepSize(Real stepSize);
+    /// Get the fixed step size.
+    Real getStepSize() const;
+
+    /// Set the deadline for the real time spent in one step, in seconds. By
+    /// default (or if this is set to zero) the deadline is the step size, so
+    /// that an overrun is a step that ran slower than real time.
+    void setDeadline(double deadlineInSec);
+    /// Get the deadline in seconds that steps are being measured against.
+    double getDeadline() const;
+
+    /// Set whether step() waits until the wall clock has caught up with the
+    /// simulation before returning, so that simulated time advances no faster
+    /// than real time. The default is false.
+    void setPaceToRealTime(bool shouldPace);
+    /// Get whether step() is pacing the simulation to real time.
+    bool getPaceToRealTime() const;
+
+    /// Set the number of steps after initialize() that are excluded from the
+    /// statistics. The default is 1.
+    void setNumWarmUpSteps(int numSteps);
+    /// Get the number of steps excluded from the statistics.
+    int getNumWarmUpSteps() const;
+
+    /// Set the latency histogram to have \a numBins bins of width
+    /// \a binWidthInSec seconds, and clear it. The last bin also counts all
+    /// latencies beyond the end of the range. The default is 100 bins
+    /// spanning twice the deadline in effect at initialize().
+    void setLatencyHistogramBins(double binWidthInSec, int numBins);
+
+    /// Supply the starting state and reset the statistics. This fixes the
+    /// Integrator's step size and initializes it.
+    void initialize(const State& initState);
+
+    /// Advance the System by one step, and return true if the step met its
+    /// deadline. If an event handler terminates the simulation, this returns
+    /// without advancing; see isSimulationOver().
+    bool step();
+
+    /// Get the current State.
+    const State& getState() const;
+    /// Get the current time in the simulation.
+    Real getTime() const {return getState().getTime();}
+    /// Return true if an event handler has terminated the simulation.
+    bool isSimulationOver() const;
+
+    /// Get the total number of steps taken since initialize().
+    int getNumSteps() const;
+    /// Get the number of measured steps that exceeded the deadline.
+    int getNumOverruns() const;
+    /// Get the latency of the most recent step in seconds, whether or not
+    /// it was measured.
+    double getLastLatency() const;
+    /// Get the largest latency of any measured step, in seconds.
+    double getMaxLatency() const;
+    /// Get the mean latency of the measured steps, in seconds.
+    double getMeanLatency() const;
+    /// Get the counts of measured steps by latency; bin i counts latencies
+    /// in [i*w, (i+1)*w) with w the bin width, except that the last bin
+    /// also counts anything longer.
+    const Array_<int>& getLatencyHistogram() const;
+    /// Get the width of the latency histogram bins, in seconds.
+    double getLatencyHistogramBinWidth() const;
+    /// Clear the statistics without affecting the simulation.
+    void resetStatistics();
+
+private:
+    RealTimeStepperRep* rep;
+    friend class RealTimeStepperRep;
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SIMMATH_REAL_TIME_STEPPER_H_
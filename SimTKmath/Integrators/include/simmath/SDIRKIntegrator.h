@@ -0,0 +1,90 @@
+#ifndef SimTK_SIMMATH_SDIRK_INTEGRATOR_H_
+#define SimTK_SIMMATH_SDIRK_INTEGRATOR_H_
+
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include "SimTKcommon.h"
+#include "simmath/internal/common.h"
+#include "simmath/Integrator.h"
+
+namespace SimTK {
+class SDIRKIntegratorRep;
+
+/**
+ * This is an implicit, error controlled integrator for stiff systems, such
+ * as multibody systems with stiff compliant contact or stiff bushings. It is
+ * the two-stage, second order, L-stable singly diagonally implicit Runge-Kutta
+ * method of R. Alexander, "Diagonally Implicit Runge-Kutta Methods for Stiff
+ * O.D.E.'s", SIAM J. Numer. Anal. 14(6):1006-1021, 1977, with an embedded
+ * first order error estimate.
+ *
+ * An explicit integrator must keep its step size below the time constant of
+ * the fastest dynamics in the system even when that motion has long since
+ * decayed, e.g. a foot resting on stiff, damped ground contact. This
+ * integrator remains stable at any step size and so chooses its steps by
+ * accuracy alone. Each step solves the stage equations by Newton iteration
+ * using a Jacobian of the state derivatives that is reused for as many steps
+ * as the iteration keeps converging quickly. The Jacobian comes from
+ * System::calcYDotJacobian() when the System can supply it (a MultibodySystem
+ * can when all its force elements provide their derivatives and there are no
+ * constraints), and is otherwise calculated by finite differences. The
+ * Newton iteration matrix is refactored only when the step size changes by
+ * more than 20% from the one it was factored for, or the Jacobian is updated.
+ * Each step therefore costs a few derivative evaluations plus, occasionally,
+ * the Jacobian update: one Dynamics stage realization with the System's
+ * Jacobian, or one more derivative evaluation per state variable without
+ * it. For non-stiff systems an explicit integrator such as
+ * RungeKuttaMersonIntegrator will usually be faster.
+ */
+class SimTK_SIMMATH_EXPORT SDIRKIntegrator : public Integrator {
+public:
+    explicit SDIRKIntegrator(const System& sys);
+
+    /** Return the number of times the Jacobian of the state derivatives has
+    been calculated since the last call to resetAllStatistics() or 
+    initialize(). Compare with getNumStepsTaken() to see how much the 
+    Jacobian is being reused. **/
+    int getNumJacobianEvaluations() const;
+
+    /** Set whether to use the Jacobian supplied by System::calcYDotJacobian()
+    when the System can calculate one, instead of finite differences. That
+    Jacobian is usually approximate; if the Newton iteration fails to converge
+    with it, a finite difference Jacobian is used for that step. The default
+    is true. **/
+    void setUseSystemJacobian(bool useSystemJacobian);
+    /** Return whether the System's Jacobian is used when available; see
+    setUseSystemJacobian(). **/
+    bool getUseSystemJacobian() const;
+
+    /** Return the number of times the Newton iteration matrix has been
+    factored since the last call to resetAllStatistics() or initialize().
+    Compare with getNumStepsAttempted() to see how much each factorization
+    is being reused. **/
+    int getNumIterationMatrixFactorizations() const;
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SIMMATH_SDIRK_INTEGRATOR_H_
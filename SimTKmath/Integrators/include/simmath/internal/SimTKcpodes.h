@@ -69,7 +69,14 @@ public:
     virtual void errorHandler(int error_code, const char* module,
                               const char* function, char* msg) const;
 
-    //TODO: Jacobian functions
+    // Calculate Jv = J*v where J = df/dy at (t,y), and fy = f(t,y). This is
+    // used only by the Krylov linear solvers, and only for an explicit ODE,
+    // after spilsSetJacTimesVecFn() has been called.
+    virtual int  jacobianTimesVector(Real t, const Vector& y, 
+                                     const Vector& fy, const Vector& v,
+                                     Vector& Jv) const;
+
+    //TODO: dense and band Jacobian functions
 };
 
 
@@ -111,6 +118,12 @@ static void errorHandler_static(const CPodesSystem& sys,
                                 const char* function, char* msg)
   { sys.errorHandler(error_code,module,function,msg); }
 
+static int jacobianTimesVector_static(const CPodesSystem& sys, 
+                                      Real t, const Vector& y, 
+                                      const Vector& fy, const Vector& v,
+                                      Vector& Jv)
+  { return sys.jacobianTimesVector(t,y,fy,v,Jv); }
+
 /**
  * This is a straightforward translation of the Sundials CPODES C 
  * interface into C++. The class CPodes represents a single instance
@@ -253,6 +266,11 @@ public:
     int dlsSetJacFn(void* jac, void* jac_data);
     int dlsProjSetJacFn(void* jacP, void* jacP_data);
 
+    // This tells the Krylov linear solver to use the user's 
+    // jacobianTimesVector() method from CPodesSystem rather than a 
+    // difference quotient. Call it after spgmr(), spbcg() or sptfqmr().
+    int spilsSetJacTimesVecFn();
+
 
     int step(Real tout, Real* tret, 
              Vector& y_inout, Vector& yp_inout, StepMode=Normal);
@@ -342,6 +360,19 @@ public:
     int lapackBand(int N, int mupper, int mlower);
     int lapackDenseProj(int Nc, int Ny, ProjectionFactorizationType);
 
+    // Krylov (scaled preconditioned iterative) linear solvers. Only 
+    // pretype 0 (no preconditioning) is currently usable since there is
+    // no way to supply a preconditioner. maxl <= 0 gives the default
+    // Krylov subspace dimension of 5.
+    int spgmr(int pretype, int maxl);
+    int spbcg(int pretype, int maxl);
+    int sptfqmr(int pretype, int maxl);
+
+    int spilsGetNumLinIters(int* nliters);
+    int spilsGetNumConvFails(int* nlcfails);
+    int spilsGetNumJtimesEvals(int* njvevals);
+    int spilsGetNumFctEvals(int* nfevalsLS);
+
 private:
     // This is how we get the client-side virtual functions to
     // be callable from library-side code while maintaining binary
@@ -366,6 +397,9 @@ private:
     typedef void (*ErrorHandlerFunc)(const CPodesSystem&, 
                                      int error_code, const char* module, 
                                      const char* function, char* msg);
+    typedef int (*JacTimesVecFunc)(const CPodesSystem&, 
+                                   Real t, const Vector& y, const Vector& fy,
+                                   const Vector& v, Vector& Jv);
 
     // Note that these routines do not tell CPodes to use the supplied
     // functions. They merely provide the client-side addresses of functions
@@ -383,6 +417,7 @@ private:
     void registerRootFunc(RootFunc);
     void registerWeightFunc(WeightFunc);
     void registerErrorHandlerFunc(ErrorHandlerFunc);
+    void registerJacTimesVecFunc(JacTimesVecFunc);
 
 
     // This is the library-side part of the CPodes constructor. This must
@@ -401,6 +436,7 @@ private:
         registerRootFunc(root_static);
         registerWeightFunc(weight_static);
         registerErrorHandlerFunc(errorHandler_static);
+        registerJacTimesVecFunc(jacobianTimesVector_static);
     }
 
     // FOR INTERNAL USE ONLY
@@ -49,6 +49,7 @@ void AbstractIntegratorRep::methodInitialize(const State& state) {
         currentStepSize = std::min(currentStepSize, userMaxStepSize);
     lastStepSize = currentStepSize;
     actualInitialStepSizeTaken = (hasErrorControl ? NaN : currentStepSize);
+    acceptedRelErr[0] = acceptedRelErr[1] = lastAcceptedStepSize = NaN;
     resetMethodStatistics();
  }
 
@@ -66,13 +67,7 @@ void AbstractIntegratorRep::createInterpolatedState(Real t) {
     State&        interp   = updInterpolatedState();
     interp = advanced; // pick up discrete stuff.
 
-    // Hermite interpolation requires state derivatives so we must realize
-    // end-of-step derivatives if they haven't already been realized.
-    realizeStateDerivatives(advanced);
-
-    interpolateOrder3(getPreviousTime(),  getPreviousY(),  getPreviousYDot(),
-                      advanced.getTime(), advanced.getY(), advanced.getYDot(),
-                      t, interp.updY());
+    interpolateY(t, interp.updY());
     interp.updTime() = t;
 
     if (userProjectInterpolatedStates == 0) {
@@ -100,18 +95,16 @@ void AbstractIntegratorRep::createInterpolatedState(Real t) {
 void AbstractIntegratorRep::backUpAdvancedStateByInterpolation(Real t) {
     const System& system   = getSystem();
     State& advanced = updAdvancedState();
-    Vector yinterp, dummy;
 
     assert(getPreviousTime() <= t && t <= advanced.getTime());
 
-    // Hermite interpolation requires state derivatives so we must realize
-    // end-of-step derivatives if they haven't already been realized.
-    realizeStateDerivatives(advanced);
-    interpolateOrder3(getPreviousTime(),  getPreviousY(),  getPreviousYDot(),
-                      advanced.getTime(), advanced.getY(), advanced.getYDot(),
-                      t, yinterp);
-    advanced.updY() = yinterp;
+    // The dense output is independent of the advanced state once formed, so
+    // we can evaluate it directly into the advanced state's y.
+    updateDenseOutput();
+    Vector& y = advanced.updY();
+    evaluateDenseOutput(t, y);
     advanced.updTime() = t;
+    setDenseOutputIsCurrent(false); // the step is now shorter
 
     // Ignore any user request not to project interpolated states here -- this
     // is the actual advanced state which will be propagated through the
@@ -128,6 +121,88 @@ void AbstractIntegratorRep::backUpAdvancedStateByInterpolation(Real t) {
 
 
 
+//==============================================================================
+//                              DENSE OUTPUT
+//==============================================================================
+// The cubic Hermite interpolant of interpolateOrder3() in powers of 
+// d=(t-t0)/h, with D=y1-y0:
+//      y(t0+d*h) = y0 + d*h*f0 + d^2*(3D - 2h*f0 - h*f1) 
+//                              + d^3*(h*f0 + h*f1 - 2D)
+// The coefficients are formed at most once per step; after that each 
+// interpolated value costs 6 flops per element of y.
+void AbstractIntegratorRep::updateDenseOutput() {
+    if (isDenseOutputCurrent())
+        return;
+
+    // Hermite interpolation requires state derivatives so we must realize
+    // end-of-step derivatives if they haven't already been realized.
+    const State& advanced = getAdvancedState();
+    realizeStateDerivatives(advanced);
+
+    const Vector& y0 = getPreviousY();
+    const Vector& y1 = advanced.getY();
+    const Real h = advanced.getTime() - getPreviousTime();
+    Vector& c0 = denseOutput[0]; Vector& c1 = denseOutput[1];
+    Vector& c2 = denseOutput[2]; Vector& c3 = denseOutput[3];
+    if (!(h > 0)) { // no step yet; there is only the advanced state
+        c0 = y1;
+        c1.resize(y1.size()); c1 = 0;
+        c2 = c1; c3 = c1;
+    } else {
+        const Vector& f0 = getPreviousYDot();
+        const Vector& f1 = advanced.getYDot();
+        // Written out elementwise since this is done every step and Vector
+        // expressions would allocate temporaries.
+        const int ny = y1.size();
+        c0 = y0;
+        c1.resize(ny); c2.resize(ny); c3.resize(ny);
+        for (int i=0; i < ny; ++i) {
+            const Real D = y1[i]-y0[i], hf0 = h*f0[i], hf1 = h*f1[i];
+            c1[i] = hf0;
+            c2[i] = 3*D - 2*hf0 - hf1;
+            c3[i] = hf1 + (hf0 - 2*D);
+        }
+    }
+    setDenseOutputIsCurrent(true);
+}
+
+template <class V> 
+void AbstractIntegratorRep::evaluateDenseOutput(Real t, V& y) const {
+    const Real t0 = getPreviousTime(), t1 = getAdvancedTime();
+    const Real d = t1 > t0 ? (t-t0)/(t1-t0) : Real(0);
+    const Vector& c0 = denseOutput[0]; const Vector& c1 = denseOutput[1];
+    const Vector& c2 = denseOutput[2]; const Vector& c3 = denseOutput[3];
+    for (int i=0; i < c0.size(); ++i)
+        y[i] = c0[i] + d*(c1[i] + d*(c2[i] + d*c3[i]));
+}
+
+void AbstractIntegratorRep::interpolateY(Real t, Vector& y) {
+    updateDenseOutput();
+    y.resize(denseOutput[0].size());
+    evaluateDenseOutput(t, y);
+}
+
+void AbstractIntegratorRep::interpolateMany
+   (const Array_<Real>& times, Matrix& y) 
+{
+    const Real t1 = getAdvancedTime();
+    const Real t0 = getPreviousTime() < t1 ? getPreviousTime() : t1;
+    for (Real t : times)
+        SimTK_ERRCHK3_ALWAYS(t0 <= t && t <= t1, 
+            "Integrator::interpolateMany()",
+            "Time %g is outside the most recent step, from %g to %g.",
+            t, t0, t1);
+
+    updateDenseOutput();
+    y.resize(denseOutput[0].size(), (int)times.size());
+    for (int j=0; j < (int)times.size(); ++j) {
+        VectorView yj = y(j);
+        evaluateDenseOutput(times[j], yj);
+    }
+}
+
+
+
 //==============================================================================
 //                            ATTEMPT DAE STEP
 //==============================================================================
@@ -451,6 +526,42 @@ bool AbstractIntegratorRep::adjustStepSize
     const Real Safety = Real(0.9), MinShrink = Real(0.1), MaxGrow = 5;
     const Real HysteresisLow = Real(0.9), HysteresisHigh = Real(1.2);
     
+    if (userStepController != Integrator::ElementaryController) {
+        // Accept exactly when the accuracy was achieved; if so the 
+        // controller picks the next step, otherwise retry with the 
+        // elementary rule. Either way, don't grow a step that was cut short.
+        const Real relErr = err / getAccuracyInUse();
+        const bool accepted = relErr <= 1;
+        Real factor;
+        if (!isFinite(relErr))
+            factor = MinShrink;
+        else if (relErr == 0)
+            factor = MaxGrow;
+        else if (accepted)
+            factor = calcAcceptedStepSizeFactor(relErr, errOrder);
+        else 
+            factor = Safety * std::pow(relErr, -1/Real(errOrder));
+        if (accepted && hWasArtificiallyLimited)
+            factor = std::min(factor, Real(1));
+        factor = std::min(std::max(factor, MinShrink), MaxGrow);
+
+        if (accepted) {
+            acceptedRelErr[1] = acceptedRelErr[0];
+            acceptedRelErr[0] = std::max(relErr, SignificantReal);
+            lastAcceptedStepSize = currentStepSize;
+        }
+
+        Real newStepSize = factor * currentStepSize;
+        if (userMinStepSize != -1)
+            newStepSize = std::max(newStepSize, userMinStepSize);
+        if (userMaxStepSize != -1)
+            newStepSize = std::min(newStepSize, userMaxStepSize);
+        // If we're already at the minimum step size there's nothing to retry.
+        const bool success = accepted || newStepSize >= currentStepSize;
+        currentStepSize = newStepSize;
+        return success;
+    }
+
     Real newStepSize;
 
     // First, make a first guess at the next step size to use based on
@@ -503,6 +614,47 @@ bool AbstractIntegratorRep::adjustStepSize
 
 
 
+// The controllers are from G. Soderlind, "Automatic control and adaptive 
+// time-stepping", Numerical Algorithms 31:281-310, 2002 (PI.3.4 and PID), and
+// K. Gustafsson, "Control-theoretic techniques for stepsize selection in 
+// implicit Runge-Kutta methods", ACM TOMS 20(4):496-517, 1994 (predictive);
+// see also Hairer & Wanner, Solving ODEs II, 2nd rev. ed., section IV.8. 
+// Until there is enough history they fall back on the elementary rule.
+// Here e = relErr and e1, e2 are the errors of the two previous accepted 
+// steps.
+Real AbstractIntegratorRep::calcAcceptedStepSizeFactor
+   (Real relErr, int errOrder) const 
+{
+    const Real Safety = Real(0.9);
+    const Real k = Real(errOrder);
+    const Real e = std::max(relErr, SignificantReal);
+    const Real e1 = acceptedRelErr[0], e2 = acceptedRelErr[1];
+
+    if (isNaN(e1)) // first accepted step
+        return Safety * std::pow(e, -1/k);
+
+    switch (userStepController) {
+    case Integrator::PIController:
+        return Safety * std::pow(e, -Real(0.3)/k) 
+                      * std::pow(e1/e, Real(0.4)/k);
+    case Integrator::GustafssonController:
+        return Safety * std::pow(e, -1/k)
+                      * (currentStepSize/lastAcceptedStepSize)
+                      * std::pow(e1/e, 1/k);
+    case Integrator::PIDController: {
+        Real factor = Safety * std::pow(e, -Real(0.3)/k) 
+                             * std::pow(e1/e, Real(0.4)/k);
+        if (!isNaN(e2))
+            factor *= std::pow(e1*e1/(e*e2), Real(0.1)/k);
+        return factor;
+    }
+    default:
+        return Safety * std::pow(e, -1/k);
+    }
+}
+
+
+
 //==============================================================================
 //                              TAKE ONE STEP
 //==============================================================================
@@ -528,7 +680,8 @@ bool AbstractIntegratorRep::takeOneStep(Real tMax, Real tReport)
               nz = advanced.getNZ(), 
               ny = nq+nu+nz;
     
-    Vector yErrEst(ny);
+    Vector& yErrEst = yErrEstTemp;
+    yErrEst.resize(ny);
     bool stepSucceeded = false;
     do {
         // If we lose more than a small fraction of the step size we wanted
@@ -556,6 +709,11 @@ bool AbstractIntegratorRep::takeOneStep(Real tMax, Real tReport)
             errNorm = (hasErrorControl ? calcErrorNorm(advanced,yErrEst,worstY)
                                        : Real(0));
             statsConvergentIterations += numIterations;
+            if (worstY >= 0) {
+                if (statsStepLimitingErrorCounts.size() != (unsigned)ny)
+                    statsStepLimitingErrorCounts.assign(ny, 0);
+                ++statsStepLimitingErrorCounts[worstY];
+            }
         } else {
             errNorm = Infinity; // step didn't converge so error is *very* bad!
             ++statsConvergenceTestFailures;
@@ -654,7 +812,7 @@ bool AbstractIntegratorRep::takeOneStep(Real tMax, Real tReport)
     // From above we have earliestTimeEst which is the time at which we
     // think the first event is triggering.
 
-    Vector eLow = e0, eHigh = e1;
+    Vector eLow = e0, eHigh = e1, eMid;
     Real bias = 1; // neutral
 
     // There is an event in (tLow,tHigh], with the eariest occurrence
@@ -681,10 +839,29 @@ bool AbstractIntegratorRep::takeOneStep(Real tMax, Real tReport)
 
         // Failure to evaluate at the interpolated state is a disaster of some
         // kind, not something we expect to be able to recover from, so this 
-        // will throw an exception if it fails.
-        realizeStateDerivatives(getInterpolatedState());
-
-        const Vector& eMid = getInterpolatedState().getEventTriggers();
+        // will throw an exception if it fails. Unless asked not to, we
+        // realize only as far as needed to evaluate the remaining candidates;
+        // the interpolated state is already realized through Velocity.
+        const State& interp = getInterpolatedState();
+        const Stage g = userLocalizeEventsAtTriggerStage == 0 
+            ? Stage::Acceleration 
+            : findHighestTriggerStage(interp, eventCandidates);
+        if (g >= Stage::Acceleration)
+            realizeStateDerivatives(interp);
+        else if (g > Stage::Velocity)
+            getSystem().realize(interp, g);
+
+        // Collect the trigger values for the stages that are realized. Only
+        // the candidates are examined below, and they are all at or below g,
+        // so the others just keep their values from tLow.
+        eMid = eLow;
+        const Stage realized = std::min(interp.getSystemStage(), 
+                                        Stage(Stage::HighestRuntime));
+        for (Stage s = Stage::LowestRuntime; s <= realized; s = s.next()) {
+            const int n = interp.getNEventTriggersByStage(s);
+            if (n) eMid(interp.getEventTriggerStartByStage(s), n) 
+                        = interp.getEventTriggersByStage(s);
+        }
 
         // TODO: should search in the wider interval first
 
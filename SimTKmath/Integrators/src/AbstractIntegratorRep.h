@@ -69,6 +69,8 @@ public:
     int getMethodMaxOrder() const override;
     bool methodHasErrorControl() const override;
 
+    void interpolateMany(const Array_<Real>& times, Matrix& y) override;
+
 protected:
     /*
      * Given initial values for time, all the continuous variables y=(q,u,z) and 
@@ -139,6 +141,13 @@ protected:
      */
     virtual bool adjustStepSize(Real err, int errOrder, 
                                 bool hWasArtificiallyLimited);
+    /**
+     * The part of adjustStepSize() used for all but the 
+     * Integrator::ElementaryController: return the factor by which to
+     * multiply the step size after an accepted step, given its error norm
+     * relative to the accuracy.
+     */
+    Real calcAcceptedStepSizeFactor(Real relErr, int errOrder) const;
     /**
      * Create an interpolated state at time t, which is between the previous 
      * and advanced times. The default implementation uses third order 
@@ -153,15 +162,40 @@ protected:
      * third order Hermite spline interpolation.
      */
     virtual void backUpAdvancedStateByInterpolation(Real t);
+    /**
+     * Make sure the continuous extension of the current step (from the 
+     * previous state to the advanced state) is up to date, then evaluate it
+     * at time t. The default continuous extension is the cubic Hermite 
+     * interpolant also used by interpolateOrder3(), but its coefficients are
+     * formed just once per step so that any number of interpolated values
+     * cost only a polynomial evaluation each.
+     */
+    void interpolateY(Real t, Vector& y);
     int statsStepsTaken, statsStepsAttempted, statsErrorTestFailures, statsConvergenceTestFailures;
 
     // Iterative methods should count iterations and then classify them as 
     // iterations that led to successful convergence and those that didn't.
     int statsConvergentIterations, statsDivergentIterations;
+
+    // Pass this empty Vector to the local projection methods when the error
+    // estimate shouldn't be projected. It is a member so that it doesn't
+    // have to be constructed (which allocates) on every step.
+    Vector dummyErrEst;
 private:
     bool takeOneStep(Real tMax, Real tReport);
+    void updateDenseOutput();
+    // y(t0+d*h) = c[0] + d*(c[1] + d*(c[2] + d*c[3])), 0 <= d <= 1.
+    template <class V> void evaluateDenseOutput(Real t, V& y) const;
+    Vector denseOutput[4];
+    // Error estimate for the step being attempted; kept here so that taking
+    // a step doesn't allocate once it has been sized.
+    Vector yErrEstTemp;
     bool initialized, hasErrorControl;
     Real currentStepSize, lastStepSize, actualInitialStepSizeTaken;
+    // Relative errors of the last two accepted steps (most recent first) and
+    // the size of the last one, for the step size controllers with memory.
+    // NaN if there haven't been that many accepted steps.
+    Real acceptedRelErr[2], lastAcceptedStepSize;
     int minOrder, maxOrder;
     std::string methodName;
 };
@@ -66,11 +66,18 @@ static void        nvcompare_SimTK(realtype, N_Vector, N_Vector);
 static booleantype nvinvtest_SimTK(N_Vector, N_Vector);
 static booleantype nvconstrmask_SimTK(N_Vector, N_Vector, N_Vector);
 static realtype    nvminquotient_SimTK(N_Vector, N_Vector);
+static void        nvlinearcombination_SimTK(int, realtype*, N_Vector*, N_Vector);
+static void        nvscaleaddmulti_SimTK(int, realtype*, N_Vector, N_Vector*, N_Vector*);
 
 // The default constructor for this static const member takes care
 // of initializing all the function pointers.
 const N_Vector_Ops_SimTK N_Vector_Ops_SimTK::Ops;
 
+// The most vectors the fused operators can be given at once. CPodes uses
+// them on the Nordsieck history array, which has at most 13 (Adams order
+// 12 plus one).
+static const int MaxFusedVecs = 16;
+
 // This is the default constructor. It is used exactly once to initialize
 // the static const member variable above.
 N_Vector_Ops_SimTK::N_Vector_Ops_SimTK() {
@@ -99,6 +106,8 @@ N_Vector_Ops_SimTK::N_Vector_Ops_SimTK() {
   nvinvtest         = nvinvtest_SimTK;
   nvconstrmask      = nvconstrmask_SimTK;
   nvminquotient     = nvminquotient_SimTK;
+  nvlinearcombination = nvlinearcombination_SimTK;
+  nvscaleaddmulti     = nvscaleaddmulti_SimTK;
 }
 
 //////////////////////////////
@@ -176,17 +185,24 @@ nvsetarraypointer_SimTK(realtype* vdata, N_Vector nvz) {
 
 // N_VLinearSum
 // z = ax + by
-// This will blow up if x and y aren't the same size.
-// z will get resized if necessary.
+// x, y, and z must all be the same size. Like all the operators
+// below, this works directly on the contiguous data rather than
+// evaluating a Vector expression, which would allocate a temporary.
 static void        
 nvlinearsum_SimTK(realtype a, N_Vector nvx, realtype b, N_Vector nvy, N_Vector nvz) {
     const Vector& x = N_Vector_SimTK::getVector(nvx);
     const Vector& y = N_Vector_SimTK::getVector(nvy);
     Vector&       z = N_Vector_SimTK::updVector(nvz);
 
-    assert(y.size() == x.size() && z.size() == x.size());
+    const int sz = x.size();
+    assert(y.size() == sz && z.size() == sz);
 
-    z = a*x + b*y;
+    const Real* xp = x.getContiguousScalarData();
+    const Real* yp = y.getContiguousScalarData();
+    Real*       zp = z.updContiguousScalarData();
+
+    for (int i=0; i<sz; ++i)
+        zp[i] = a*xp[i] + b*yp[i];
 }
 
 // N_VConst
@@ -244,8 +260,14 @@ nvscale_SimTK(realtype c, N_Vector nvx, N_Vector nvz) {
     const Vector& x = N_Vector_SimTK::getVector(nvx);
     Vector&       z = N_Vector_SimTK::updVector(nvz);
 
-    assert(z.size() == x.size());
-    z = c*x;
+    const int sz = x.size();
+    assert(z.size() == sz);
+
+    const Real* xp = x.getContiguousScalarData();
+    Real*       zp = z.updContiguousScalarData();
+
+    for (int i=0; i<sz; ++i)
+        zp[i] = c*xp[i];
 }
 
 // N_VAbs
@@ -255,8 +277,14 @@ nvabs_SimTK(N_Vector nvx, N_Vector nvz) {
     const Vector& x = N_Vector_SimTK::getVector(nvx);
     Vector&       z = N_Vector_SimTK::updVector(nvz);
 
-    assert(z.size() == x.size());
-    z = x.abs();
+    const int sz = x.size();
+    assert(z.size() == sz);
+
+    const Real* xp = x.getContiguousScalarData();
+    Real*       zp = z.updContiguousScalarData();
+
+    for (int i=0; i<sz; ++i)
+        zp[i] = std::abs(xp[i]);
 }
 
 // N_VInv
@@ -301,9 +329,16 @@ nvdotprod_SimTK(N_Vector nvx, N_Vector nvy) {
     const Vector& x = N_Vector_SimTK::getVector(nvx);
     const Vector& y = N_Vector_SimTK::getVector(nvy);
 
-    assert(y.size() == x.size());
+    const int sz = x.size();
+    assert(y.size() == sz);
+
+    const Real* xp = x.getContiguousScalarData();
+    const Real* yp = y.getContiguousScalarData();
 
-    return ~x * y;
+    Real sum = 0;
+    for (int i=0; i<sz; ++i)
+        sum += xp[i]*yp[i];
+    return sum;
 }
 
 // N_VMaxNorm
@@ -536,3 +571,57 @@ nvminquotient_SimTK(N_Vector nvnum, N_Vector nvdenom) {
 
     return result;
 }
+
+// N_VLinearCombination
+// z = c[0]*X[0] + c[1]*X[1] + ... + c[nvec-1]*X[nvec-1], summed in that
+// order so that the result is the same as N_VScale followed by a series of
+// N_VLinearSum's, but in a single pass. z may be X[0].
+static void
+nvlinearcombination_SimTK(int nvec, realtype* c, N_Vector* X, N_Vector nvz) {
+    Vector& z = N_Vector_SimTK::updVector(nvz);
+    const int sz = z.size();
+
+    assert(0 < nvec && nvec <= MaxFusedVecs);
+    const Real* xp[MaxFusedVecs];
+    for (int j=0; j<nvec; ++j) {
+        const Vector& x = N_Vector_SimTK::getVector(X[j]);
+        assert(x.size() == sz);
+        xp[j] = x.getContiguousScalarData();
+    }
+    Real* zp = z.updContiguousScalarData();
+
+    for (int i=0; i<sz; ++i) {
+        Real sum = c[0]*xp[0][i];
+        for (int j=1; j<nvec; ++j)
+            sum = sum + c[j]*xp[j][i];
+        zp[i] = sum;
+    }
+}
+
+// N_VScaleAddMulti
+// Z[j] = a[j]*x + Y[j] for j = 0..nvec-1, reading x only once. Z[j] may
+// be Y[j].
+static void
+nvscaleaddmulti_SimTK(int nvec, realtype* a, N_Vector nvx, N_Vector* Y,
+                      N_Vector* Z) {
+    const Vector& x = N_Vector_SimTK::getVector(nvx);
+    const int sz = x.size();
+
+    assert(0 < nvec && nvec <= MaxFusedVecs);
+    const Real* yp[MaxFusedVecs];
+    Real*       zp[MaxFusedVecs];
+    for (int j=0; j<nvec; ++j) {
+        const Vector& y = N_Vector_SimTK::getVector(Y[j]);
+        Vector&       z = N_Vector_SimTK::updVector(Z[j]);
+        assert(y.size() == sz && z.size() == sz);
+        yp[j] = y.getContiguousScalarData();
+        zp[j] = z.updContiguousScalarData();
+    }
+    const Real* xp = x.getContiguousScalarData();
+
+    for (int i=0; i<sz; ++i) {
+        const Real xi = xp[i];
+        for (int j=0; j<nvec; ++j)
+            zp[j][i] = a[j]*xi + yp[j][i];
+    }
+}
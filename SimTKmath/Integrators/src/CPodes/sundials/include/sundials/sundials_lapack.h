@@ -60,8 +60,51 @@ SUNDIALS_EXPORT void LapackBandAddI(DlsMat A);
  * ==================================================================
  */
 
+#if defined(SUNDIALS_SINGLE_PRECISION)
+
+/* Same routines as below, but the single precision versions, since realtype
+   is float. */
+
 #if defined(F77_FUNC)
 
+#define dcopy_f77       F77_FUNC(scopy, SCOPY)
+#define dscal_f77       F77_FUNC(sscal, SSCAL)
+#define dgemv_f77       F77_FUNC(sgemv, SGEMV)
+#define dtrsv_f77       F77_FUNC(strsv, STRSV)
+#define dsyrk_f77       F77_FUNC(ssyrk, SSYRK)
+
+#define dgbtrf_f77      F77_FUNC(sgbtrf, SGBTRF)
+#define dgbtrs_f77      F77_FUNC(sgbtrs, SGBTRS)
+#define dgetrf_f77      F77_FUNC(sgetrf, SGETRF)
+#define dgetrs_f77      F77_FUNC(sgetrs, SGETRS)
+#define dgeqp3_f77      F77_FUNC(sgeqp3, SGEQP3)
+#define dgeqrf_f77      F77_FUNC(sgeqrf, SGEQRF)
+#define dormqr_f77      F77_FUNC(sormqr, SORMQR)
+#define dpotrf_f77      F77_FUNC(spotrf, SPOTRF)
+#define dpotrs_f77      F77_FUNC(spotrs, SPOTRS)
+
+#else
+
+#define dcopy_f77       scopy_
+#define dscal_f77       sscal_
+#define dgemv_f77       sgemv_
+#define dtrsv_f77       strsv_
+#define dsyrk_f77       ssyrk_
+
+#define dgbtrf_f77      sgbtrf_
+#define dgbtrs_f77      sgbtrs_
+#define dgetrf_f77      sgetrf_
+#define dgetrs_f77      sgetrs_
+#define dgeqp3_f77      sgeqp3_
+#define dgeqrf_f77      sgeqrf_
+#define dormqr_f77      sormqr_
+#define dpotrf_f77      spotrf_
+#define dpotrs_f77      spotrs_
+
+#endif
+
+#elif defined(F77_FUNC)
+
 #define dcopy_f77       F77_FUNC(dcopy, DCOPY)
 #define dscal_f77       F77_FUNC(dscal, DSCAL)
 #define dgemv_f77       F77_FUNC(dgemv, DGEMV)
@@ -100,55 +143,55 @@ SUNDIALS_EXPORT void LapackBandAddI(DlsMat A);
 
 /* Level-1 BLAS */
   
-extern void dcopy_f77(int *n, const double *x, const int *inc_x, double *y, const int *inc_y);
-extern void dscal_f77(int *n, const double *alpha, double *x, const int *inc_x);
+extern void dcopy_f77(int *n, const realtype *x, const int *inc_x, realtype *y, const int *inc_y);
+extern void dscal_f77(int *n, const realtype *alpha, realtype *x, const int *inc_x);
 
 /* Level-2 BLAS */
 
-extern void dgemv_f77(const char *trans, int *m, int *n, const double *alpha, const double *a, 
-              int *lda, const double *x, int *inc_x, const double *beta, double *y, int *inc_y, 
+extern void dgemv_f77(const char *trans, int *m, int *n, const realtype *alpha, const realtype *a, 
+              int *lda, const realtype *x, int *inc_x, const realtype *beta, realtype *y, int *inc_y, 
               int len_trans);
 
 extern void dtrsv_f77(const char *uplo, const char *trans, const char *diag, const int *n, 
-              const double *a, const int *lda, double *x, const int *inc_x, 
+              const realtype *a, const int *lda, realtype *x, const int *inc_x, 
               int len_uplo, int len_trans, int len_diag);
 
 /* Level-3 BLAS */
 
 extern void dsyrk_f77(const char *uplo, const char *trans, const int *n, const int *k, 
-              const double *alpha, const double *a, const int *lda, const double *beta, 
-              const double *c, const int *ldc, int len_uplo, int len_trans);
+              const realtype *alpha, const realtype *a, const int *lda, const realtype *beta, 
+              const realtype *c, const int *ldc, int len_uplo, int len_trans);
   
 /* LAPACK */
 
 extern void dgbtrf_f77(const int *m, const int *n, const int *kl, const int *ku, 
-               double *ab, int *ldab, int *ipiv, int *info);
+               realtype *ab, int *ldab, int *ipiv, int *info);
 
 extern void dgbtrs_f77(const char *trans, const int *n, const int *kl, const int *ku, const int *nrhs, 
-               double *ab, const int *ldab, int *ipiv, double *b, const int *ldb, 
+               realtype *ab, const int *ldab, int *ipiv, realtype *b, const int *ldb, 
                int *info, int len_trans);
 
 
-extern void dgeqp3_f77(const int *m, const int *n, double *a, const int *lda, int *jpvt, double *tau, 
-               double *work, const int *lwork, int *info);
+extern void dgeqp3_f77(const int *m, const int *n, realtype *a, const int *lda, int *jpvt, realtype *tau, 
+               realtype *work, const int *lwork, int *info);
 
-extern void dgeqrf_f77(const int *m, const int *n, double *a, const int *lda, double *tau, double *work, 
+extern void dgeqrf_f77(const int *m, const int *n, realtype *a, const int *lda, realtype *tau, realtype *work, 
                const int *lwork, int *info);
 
-extern void dgetrf_f77(const int *m, const int *n, double *a, int *lda, int *ipiv, int *info);
+extern void dgetrf_f77(const int *m, const int *n, realtype *a, int *lda, int *ipiv, int *info);
 
-extern void dgetrs_f77(const char *trans, const int *n, const int *nrhs, double *a, const int *lda, 
-               int *ipiv, double *b, const int *ldb, int *info, int len_trans);
+extern void dgetrs_f77(const char *trans, const int *n, const int *nrhs, realtype *a, const int *lda, 
+               int *ipiv, realtype *b, const int *ldb, int *info, int len_trans);
 
 
 extern void dormqr_f77(const char *side, const char *trans, const int *m, const int *n, const int *k, 
-               double *a, const int *lda, double *tau, double *c, const int *ldc, 
-               double *work, const int *lwork, int *info, int len_side, int len_trans);
+               realtype *a, const int *lda, realtype *tau, realtype *c, const int *ldc, 
+               realtype *work, const int *lwork, int *info, int len_side, int len_trans);
 
-extern void dpotrf_f77(const char *uplo, const int *n, double *a, int *lda, int *info, int len_uplo);
+extern void dpotrf_f77(const char *uplo, const int *n, realtype *a, int *lda, int *info, int len_uplo);
 
-extern void dpotrs_f77(const char *uplo, const int *n, const int *nrhs, double *a, const int *lda, 
-               double *b, const int *ldb, int * info, int len_uplo);
+extern void dpotrs_f77(const char *uplo, const int *n, const int *nrhs, realtype *a, const int *lda, 
+               realtype *b, const int *ldb, int * info, int len_uplo);
 
 
 #ifdef __cplusplus
@@ -91,6 +91,10 @@ struct _generic_N_Vector_Ops {
   booleantype (*nvinvtest)(N_Vector, N_Vector);
   booleantype (*nvconstrmask)(N_Vector, N_Vector, N_Vector);
   realtype    (*nvminquotient)(N_Vector, N_Vector);
+  /* Fused operations; these may be NULL (see below). */
+  void        (*nvlinearcombination)(int, realtype*, N_Vector*, N_Vector);
+  void        (*nvscaleaddmulti)(int, realtype*, N_Vector, N_Vector*,
+                                 N_Vector*);
 };
 
 /*
@@ -242,6 +246,21 @@ struct _generic_N_Vector {
  *   in denom will be skipped. If no such quotients are found,
  *   then the large value BIG_REAL is returned.
  *
+ * N_VLinearCombination
+ *   Performs the operation z = c[0]*X[0] + c[1]*X[1] + ... 
+ *   + c[nvec-1]*X[nvec-1], accumulating the terms in that order.
+ *   z may be the same vector as X[0] but no other X[j].
+ *
+ * N_VScaleAddMulti
+ *   Performs the operations Z[j] = a[j]*x + Y[j] for j = 0, 1, ...,
+ *   nvec-1. Z[j] may be the same vector as Y[j].
+ *
+ *   These two fused operations let an implementation make a single
+ *   pass over memory where a sequence of N_VLinearSum calls would make
+ *   several. An implementation may leave their entries in the ops
+ *   structure NULL, in which case they are carried out with 
+ *   N_VScale and N_VLinearSum, with the same result.
+ *
  * -----------------------------------------------------------------
  *
  * The following table lists the vector functions used by
@@ -338,6 +357,10 @@ SUNDIALS_EXPORT void N_VCompare(realtype c, N_Vector x, N_Vector z);
 SUNDIALS_EXPORT booleantype N_VInvTest(N_Vector x, N_Vector z);
 SUNDIALS_EXPORT booleantype N_VConstrMask(N_Vector c, N_Vector x, N_Vector m);
 SUNDIALS_EXPORT realtype N_VMinQuotient(N_Vector num, N_Vector denom);
+SUNDIALS_EXPORT void N_VLinearCombination(int nvec, realtype *c, N_Vector *X,
+                                          N_Vector z);
+SUNDIALS_EXPORT void N_VScaleAddMulti(int nvec, realtype *a, N_Vector x,
+                                      N_Vector *Y, N_Vector *Z);
 
 /*
  * -----------------------------------------------------------------
@@ -2663,6 +2663,7 @@ int cpGetSolution(void *cpode_mem, realtype t, N_Vector yret, N_Vector ypret)
 {
   realtype s, c, d;
   realtype tfuzz, tp, tn1;
+  realtype cvals[L_MAX], dvals[L_MAX];
   int j;
   CPodeMem cp_mem;
 
@@ -2675,20 +2676,20 @@ int cpGetSolution(void *cpode_mem, realtype t, N_Vector yret, N_Vector ypret)
   tn1 = tn + tfuzz;
   if ((t-tp)*(t-tn1) > ZERO) return(CP_BAD_T);
 
-  /* Initialize yret = zn[0] and ypret = 0 */
-  N_VScale(ONE, zn[0], yret);
-  N_VConst(ZERO, ypret);
-
-  /* Accumulate multiples of columns zn[j] into yret and ypret. */
+  /* Form yret = zn[0] + sum c_j zn[j] and ypret = sum d_j zn[j]
+     in one pass each. */
   s = (t - tn) / h;
   c = s;
   d = ONE/h;
+  cvals[0] = ONE;
   for (j=1; j<=q; j++) {
-    N_VLinearSum(ONE,  yret, c, zn[j],  yret);
-    N_VLinearSum(ONE, ypret, d, zn[j], ypret);
+    cvals[j] = c;
+    dvals[j-1] = d;
     d = (j+1)*c/h;
     c *= s;
   }
+  N_VLinearCombination(q+1, cvals, zn, yret);
+  N_VLinearCombination(q, dvals, zn+1, ypret);
 
   return(CP_SUCCESS);
 }
@@ -2789,25 +2790,19 @@ void cpRestore(CPodeMem cp_mem, realtype saved_t)
  * cpCorrect
  *
  * This routine applies the corrections to the zn array.
- * The correction to zn is done by repeated additions.
+ * The correction to zn is done by repeated additions, fused
+ * into a single pass over each correction vector.
  */
 
 static void cpCorrect(CPodeMem cp_mem)
 {
-  int j;
- 
-  for (j=0; j <= q; j++)
-    N_VLinearSum(l[j], acor, ONE, zn[j], zn[j]);
+  N_VScaleAddMulti(q+1, l, acor, zn, zn);
 
-  if (applyProj) {
-    for (j=0; j <= q; j++)
-      N_VLinearSum(p[j], acorP, ONE, zn[j], zn[j]); 
-  }
+  if (applyProj)
+    N_VScaleAddMulti(q+1, p, acorP, zn, zn);
   
-  if (quadr) {
-    for (j=0; j <= q; j++) 
-      N_VLinearSum(l[j], acorQ, ONE, znQ[j], znQ[j]);
-  }
+  if (quadr)
+    N_VScaleAddMulti(q+1, l, acorQ, znQ, znQ);
 
 }
 
@@ -3045,13 +3040,13 @@ static void cpIncreaseBDF(CPodeMem cp_mem)
    */
 
   N_VScale(A1, zn[indx_acor], zn[L]);
-  for (j=2; j <= q; j++)
-    N_VLinearSum(l[j], zn[L], ONE, zn[j], zn[j]);
+  if (q >= 2)
+    N_VScaleAddMulti(q-1, l+2, zn[L], zn+2, zn+2);
   
   if (quadr) {
     N_VScale(A1, znQ[indx_acor], znQ[L]);
-    for (j=2; j <= q; j++)
-      N_VLinearSum(l[j], znQ[L], ONE, znQ[j], znQ[j]);
+    if (q >= 2)
+      N_VScaleAddMulti(q-1, l+2, znQ[L], znQ+2, znQ+2);
   }
 
 }
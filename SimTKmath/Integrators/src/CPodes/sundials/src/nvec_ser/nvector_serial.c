@@ -100,6 +100,8 @@ N_Vector N_VNewEmpty_Serial(long int length)
   ops->nvinvtest         = N_VInvTest_Serial;
   ops->nvconstrmask      = N_VConstrMask_Serial;
   ops->nvminquotient     = N_VMinQuotient_Serial;
+  ops->nvlinearcombination = NULL;
+  ops->nvscaleaddmulti     = NULL;
 
   /* Create content */
   content = NULL;
@@ -314,6 +316,8 @@ N_Vector N_VCloneEmpty_Serial(N_Vector w)
   ops->nvinvtest         = w->ops->nvinvtest;
   ops->nvconstrmask      = w->ops->nvconstrmask;
   ops->nvminquotient     = w->ops->nvminquotient;
+  ops->nvlinearcombination = w->ops->nvlinearcombination;
+  ops->nvscaleaddmulti     = w->ops->nvscaleaddmulti;
 
   /* Create content */
   content = NULL;
@@ -19,6 +19,9 @@
 #include <stdlib.h>
 
 #include <sundials/sundials_nvector.h>
+#include <sundials/sundials_math.h>
+
+#define ONE  RCONST(1.0)
 
 /*
  * -----------------------------------------------------------------
@@ -168,6 +171,36 @@ realtype N_VMinQuotient(N_Vector num, N_Vector denom)
   return((realtype) num->ops->nvminquotient(num, denom));
 }
 
+void N_VLinearCombination(int nvec, realtype *c, N_Vector *X, N_Vector z)
+{
+  int j;
+
+  if (z->ops->nvlinearcombination != NULL) {
+    z->ops->nvlinearcombination(nvec, c, X, z);
+    return;
+  }
+
+  z->ops->nvscale(c[0], X[0], z);
+  for (j = 1; j < nvec; j++)
+    z->ops->nvlinearsum(ONE, z, c[j], X[j], z);
+  return;
+}
+
+void N_VScaleAddMulti(int nvec, realtype *a, N_Vector x, N_Vector *Y,
+                      N_Vector *Z)
+{
+  int j;
+
+  if (x->ops->nvscaleaddmulti != NULL) {
+    x->ops->nvscaleaddmulti(nvec, a, x, Y, Z);
+    return;
+  }
+
+  for (j = 0; j < nvec; j++)
+    x->ops->nvlinearsum(a[j], x, ONE, Y[j], Z[j]);
+  return;
+}
+
 /*
  * -----------------------------------------------------------------
  * Additional functions exported by the generic NVECTOR:
@@ -26,6 +26,8 @@
 #include "IntegratorRep.h"
 #include "CPodesIntegratorRep.h"
 
+#include <algorithm>
+
 using namespace SimTK;
 
 
@@ -51,6 +53,49 @@ void CPodesIntegrator::setOrderLimit(int order) {
     cprep.setOrderLimit(order);
 }
 
+void CPodesIntegrator::setUseDenseLinearSolver() {
+    CPodesIntegratorRep& cprep = dynamic_cast<CPodesIntegratorRep&>(*rep);
+    cprep.setLinearSolver(DenseLinearSolver, 0, 0, 0);
+}
+
+void CPodesIntegrator::setUseBandLinearSolver(int upperBandwidth, 
+                                              int lowerBandwidth) {
+    SimTK_APIARGCHECK2_ALWAYS(upperBandwidth >= 0 && lowerBandwidth >= 0,
+        "CPodesIntegrator", "setUseBandLinearSolver",
+        "The bandwidths must be nonnegative but were %d and %d.",
+        upperBandwidth, lowerBandwidth);
+    CPodesIntegratorRep& cprep = dynamic_cast<CPodesIntegratorRep&>(*rep);
+    cprep.setLinearSolver(BandLinearSolver, upperBandwidth, lowerBandwidth, 0);
+}
+
+void CPodesIntegrator::setUseKrylovLinearSolver(int maxKrylovDimension) {
+    SimTK_APIARGCHECK1_ALWAYS(maxKrylovDimension >= 0,
+        "CPodesIntegrator", "setUseKrylovLinearSolver",
+        "The maximum Krylov dimension must be nonnegative but was %d.",
+        maxKrylovDimension);
+    CPodesIntegratorRep& cprep = dynamic_cast<CPodesIntegratorRep&>(*rep);
+    cprep.setLinearSolver(KrylovLinearSolver, 0, 0, maxKrylovDimension);
+}
+
+CPodesIntegrator::LinearSolverType 
+CPodesIntegrator::getLinearSolverType() const {
+    const CPodesIntegratorRep& cprep = 
+        dynamic_cast<const CPodesIntegratorRep&>(*rep);
+    return cprep.linearSolver;
+}
+
+void CPodesIntegrator::setJacobianTimesVector
+   (const JacobianTimesVector* jacobianTimesVector) {
+    CPodesIntegratorRep& cprep = dynamic_cast<CPodesIntegratorRep&>(*rep);
+    cprep.setJacobianTimesVector(jacobianTimesVector);
+}
+
+int CPodesIntegrator::getNumLinearSolverIterations() const {
+    const CPodesIntegratorRep& cprep = 
+        dynamic_cast<const CPodesIntegratorRep&>(*rep);
+    return cprep.statsLinearIterations;
+}
+
 
 
 //------------------------------------------------------------------------------
@@ -109,7 +154,8 @@ public:
                 return CPodes::RecoverableError;
         }
         catch (...) { return CPodes::RecoverableError; } // assume recoverable
-        ycorr = advanced.getY()-y;
+        ycorr.resize(y.size());
+        IntegratorRep::setSegmentToDifference(ycorr, 0, advanced.getY(), y);
         return CPodes::Success;
     }
     
@@ -124,7 +170,34 @@ public:
         gout = integ.getAdvancedState().getEventTriggers();
         return CPodes::Success;
     }
+
+    // Calculate Jv = (df/dy)*v at (t,y) using the user's 
+    // JacobianTimesVector. CPODES has normally just evaluated f there, in
+    // which case the advanced state is already realized.
+    int jacobianTimesVector(Real t, const Vector& y, const Vector& fy,
+                            const Vector& v, Vector& Jv) const override {
+        try {
+            const State& advanced = integ.getAdvancedState();
+            if (advanced.getTime() != t 
+                || !isAdvancedStateAt(y)
+                || advanced.getSystemStage() < Stage::Acceleration)
+                integ.setAdvancedStateAndRealizeDerivatives(t,y);
+            Jv.resize(y.size());
+            integ.jacobianTimesVector->multiply(integ.getAdvancedState(), 
+                                                v, Jv);
+        }
+        catch(...) { return CPodes::RecoverableError; } // assume recoverable
+        return CPodes::Success;
+    }
 private:
+    bool isAdvancedStateAt(const Vector& y) const {
+        const Vector& ya = integ.getAdvancedState().getY();
+        if (ya.size() != y.size()) return false;
+        for (int i=0; i < y.size(); ++i)
+            if (ya[i] != y[i]) return false;
+        return true;
+    }
+
     CPodesIntegratorRep& integ;
     const System& system;
 };
@@ -137,6 +210,10 @@ void CPodesIntegratorRep::init
     cps = new CPodesSystemImpl(*this, getSystem());
     initialized = false;
     useCpodesProjection = false;
+    linearSolver = CPodesIntegrator::DenseLinearSolver;
+    upperBandwidth = lowerBandwidth = maxKrylovDimension = 0;
+    jacobianTimesVector = nullptr;
+    statsLinearIterations = 0;
 }
 
 CPodesIntegratorRep::CPodesIntegratorRep
@@ -189,7 +266,22 @@ void CPodesIntegratorRep::methodInitialize(const State& state) {
         printf("init() returned %d\n", retval);
         SimTK_THROW1(Integrator::InitializationFailed, "init() failed");
     }
-    cpodes->lapackDense(ny);
+    switch (linearSolver) {
+    case CPodesIntegrator::DenseLinearSolver:
+        cpodes->lapackDense(ny);
+        break;
+    case CPodesIntegrator::BandLinearSolver: {
+        const int maxBandwidth = std::max(ny-1, 0);
+        cpodes->lapackBand(ny, std::min(upperBandwidth, maxBandwidth),
+                               std::min(lowerBandwidth, maxBandwidth));
+        break;
+    }
+    case CPodesIntegrator::KrylovLinearSolver:
+        cpodes->spgmr(0, maxKrylovDimension); // no preconditioning
+        if (jacobianTimesVector)
+            cpodes->spilsSetJacTimesVecFn();
+        break;
+    }
     cpodes->setNonlinConvCoef(Real(0.01)); // TODO (default is 0.1)
     if (useCpodesProjection) {
         const int nqerr = state.getNQErr(), nuerr = state.getNUErr();
@@ -287,6 +379,19 @@ void CPodesIntegratorRep::createInterpolatedState(Real t) {
     realizeAndProjectKinematicsWithThrow(interp, ProjectOptions::LocalOnly);
 }
 
+// CPodes keeps its own interpolating polynomial for the last step.
+void CPodesIntegratorRep::interpolateMany
+   (const Array_<Real>& times, Matrix& y) {
+    Vector yout(getAdvancedState().getY().size());
+    y.resize(yout.size(), (int)times.size());
+    for (int j=0; j < (int)times.size(); ++j) {
+        SimTK_ERRCHK1_ALWAYS(cpodes->getDky(times[j], 0, yout) == 0,
+            "Integrator::interpolateMany()",
+            "Time %g is outside the most recent step.", times[j]);
+        y(j) = yout;
+    }
+}
+
 // Take a step. See AbstractIntegratorRep::stepTo() for how this is supposed
 // to behave. We have to go through some contortions to squeeze CPodes into
 // that mold.
@@ -380,14 +485,19 @@ stepTo(Real reportTime, Real scheduledEventTime) {
             updAdvancedState().autoUpdateDiscreteVariables();
 
             previousStartTime = getAdvancedTime();
-            Vector yout(getAdvancedState().getY().size());
-            Vector ypout(getAdvancedState().getY().size()); // ignored
+            Vector& yout = stepYOut;
+            Vector& ypout = stepYPOut; // ignored
+            yout.resize(getAdvancedState().getY().size());
+            ypout.resize(getAdvancedState().getY().size());
             int oldSteps=0, oldTestFailures=0, oldNonlinIterations=0, 
                 oldNonlinConvFailures=0;
             cpodes->getNumSteps(&oldSteps);
             cpodes->getNumErrTestFails(&oldTestFailures);
             cpodes->getNumNonlinSolvIters(&oldNonlinIterations);
             cpodes->getNumNonlinSolvConvFails(&oldNonlinConvFailures);
+            int oldLinearIterations=0;
+            if (linearSolver == CPodesIntegrator::KrylovLinearSolver)
+                cpodes->spilsGetNumLinIters(&oldLinearIterations);
 
             //---------------------step------------------------
             res = cpodes->step(tMax, &tret, yout, ypout, mode);
@@ -413,10 +523,18 @@ stepTo(Real reportTime, Real scheduledEventTime) {
             cpodes->getNumErrTestFails(&newTestFailures);
             cpodes->getNumNonlinSolvIters(&newNonlinIterations);
             cpodes->getNumNonlinSolvConvFails(&newNonlinConvFailures);
+            int newLinearIterations=0;
+            if (linearSolver == CPodesIntegrator::KrylovLinearSolver)
+                cpodes->spilsGetNumLinIters(&newLinearIterations);
             statsStepsTaken += newSteps-oldSteps;
             statsErrorTestFailures += newTestFailures-oldTestFailures;
             // Project stats were already updated in project() above.
             statsIterations += newNonlinIterations-oldNonlinIterations;
+            // The Krylov solver zeroes its count when it is reinitialized
+            // during the first step after a reInit(), rather than in
+            // reInit() itself, so a decrease means the count started over.
+            statsLinearIterations += newLinearIterations >= oldLinearIterations
+                ? newLinearIterations-oldLinearIterations : newLinearIterations;
             statsConvergenceTestFailures += newNonlinConvFailures-oldNonlinConvFailures;
  
             // This takes care of prescribed motion.
@@ -614,6 +732,7 @@ void CPodesIntegratorRep::resetMethodStatistics() {
     statsErrorTestFailures = 0;
     statsConvergenceTestFailures = 0;
     statsIterations = 0;
+    statsLinearIterations = 0;
 }
 
 const char* CPodesIntegratorRep::getMethodName() const {
@@ -639,6 +758,26 @@ void CPodesIntegratorRep::setUseCPodesProjection() {
     useCpodesProjection = true;
 }
 
+void CPodesIntegratorRep::setLinearSolver
+   (CPodesIntegrator::LinearSolverType type, int upper, int lower, 
+    int maxKrylovDim) {
+    SimTK_APIARGCHECK_ALWAYS(!initialized, "CPodesIntegrator", 
+        "setUse...LinearSolver",
+        "This method may not be invoked after the integrator has been initialized.");
+    linearSolver = type;
+    upperBandwidth = upper;
+    lowerBandwidth = lower;
+    maxKrylovDimension = maxKrylovDim;
+}
+
+void CPodesIntegratorRep::setJacobianTimesVector
+   (const CPodesIntegrator::JacobianTimesVector* jtv) {
+    SimTK_APIARGCHECK_ALWAYS(!initialized, "CPodesIntegrator", 
+        "setJacobianTimesVector",
+        "This method may not be invoked after the integrator has been initialized.");
+    jacobianTimesVector = jtv;
+}
+
 void CPodesIntegratorRep::setOrderLimit(int order) {
     cpodes->setMaxOrd(order);
 }
@@ -27,6 +27,7 @@
 #include "SimTKcommon.h"
 #include "simmath/internal/common.h"
 #include "simmath/Integrator.h"
+#include "simmath/CPodesIntegrator.h"
 #include "simmath/internal/SimTKcpodes.h"
 
 #include "IntegratorRep.h"
@@ -56,6 +57,7 @@ public:
     int getNumIterations() const override;
     void resetMethodStatistics() override;
     void createInterpolatedState(Real t);
+    void interpolateMany(const Array_<Real>& times, Matrix& y) override;
     void initializeIntegrationParameters();
     void reconstructForNewModel();
     const char* getMethodName() const override;
@@ -64,6 +66,10 @@ public:
     bool methodHasErrorControl() const override;
     void setUseCPodesProjection();
     void setOrderLimit(int order);
+    void setLinearSolver(CPodesIntegrator::LinearSolverType type,
+                         int upper, int lower, int maxKrylovDim);
+    void setJacobianTimesVector
+       (const CPodesIntegrator::JacobianTimesVector* jtv);
     class CPodesSystemImpl;
     friend class CPodesSystemImpl;
 private:
@@ -75,7 +81,13 @@ private:
     int pendingReturnCode;
     Real previousStartTime, previousTimeReturned;
     Vector savedY;
+    Vector stepYOut, stepYPOut; // CPodes::step() outputs, reused each step
     CPodes::LinearMultistepMethod method;
+    CPodesIntegrator::LinearSolverType linearSolver;
+    int upperBandwidth, lowerBandwidth, maxKrylovDimension;
+    const CPodesIntegrator::JacobianTimesVector* jacobianTimesVector;
+    int statsLinearIterations;
+    friend class CPodesIntegrator;
     void init(CPodes::LinearMultistepMethod method, CPodes::NonlinearSystemIterationType iterationType);
 };
 
@@ -0,0 +1,207 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/** @file
+ * This is the private (library side) implementation of the Simmath
+ * EnsembleIntegrator class.
+ */
+
+#include "SimTKcommon.h"
+#include "simmath/EnsembleIntegrator.h"
+#include "simmath/RungeKuttaMersonIntegrator.h"
+
+#include "EnsembleIntegratorRep.h"
+
+#include <exception>
+#include <mutex>
+
+namespace SimTK {
+
+    ///////////////////////////////////////////
+    // IMPLEMENTATION OF ENSEMBLE INTEGRATOR //
+    ///////////////////////////////////////////
+
+EnsembleIntegrator::EnsembleIntegrator(const System& system) {
+    rep = new EnsembleIntegratorRep(this, system);
+    setIntegratorType<RungeKuttaMersonIntegrator>();
+}
+
+EnsembleIntegrator::~EnsembleIntegrator() {
+    if (rep && rep->myHandle==this)
+        delete rep;
+    rep = 0;
+}
+
+void EnsembleIntegrator::setIntegratorCreator(IntegratorCreator creator) {
+    rep->creator = creator;
+}
+
+void EnsembleIntegrator::setAccuracy(Real accuracy) {
+    SimTK_APIARGCHECK1_ALWAYS(accuracy > 0, "EnsembleIntegrator",
+        "setAccuracy", "The accuracy must be positive but was %g.", accuracy);
+    rep->accuracy = accuracy;
+}
+Real EnsembleIntegrator::getAccuracy() const {return rep->accuracy;}
+
+void EnsembleIntegrator::setNumThreads(int numThreads) {
+    SimTK_APIARGCHECK_ALWAYS(numThreads >= 0, "EnsembleIntegrator",
+        "setNumThreads", "Number of threads must be nonnegative.");
+    rep->numThreads = numThreads;
+}
+int EnsembleIntegrator::getNumThreads() const {return rep->numThreads;}
+
+void EnsembleIntegrator::initialize(const Array_<State>& initStates) {
+    rep->initialize(initStates);
+}
+
+void EnsembleIntegrator::stepTo(Real time) {
+    rep->stepTo(time);
+}
+
+int EnsembleIntegrator::getNumMembers() const {return rep->getNumMembers();}
+
+const State& EnsembleIntegrator::getState(int member) const {
+    return rep->getMember(member).integ->getState();
+}
+
+bool EnsembleIntegrator::isTerminated(int member) const {
+    return rep->getMember(member).terminated;
+}
+
+const Integrator& EnsembleIntegrator::getIntegrator(int member) const {
+    return *rep->getMember(member).integ;
+}
+
+Integrator& EnsembleIntegrator::updIntegrator(int member) {
+    return *rep->updMember(member).integ;
+}
+
+void EnsembleIntegrator::getContinuousStates(Matrix& y) const {
+    rep->getContinuousStates(y);
+}
+
+
+
+    /////////////////////////////
+    // ENSEMBLE INTEGRATOR REP //
+    /////////////////////////////
+
+EnsembleIntegratorRep::EnsembleIntegratorRep
+   (EnsembleIntegrator* handle, const System& system)
+:   myHandle(handle), system(system), creator(nullptr), accuracy(1e-3),
+    numThreads(0), membersCreator(nullptr) {}
+
+void EnsembleIntegratorRep::initialize(const Array_<State>& initStates) {
+    if (initStates.size() != members.size() || membersCreator != creator) {
+        members.clear();
+        members.resize(initStates.size());
+        membersCreator = creator;
+    }
+
+    for (unsigned i=0; i < initStates.size(); ++i) {
+        Member& m = members[i];
+        if (!m.integ) {
+            m.integ.reset(creator(system));
+            m.stepper.reset(new TimeStepper(system, *m.integ));
+        }
+        m.integ->setAccuracy(accuracy);
+        m.stepper->initialize(initStates[i]);
+        m.terminated = m.integ->isSimulationOver();
+    }
+}
+
+namespace {
+// Advance one member of the ensemble per execute() index. ParallelExecutor
+// swallows exceptions on worker threads, so we remember the first one for
+// rethrowing.
+class StepToTask : public ParallelExecutor::Task {
+public:
+    typedef EnsembleIntegratorRep::Member Member;
+    StepToTask(std::vector<Member>& members, Real time)
+    :   members(members), time(time) {}
+
+    void execute(int i) override {
+        Member& m = members[i];
+        if (m.terminated)
+            return;
+        try {
+            // The TimeStepper returns early only when the member's
+            // simulation is over.
+            m.stepper->stepTo(time);
+            m.terminated = m.integ->isSimulationOver();
+        } catch (...) {
+            m.terminated = true;
+            std::lock_guard<std::mutex> lock(errorLock);
+            if (!firstError) firstError = std::current_exception();
+        }
+    }
+
+    void rethrowFirstError() const {
+        if (firstError) std::rethrow_exception(firstError);
+    }
+private:
+    std::vector<Member>&    members;
+    const Real              time;
+    std::mutex              errorLock;
+    std::exception_ptr      firstError;
+};
+}
+
+void EnsembleIntegratorRep::stepTo(Real time) {
+    StepToTask task(members, time);
+    if (numThreads == 1) {
+        executor.reset();
+        for (int i=0; i < getNumMembers(); ++i)
+            task.execute(i);
+        task.rethrowFirstError();
+        return;
+    }
+
+    // By default use the shared executor so that ensembles draw on the same
+    // thread budget as everything else.
+    if (numThreads == 0)
+        executor.reset();
+    else if (executor.empty() || executor->getMaxThreads() != numThreads)
+        executor = new ParallelExecutor(numThreads);
+    ParallelExecutor& exec = executor.empty()
+        ? ParallelExecutor::getSharedExecutor() : executor.updRef();
+
+    exec.execute(task, getNumMembers());
+    task.rethrowFirstError();
+}
+
+void EnsembleIntegratorRep::getContinuousStates(Matrix& y) const {
+    const int nm = getNumMembers();
+    const int ny = nm ? members[0].integ->getState().getNY() : 0;
+    y.resize(nm, ny);
+    for (int i=0; i < nm; ++i) {
+        const Vector& yi = members[i].integ->getState().getY();
+        SimTK_ERRCHK3_ALWAYS(yi.size() == ny,
+            "EnsembleIntegrator::getContinuousStates()",
+            "Member %d has %d continuous state variables but member 0 has "
+            "%d; they must all be the same.", i, yi.size(), ny);
+        y[i] = ~yi;
+    }
+}
+
+} // namespace SimTK
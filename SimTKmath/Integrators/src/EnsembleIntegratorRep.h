@@ -0,0 +1,101 @@
+#ifndef SimTK_SIMMATH_ENSEMBLE_INTEGRATOR_REP_H_
+#define SimTK_SIMMATH_ENSEMBLE_INTEGRATOR_REP_H_
+
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/** @file
+ * This is the declaration of the EnsembleIntegratorRep class which
+ * represents the implementation of the EnsembleIntegrator class.
+ */
+
+#include "SimTKcommon.h"
+
+#include "simmath/Integrator.h"
+#include "simmath/TimeStepper.h"
+#include "simmath/EnsembleIntegrator.h"
+
+#include <memory>
+#include <vector>
+
+namespace SimTK {
+
+    ///////////////////////////////////
+    // CLASS ENSEMBLE INTEGRATOR REP //
+    ///////////////////////////////////
+
+class EnsembleIntegratorRep {
+public:
+    // One member has its own Integrator, which holds its State, and the
+    // TimeStepper that handles its events. These are reused by later runs
+    // with the same number of members and the same kind of Integrator.
+    struct Member {
+        std::unique_ptr<Integrator>  integ;
+        std::unique_ptr<TimeStepper> stepper;
+        bool                         terminated = false;
+    };
+
+    EnsembleIntegratorRep(EnsembleIntegrator* handle, const System& system);
+    // default destructor, no default constructor, no copy or copy assign
+
+    void initialize(const Array_<State>& initStates);
+    void stepTo(Real time);
+    void getContinuousStates(Matrix& y) const;
+
+    int getNumMembers() const {return (int)members.size();}
+    const Member& getMember(int i) const {
+        SimTK_INDEXCHECK_ALWAYS(i, getNumMembers(),
+                                "EnsembleIntegrator::getMember()");
+        return members[i];
+    }
+    Member& updMember(int i) {
+        SimTK_INDEXCHECK_ALWAYS(i, getNumMembers(),
+                                "EnsembleIntegrator::updMember()");
+        return members[i];
+    }
+
+private:
+    EnsembleIntegrator* myHandle;
+    friend class EnsembleIntegrator;
+
+    const System&                       system;
+    EnsembleIntegrator::IntegratorCreator creator;
+    Real                                accuracy;
+    int                                 numThreads;
+
+    // The members of the current run, and the creator that was used for
+    // their Integrators.
+    std::vector<Member>                 members;
+    EnsembleIntegrator::IntegratorCreator membersCreator;
+
+    // Allocated on first use and replaced if the number of threads changes.
+    ClonePtr<ParallelExecutor>          executor;
+
+    // suppress
+    EnsembleIntegratorRep(const EnsembleIntegratorRep&);
+    EnsembleIntegratorRep& operator=(const EnsembleIntegratorRep&);
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SIMMATH_ENSEMBLE_INTEGRATOR_REP_H_
@@ -136,7 +136,7 @@ bool ExplicitEulerIntegratorRep::attemptDAEStep
 
     // Take the step.
     advanced.updTime() = t1;
-    advanced.updY()    = getPreviousY() + h*getPreviousYDot();
+    setToScaledSum(advanced.updY(), getPreviousY(), h, getPreviousYDot());
     yErrEst = advanced.getY(); // save unprojected Y for error estimate
 
     system.realize(advanced, Stage::Time);
@@ -147,9 +147,9 @@ bool ExplicitEulerIntegratorRep::attemptDAEStep
     // projection prior to calculating prescribed u's since the prescription
     // can depend on q's. Prevent project() from throwing an exception since
     // failure here may be recoverable.
-    Vector dummy; // no error estimate to project
+    // No error estimate to project.
     bool anyChanges;
-    if (!localProjectQAndQErrEstNoThrow(advanced, dummy, anyChanges))
+    if (!localProjectQAndQErrEstNoThrow(advanced, dummyErrEst, anyChanges))
         return false; // convergence failure for this step
 
     // q's satisfy the position constraint manifold. Now work on u's.
@@ -161,7 +161,7 @@ bool ExplicitEulerIntegratorRep::attemptDAEStep
     // velocity constraints are already satisfied unless user has set the
     // ForceProjection option.
 
-    if (!localProjectUAndUErrEstNoThrow(advanced, dummy, anyChanges))
+    if (!localProjectUAndUErrEstNoThrow(advanced, dummyErrEst, anyChanges))
         return false; // convergence failure for this step
 
     // Now calculate derivatives at the end of this interval/start of next
@@ -173,7 +173,11 @@ bool ExplicitEulerIntegratorRep::attemptDAEStep
     // it to estimate error.
     //TODO: this is an odd mix of the unprojected Y and the projected YDot;
     //probably not right!
-    yErrEst -= getPreviousY() + (h/2)*(getPreviousYDot()+advanced.getYDot());
+    const Vector& y0 = getPreviousY();
+    const Vector& f0 = getPreviousYDot();
+    const Vector& f1 = advanced.getYDot();
+    for (int i=0; i < yErrEst.size(); ++i)
+        yErrEst[i] -= y0[i] + (h/2)*(f0[i]+f1[i]);
     errOrder = 2;
     numIterations = 1;
     return true;
@@ -167,6 +167,10 @@ State& Integrator::updAdvancedState() {
     return updRep().updAdvancedState();
 }
 
+void Integrator::interpolateMany(const Array_<Real>& times, Matrix& y) {
+    updRep().interpolateMany(times, y);
+}
+
 
 Real Integrator::getAccuracyInUse() const {
     return getRep().getAccuracyInUse();
@@ -232,6 +236,9 @@ int Integrator::getNumDivergentIterations() const {
 int Integrator::getNumIterations() const {
     return getRep().getNumIterations();
 }
+const Array_<int>& Integrator::getStepLimitingErrorCounts() const {
+    return getRep().getStepLimitingErrorCounts();
+}
 
 void Integrator::setFinalTime(Real tFinal) {
     assert(tFinal == -1. || (0. <= tFinal));
@@ -279,9 +286,20 @@ void Integrator::setUseInfinityNorm(bool useInfinityNorm) {
 bool Integrator::isInfinityNormInUse() const
 {   return getRep().userUseInfinityNorm == 1; }
 
+void Integrator::setStepController(StepController controller) {
+    updRep().userStepController = controller;
+}
+Integrator::StepController Integrator::getStepController() const
+{   return getRep().userStepController; }
+
 void Integrator::setForceFullNewton(bool forceFullNewton) {
     updRep().userForceFullNewton = forceFullNewton ? 1 : 0;
 }
+void Integrator::setLocalizeEventsAtTriggerStage(bool localizeAtTriggerStage) {
+    updRep().userLocalizeEventsAtTriggerStage = localizeAtTriggerStage ? 1 : 0;
+}
+bool Integrator::getLocalizeEventsAtTriggerStage() const
+{   return getRep().userLocalizeEventsAtTriggerStage != 0; }
 void Integrator::setReturnEveryInternalStep(bool shouldReturn) {
     updRep().userReturnEveryInternalStep = shouldReturn ? 1 : 0;
 }
@@ -278,6 +278,14 @@ public:
     virtual void resetMethodStatistics() {
     }
 
+    // Set the columns of y to the continuous state variables at each of the
+    // given times, which must lie within the most recent internal step, 
+    // without realizing anything. Methods that support this must override it.
+    virtual void interpolateMany(const Array_<Real>& times, Matrix& y) {
+        SimTK_ERRCHK1_ALWAYS(!"unsupported", "Integrator::interpolateMany()",
+            "The %s integrator doesn't support this.", getMethodName());
+    }
+
     // Cubic Hermite interpolation. See Hairer, et al. Solving ODEs I, 2nd rev.
     // ed., pg 190. Given (t0,y0,y0'),(t1,y1,y1') with y0 and y1 at least 3rd 
     // order accurate, we can obtain a 3rd order accurate interpolation yt for
@@ -442,6 +450,22 @@ public:
         }
     }
     
+    // Return the highest Stage of any of the given event triggers; that is
+    // the stage through which a State must be realized to evaluate them.
+    // Returns Stage::Empty if the list is empty.
+    static Stage findHighestTriggerStage
+       (const State& s, const Array_<SystemEventTriggerIndex>& triggers)
+    {
+        for (Stage g = Stage::HighestRuntime; g >= Stage::LowestRuntime;
+             g = g.prev())
+        {   const int start = s.getEventTriggerStartByStage(g);
+            const int end = start + s.getNEventTriggersByStage(g);
+            for (SystemEventTriggerIndex e : triggers)
+                if (start <= e && e < end) return g;
+        }
+        return Stage::Empty;
+    }
+
     /// Given a list of events, specified by their indices in the list of trigger functions,
     /// convert them to the corresponding event IDs.
     void findEventIds(const Array_<SystemEventTriggerIndex>& indices, Array_<EventId>& ids) {
@@ -453,24 +477,23 @@ public:
     // was dominant.
     Real calcErrorNorm(const State& s, const Vector& yErrEst, 
                        int& worstY) const {
-        const int nq=s.getNQ(), nu=s.getNU(), nz=s.getNZ();
+        const int nq=s.getNQ(), nu=s.getNU();
+        const bool useInfNorm = (userUseInfinityNorm == 1);
         int worstQ, worstU, worstZ;
         Real qNorm, uNorm, zNorm, maxNorm;
-        if (userUseInfinityNorm == 1) {
-            qNorm = calcWeightedInfNormQ(s, s.getUWeights(), yErrEst(0,nq),
-                                         worstQ);
-            uNorm = calcWeightedInfNorm(getPreviousUScale(), yErrEst(nq,nu),
-                                        worstU);
-            zNorm = calcWeightedInfNorm(getPreviousZScale(), yErrEst(nq+nu,nz),
-                                        worstZ);
-        } else {
-            qNorm = calcWeightedRMSNormQ(s, s.getUWeights(), yErrEst(0,nq),
-                                         worstQ);
-            uNorm = calcWeightedRMSNorm(getPreviousUScale(), yErrEst(nq,nu),
-                                        worstU);
-            zNorm = calcWeightedRMSNorm(getPreviousZScale(), yErrEst(nq+nu,nz),
-                                        worstZ);
-        }
+
+        // This is called for every step attempt so must not allocate; the
+        // u and z parts are measured in place rather than through views.
+        qErrEstTemp.resize(nq);
+        for (int i=0; i < nq; ++i)
+            qErrEstTemp[i] = yErrEst[i];
+        qNorm = useInfNorm
+            ? calcWeightedInfNormQ(s, s.getUWeights(), qErrEstTemp, worstQ)
+            : calcWeightedRMSNormQ(s, s.getUWeights(), qErrEstTemp, worstQ);
+        uNorm = calcWeightedNormOfSegment(useInfNorm, getPreviousUScale(),
+                                          yErrEst, nq, worstU);
+        zNorm = calcWeightedNormOfSegment(useInfNorm, getPreviousZScale(),
+                                          yErrEst, nq+nu, worstZ);
 
         // Find the largest of the three norms and report the corresponding
         // worst offender within q, u, or z.
@@ -507,17 +530,18 @@ public:
         assert(Wu.size() == nu);
         dqw.resize(nq);
         if (nq==0) return;
-        Vector du(nu);
+        Vector& du = scaleDQTemp;
+        du.resize(nu);
         system.multiplyByNPInv(state, dq, du);
-        du.rowScaleInPlace(Wu);
+        for (int i=0; i < nu; ++i) // du.rowScaleInPlace(Wu) makes a view
+            du[i] *= Wu[i];
         system.multiplyByN(state, du, dqw);
     }
     // Calculate |Wq*dq|_RMS=|N*Wu*pinv(N)*dq|_RMS
     Real calcWeightedRMSNormQ(const State& state, const Vector& Wu,
                               const Vector& dq, int& worstQ) const
     {
-        const int nq = state.getNQ();
-        Vector dqw(nq);
+        Vector& dqw = weightedDQTemp;
         scaleDQ(state, Wu, dq, dqw);
         return dqw.normRMS(&worstQ);
     }
@@ -525,8 +549,7 @@ public:
     Real calcWeightedInfNormQ(const State& state, const Vector& Wu,
                               const Vector& dq, int& worstQ) const
     {
-        const int nq = state.getNQ();
-        Vector dqw(nq);
+        Vector& dqw = weightedDQTemp;
         scaleDQ(state, Wu, dq, dqw);
         return dqw.normInf(&worstQ);
     }
@@ -542,6 +565,71 @@ public:
         return values.weightedNormInf(weights, &worstOne);
     }
 
+    // Same as the above but for the weights.size() elements of values starting
+    // at values[start], and without creating a view since that would allocate
+    // heap memory. worstOne is relative to start, or -1 if there are none.
+    static Real calcWeightedNormOfSegment(bool useInfNorm, 
+                                          const Vector& weights,
+                                          const Vector& values, int start,
+                                          int& worstOne) {
+        const int n = weights.size();
+        assert(start >= 0 && start+n <= values.size());
+        worstOne = n ? 0 : -1;
+        Real maxabs = 0, sumsq = 0;
+        for (int i=0; i < n; ++i) {
+            const Real wv = std::abs(weights[i]*values[start+i]);
+            if (wv > maxabs) maxabs=wv, worstOne=i;
+            sumsq += wv*wv;
+        }
+        if (n == 0) return 0;
+        return useInfNorm ? maxabs : std::sqrt(sumsq/n);
+    }
+
+    // Elementwise updates for use by the step methods. Unlike the equivalent
+    // Vector expressions these don't create temporaries, so they don't
+    // allocate heap memory once the result has the right size. The result
+    // may be the same Vector as one of the operands.
+
+    // y = x + c*v
+    static void setToScaledSum(Vector& y, const Vector& x, Real c, 
+                               const Vector& v) {
+        assert(v.size() == x.size());
+        y.resize(x.size());
+        for (int i=0; i < x.size(); ++i)
+            y[i] = x[i] + c*v[i];
+    }
+    // y += c*v
+    static void addScaled(Vector& y, Real c, const Vector& v) {
+        assert(v.size() == y.size());
+        for (int i=0; i < y.size(); ++i)
+            y[i] += c*v[i];
+    }
+    // The a.size() elements of y starting at y[start] = a - b
+    static void setSegmentToDifference(Vector& y, int start, const Vector& a,
+                                       const Vector& b) {
+        assert(b.size() == a.size() && start+a.size() <= y.size());
+        for (int i=0; i < a.size(); ++i)
+            y[start+i] = a[i] - b[i];
+    }
+    // Return the 2-norm of a - b.
+    static Real calcNormOfDifference(const Vector& a, const Vector& b) {
+        assert(b.size() == a.size());
+        Real sumsq = 0;
+        for (int i=0; i < a.size(); ++i)
+            sumsq += square(a[i] - b[i]);
+        return std::sqrt(sumsq);
+    }
+
+    // Make view refer to the n elements of v starting at v[start]. Creating
+    // a view allocates heap memory so this is done only if view doesn't
+    // already refer to exactly those elements; step-by-step code can then
+    // keep views of its persistent temporaries without any cost.
+    static void updSegmentView(Vector& view, Vector& v, int start, int n) {
+        if (view.size() == n && (n == 0 || &view[0] == &v[start]))
+            return;
+        view.viewAssign(v(start, n));
+    }
+
     virtual const char* getMethodName() const = 0;
     virtual int getMethodMinOrder() const = 0;
     virtual int getMethodMaxOrder() const = 0;
@@ -635,6 +723,12 @@ protected:
 
     const Vector& getPreviousEventTriggers() const {return triggersPrev;}
 
+    // Whether the continuous extension of the most recent step is up to date;
+    // see interpolateMany().
+    bool isDenseOutputCurrent() const {return denseOutputIsCurrent;}
+    void setDenseOutputIsCurrent(bool current) 
+    {   denseOutputIsCurrent = current; }
+
     Array_<EventTriggerInfo>& updEventTriggerInfo() {return eventTriggerInfo;}
 
     // Given an array of state variables v (either u or z) and corresponding
@@ -663,11 +757,12 @@ protected:
         const int nq = s.getNQ(), nu = s.getNU(), nz = s.getNZ();
 
         tPrev        = s.getTime();
+        denseOutputIsCurrent = false;
 
         yPrev        = s.getY();
-        qPrev.viewAssign(yPrev(0,     nq));
-        uPrev.viewAssign(yPrev(nq,    nu));
-        zPrev.viewAssign(yPrev(nq+nu, nz));
+        updSegmentView(qPrev, yPrev, 0,     nq);
+        updSegmentView(uPrev, yPrev, nq,    nu);
+        updSegmentView(zPrev, yPrev, nq+nu, nz);
 
         calcRelativeScaling(s.getU(), s.getUWeights(), uScalePrev); 
         calcRelativeScaling(s.getZ(), s.getZWeights(), zScalePrev);
@@ -682,9 +777,9 @@ protected:
         const int nq = s.getNQ(), nu = s.getNU(), nz = s.getNZ();
 
         ydotPrev     = s.getYDot();
-        qdotPrev.viewAssign(ydotPrev(0,     nq));
-        udotPrev.viewAssign(ydotPrev(nq,    nu));
-        zdotPrev.viewAssign(ydotPrev(nq+nu, nz));
+        updSegmentView(qdotPrev, ydotPrev, 0,     nq);
+        updSegmentView(udotPrev, ydotPrev, nq,    nu);
+        updSegmentView(zdotPrev, ydotPrev, nq+nu, nz);
 
         qdotdotPrev  = s.getQDotDot();
         triggersPrev = s.getEventTriggers();
@@ -711,6 +806,9 @@ protected:
     int  userAllowInterpolation;        //      "
     int  userProjectInterpolatedStates; //      "
     int  userForceFullNewton;           //      "
+    int  userLocalizeEventsAtTriggerStage; //   "
+
+    Integrator::StepController userStepController;
 
     // Mark all user-supplied options "not supplied by user".
     void initializeUserStuff() {
@@ -722,7 +820,10 @@ protected:
         // booleans
         userUseInfinityNorm = userReturnEveryInternalStep = 
             userProjectEveryStep = userAllowInterpolation = 
-            userProjectInterpolatedStates = userForceFullNewton = -1;
+            userProjectInterpolatedStates = userForceFullNewton = 
+            userLocalizeEventsAtTriggerStage = -1;
+
+        userStepController = Integrator::ElementaryController;
 
         accuracyInUse = NaN;
         consTol  = NaN;
@@ -787,8 +888,8 @@ protected:
         // Nothing happens here if position constraints were already satisfied
         // unless we set the ForceProjection option above.
         if (yErrEst.size()) {
-            VectorView qErrEst = yErrEst(0, s.getNQ());
-            getSystem().projectQ(s, qErrEst, options, results);
+            updSegmentView(qErrEstView, yErrEst, 0, s.getNQ());
+            getSystem().projectQ(s, qErrEstView, options, results);
         } else {
             getSystem().projectQ(s, yErrEst, options, results);
         }
@@ -830,8 +931,8 @@ protected:
         // Nothing happens here if velocity constraints were already satisfied
         // unless we set the ForceProjection option above.
         if (yErrEst.size()) {
-            VectorView uErrEst = yErrEst(s.getNQ(), s.getNU());
-            getSystem().projectU(s, uErrEst, options, results);
+            updSegmentView(uErrEstView, yErrEst, s.getNQ(), s.getNU());
+            getSystem().projectU(s, uErrEstView, options, results);
         } else {
             getSystem().projectU(s, yErrEst, options, results);
         }
@@ -939,6 +1040,7 @@ protected:
         statsQProjections = statsUProjections = 0;
         statsRealizationFailures = 0;
         statsQProjectionFailures = statsUProjectionFailures = 0;
+        statsStepLimitingErrorCounts.clear();
     }
 
     int getNumRealizations() const {return statsRealizations;} 
@@ -949,6 +1051,9 @@ protected:
     int getNumQProjectionFailures() const {return statsQProjectionFailures;} 
     int getNumUProjectionFailures() const {return statsUProjectionFailures;} 
 
+    const Array_<int>& getStepLimitingErrorCounts() const
+    {   return statsStepLimitingErrorCounts; }
+
 private:
     class EventSorter {
     public:
@@ -1004,6 +1109,9 @@ protected:
     mutable int statsQProjections, statsUProjections;
     mutable int statsRealizations;
     mutable int statsRealizationFailures;
+    // Error-controlled methods should bump the element of the worst y after
+    // each error test; see Integrator::getStepLimitingErrorCounts().
+    Array_<int> statsStepLimitingErrorCounts;
 private:
 
         // SYSTEM INFORMATION
@@ -1091,6 +1199,11 @@ private:
     Real    tPrev;
     Vector  yPrev;
 
+    // Methods that keep a continuous extension of the most recent step (see
+    // interpolateMany()) use this to know when it must be recalculated; it is
+    // cleared whenever a new step begins.
+    bool    denseOutputIsCurrent = false;
+
     // These combine weightings from the Prev state with the possible
     // requirement of relative accuracy using the current values of u and z.
     // The result is min( wxi, 1/|xi|) for the relative ones where wxi is
@@ -1109,6 +1222,12 @@ private:
     Vector qPrev, uPrev, zPrev;
     Vector qdotPrev, udotPrev, zdotPrev;
 
+    // Temporaries for the error norm and local projections, kept here so
+    // that taking a step doesn't allocate once these have been sized. The
+    // views refer to the most recent error estimate that was projected.
+    mutable Vector qErrEstTemp, scaleDQTemp, weightedDQTemp;
+    Vector qErrEstView, uErrEstView;
+
     // We'll leave the various arrays above sized as they are and full
     // of garbage. They'll be resized when first assigned to something
     // meaningful.
@@ -1119,6 +1238,7 @@ private:
         tLow = tHigh            = NaN;
         useInterpolatedState    = false;
         tPrev                   = NaN;
+        denseOutputIsCurrent    = false;
     }
 
     // suppress
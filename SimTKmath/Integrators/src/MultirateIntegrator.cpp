@@ -0,0 +1,225 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+/** @file
+ * This is the private (library side) implementation of the 
+ * MultirateIntegrator and MultirateIntegratorRep classes.
+ */
+
+#include "SimTKcommon.h"
+#include "simmath/Integrator.h"
+#include "simmath/MultirateIntegrator.h"
+
+#include "IntegratorRep.h"
+#include "MultirateIntegratorRep.h"
+
+#include <cmath>
+
+using namespace SimTK;
+
+//------------------------------------------------------------------------------
+//                          MULTIRATE INTEGRATOR
+//------------------------------------------------------------------------------
+
+MultirateIntegrator::MultirateIntegrator(const System& sys) 
+{
+    rep = new MultirateIntegratorRep(this, sys);
+}
+
+void MultirateIntegrator::addFastQ(QIndex q) {
+    dynamic_cast<MultirateIntegratorRep&>(*rep).addFastQ(q);
+}
+void MultirateIntegrator::addFastU(UIndex u) {
+    dynamic_cast<MultirateIntegratorRep&>(*rep).addFastU(u);
+}
+void MultirateIntegrator::addFastZ(ZIndex z) {
+    dynamic_cast<MultirateIntegratorRep&>(*rep).addFastZ(z);
+}
+void MultirateIntegrator::clearFastVariables() {
+    dynamic_cast<MultirateIntegratorRep&>(*rep).clearFastVariables();
+}
+
+void MultirateIntegrator::setFastDerivativeFunction
+   (FastDerivativeFunction* fastDerivs) {
+    dynamic_cast<MultirateIntegratorRep&>(*rep)
+        .setFastDerivativeFunction(fastDerivs);
+}
+bool MultirateIntegrator::hasFastDerivativeFunction() const {
+    return dynamic_cast<const MultirateIntegratorRep&>(*rep)
+        .hasFastDerivativeFunction();
+}
+
+void MultirateIntegrator::setNumSubsteps(int numSubsteps) {
+    SimTK_APIARGCHECK1_ALWAYS(numSubsteps >= 1, "MultirateIntegrator",
+        "setNumSubsteps", "The number of substeps must be at least 1 but "
+        "was %d.", numSubsteps);
+    dynamic_cast<MultirateIntegratorRep&>(*rep).setNumSubsteps(numSubsteps);
+}
+int MultirateIntegrator::getNumSubsteps() const {
+    return dynamic_cast<const MultirateIntegratorRep&>(*rep).getNumSubsteps();
+}
+
+//------------------------------------------------------------------------------
+//                        MULTIRATE INTEGRATOR REP
+//------------------------------------------------------------------------------
+
+MultirateIntegratorRep::MultirateIntegratorRep
+   (Integrator* handle, const System& sys) 
+:   AbstractIntegratorRep(handle, sys, 2, 2, "Multirate", true) {
+}
+
+void MultirateIntegratorRep::markFastVariables(const State& state) {
+    const int nq = state.getNQ(), nu = state.getNU(), nz = state.getNZ();
+    isFast.clear();
+    isFast.resize(state.getNY(), false);
+    numFast = 0;
+    for (QIndex q : fastQ) {
+        SimTK_ERRCHK2_ALWAYS(0 <= q && q < nq, 
+            "MultirateIntegrator::addFastQ()",
+            "QIndex %d is out of range; there are %d q's.", (int)q, nq);
+        if (!isFast[state.getQStart() + q]) ++numFast;
+        isFast[state.getQStart() + q] = true;
+    }
+    for (UIndex u : fastU) {
+        SimTK_ERRCHK2_ALWAYS(0 <= u && u < nu, 
+            "MultirateIntegrator::addFastU()",
+            "UIndex %d is out of range; there are %d u's.", (int)u, nu);
+        if (!isFast[state.getUStart() + u]) ++numFast;
+        isFast[state.getUStart() + u] = true;
+    }
+    for (ZIndex z : fastZ) {
+        SimTK_ERRCHK2_ALWAYS(0 <= z && z < nz, 
+            "MultirateIntegrator::addFastZ()",
+            "ZIndex %d is out of range; there are %d z's.", (int)z, nz);
+        if (!isFast[state.getZStart() + z]) ++numFast;
+        isFast[state.getZStart() + z] = true;
+    }
+}
+
+void MultirateIntegratorRep::calcSubstepDerivatives
+   (Real t, const Vector& y, Vector& ydot)
+{
+    if (!fastDerivs) {
+        setAdvancedStateAndRealizeDerivatives(t, y);
+        ydot = getAdvancedState().getYDot();
+        return;
+    }
+    setAdvancedState(t, y);
+    getSystem().realize(getAdvancedState(), Stage::Time);
+    fastDerivs->calcFastDerivatives(getAdvancedState(), ydot);
+}
+
+// This is the "slowest first" multirate scheme of Gear & Wells, "Multirate
+// linear multistep methods", BIT 24:484-502, 1984, built on Heun's method.
+// With slow variables ys and fast ones yf, a step of size H from t0 is:
+//
+//  (1) Predict the slow variables with Euler's method, 
+//          ys(t) ~ ys0 + (t-t0)*fs0,  t0 <= t <= t1.
+//  (2) Take m Heun substeps of size h=H/m for the fast variables, setting the
+//      slow variables from that prediction at each stage.
+//  (3) Correct the slow variables with the trapezoid rule,
+//          ys1 = ys0 + (H/2)*(fs0 + fs1),
+//      where fs1 is evaluated at the end of the fast substeps.
+//
+// Both groups get an error estimate from the difference between Heun's and 
+// Euler's methods; for the fast variables these are summed over the 
+// substeps. Either way the estimate behaves as H^2. The first stage of the
+// first substep reuses f0 from the end of the last step, so the step costs 
+// 2m-1 substep evaluations and one full evaluation for fs1. The substep
+// evaluations are full ones too unless there is a FastDerivativeFunction.
+bool MultirateIntegratorRep::attemptODEStep
+   (Real t1, Vector& y1err, int& errOrder, int& numIterations)
+{
+    const Real t0 = getPreviousTime();
+    assert(t1 > t0);
+
+    statsStepsAttempted++;
+    errOrder = 2;
+    numIterations = 1;
+    const Vector& y0 = getPreviousY();
+    const Vector& f0 = getPreviousYDot();
+    const int ny = y0.size();
+    if (ytmp[0].size() != ny)
+        for (int i=0; i<NTemps; ++i)
+            ytmp[i].resize(ny);
+    // The fast variables might have been changed since the last step.
+    markFastVariables(getAdvancedState());
+    Vector& y  = ytmp[0]; // rename temps
+    Vector& yE = ytmp[1];
+    Vector& k1 = ytmp[2];
+    Vector& k2 = ytmp[3];
+
+    const Real H = t1-t0;
+    const int  m = numFast ? numSubsteps : 1;
+    const Real h = H/m;
+
+    // Slow variables along their Euler prediction at time t.
+    auto setSlow = [&](Real t, Vector& v) {
+        for (int i=0; i < ny; ++i)
+            if (!isFast[i]) v[i] = y0[i] + (t-t0)*f0[i];
+    };
+
+    y = y0;
+    y1err = 0;
+    k1 = f0;
+    for (int k=0; k < m; ++k) {
+        const Real tk = t0 + k*h, tk1 = (k+1 == m ? t1 : tk + h);
+        if (k > 0) {
+            setSlow(tk, y);
+            calcSubstepDerivatives(tk, y, k1);
+        }
+        setToScaledSum(yE, y, h, k1);
+        setSlow(tk1, yE);
+        if (numFast) calcSubstepDerivatives(tk1, yE, k2);
+        else { // need the full derivatives for the slow variables
+            setAdvancedStateAndRealizeDerivatives(tk1, yE);
+            k2 = getAdvancedState().getYDot();
+        }
+        for (int i=0; i < ny; ++i) {
+            if (isFast[i]) {
+                y[i] += (h/2)*(k1[i] + k2[i]);
+                y1err[i] += (h/2)*std::abs(k2[i] - k1[i]);
+            }
+        }
+    }
+
+    // With no fast variables the single substep's second stage was already
+    // at (t1, y0+H*f0); otherwise evaluate fs1 at the end of the substeps.
+    if (numFast) {
+        setSlow(t1, y);
+        setAdvancedStateAndRealizeDerivatives(t1, y);
+        k2 = getAdvancedState().getYDot();
+    }
+    for (int i=0; i < ny; ++i) {
+        if (!isFast[i]) {
+            y[i] = y0[i] + (H/2)*(f0[i] + k2[i]);
+            y1err[i] = (H/2)*std::abs(k2[i] - f0[i]);
+        }
+    }
+
+    // Evaluate through kinematics only; the caller will project and then
+    // evaluate derivatives at the final value.
+    setAdvancedStateAndRealizeKinematics(t1, y);
+    return true;
+}
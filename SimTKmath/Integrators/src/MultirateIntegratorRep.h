@@ -0,0 +1,80 @@
+#ifndef SimTK_SIMMATH_MULTIRATE_INTEGRATOR_REP_H_
+#define SimTK_SIMMATH_MULTIRATE_INTEGRATOR_REP_H_
+
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include "AbstractIntegratorRep.h"
+#include "simmath/MultirateIntegrator.h"
+
+#include <memory>
+
+namespace SimTK {
+
+/**
+ * This is the private (library side) implementation of the 
+ * MultirateIntegratorRep class which is a concrete class
+ * implementing the abstract IntegratorRep.
+ */
+
+class MultirateIntegratorRep : public AbstractIntegratorRep {
+public:
+    MultirateIntegratorRep(Integrator* handle, const System& sys);
+
+    void addFastQ(QIndex q) {fastQ.push_back(q);}
+    void addFastU(UIndex u) {fastU.push_back(u);}
+    void addFastZ(ZIndex z) {fastZ.push_back(z);}
+    void clearFastVariables() {fastQ.clear(); fastU.clear(); fastZ.clear();}
+
+    void setFastDerivativeFunction
+       (MultirateIntegrator::FastDerivativeFunction* f) {fastDerivs.reset(f);}
+    bool hasFastDerivativeFunction() const {return fastDerivs != nullptr;}
+
+    void setNumSubsteps(int n) {numSubsteps = n;}
+    int getNumSubsteps() const {return numSubsteps;}
+protected:
+    bool attemptODEStep
+       (Real t1, Vector& yErrEst, int& errOrder, int& numIterations) override;
+private:
+    // Fill isFast and numFast for the current state layout.
+    void markFastVariables(const State& state);
+    // Evaluate derivatives at (t,y) into ydot; only the fast entries are
+    // valid unless the whole System had to be realized.
+    void calcSubstepDerivatives(Real t, const Vector& y, Vector& ydot);
+
+    Array_<QIndex> fastQ;
+    Array_<UIndex> fastU;
+    Array_<ZIndex> fastZ;
+    int            numSubsteps = 10;
+    std::unique_ptr<MultirateIntegrator::FastDerivativeFunction> fastDerivs;
+
+    Array_<bool>   isFast;      // ny
+    int            numFast = 0;
+    static const int NTemps = 4;
+    Vector ytmp[NTemps];
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SIMMATH_MULTIRATE_INTEGRATOR_REP_H_
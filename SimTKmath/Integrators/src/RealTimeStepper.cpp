@@ -0,0 +1,187 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/** @file
+ * This is the private (library side) implementation of the Simmath
+ * RealTimeStepper class.
+ */
+
+#include "SimTKcommon.h"
+#include "simmath/RealTimeStepper.h"
+
+#include "RealTimeStepperRep.h"
+
+#include <algorithm>
+
+namespace SimTK {
+
+    /////////////////////////////////////////
+    // IMPLEMENTATION OF REAL TIME STEPPER //
+    /////////////////////////////////////////
+
+RealTimeStepper::RealTimeStepper(const System& system, Integrator& integ) {
+    rep = new RealTimeStepperRep(this, system, integ);
+}
+
+RealTimeStepper::~RealTimeStepper() {
+    if (rep && rep->myHandle==this)
+        delete rep;
+    rep = 0;
+}
+
+void RealTimeStepper::setStepSize(Real stepSize) {
+    SimTK_APIARGCHECK1_ALWAYS(stepSize > 0, "RealTimeStepper", "setStepSize",
+        "The step size must be positive but was %g.", stepSize);
+    rep->stepSize = stepSize;
+}
+Real RealTimeStepper::getStepSize() const {return rep->stepSize;}
+
+void RealTimeStepper::setDeadline(double deadlineInSec) {
+    SimTK_APIARGCHECK1_ALWAYS(deadlineInSec >= 0, "RealTimeStepper",
+        "setDeadline", "The deadline must be nonnegative but was %g.",
+        deadlineInSec);
+    rep->deadline = deadlineInSec;
+}
+double RealTimeStepper::getDeadline() const {return rep->getDeadlineInUse();}
+
+void RealTimeStepper::setPaceToRealTime(bool shouldPace)
+{   rep->paceToRealTime = shouldPace; }
+bool RealTimeStepper::getPaceToRealTime() const {return rep->paceToRealTime;}
+
+void RealTimeStepper::setNumWarmUpSteps(int numSteps) {
+    SimTK_APIARGCHECK1_ALWAYS(numSteps >= 0, "RealTimeStepper",
+        "setNumWarmUpSteps",
+        "The number of steps must be nonnegative but was %d.", numSteps);
+    rep->numWarmUpSteps = numSteps;
+}
+int RealTimeStepper::getNumWarmUpSteps() const {return rep->numWarmUpSteps;}
+
+void RealTimeStepper::setLatencyHistogramBins(double binWidthInSec,
+                                              int numBins) {
+    SimTK_APIARGCHECK2_ALWAYS(binWidthInSec > 0 && numBins > 0,
+        "RealTimeStepper", "setLatencyHistogramBins",
+        "The bin width and number of bins must be positive but were %g "
+        "and %d.", binWidthInSec, numBins);
+    rep->binWidth = rep->binWidthInUse = binWidthInSec;
+    rep->numBins = numBins;
+    rep->histogram.assign(numBins, 0);
+}
+
+void RealTimeStepper::initialize(const State& initState)
+{   rep->initialize(initState); }
+
+bool RealTimeStepper::step() {return rep->step();}
+
+const State& RealTimeStepper::getState() const
+{   return rep->integ.getState(); }
+bool RealTimeStepper::isSimulationOver() const
+{   return rep->integ.isSimulationOver(); }
+
+int RealTimeStepper::getNumSteps() const {return rep->numSteps;}
+int RealTimeStepper::getNumOverruns() const {return rep->numOverruns;}
+double RealTimeStepper::getLastLatency() const {return rep->lastLatency;}
+double RealTimeStepper::getMaxLatency() const {return rep->maxLatency;}
+double RealTimeStepper::getMeanLatency() const {
+    return rep->numMeasured ? rep->totalLatency/rep->numMeasured : 0.;
+}
+const Array_<int>& RealTimeStepper::getLatencyHistogram() const
+{   return rep->histogram; }
+double RealTimeStepper::getLatencyHistogramBinWidth() const
+{   return rep->binWidthInUse; }
+
+void RealTimeStepper::resetStatistics() {rep->resetStatistics();}
+
+
+
+    ///////////////////////////
+    // REAL TIME STEPPER REP //
+    ///////////////////////////
+
+RealTimeStepperRep::RealTimeStepperRep
+   (RealTimeStepper* handle, const System& system, Integrator& integrator)
+:   myHandle(handle), integ(integrator), stepper(system, integrator),
+    stepSize(Real(0.001)), deadline(0), paceToRealTime(false),
+    numWarmUpSteps(1), binWidth(0), numBins(100), tInitial(NaN),
+    nextWallTimeInNs(0), numSteps(0)
+{
+    binWidthInUse = 2*getDeadlineInUse()/numBins;
+    resetStatistics();
+}
+
+void RealTimeStepperRep::initialize(const State& initState) {
+    integ.setFixedStepSize(stepSize);
+    stepper.initialize(initState);
+    tInitial = integ.getTime();
+    nextWallTimeInNs = 0;
+
+    binWidthInUse = binWidth > 0 ? binWidth : 2*getDeadlineInUse()/numBins;
+    numSteps = 0;
+    resetStatistics();
+}
+
+void RealTimeStepperRep::resetStatistics() {
+    numMeasured = numOverruns = 0;
+    lastLatency = maxLatency = totalLatency = 0;
+    histogram.assign(numBins, 0);
+}
+
+bool RealTimeStepperRep::step() {
+    if (integ.isSimulationOver())
+        return true;
+
+    const long long startInNs = realTimeInNs();
+    stepper.stepTo(tInitial + (numSteps+1)*stepSize);
+    const long long endInNs = realTimeInNs();
+
+    ++numSteps;
+    lastLatency = nsToSec(endInNs - startInNs);
+    const bool metDeadline = lastLatency <= getDeadlineInUse();
+
+    if (numSteps > numWarmUpSteps) {
+        ++numMeasured;
+        totalLatency += lastLatency;
+        maxLatency = std::max(maxLatency, lastLatency);
+        if (!metDeadline)
+            ++numOverruns;
+        const int bin = std::min(int(lastLatency/binWidthInUse), numBins-1);
+        ++histogram[bin];
+    }
+
+    if (paceToRealTime) {
+        // Time the pacing from the start of the first step. If we have
+        // fallen behind there is nothing to wait for; we don't try to catch
+        // up by running faster, but we don't let the lag accumulate either.
+        if (nextWallTimeInNs == 0)
+            nextWallTimeInNs = startInNs;
+        nextWallTimeInNs += secToNs(stepSize);
+        const long long nowInNs = realTimeInNs();
+        if (nowInNs < nextWallTimeInNs)
+            sleepInNs(nextWallTimeInNs - nowInNs);
+        else
+            nextWallTimeInNs = nowInNs;
+    }
+
+    return metDeadline;
+}
+
+} // namespace SimTK
@@ -0,0 +1,91 @@
+#ifndef SimTK_SIMMATH_REAL_TIME_STEPPER_REP_H_
+#define SimTK_SIMMATH_REAL_TIME_STEPPER_REP_H_
+
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/** @file
+ * This is the declaration of the RealTimeStepperRep class which
+ * represents the implementation of the RealTimeStepper class.
+ */
+
+#include "SimTKcommon.h"
+
+#include "simmath/Integrator.h"
+#include "simmath/TimeStepper.h"
+#include "simmath/RealTimeStepper.h"
+
+namespace SimTK {
+
+    /////////////////////////////////
+    // CLASS REAL TIME STEPPER REP //
+    /////////////////////////////////
+
+class RealTimeStepperRep {
+public:
+    RealTimeStepperRep(RealTimeStepper* handle, const System& system,
+                       Integrator& integrator);
+    // default destructor, no default constructor, no copy or copy assign
+
+    void initialize(const State& initState);
+    bool step();
+    void resetStatistics();
+
+    double getDeadlineInUse() const 
+    {   return deadline > 0 ? deadline : double(stepSize); }
+
+private:
+    RealTimeStepper* myHandle;
+    friend class RealTimeStepper;
+
+    // The TimeStepper handles events; the Integrator holds the State.
+    Integrator&     integ;
+    TimeStepper     stepper;
+
+    // Options.
+    Real            stepSize;
+    double          deadline;       // 0 means use the step size
+    bool            paceToRealTime;
+    int             numWarmUpSteps;
+    double          binWidth;       // 0 means 1/numBins of twice the deadline
+    int             numBins;
+    double          binWidthInUse;
+
+    // Steps are taken to multiples of the step size from the initial time
+    // so that round off doesn't accumulate in the simulated time.
+    Real            tInitial;
+    long long       nextWallTimeInNs; // when pacing; 0 before the first step
+
+    // Statistics.
+    int             numSteps, numMeasured, numOverruns;
+    double          lastLatency, maxLatency, totalLatency;
+    Array_<int>     histogram;
+
+    // suppress
+    RealTimeStepperRep(const RealTimeStepperRep&);
+    RealTimeStepperRep& operator=(const RealTimeStepperRep&);
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SIMMATH_REAL_TIME_STEPPER_REP_H_
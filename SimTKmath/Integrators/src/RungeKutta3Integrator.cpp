@@ -96,13 +96,17 @@ bool RungeKutta3IntegratorRep::attemptODEStep
             ytmp[i].resize(y0.size());
     Vector& f1    = ytmp[0]; // rename temps
     Vector& f2    = ytmp[1];
+    Vector& ys    = ytmp[2]; // stage values of y, formed without temporaries
+    const int ny = y0.size();
 
     const Real h = t1-t0;
 
-    setAdvancedStateAndRealizeDerivatives(t0+h/2, y0 + (h/2)*f0);
+    for (int i=0; i<ny; ++i) ys[i] = y0[i] + (h/2)*f0[i];
+    setAdvancedStateAndRealizeDerivatives(t0+h/2, ys);
     f1 = getAdvancedState().getYDot();
 
-    setAdvancedStateAndRealizeDerivatives(t1,     y0 + h*(2*f1-f0));
+    for (int i=0; i<ny; ++i) ys[i] = y0[i] + h*(2*f1[i]-f0[i]);
+    setAdvancedStateAndRealizeDerivatives(t1,     ys);
     f2 = getAdvancedState().getYDot();
 
     // Final value. This is the 3rd order accurate estimate for 
@@ -110,7 +114,8 @@ bool RungeKutta3IntegratorRep::attemptODEStep
     // Evaluate through kinematics only; it is a waste of a stage to 
     // evaluate derivatives here since the caller will muck with this before
     // the end of the step.
-    setAdvancedStateAndRealizeKinematics(t1,      y0 + (h/6)*(f0 + 4*f1 + f2));
+    for (int i=0; i<ny; ++i) ys[i] = y0[i] + (h/6)*(f0[i] + 4*f1[i] + f2[i]);
+    setAdvancedStateAndRealizeKinematics(t1,      ys);
     // YErr is valid now
 
     // This is an embedded 2nd-order estimate y1hat=y(t1)+O(h^3), with
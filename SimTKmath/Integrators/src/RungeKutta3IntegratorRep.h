@@ -41,7 +41,7 @@ protected:
     bool attemptODEStep
        (Real t1, Vector& yErrEst, int& errOrder, int& numIterations) override;
 private:    
-    static const int NTemps = 2;
+    static const int NTemps = 3;
     Vector ytmp[NTemps];
 };
 
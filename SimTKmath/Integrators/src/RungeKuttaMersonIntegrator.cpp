@@ -83,6 +83,8 @@ RungeKuttaMersonIntegratorRep::RungeKuttaMersonIntegratorRep
 // 
 // We will call the derivatives at stage f1,f2,f3,f4 but these are done with 
 // only two temporaries fa and fb. (What we're calling "f" Hairer calls "k".)
+// The stage values of y are formed elementwise in another temporary rather
+// than with Vector expressions, which would allocate on every step.
 bool RungeKuttaMersonIntegratorRep::attemptODEStep
    (Real t1, Vector& y1err, int& errOrder, int& numIterations)
 {
@@ -99,20 +101,26 @@ bool RungeKuttaMersonIntegratorRep::attemptODEStep
     Vector& ysave = ytmp[0]; // rename temps
     Vector& fa    = ytmp[1];
     Vector& fb    = ytmp[2];
+    Vector& ys    = ytmp[3];
+    const int ny = y0.size();
 
     const Real h = t1-t0;
 
-    setAdvancedStateAndRealizeDerivatives(t0+h/3, y0 + (h/3)*f0);
+    for (int i=0; i<ny; ++i) ys[i] = y0[i] + (h/3)*f0[i];
+    setAdvancedStateAndRealizeDerivatives(t0+h/3, ys);
     fa = getAdvancedState().getYDot(); // fa=f1
 
-    setAdvancedStateAndRealizeDerivatives(t0+h/3, y0 + (h/6)*(f0+fa)); // f0+f1
+    for (int i=0; i<ny; ++i) ys[i] = y0[i] + (h/6)*(f0[i]+fa[i]); // f0+f1
+    setAdvancedStateAndRealizeDerivatives(t0+h/3, ys);
     fa = getAdvancedState().getYDot(); // fa=f2
 
-    setAdvancedStateAndRealizeDerivatives(t0+h/2, y0 + (h/8)*(f0 + 3*fa)); // f0+3f2
+    for (int i=0; i<ny; ++i) ys[i] = y0[i] + (h/8)*(f0[i] + 3*fa[i]); // f0+3f2
+    setAdvancedStateAndRealizeDerivatives(t0+h/2, ys);
     fb = getAdvancedState().getYDot(); // fb=f3
 
     // We'll need this for error estimation.
-    ysave = y0 + (h/2)*(f0 - 3*fa + 4*fb); // f0-3f2+4f3
+    for (int i=0; i<ny; ++i) // f0-3f2+4f3
+        ysave[i] = y0[i] + (h/2)*(f0[i] - 3*fa[i] + 4*fb[i]);
     setAdvancedStateAndRealizeDerivatives(t1, ysave);
     fa = getAdvancedState().getYDot(); // fa=f4
 
@@ -121,7 +129,8 @@ bool RungeKuttaMersonIntegratorRep::attemptODEStep
     // Evaluate through kinematics only; it is a waste of a stage to 
     // evaluate derivatives here since the caller will muck with this before
     // the end of the step.
-    setAdvancedStateAndRealizeKinematics(t1, y0 + (h/6)*(f0 + 4*fb + fa));
+    for (int i=0; i<ny; ++i) ys[i] = y0[i] + (h/6)*(f0[i] + 4*fb[i] + fa[i]);
+    setAdvancedStateAndRealizeKinematics(t1, ys);
     // YErr is valid now
 
     // This is an embedded 3rd-order estimate y1hat=y(t0+h)+O(h^4). (Apparently
@@ -0,0 +1,285 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+/** @file
+ * This is the private (library side) implementation of the 
+ * SDIRKIntegrator and SDIRKIntegratorRep classes.
+ */
+
+#include "SimTKcommon.h"
+#include "simmath/Integrator.h"
+#include "simmath/SDIRKIntegrator.h"
+
+#include "IntegratorRep.h"
+#include "SDIRKIntegratorRep.h"
+
+#include <cmath>
+
+using namespace SimTK;
+
+//------------------------------------------------------------------------------
+//                            SDIRK INTEGRATOR
+//------------------------------------------------------------------------------
+
+SDIRKIntegrator::SDIRKIntegrator(const System& sys) 
+{
+    rep = new SDIRKIntegratorRep(this, sys);
+}
+
+int SDIRKIntegrator::getNumJacobianEvaluations() const {
+    return dynamic_cast<const SDIRKIntegratorRep&>(*rep)
+                .getNumJacobianEvaluations();
+}
+
+void SDIRKIntegrator::setUseSystemJacobian(bool useSystemJacobian) {
+    dynamic_cast<SDIRKIntegratorRep&>(*rep)
+        .setUseSystemJacobian(useSystemJacobian);
+}
+
+bool SDIRKIntegrator::getUseSystemJacobian() const {
+    return dynamic_cast<const SDIRKIntegratorRep&>(*rep)
+                .getUseSystemJacobian();
+}
+
+int SDIRKIntegrator::getNumIterationMatrixFactorizations() const {
+    return dynamic_cast<const SDIRKIntegratorRep&>(*rep)
+                .getNumIterationMatrixFactorizations();
+}
+
+//------------------------------------------------------------------------------
+//                          SDIRK INTEGRATOR REP
+//------------------------------------------------------------------------------
+
+SDIRKIntegratorRep::SDIRKIntegratorRep(Integrator* handle, const System& sys) 
+:   AbstractIntegratorRep(handle, sys, 1, 2, "SDIRK", true) {
+}
+
+void SDIRKIntegratorRep::methodInitialize(const State& state) {
+    AbstractIntegratorRep::methodInitialize(state);
+    haveJacobian = false;
+    hgFactored = NaN;
+}
+
+// An event handler may have changed the state discontinuously, or even the
+// number of state variables, so start over with a new Jacobian.
+void SDIRKIntegratorRep::methodReinitialize(Stage stage, bool shouldTerminate) {
+    haveJacobian = false;
+    hgFactored = NaN;
+}
+
+void SDIRKIntegratorRep::resetMethodStatistics() {
+    AbstractIntegratorRep::resetMethodStatistics();
+    statsJacobianEvaluations = 0;
+    statsIterationMatrixFactorizations = 0;
+}
+
+// We are solving y' = f(t,y) with Alexander's 2-stage, 2nd order, L-stable
+// SDIRK method. With g = 1 - 1/sqrt(2) this is the Butcher diagram:
+//
+//           g|   g
+//           1| 1-g    g
+//          --|-------------
+//           1| 1-g    g        2nd order propagated solution
+//          --|-------------
+//           1|   1    0        1st order solution for error estimate
+//
+// The last stage value is the solution (the method is "stiffly accurate"),
+// so each step consists of two implicit stage solves
+//      Y = c + hg*f(t,Y)
+// done by Newton iteration with the iteration matrix W = I - hg*J, where J 
+// is an approximation to df/dy that need not be current. The raw error
+// estimate y1-y1hat = hg*(k2-k1) is unreliable for the stiff components, 
+// which would then force the small step sizes we're trying to avoid, so we 
+// filter it with W^-1 as recommended by Hairer & Wanner, Solving ODEs II, 
+// 2nd rev. ed., section IV.8.
+
+bool SDIRKIntegratorRep::attemptODEStep
+   (Real t1, Vector& y1err, int& errOrder, int& numIterations)
+{
+    const Real t0 = getPreviousTime();
+    assert(t1 > t0);
+
+    statsStepsAttempted++;
+    errOrder = 2;
+    numIterations = 0;
+    const Vector& y0 = getPreviousY();
+    const Vector& f0 = getPreviousYDot();
+    if (ytmp[0].size() != y0.size())
+        for (int i=0; i<NTemps; ++i)
+            ytmp[i].resize(y0.size());
+    Vector& Y  = ytmp[0]; // rename temps
+    Vector& c  = ytmp[1];
+    Vector& k1 = ytmp[2];
+    Vector& k2 = ytmp[3];
+    Vector& d  = ytmp[4];
+
+    const Real g  = 1 - 1/std::sqrt(Real(2));
+    const Real h  = t1-t0;
+    const Real hg = h*g;
+
+    if (!haveJacobian || (refreshJacobian && jacobianTime != t0))
+        calcJacobian();
+
+    while (true) {
+        factorIterationMatrix(hg);
+
+        int iters;
+        c = y0;
+        setToScaledSum(Y, y0, hg, f0);
+        bool converged = solveStage(t0+hg, c, hg, Y, k1, iters);
+        numIterations += iters;
+        if (converged) {
+            setToScaledSum(c, y0, h-hg, k1);
+            setToScaledSum(Y, c, hg, k1);
+            converged = solveStage(t1, c, hg, Y, k2, iters);
+            numIterations += iters;
+        }
+        if (converged)
+            break;
+
+        // A Jacobian from an earlier step, or the System's approximate one,
+        // may be to blame; try again with a fresh numerical one. Otherwise
+        // let the caller reduce the step size.
+        if (jacobianTime == t0 && !jacobianFromSystem)
+            return false;
+        calcJacobian(jacobianTime == t0);
+    }
+
+    // Evaluate through kinematics only; the caller will project and then
+    // evaluate derivatives at the final value.
+    setAdvancedStateAndRealizeKinematics(t1, Y);
+
+    for (int i=0; i<d.size(); ++i)
+        d[i] = hg*(k2[i]-k1[i]);
+    iterationMatrixLU.solve(d, c);
+    for (int i=0; i<c.size(); ++i)
+        y1err[i] = std::abs(c[i]);
+
+    return true;
+}
+
+// The Jacobian is evaluated at the start of the step. If the System can
+// supply one (e.g. a MultibodySystem whose force elements all provide their
+// derivatives), that needs only a Dynamics stage realization. Otherwise we
+// use forward differences from f0 = f(t0,y0), which we already have, with one
+// derivative evaluation per state variable.
+void SDIRKIntegratorRep::calcJacobian(bool numerical) {
+    const Real    t0 = getPreviousTime();
+    const Vector& y0 = getPreviousY();
+    const Vector& f0 = getPreviousYDot();
+    const int n = y0.size();
+
+    jacobianFromSystem = false;
+    if (useSystemJacobian && !numerical) {
+        setAdvancedStateAndRealizeKinematics(t0, y0);
+        const State& advanced = getAdvancedState();
+        getSystem().realize(advanced, Stage::Dynamics);
+        jacobianFromSystem = getSystem().calcYDotJacobian(advanced, jacobian);
+    }
+
+    if (!jacobianFromSystem) {
+        jacobian.resize(n, n);
+        Vector& y = ytmp[0]; // the caller doesn't need this yet
+        y = y0;
+        for (int j=0; j < n; ++j) {
+            y[j] = y0[j] + SqrtEps*std::max(std::abs(y0[j]), Real(1));
+            const Real delta = y[j] - y0[j]; // exactly representable
+            setAdvancedStateAndRealizeDerivatives(t0, y);
+            jacobian(j) = (getAdvancedState().getYDot() - f0) / delta;
+            y[j] = y0[j];
+        }
+    }
+
+    ++statsJacobianEvaluations;
+    haveJacobian    = true;
+    jacobianTime    = t0;
+    refreshJacobian = false;
+    hgFactored      = NaN;
+}
+
+// The step size changes a little from almost every step to the next, but the
+// simplified Newton iteration doesn't need an exact iteration matrix (the
+// residual always uses the actual hg), so we keep the factorization while hg
+// stays within 20% of the value it was factored for. The matrix is formed
+// elementwise so that this doesn't allocate once it has been sized.
+void SDIRKIntegratorRep::factorIterationMatrix(Real hg) {
+    const Real MaxRatio = Real(1.2);
+    if (hgFactored/MaxRatio <= hg && hg <= MaxRatio*hgFactored)
+        return; // false if hgFactored is NaN
+    const int n = jacobian.nrow();
+    iterationMatrix.resize(n, n);
+    for (int j=0; j < n; ++j)
+        for (int i=0; i < n; ++i)
+            iterationMatrix(i,j) = -hg*jacobian(i,j) + (i==j ? 1 : 0);
+    iterationMatrixLU.factor(iterationMatrix);
+    hgFactored = hg;
+    ++statsIterationMatrixFactorizations;
+}
+
+// Simplified Newton iteration for one stage. The convergence test on the
+// (weighted) size of the iterates' changes follows Hairer & Wanner: with a
+// contraction rate r the remaining error is about r/(1-r) times the last
+// change. A slowly converging iteration asks for a new Jacobian at the next
+// step.
+bool SDIRKIntegratorRep::solveStage
+   (Real t, const Vector& c, Real hg, Vector& Y, Vector& k, int& numIterations)
+{
+    const int  MaxIterations = 7;
+    const Real tol = Real(0.05)*getAccuracyInUse();
+    Vector& r  = residual;
+    Vector& dY = deltaY;
+    Real prevNorm = NaN;
+    for (numIterations=1; numIterations <= MaxIterations; ++numIterations) {
+        setAdvancedStateAndRealizeDerivatives(t, Y);
+        const State& advanced = getAdvancedState();
+        Y = advanced.getY(); // might have been changed by prescribed motion
+        const Vector& f = advanced.getYDot();
+        r.resize(Y.size());
+        for (int i=0; i < Y.size(); ++i)
+            r[i] = Y[i] - c[i] - hg*f[i];
+        iterationMatrixLU.solve(r, dY);
+        addScaled(Y, -1, dY);
+
+        int worstY;
+        const Real norm = calcErrorNorm(advanced, dY, worstY);
+        if (isNaN(norm))
+            return false;
+        Real rate = 0;
+        if (numIterations > 1) {
+            rate = norm/prevNorm;
+            if (rate >= 1)
+                return false; // diverging
+        }
+        if (norm <= tol || (numIterations > 1 && rate/(1-rate)*norm <= tol)) {
+            if (rate > Real(0.5))
+                refreshJacobian = true;
+            for (int i=0; i < Y.size(); ++i)
+                k[i] = (Y[i] - c[i]) / hg;
+            return true;
+        }
+        prevNorm = norm;
+    }
+    --numIterations;
+    return false;
+}
@@ -0,0 +1,88 @@
+#ifndef SimTK_SIMMATH_SDIRK_INTEGRATOR_REP_H_
+#define SimTK_SIMMATH_SDIRK_INTEGRATOR_REP_H_
+
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include "AbstractIntegratorRep.h"
+#include "simmath/LinearAlgebra.h"
+
+namespace SimTK {
+
+/**
+ * This is the private (library side) implementation of the 
+ * SDIRKIntegratorRep class which is a concrete class
+ * implementing the abstract IntegratorRep.
+ */
+
+class SDIRKIntegratorRep : public AbstractIntegratorRep {
+public:
+    SDIRKIntegratorRep(Integrator* handle, const System& sys);
+
+    void methodInitialize(const State&) override;
+    void methodReinitialize(Stage stage, bool shouldTerminate) override;
+    void resetMethodStatistics() override;
+
+    void setUseSystemJacobian(bool use) {useSystemJacobian = use;}
+    bool getUseSystemJacobian() const {return useSystemJacobian;}
+    int getNumJacobianEvaluations() const {return statsJacobianEvaluations;}
+    int getNumIterationMatrixFactorizations() const 
+    {   return statsIterationMatrixFactorizations; }
+protected:
+    bool attemptODEStep
+       (Real t1, Vector& yErrEst, int& errOrder, int& numIterations) override;
+private:
+    // Calculate the Jacobian J=df/dy at the start of the step, by asking the
+    // System unless told to use forward differences, leaving the advanced
+    // state trashed.
+    void calcJacobian(bool numerical=false);
+    // Factor the Newton iteration matrix I - hg*J unless the current one was
+    // factored for nearly the same hg.
+    void factorIterationMatrix(Real hg);
+    // Solve Y = c + hg*f(t,Y) for the stage value Y, given an initial guess in
+    // Y. On successful return the advanced state holds (t,Y) realized through
+    // derivatives and k is the slope (Y-c)/hg.
+    bool solveStage(Real t, const Vector& c, Real hg, 
+                    Vector& Y, Vector& k, int& numIterations);
+
+    Matrix   jacobian;                  // df/dy
+    bool     haveJacobian = false;      // anything usable in jacobian?
+    bool     jacobianFromSystem = false;// or from finite differences?
+    bool     useSystemJacobian = true;
+    Real     jacobianTime = NaN;        // step start time it was computed at
+    bool     refreshJacobian = false;   // recompute at the next step?
+    Matrix   iterationMatrix;           // I - hg*J
+    FactorLU iterationMatrixLU;
+    Real     hgFactored = NaN;          // NaN if iterationMatrixLU is stale
+    int      statsJacobianEvaluations = 0;
+    int      statsIterationMatrixFactorizations = 0;
+
+    static const int NTemps = 5;
+    Vector ytmp[NTemps];
+    Vector residual, deltaY; // for solveStage()
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SIMMATH_SDIRK_INTEGRATOR_REP_H_
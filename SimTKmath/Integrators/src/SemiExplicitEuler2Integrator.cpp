@@ -138,16 +138,9 @@ bool SemiExplicitEuler2IntegratorRep::attemptDAEStep
 {
     const System& system   = getSystem();
     State& advanced = updAdvancedState();
-    Vector dummyErrEst; // for when we don't want the error estimate projected
  
     const int nq = advanced.getNQ();
     const int nu = advanced.getNU();
-    const int nz = advanced.getNZ();
-
-    // We'll need to work with these variable separately.
-    VectorView qErrEst  = yErrEst(    0, nq);
-    VectorView uErrEst  = yErrEst(   nq, nu);
-    VectorView zErrEst  = yErrEst(nq+nu, nz);
 
     statsStepsAttempted++;
     errOrder = 2;
@@ -165,8 +158,11 @@ bool SemiExplicitEuler2IntegratorRep::attemptDAEStep
 
     // -------------------------------------------------------------------------
     // First calculate the big step, borrowing advanced for the calculations.
-    advanced.updZ() = m_zBig = getPreviousZ() + h * getPreviousZDot();
-    advanced.updU() = getPreviousU() + h * getPreviousUDot();
+    // These are written elementwise since Vector expressions would allocate
+    // temporaries on every step.
+    setToScaledSum(m_zBig, getPreviousZ(), h, getPreviousZDot());
+    advanced.updZ() = m_zBig;
+    setToScaledSum(advanced.updU(), getPreviousU(), h, getPreviousUDot());
 
     // Note that changing time does not invalidate position kinematics.
     advanced.updTime() = t1;
@@ -175,7 +171,7 @@ bool SemiExplicitEuler2IntegratorRep::attemptDAEStep
 
     // Update qdotBig = N(q_t0)*u_t1 from now-advanced u.
     system.multiplyByN(advanced, advanced.getU(), m_qdotTmp);
-    advanced.updQ() = getPreviousQ() + h * m_qdotTmp;
+    setToScaledSum(advanced.updQ(), getPreviousQ(), h, m_qdotTmp);
     system.prescribeQ(advanced); // at t1
     m_qBig = advanced.getQ();
     system.realize(advanced, Stage::Position); // new q, new t=t1
@@ -187,8 +183,8 @@ bool SemiExplicitEuler2IntegratorRep::attemptDAEStep
 
     // -------------------------------------------------------------------------
     // Now take two half steps, working directly in advanced.
-    advanced.updZ() = getPreviousZ() + hHalf * getPreviousZDot();
-    advanced.updU() = getPreviousU() + hHalf * getPreviousUDot();
+    setToScaledSum(advanced.updZ(), getPreviousZ(), hHalf, getPreviousZDot());
+    setToScaledSum(advanced.updU(), getPreviousU(), hHalf, getPreviousUDot());
     advanced.updQ() = getPreviousQ(); // back to old q
     advanced.updTime() = tHalf;
     system.realize(advanced, Stage::Position); // old q, new t=tHalf
@@ -196,7 +192,7 @@ bool SemiExplicitEuler2IntegratorRep::attemptDAEStep
 
     // Update qdot_tHalf = N(q_t0)*u_tHalf from now-advanced u.
     system.multiplyByN(advanced, advanced.getU(), m_qdotTmp);
-    advanced.updQ() += hHalf * m_qdotTmp;
+    addScaled(advanced.updQ(), hHalf, m_qdotTmp);
     system.prescribeQ(advanced);
     system.realize(advanced, Stage::Position); // new q, new t
     system.prescribeU(advanced); // update prescribed u if q-dependent
@@ -209,8 +205,8 @@ bool SemiExplicitEuler2IntegratorRep::attemptDAEStep
     const Vector& udotHalf = advanced.getUDot();
 
     // Second half-step.
-    advanced.updZ() += hHalf * zdotHalf;
-    advanced.updU() += hHalf * udotHalf;
+    addScaled(advanced.updZ(), hHalf, zdotHalf);
+    addScaled(advanced.updU(), hHalf, udotHalf);
 
     advanced.updTime() = t1; // position kinematics unchanged
     system.realize(advanced, Stage::Position); // old q=qHalf, new t=t1
@@ -218,16 +214,16 @@ bool SemiExplicitEuler2IntegratorRep::attemptDAEStep
 
     // Update qdot_t1 = N(q_tHalf)*u_t1 from now-advanced u.
     system.multiplyByN(advanced, advanced.getU(), m_qdotTmp);
-    advanced.updQ() += hHalf * m_qdotTmp;
+    addScaled(advanced.updQ(), hHalf, m_qdotTmp);
     system.prescribeQ(advanced);
     system.realize(advanced, Stage::Position); // new q=q1, new t=t1
     system.prescribeU(advanced); // update prescribed u in case q-dependent
     // -------------------------------------------------------------------------
     // Now estimate the error and use local extrapolation to improve the
     // final solution.
-    qErrEst = advanced.getQ() - m_qBig;
-    uErrEst = advanced.getU() - m_uBig;
-    zErrEst = advanced.getZ() - m_zBig;
+    setSegmentToDifference(yErrEst,     0, advanced.getQ(), m_qBig);
+    setSegmentToDifference(yErrEst,    nq, advanced.getU(), m_uBig);
+    setSegmentToDifference(yErrEst, nq+nu, advanced.getZ(), m_zBig);
 
     // Local extrapolation. CAUSES STABILITY PROBLEMS! Don't do it!
     //advanced.updZ() += zErrEst; // Solution is now second-order.
@@ -129,7 +129,6 @@ bool SemiExplicitEulerIntegratorRep::attemptDAEStep
 {
     const System& system   = getSystem();
     State& advanced = updAdvancedState();
-    Vector dummyErrEst; // for when we don't want the error estimate projected
     
     statsStepsAttempted++;
 
@@ -147,8 +146,8 @@ bool SemiExplicitEulerIntegratorRep::attemptDAEStep
     // Advance the first order variables.
     // TODO: this part should be implicit in u and z to make this symplectic
     // Euler.
-    advanced.updZ() = getPreviousZ() + h * getPreviousZDot();
-    advanced.updU() = getPreviousU() + h * getPreviousUDot();
+    setToScaledSum(advanced.updZ(), getPreviousZ(), h, getPreviousZDot());
+    setToScaledSum(advanced.updU(), getPreviousU(), h, getPreviousUDot());
 
     // Note that changing time does not invalidate position kinematics.
     advanced.updTime() = t1;
@@ -156,10 +155,10 @@ bool SemiExplicitEulerIntegratorRep::attemptDAEStep
     system.prescribeU(advanced);
 
     // Update qdot_t1 = N(q_t0)*u_t1 from now-advanced u.
-    const int nq = advanced.getNQ();
-    Vector qdot_t1(nq);
+    Vector& qdot_t1 = m_qdotTmp;
+    qdot_t1.resize(advanced.getNQ());
     system.multiplyByN(advanced, advanced.getU(), qdot_t1);
-    advanced.updQ() = getPreviousQ() + h * qdot_t1;
+    setToScaledSum(advanced.updQ(), getPreviousQ(), h, qdot_t1);
     system.prescribeQ(advanced);
     system.realize(advanced, Stage::Position); // new q, new t
     system.prescribeU(advanced); // update prescribed u in case q-dependent
@@ -36,6 +36,8 @@ protected:
        (Real t1, Vector& yErrEst, int& errOrder, int& numIterations) override;
     void createInterpolatedState(Real t) override;
     void backUpAdvancedStateByInterpolation(Real t) override;
+private:
+    Vector m_qdotTmp;
 };
 
 } // namespace SimTK
@@ -63,7 +63,6 @@ bool VerletIntegratorRep::attemptDAEStep
 {
     const System& system   = getSystem();
     State& advanced = updAdvancedState();
-    Vector dummyErrEst; // for when we don't want the error estimate projected
     
     statsStepsAttempted++;
 
@@ -91,21 +90,25 @@ bool VerletIntegratorRep::attemptDAEStep
   {
     numIterations = 0;
 
-    VectorView qErrEst  = yErrEst(    0, nq);       // all 3rd order estimates
-    VectorView uErrEst  = yErrEst(   nq, nu);
-    VectorView zErrEst  = yErrEst(nq+nu, nz);
-    VectorView uzErrEst = yErrEst(   nq, nu+nz);    // all 2nd order estimates
+    // The error estimate has the q's first (all 3rd order estimates), then
+    // the u's and z's (all 2nd order estimates). Everything here is written
+    // elementwise since Vector expressions would allocate temporaries on
+    // every step.
     
     // Calculate the new positions q (3rd order) and initial (1st order) 
     // estimate for the velocities u and auxiliary variables z.
     
     // These are final values (the q's will get projected, though).
     advanced.updTime() = t1;
-    advanced.updQ()    = q0 + h*qdot0 + (h*h/2)*qdotdot0;
+    Vector& q1 = advanced.updQ();
+    for (int i=0; i < nq; ++i)
+        q1[i] = q0[i] + h*qdot0[i] + (h*h/2)*qdotdot0[i];
 
     // Now make an initial estimate of first-order variable u and z.
-    const Vector u1_est = u0 + h*udot0;
-    const Vector z1_est = z0 + h*zdot0;
+    Vector& u1_est = m_u1Est;
+    Vector& z1_est = m_z1Est;
+    setToScaledSum(u1_est, u0, h, udot0);
+    setToScaledSum(z1_est, z0, h, zdot0);
 
     advanced.updU() = u1_est; // u's and z's will change in advanced below
     advanced.updZ() = z1_est;
@@ -143,7 +146,8 @@ bool VerletIntegratorRep::attemptDAEStep
     // here which has a very limited radius of convergence.
     
     const Real tol = std::min(Real(1e-4), Real(0.1)*getAccuracyInUse());
-    Vector usave(nu), zsave(nz); // temporaries
+    Vector& usave = m_uSave; // temporaries
+    Vector& zsave = m_zSave;
     bool converged = false;
     Real prevChange = Infinity; // use this to quit early
     for (int i = 0; !converged && i < 10; ++i) {
@@ -160,8 +164,13 @@ bool VerletIntegratorRep::attemptDAEStep
         const Vector& zdot1 = advanced.getZDot();
         
         // Refine u and z estimates.
-        advanced.setU(u0 + (h/2)*(udot0 + udot1));
-        advanced.setZ(z0 + (h/2)*(zdot0 + zdot1));
+        m_uNew.resize(nu); m_zNew.resize(nz);
+        for (int j=0; j < nu; ++j) 
+            m_uNew[j] = u0[j] + (h/2)*(udot0[j] + udot1[j]);
+        for (int j=0; j < nz; ++j) 
+            m_zNew[j] = z0[j] + (h/2)*(zdot0[j] + zdot1[j]);
+        advanced.setU(m_uNew);
+        advanced.setZ(m_zNew);
 
         // Fix prescribed u's which may have been changed here.
         system.prescribeU(advanced);
@@ -177,9 +186,9 @@ bool VerletIntegratorRep::attemptDAEStep
         // 2-norm but this ratio would be the same if we used the RMS norm. 
         // TinyReal is there to keep us out of trouble if we started at zero.
         
-        const Real convergenceU = (advanced.getU()-usave).norm()
+        const Real convergenceU = calcNormOfDifference(advanced.getU(),usave)
                                   / (usave.norm()+TinyReal);
-        const Real convergenceZ = (advanced.getZ()-zsave).norm()
+        const Real convergenceZ = calcNormOfDifference(advanced.getZ(),zsave)
                                   / (zsave.norm()+TinyReal);
         const Real change = std::max(convergenceU,convergenceZ);
         converged = (change <= tol);
@@ -193,12 +202,14 @@ bool VerletIntegratorRep::attemptDAEStep
     // estimates for u and z. Note that we have already realized the state with
     // the new values, so QDot reflects the new u's.
 
-    qErrEst = q0 + (h/2)*(qdot0+advanced.getQDot()) // implicit trapezoid rule integral
-              - advanced.getQ();                    // Verlet integral
+    const Vector& qdot1   = advanced.getQDot();
+    const Vector& qVerlet = advanced.getQ(); // Verlet integral
+    for (int i=0; i < nq; ++i) // implicit trapezoid rule integral - Verlet
+        yErrEst[i] = q0[i] + (h/2)*(qdot0[i]+qdot1[i]) - qVerlet[i];
 
-    uErrEst = u1_est                    // explicit Euler integral
-              - advanced.getU();        // implicit trapezoid rule integral
-    zErrEst = z1_est - advanced.getZ(); // ditto for z's
+    // explicit Euler integral - implicit trapezoid rule integral
+    setSegmentToDifference(yErrEst,    nq, u1_est, advanced.getU());
+    setSegmentToDifference(yErrEst, nq+nu, z1_est, advanced.getZ()); // z's
 
     // TODO: because we're only projecting velocities here, we aren't going to 
     // get our position errors reduced here, which is a shame. Should be able 
@@ -220,7 +231,8 @@ bool VerletIntegratorRep::attemptDAEStep
     // decides to accept the step. Instead, a different error order should
     // be used when one of these is driving the step size.
 
-    uErrEst *= h; zErrEst *= h; // everything is 3rd order in h now
+    for (int i=nq; i < nq+nu+nz; ++i) 
+        yErrEst[i] *= h; // everything is 3rd order in h now
     errOrder = 3;
 
     //errOrder = qErrRMS > uzErrRMS ? 3 : 2;
@@ -34,6 +34,9 @@ public:
 protected:
     bool attemptDAEStep
        (Real t1, Vector& yErrEst, int& errOrder, int& numIterations) override;
+private:
+    // Temporaries, kept here so that taking a step doesn't allocate.
+    Vector m_u1Est, m_z1Est, m_uSave, m_zSave, m_uNew, m_zNew;
 };
 
 } // namespace SimTK
@@ -90,8 +90,16 @@ FactorLU::FactorLU( const Matrix_<ELT>& m ) {
 
 template < class ELT >
 void FactorLU::factor( const Matrix_<ELT>& m ) {
+    // Reuse the existing storage if we already hold a factorization of a 
+    // matrix with the same element type and dimensions.
+    typedef FactorLURep<typename CNT<ELT>::StdNumber> RepType;
+    RepType* typedRep = dynamic_cast<RepType*>(rep);
+    if (typedRep && typedRep->hasSameShape(m)) {
+        typedRep->factor(m);
+        return;
+    }
     delete rep;
-    rep = new FactorLURep<typename CNT<ELT>::StdNumber>(m);
+    rep = new RepType(m);
 }
 
 template < typename ELT >
@@ -81,21 +81,34 @@ void FactorQTZ::inverse( Matrix_<ELT>& inverse ) const {
 }
 template < class ELT >
 void FactorQTZ::factor( const Matrix_<ELT>& m ){
-    delete rep;
-  
     // if user does not supply rcond set it to max(nRow,nCol)*(eps)^7/8 (similar to matlab)
     int mnmax = (m.nrow() > m.ncol()) ? m.nrow() : m.ncol();
-    rep = new FactorQTZRep<typename CNT<ELT>::StdNumber>(m, mnmax*NTraits<typename CNT<ELT>::Precision>::getSignificant());
+    factor(m, (typename CNT<ELT>::Precision)
+              (mnmax*NTraits<typename CNT<ELT>::Precision>::getSignificant()));
 }
+// If we already hold a factorization of a matrix with the same element type
+// and dimensions, its storage and LAPACK workspace are reused.
 template < class ELT >
 void FactorQTZ::factor( const Matrix_<ELT>& m, double rcond ){
+    typedef FactorQTZRep<typename CNT<ELT>::StdNumber> RepType;
+    RepType* typedRep = dynamic_cast<RepType*>(rep);
+    if (typedRep && typedRep->hasSameShape(m)) {
+        typedRep->refactor(m, rcond);
+        return;
+    }
     delete rep;
-    rep = new FactorQTZRep<typename CNT<ELT>::StdNumber>(m, rcond );
+    rep = new RepType(m, rcond );
 }
 template < class ELT >
 void FactorQTZ::factor( const Matrix_<ELT>& m, float rcond ){
+    typedef FactorQTZRep<typename CNT<ELT>::StdNumber> RepType;
+    RepType* typedRep = dynamic_cast<RepType*>(rep);
+    if (typedRep && typedRep->hasSameShape(m)) {
+        typedRep->refactor(m, rcond);
+        return;
+    }
     delete rep;
-    rep = new FactorQTZRep<typename CNT<ELT>::StdNumber>(m, rcond );
+    rep = new RepType(m, rcond );
 }
 template < class ELT >
 FactorQTZ::FactorQTZ( const Matrix_<ELT>& m ) {
@@ -146,7 +159,9 @@ FactorQTZRep<T>::FactorQTZRep()
     pivots(0),
     qtz(0),
     tauGEQP3(0),
-    tauORMQR(0)
+    tauORMQR(0),
+    work(0),
+    solveLWork(0)
 { 
 } 
 
@@ -164,7 +179,9 @@ FactorQTZRep<T>::FactorQTZRep( const Matrix_<ELT>& mat, typename CNT<T>::TReal r
     pivots(mat.ncol()),
     qtz( mat.nrow()*mat.ncol() ),
     tauGEQP3(mn),
-    tauORMQR(mn)    
+    tauORMQR(mn),
+    work(0),
+    solveLWork(0)
 { 
     for(int i=0; i<mat.ncol(); ++i) 
         pivots.data[i] = 0;
@@ -172,6 +189,24 @@ FactorQTZRep<T>::FactorQTZRep( const Matrix_<ELT>& mat, typename CNT<T>::TReal r
     isFactored = true;
 }
 
+template <typename T >
+    template < typename ELT >
+void FactorQTZRep<T>::refactor( const Matrix_<ELT>& mat, 
+                                typename CNT<T>::TReal rc) 
+{
+    assert(hasSameShape(mat));
+    scaleLinSys  = false;
+    linSysScaleF = NTraits<typename CNT<T>::Precision>::getNaN();
+    anrm         = NTraits<typename CNT<T>::Precision>::getNaN();
+    rcond        = rc;
+    rank         = 0;
+    actualRCond  = 0;
+    for(int i=0; i<nCol; ++i) 
+        pivots.data[i] = 0; // let geqp3 choose all the pivots
+    FactorQTZRep<T>::factor( mat );
+    isFactored = true;
+}
+
 template <typename T >
 FactorQTZRepBase* FactorQTZRep<T>::clone() const {
    return( new FactorQTZRep<T>(*this) );
@@ -231,18 +266,23 @@ void FactorQTZRep<T>::doSolve(Matrix_<T>& b, Matrix_<T>& x) const {
     if (rank == 0) return;
 
     // Ask the experts for their optimal workspace sizes. The size parameters
-    // here must match the calls below.
-    T workSz;
-    LapackInterface::ormqr<T>('L', 'T', nRow, b.ncol(), mn, 0, nRow, 
-                               0, 0, b.nrow(), &workSz, -1, info );
-    const int lwork1 = (int)NTraits<T>::real(workSz);
-
-    LapackInterface::ormrz<T>('L', 'T', nCol, b.ncol(), rank, nCol-rank, 
-                              0, nRow, 0, 0, 
-                              b.nrow(), &workSz, -1, info );
-    const int lwork2 = (int)NTraits<T>::real(workSz);
+    // here must match the calls below. The answer for a single right hand
+    // side was saved when we factored.
+    int lwork = solveLWork;
+    if (nrhs != 1 || lwork == 0) {
+        T workSz;
+        LapackInterface::ormqr<T>('L', 'T', nRow, b.ncol(), mn, 0, nRow, 
+                                   0, 0, b.nrow(), &workSz, -1, info );
+        const int lwork1 = (int)NTraits<T>::real(workSz);
+
+        LapackInterface::ormrz<T>('L', 'T', nCol, b.ncol(), rank, nCol-rank, 
+                                  0, nRow, 0, 0, 
+                                  b.nrow(), &workSz, -1, info );
+        const int lwork2 = (int)NTraits<T>::real(workSz);
+        lwork = std::max(lwork1, lwork2);
+    }
     
-    TypedWorkSpace<T> work(std::max(lwork1, lwork2));
+    TypedWorkSpace<T> work(lwork);
 
     // compute norm of RHS
     bnrm = (RealType)LapackInterface::lange<T>('M', m, nrhs, &b(0,0), b.nrow());
@@ -340,16 +380,19 @@ void FactorQTZRep<T>::factor(const Matrix_<ELT>&mat )  {
 
     // Compute optimal size for work space for dtzrzf and dgepq3. The
     // arguments here should match the calls below, although we'll use maxRank
-    // rather than rank since we don't know the rank yet.
-    T workSz;
-    const int maxRank = std::min(nRow, nCol);
-    LapackInterface::tzrzf<T>(maxRank, nCol, 0, nRow, 0, &workSz, -1, info);
-    const int lwork1 = (int)NTraits<T>::real(workSz);
-
-    LapackInterface::geqp3<T>(nRow, nCol, 0, nRow, 0, 0, &workSz, -1, info);
-    const int lwork2 = (int)NTraits<T>::real(workSz);
+    // rather than rank since we don't know the rank yet. This depends only
+    // on the dimensions so is done only once for a given rep.
+    if (work.size == 0) {
+        T workSz;
+        const int maxRank = std::min(nRow, nCol);
+        LapackInterface::tzrzf<T>(maxRank, nCol, 0, nRow, 0, &workSz, -1, info);
+        const int lwork1 = (int)NTraits<T>::real(workSz);
+
+        LapackInterface::geqp3<T>(nRow, nCol, 0, nRow, 0, 0, &workSz, -1, info);
+        const int lwork2 = (int)NTraits<T>::real(workSz);
    
-    TypedWorkSpace<T> work(std::max(lwork1, lwork2));
+        work.resize(std::max(lwork1, std::max(lwork2, 1)));
+    }
 
     LapackInterface::getMachinePrecision<RealType>( smlnum, bignum);
 
@@ -427,6 +470,20 @@ void FactorQTZRep<T>::factor(const Matrix_<ELT>&mat )  {
             }
         }
     }
+
+    // Save the solve workspace size for a single right hand side, using the
+    // same arguments as doSolve().
+    solveLWork = 0;
+    if (rank > 0) {
+        T workSz;
+        LapackInterface::ormqr<T>('L', 'T', nRow, 1, mn, 0, nRow, 
+                                   0, 0, maxmn, &workSz, -1, info );
+        const int lwork1 = (int)NTraits<T>::real(workSz);
+        LapackInterface::ormrz<T>('L', 'T', nCol, 1, rank, nCol-rank, 
+                                  0, nRow, 0, 0, maxmn, &workSz, -1, info );
+        const int lwork2 = (int)NTraits<T>::real(workSz);
+        solveLWork = std::max(lwork1, lwork2);
+    }
 }
 
 // instantiate
@@ -123,6 +123,11 @@ public:
    ~FactorQTZRep();
 
    template < class ELT > void factor(const Matrix_<ELT>& ); 
+   // Factor a new matrix of the same shape, reusing all allocated storage.
+   template < class ELT > void refactor(const Matrix_<ELT>&, 
+                                        typename CNT<T>::TReal ); 
+   template < class ELT > bool hasSameShape(const Matrix_<ELT>& m) const
+   {   return m.nrow() == nRow && m.ncol() == nCol; }
    void inverse( Matrix_<T>& ) const override; 
    void solve( const Vector_<T>& b, Vector_<T>& x ) const override;
    void solve( const Matrix_<T>& b, Matrix_<T>& x ) const override;
@@ -144,6 +149,8 @@ private:
    TypedWorkSpace<T>        qtz;     // factored matrix
    TypedWorkSpace<T>        tauGEQP3;
    TypedWorkSpace<T>        tauORMQR;
+   TypedWorkSpace<T>        work;    // for factor(); kept for refactor()
+   int                      solveLWork; // cached LAPACK lwork for 1 rhs
 
 }; // end class FactorQTZRep
 
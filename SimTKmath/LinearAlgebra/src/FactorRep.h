@@ -206,6 +206,9 @@ class FactorLURep : public FactorLURepBase {
    FactorLURepBase* clone() const override;
 
    template < class ELT > void factor(const Matrix_<ELT>& ); 
+   // True if m could be factored into the storage we already have.
+   template < class ELT > bool hasSameShape(const Matrix_<ELT>& m) const
+   {   return m.nrow() == nRow && m.ncol() == nCol; }
    void solve( const Vector_<T>& b, Vector_<T>& x ) const override;
    void solve( const Matrix_<T>& b, Matrix_<T>& x ) const override;
    void inverse( Matrix_<T>& m ) const override;
@@ -25,6 +25,8 @@
 
 #include <bitset>
 
+#if SimTK_DEFAULT_PRECISION == 2 // c-cmaes works only in double
+
 namespace SimTK {
 
 #define SimTK_CMAES_PRINT(diag, cmds) \
@@ -61,16 +63,19 @@ Real CMAESOptimizer::optimize(SimTK::Vector& results)
     
     // Initialize parallelism, if requested.
     std::string parallel;
-    std::unique_ptr<ParallelExecutor> executor;
+    std::unique_ptr<ParallelExecutor> ownExecutor;
+    ParallelExecutor* executor = nullptr;
     if (getAdvancedStrOption("parallel", parallel)) {
 
-        // Number of parallel processes/threads.
-        int nthreads = ParallelExecutor::getNumProcessors();
-        getAdvancedIntOption("nthreads", nthreads);
-
-        // Multithreading.
+        // Multithreading. Unless a specific number of threads was requested
+        // we use the process-wide shared executor.
         if (parallel == "multithreading") {
-            executor.reset(new ParallelExecutor(nthreads));
+            int nthreads;
+            if (getAdvancedIntOption("nthreads", nthreads)) {
+                ownExecutor.reset(new ParallelExecutor(nthreads));
+                executor = ownExecutor.get();
+            } else
+                executor = &ParallelExecutor::getSharedExecutor();
         }
 
     }
@@ -98,7 +103,7 @@ Real CMAESOptimizer::optimize(SimTK::Vector& results)
 
         // Evaluate the objective function on the samples.
         // ===============================================
-        evaluateObjectiveFunctionOnPopulation(evo, pop, funvals, executor.get());
+        evaluateObjectiveFunctionOnPopulation(evo, pop, funvals, executor);
         
         // Update the distribution (mean, covariance, etc.).
         // =================================================
@@ -334,3 +339,5 @@ void CMAESOptimizer::evaluateObjectiveFunctionOnPopulation(
 #undef SimTK_CMAES_SMART_PTR
 
 } // namespace SimTK
+
+#endif
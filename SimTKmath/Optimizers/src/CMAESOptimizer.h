@@ -30,6 +30,9 @@
 
 #include <memory>
 
+// c-cmaes works only in double precision.
+#if SimTK_DEFAULT_PRECISION == 2
+
 namespace SimTK {
 
 class CMAESOptimizer: public Optimizer::OptimizerRep {
@@ -72,4 +75,6 @@ private:
 
 } // namespace SimTK
 
+#endif
+
 #endif // SimTK_SIMMATH_CMAES_OPTIMIZER_H_
@@ -499,7 +499,7 @@ namespace Ipopt
           }
           else {
             // ToDo: What lower bound to use?
-            Number sTy_new = Max(1e-8, fabs(s_new->Dot(*y_new)));
+            Number sTy_new = Max(Number(1e-8), Number(fabs(s_new->Dot(*y_new))));
             DBG_ASSERT(sTy_new!=0.);
             switch (limited_memory_initialization_) {
               case SCALAR1:
@@ -786,7 +786,7 @@ namespace Ipopt
     }
 
     // Determine the ratio of smallest over the largest eigenvalue
-    Number emax = Max(fabs(Evals[0]), fabs(Evals[dim-1]));
+    Number emax = Max(Number(fabs(Evals[0])), Number(fabs(Evals[dim-1])));
     if (emax==0.) {
       return true;
     }
@@ -1692,7 +1692,7 @@ namespace Ipopt
     // Now go through all variables and check the partial derivatives
     for (Index ivar=0; ivar<nx; ivar++) {
       Number this_perturbation =
-        derivative_test_perturbation_*Max(1.,fabs(xref[ivar]));
+        derivative_test_perturbation_*Max(Number(1.),Number(fabs(xref[ivar])));
       xpert[ivar] = xref[ivar] + this_perturbation;
 
       Number fpert;
@@ -1705,7 +1705,7 @@ namespace Ipopt
       Number deriv_approx = (fpert - fref)/this_perturbation;
       Number deriv_exact = grad_f[ivar];
       Number rel_error =
-        fabs(deriv_approx-deriv_exact)/Max(fabs(deriv_approx),1.);
+        fabs(deriv_approx-deriv_exact)/Max(Number(fabs(deriv_approx)),Number(1.));
       char cflag=' ';
       if (rel_error >= derivative_test_tol_) {
         cflag='*';
@@ -1733,7 +1733,7 @@ namespace Ipopt
             }
           }
 
-          rel_error = fabs(deriv_approx-deriv_exact)/Max(fabs(deriv_approx),1.);
+          rel_error = fabs(deriv_approx-deriv_exact)/Max(Number(fabs(deriv_approx)),Number(1.));
           cflag=' ';
           if (rel_error >= derivative_test_tol_) {
             cflag='*';
@@ -1810,7 +1810,7 @@ namespace Ipopt
 
         for (Index ivar=0; ivar<nx; ivar++) {
           Number this_perturbation =
-            derivative_test_perturbation_*Max(1.,fabs(xref[ivar]));
+            derivative_test_perturbation_*Max(Number(1.),Number(fabs(xref[ivar])));
           xpert[ivar] = xref[ivar] + this_perturbation;
 
           new_x = true;
@@ -1850,7 +1850,7 @@ namespace Ipopt
               }
             }
             Number rel_error =
-              fabs(deriv_approx-deriv_exact)/Max(fabs(deriv_approx),1.);
+              fabs(deriv_approx-deriv_exact)/Max(Number(fabs(deriv_approx)),Number(1.));
             char cflag=' ';
             if (rel_error >= derivative_test_tol_) {
               cflag='*';
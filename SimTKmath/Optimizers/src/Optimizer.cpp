@@ -43,8 +43,8 @@ bool Optimizer::isAlgorithmAvailable(OptimizerAlgorithm algorithm) {
         case LBFGSB:        return LBFGSBOptimizer::isAvailable();
 #if SimTK_DEFAULT_PRECISION==2 // double only
         case CFSQP:         return CFSQPOptimizer::isAvailable();
-#endif
         case CMAES:         return CMAESOptimizer::isAvailable();
+#endif
         default:            return false;
     }
 }
@@ -115,10 +115,10 @@ Optimizer::constructOptimizerRep( const OptimizerSystem& sys, OptimizerAlgorithm
             newRep = 0;
         }
     }
-#endif
     else if( algorithm == CMAES ) {
         newRep = (OptimizerRep *) new CMAESOptimizer( sys  );
     }
+#endif
 
     SimTK_APIARGCHECK_ALWAYS(
             algorithm != UnknownOptimizerAlgorithm &&
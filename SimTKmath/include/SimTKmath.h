@@ -43,6 +43,7 @@
 #include "simmath/internal/GeodesicIntegrator.h"
 #include "simmath/internal/ContactGeometry.h"
 #include "simmath/internal/OrientedBoundingBox.h"
+#include "simmath/internal/SpatialIndex.h"
 #include "simmath/internal/Contact.h"
 #include "simmath/internal/ContactTracker.h"
 #include "simmath/internal/CollisionDetectionAlgorithm.h"
@@ -62,5 +63,9 @@
 #include "simmath/VerletIntegrator.h"
 #include "simmath/SemiExplicitEulerIntegrator.h"
 #include "simmath/SemiExplicitEuler2Integrator.h"
+#include "simmath/SDIRKIntegrator.h"
+#include "simmath/MultirateIntegrator.h"
+#include "simmath/EnsembleIntegrator.h"
+#include "simmath/RealTimeStepper.h"
 
 #endif // SimTK_SIMMATH_H_
@@ -74,7 +74,9 @@ class SimTK_SIMMATH_EXPORT FactorLU: public Factor {
     FactorLU& operator=(const FactorLU& rhs);
 
     template <class ELT> FactorLU( const Matrix_<ELT>& m );
-    /// factors a matrix
+    /// factors a matrix; if this object already holds a factorization of
+    /// a matrix with the same element type and dimensions, its storage is
+    /// reused rather than reallocated
     template <class ELT> void factor( const Matrix_<ELT>& m );
     /// solves a single right hand side 
     template <class ELT> void solve( const Vector_<ELT>& b, Vector_<ELT>& x ) const;
@@ -118,7 +120,10 @@ class SimTK_SIMMATH_EXPORT FactorQTZ: public Factor {
     template <typename ELT> FactorQTZ( const Matrix_<ELT>& m, double rcond );
     /// do QTZ factorization of a matrix for a given reciprocal condition number
     template <typename ELT> FactorQTZ( const Matrix_<ELT>& m, float rcond );
-    /// do QTZ factorization of a matrix
+    /// do QTZ factorization of a matrix; if this object already holds a 
+    /// factorization of a matrix with the same element type and dimensions,
+    /// its storage and LAPACK workspace are reused rather than reallocated,
+    /// which makes repeated factoring in a loop much cheaper
     template <typename ELT> void factor( const Matrix_<ELT>& m);
     /// do QTZ factorization of a matrix for a given reciprocal condition number
     template <typename ELT> void factor( const Matrix_<ELT>& m, float rcond );
@@ -404,8 +404,9 @@ private:
  *   threadsafe: you can't reliably modify any mutable variables in your
  *   OptimizerSystem::objectiveFun().
  * - <b>nthreads</b> (int) If the <b>parallel</b> option is set to
- *   "multithreading", this is the number of threads to use (by default, this
- *   is the number of processors/threads on the machine).
+ *   "multithreading", this is the number of threads to use (by default, 
+ *   the optimizer uses ParallelExecutor::getSharedExecutor(), which has one
+ *   thread per processor unless configured otherwise).
  *
  * If you want to generate identical results with repeated optimizations,
  * you can set the <b>seed</b> option. In addition, you *must* set the
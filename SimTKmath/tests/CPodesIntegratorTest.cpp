@@ -24,6 +24,31 @@
 #include "IntegratorTestFramework.h"
 #include "simmath/CPodesIntegrator.h"
 
+// Calculate Jacobian-vector products with a directional difference, as CPODES
+// itself would, counting the calls.
+class DifferenceJacobianTimesVector 
+:   public CPodesIntegrator::JacobianTimesVector {
+public:
+    explicit DifferenceJacobianTimesVector(const System& sys) 
+    :   sys(sys), numCalls(0) {}
+    void multiply(const State& state, const Vector& v, 
+                  Vector& Jv) const override {
+        ++numCalls;
+        const Real vnorm = v.norm();
+        if (vnorm == 0) {
+            Jv = 0;
+            return;
+        }
+        const Real eps = SqrtEps/vnorm;
+        State perturbed = state;
+        perturbed.updY() = state.getY() + eps*v;
+        sys.realize(perturbed, Stage::Acceleration);
+        Jv = (perturbed.getYDot() - state.getYDot())/eps;
+    }
+    const System& sys;
+    mutable int numCalls;
+};
+
 int main () {
   try {
     PendulumSystem sys;
@@ -71,6 +96,40 @@ int main () {
         CPodesIntegrator projInteg(sys, CPodes::BDF);
         projInteg.setUseCPodesProjection();
         testIntegrator(projInteg, sys);
+
+        // Try the band and Krylov linear solvers, first with difference
+        // quotient Jacobian-vector products and then with our own.
+
+        CPodesIntegrator bandInteg(sys, CPodes::BDF);
+        bandInteg.setUseBandLinearSolver(2, 2);
+        ASSERT(bandInteg.getLinearSolverType() 
+               == CPodesIntegrator::BandLinearSolver);
+        testIntegrator(bandInteg, sys);
+        ASSERT(bandInteg.getNumLinearSolverIterations() == 0);
+
+        CPodesIntegrator krylovInteg(sys, CPodes::BDF);
+        krylovInteg.setUseKrylovLinearSolver();
+        ASSERT(krylovInteg.getLinearSolverType() 
+               == CPodesIntegrator::KrylovLinearSolver);
+        testIntegrator(krylovInteg, sys);
+        ASSERT(krylovInteg.getNumLinearSolverIterations() > 0);
+
+        DifferenceJacobianTimesVector jtv(sys);
+        CPodesIntegrator jtvInteg(sys, CPodes::BDF);
+        jtvInteg.setUseKrylovLinearSolver(3);
+        jtvInteg.setJacobianTimesVector(&jtv);
+        testIntegrator(jtvInteg, sys);
+        ASSERT(jtv.numCalls > 0);
+        ASSERT(jtvInteg.getNumLinearSolverIterations() > 0);
+
+        // The linear solver can't be changed after initialization.
+
+        try {
+            jtvInteg.setUseDenseLinearSolver();
+            assert(false);
+        }
+        catch (...) {
+        }
     }
     cout << "Done" << endl;
     return 0;
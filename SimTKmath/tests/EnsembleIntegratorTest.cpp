@@ -0,0 +1,109 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "IntegratorTestFramework.h"
+#include "simmath/EnsembleIntegrator.h"
+#include "simmath/RungeKuttaFeldbergIntegrator.h"
+
+// Each member of an ensemble must follow exactly the same trajectory as it
+// would if it were simulated on its own with a TimeStepper.
+template <class IntegratorType>
+void testEnsemble(PendulumSystem& sys, int numThreads) {
+    const int NumMembers = 7;
+    const Real Accuracy = 1e-5;
+
+    Array_<State> states;
+    for (int i=0; i < NumMembers; ++i) {
+        State s = sys.getDefaultState();
+        const Real angle = 0.1*i;
+        s.updQ()[0] = std::cos(angle);
+        s.updQ()[1] = -std::sin(angle);
+        states.push_back(s);
+    }
+
+    EnsembleIntegrator ensemble(sys);
+    ensemble.setIntegratorType<IntegratorType>();
+    ensemble.setAccuracy(Accuracy);
+    ASSERT(ensemble.getAccuracy() == Accuracy);
+    ensemble.setNumThreads(numThreads);
+    ASSERT(ensemble.getNumThreads() == numThreads);
+
+    // Do it twice to make sure the reused members start over.
+    for (int run=0; run < 2; ++run) {
+        ensemble.initialize(states);
+        ASSERT(ensemble.getNumMembers() == NumMembers);
+        ensemble.stepTo(1);
+        ensemble.stepTo(2.5);
+
+        Matrix y;
+        ensemble.getContinuousStates(y);
+        ASSERT(y.nrow() == NumMembers);
+        ASSERT(y.ncol() == sys.getDefaultState().getNY());
+
+        for (int i=0; i < NumMembers; ++i) {
+            IntegratorType integ(sys);
+            integ.setAccuracy(Accuracy);
+            TimeStepper ts(sys, integ);
+            ts.initialize(states[i]);
+            ts.stepTo(1);
+            ts.stepTo(2.5);
+
+            const State& s = ensemble.getState(i);
+            ASSERT(!ensemble.isTerminated(i));
+            ASSERT(s.getTime() == 2.5);
+            ASSERT((s.getY() - ts.getState().getY()).normInf() == 0);
+            ASSERT((~y[i] - ts.getState().getY()).normInf() == 0);
+            ASSERT(ensemble.getIntegrator(i).getNumStepsTaken()
+                   == integ.getNumStepsTaken());
+        }
+    }
+}
+
+int main () {
+  try {
+    PendulumSystem sys;
+    sys.realizeTopology();
+    sys.setDefaultMass(10);
+    sys.setDefaultTimeAndState(0, Vector(Vec2(1,0)), Vector(2, Real(0)));
+
+    testEnsemble<RungeKuttaMersonIntegrator>(sys, 0);
+    testEnsemble<RungeKuttaMersonIntegrator>(sys, 1);
+    testEnsemble<RungeKuttaFeldbergIntegrator>(sys, 3);
+
+    // A member whose Integrator reaches its final time is terminated.
+    EnsembleIntegrator ensemble(sys);
+    ensemble.initialize(Array_<State>(2, sys.getDefaultState()));
+    ensemble.updIntegrator(1).setFinalTime(0.5);
+    ensemble.stepTo(1);
+    ASSERT(!ensemble.isTerminated(0) && ensemble.isTerminated(1));
+    ASSERT(ensemble.getState(0).getTime() == 1);
+    ASSERT(ensemble.getState(1).getTime() == 0.5);
+
+    cout << "Done" << endl;
+    return 0;
+  }
+  catch (std::exception& e) {
+    std::printf("FAILED: %s\n", e.what());
+    return 1;
+  }
+}
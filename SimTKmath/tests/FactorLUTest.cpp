@@ -124,6 +124,12 @@ int main () {
         cout << "Inverse c: " << endl;
         cout << invC[0] << endl;
         cout << invC[1] << endl;
+
+        // Refactoring a same-shape matrix reuses the existing storage.
+        clu.factor(2*c);
+        Matrix invC2;
+        clu.inverse(invC2);
+        ASSERT((2*invC2-invC).norm() < 10*SignificantReal);
         Real Z[4] = { 0.0,   0.0,
                      0.0,   0.0  };
         Matrix z(2,2, Z);
@@ -184,6 +184,25 @@ int main () {
         cout << " FactorQTZ.inverse : " << endl;
         cout << invQTZ[0] << endl;
         cout << invQTZ[1] << endl;
+
+        // Refactoring same-shape matrices reuses storage; make sure nothing
+        // from the previous factorization (rank, pivots) leaks through.
+        Real S[4] = { 1.0,   2.0,
+                      2.0,   4.0  };
+        Matrix s(2,2, S);
+        FactorQTZ rqtz(c);
+        ASSERT( rqtz.getRank() == 2 );
+        rqtz.factor(s);
+        ASSERT( rqtz.getRank() == 1 );
+        rqtz.factor(c);
+        ASSERT( rqtz.getRank() == 2 );
+        Matrix invQTZ2;
+        rqtz.inverse(invQTZ2);
+        ASSERT( (invQTZ2-invQTZ).norm() < 10*SignificantReal );
+        Vector bc(2); bc[0] = 1; bc[1] = -1;
+        Vector xcr;
+        rqtz.solve(bc, xcr);
+        ASSERT( (c*xcr-bc).norm() < 10*SignificantReal );
   
         Real Z[4] = { 0.0,   0.0,
                      0.0,   0.0  };
@@ -0,0 +1,115 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Once an integrator has taken its first few steps, taking more steps must
+// not allocate heap memory. We check that by replacing the global operator
+// new with one that counts.
+
+#include "IntegratorTestFramework.h"
+#include "SimTKmath.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<long> numAllocations(0);
+
+void* operator new(std::size_t n) {
+    ++numAllocations;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t n) {
+    ++numAllocations;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept {std::free(p);}
+void operator delete[](void* p) noexcept {std::free(p);}
+void operator delete(void* p, std::size_t) noexcept {std::free(p);}
+void operator delete[](void* p, std::size_t) noexcept {std::free(p);}
+
+const int NumWarmUpSteps = 20, NumSteps = 50;
+
+// Take internal steps with the given integrator and return the number of
+// allocations made after the warm-up steps.
+long countStepAllocations(const System& sys, Integrator& integ) {
+    integ.setReturnEveryInternalStep(true);
+    integ.initialize(sys.getDefaultState());
+    for (int i=0; i < NumWarmUpSteps; ++i)
+        integ.stepTo(100);
+    const long before = numAllocations;
+    for (int i=0; i < NumSteps; ++i)
+        integ.stepTo(100);
+    return numAllocations - before;
+}
+
+template <class IntegratorType>
+void testIntegrator(const System& sys, const char* name) {
+    IntegratorType integ(sys);
+    integ.setAccuracy(1e-4);
+    const long n = countStepAllocations(sys, integ);
+    cout << name << ": " << n << " allocations in " << NumSteps << " steps\n";
+    ASSERT(n == 0);
+}
+
+int main() {
+  try {
+    PendulumSystem sys;
+    sys.realizeTopology();
+    sys.setDefaultMass(10);
+    sys.setDefaultTimeAndState(0, Vector(Vec2(1,0)), Vector(2, Real(0)));
+
+    testIntegrator<RungeKuttaMersonIntegrator>(sys, "RungeKuttaMerson");
+    testIntegrator<RungeKuttaFeldbergIntegrator>(sys, "RungeKuttaFeldberg");
+    testIntegrator<RungeKutta3Integrator>(sys, "RungeKutta3");
+    testIntegrator<RungeKutta2Integrator>(sys, "RungeKutta2");
+    testIntegrator<ExplicitEulerIntegrator>(sys, "ExplicitEuler");
+    testIntegrator<SemiExplicitEuler2Integrator>(sys, "SemiExplicitEuler2");
+    testIntegrator<VerletIntegrator>(sys, "Verlet");
+    testIntegrator<SDIRKIntegrator>(sys, "SDIRK");
+    testIntegrator<MultirateIntegrator>(sys, "Multirate");
+    testIntegrator<CPodesIntegrator>(sys, "CPodes");
+
+    SemiExplicitEulerIntegrator semiExplicitEuler(sys, 0.001);
+    ASSERT(countStepAllocations(sys, semiExplicitEuler) == 0);
+
+    // Fixed-step real-time stepping goes through a TimeStepper.
+    SemiExplicitEuler2Integrator integ(sys);
+    RealTimeStepper stepper(sys, integ);
+    stepper.initialize(sys.getDefaultState());
+    for (int i=0; i < NumWarmUpSteps; ++i)
+        stepper.step();
+    const long before = numAllocations;
+    for (int i=0; i < NumSteps; ++i)
+        stepper.step();
+    ASSERT(numAllocations == before);
+
+    cout << "Done" << endl;
+    return 0;
+  }
+  catch (std::exception& e) {
+    std::printf("FAILED: %s\n", e.what());
+    return 1;
+  }
+}
@@ -0,0 +1,102 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "IntegratorTestFramework.h"
+#include "simmath/MultirateIntegrator.h"
+
+// The pendulum's qdot is just u, which doesn't need the System realized past
+// Time.
+class PositionDerivatives 
+:   public MultirateIntegrator::FastDerivativeFunction {
+public:
+    void calcFastDerivatives(const State& state, Vector& ydot) const override
+    {   ydot(state.getQStart(), state.getNQ()) = state.getU(); }
+};
+
+int main () {
+  try {
+    PendulumSystem sys;
+    sys.addEventHandler(new ZeroVelocityHandler(sys));
+    sys.addEventHandler(PeriodicHandler::handler = new PeriodicHandler());
+    sys.addEventHandler(new ZeroPositionHandler(sys));
+    sys.addEventReporter(PeriodicReporter::reporter = new PeriodicReporter(sys));
+    sys.addEventReporter(new OnceOnlyEventReporter());
+    sys.addEventReporter(new DiscontinuousReporter());
+    sys.realizeTopology();
+
+    // Test with various intervals for the event handler and event reporter, 
+    // ones that are either large or small compared to the expected internal 
+    // step size of the integrator.
+
+    for (int i = 0; i < 4; ++i) {
+        PeriodicHandler::handler->setEventInterval
+           (i == 0 || i == 1 ? 0.01 : 2.0);
+        PeriodicReporter::reporter->setEventInterval
+           (i == 0 || i == 2 ? 0.015 : 1.5);
+        
+        // Test the integrator in both normal and single step modes, first 
+        // with no fast variables and then with the x coordinate sub-cycled.
+        
+        MultirateIntegrator integ(sys);
+        testIntegrator(integ, sys);
+        integ.setReturnEveryInternalStep(true);
+        testIntegrator(integ, sys);
+
+        integ.addFastQ(QIndex(0));
+        integ.addFastU(UIndex(0));
+        integ.setNumSubsteps(5);
+        ASSERT(integ.getNumSubsteps() == 5);
+        testIntegrator(integ, sys);
+        integ.setReturnEveryInternalStep(false);
+        testIntegrator(integ, sys);
+    }
+
+    // Sub-cycle the q's with and without evaluating only their derivatives
+    // during the substeps; the former must need fewer full realizations.
+    Real realizationsPerStep[2];
+    for (int i = 0; i < 2; ++i) {
+        MultirateIntegrator integ(sys);
+        integ.addFastQ(QIndex(0));
+        integ.addFastQ(QIndex(1));
+        if (i == 1)
+            integ.setFastDerivativeFunction(new PositionDerivatives());
+        ASSERT(integ.hasFastDerivativeFunction() == (i == 1));
+        testIntegrator(integ, sys);
+        realizationsPerStep[i] = Real(integ.getNumRealizations())
+                                 / integ.getNumStepsTaken();
+    }
+    ASSERT(realizationsPerStep[1] < realizationsPerStep[0]/2);
+
+    MultirateIntegrator integ(sys);
+    bool threw = false;
+    try {integ.setNumSubsteps(0);} catch (const std::exception&) {threw = true;}
+    ASSERT(threw);
+
+    cout << "Done" << endl;
+    return 0;
+  }
+  catch (std::exception& e) {
+    std::printf("FAILED: %s\n", e.what());
+    return 1;
+  }
+}
@@ -0,0 +1,95 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "IntegratorTestFramework.h"
+#include "simmath/RealTimeStepper.h"
+#include "simmath/SemiExplicitEuler2Integrator.h"
+
+int main () {
+  try {
+    PendulumSystem sys;
+    sys.addEventHandler(new ZeroVelocityHandler(sys));
+    sys.realizeTopology();
+    const Real qi[] = {1,0}, ui[] = {0,0};
+    sys.setDefaultMass(10);
+    sys.setDefaultTimeAndState(0, Vector(2, qi), Vector(2, ui));
+
+    SemiExplicitEuler2Integrator integ(sys);
+    RealTimeStepper stepper(sys, integ);
+    stepper.setStepSize(0.01);
+    ASSERT(stepper.getStepSize() == 0.01);
+    ASSERT(stepper.getDeadline() == 0.01); // defaults to the step size
+    stepper.setNumWarmUpSteps(2);
+    ASSERT(stepper.getNumWarmUpSteps() == 2);
+
+    // A generous deadline is always met; the steps are exactly the given
+    // size (in simulated time) and events are handled along the way.
+    stepper.setDeadline(10);
+    ASSERT(stepper.getDeadline() == 10);
+    stepper.initialize(sys.getDefaultState());
+    ZeroVelocityHandler::eventCount = 0;
+    for (int i=0; i < 300; ++i)
+        ASSERT(stepper.step());
+    ASSERT(stepper.getNumSteps() == 300);
+    ASSERT(std::abs(stepper.getTime() - 3) < 1e-12);
+    ASSERT(integ.getNumStepsTaken() >= 300);
+    ASSERT(ZeroVelocityHandler::eventCount > 0);
+    ASSERT(stepper.getNumOverruns() == 0);
+    ASSERT(0 < stepper.getMeanLatency()
+           && stepper.getMeanLatency() <= stepper.getMaxLatency());
+    ASSERT(stepper.getLatencyHistogramBinWidth() == 2*10./100);
+    int measured = 0;
+    for (int n : stepper.getLatencyHistogram()) measured += n;
+    ASSERT(measured == 298);
+
+    // An impossible deadline is never met.
+    stepper.setDeadline(1e-15);
+    stepper.setLatencyHistogramBins(1e-6, 10);
+    stepper.initialize(sys.getDefaultState());
+    for (int i=0; i < 20; ++i)
+        ASSERT(!stepper.step());
+    ASSERT(stepper.getNumOverruns() == 18);
+    ASSERT(stepper.getLatencyHistogram().size() == 10);
+    ASSERT(stepper.getLatencyHistogramBinWidth() == 1e-6);
+    stepper.resetStatistics();
+    ASSERT(stepper.getNumOverruns() == 0 && stepper.getMaxLatency() == 0);
+
+    // When pacing, simulated time doesn't run ahead of real time.
+    stepper.setStepSize(0.002);
+    stepper.setDeadline(0);
+    stepper.setPaceToRealTime(true);
+    ASSERT(stepper.getPaceToRealTime());
+    stepper.initialize(sys.getDefaultState());
+    const double start = realTime();
+    for (int i=0; i < 50; ++i)
+        stepper.step();
+    ASSERT(realTime() - start >= 0.099);
+
+    cout << "Done" << endl;
+    return 0;
+  }
+  catch (std::exception& e) {
+    std::printf("FAILED: %s\n", e.what());
+    return 1;
+  }
+}
@@ -24,6 +24,37 @@
 #include "IntegratorTestFramework.h"
 #include "simmath/RungeKuttaFeldbergIntegrator.h"
 
+// Run the standard tests with each of the step size controllers, and check
+// the profiling counters while we're at it.
+void testStepControllers(PendulumSystem& sys) {
+    const Integrator::StepController controllers[] = 
+    {   Integrator::ElementaryController, Integrator::PIController,
+        Integrator::GustafssonController, Integrator::PIDController };
+
+    sys.setRealizationTimingEnabled(true);
+    for (Integrator::StepController controller : controllers) {
+        sys.resetAllCountersToZero();
+        RungeKuttaFeldbergIntegrator integ(sys);
+        ASSERT(integ.getStepController() == Integrator::ElementaryController);
+        integ.setStepController(controller);
+        ASSERT(integ.getStepController() == controller);
+        testIntegrator(integ, sys);
+
+        const Array_<int>& counts = integ.getStepLimitingErrorCounts();
+        ASSERT(counts.size() == (unsigned)sys.getDefaultState().getNY());
+        int total = 0;
+        for (int n : counts) total += n;
+        ASSERT(0 < total && total <= integ.getNumStepsAttempted());
+        ASSERT(sys.getRealizationTimeOfThisStage(Stage::Acceleration) > 0);
+
+        integ.resetAllStatistics();
+        ASSERT(integ.getStepLimitingErrorCounts().empty());
+    }
+    sys.setRealizationTimingEnabled(false);
+    sys.resetAllCountersToZero();
+    ASSERT(sys.getRealizationTimeOfThisStage(Stage::Acceleration) == 0);
+}
+
 int main () {
   try {
     PendulumSystem sys;
@@ -49,6 +80,7 @@ int main () {
         integ.setReturnEveryInternalStep(true);
         testIntegrator(integ, sys);
     }
+    testStepControllers(sys);
     cout << "Done" << endl;
     return 0;
   }
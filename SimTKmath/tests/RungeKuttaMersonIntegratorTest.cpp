@@ -24,8 +24,99 @@
 #include "IntegratorTestFramework.h"
 #include "simmath/RungeKuttaMersonIntegrator.h"
 
+// Sample the trajectory several times within each step with 
+// interpolateMany(), then check the samples against the interpolated states
+// a second integrator reports when asked to stop at the same times.
+void testInterpolateMany() {
+    PendulumSystem sys;
+    sys.realizeTopology();
+    const Real qi[] = {1,0}, ui[] = {0,0};
+    sys.setDefaultMass(10);
+    sys.setDefaultTimeAndState(0, Vector(2, qi), Vector(2, ui));
+
+    RungeKuttaMersonIntegrator integ(sys), reference(sys);
+    for (Integrator* ip : {(Integrator*)&integ, (Integrator*)&reference}) {
+        ip->setAccuracy(1e-4);
+        ip->setProjectInterpolatedStates(false);
+        ip->initialize(sys.getDefaultState());
+    }
+    integ.setReturnEveryInternalStep(true);
+
+    Array_<Real> allTimes;
+    Array_<Vector> allY;
+    Array_<Real> times;
+    Matrix y;
+    while (integ.getTime() < 3) {
+        if (integ.stepTo(3) != Integrator::TimeHasAdvanced)
+            continue;
+        const Real t1 = integ.getAdvancedTime();
+        const Real h = integ.getPreviousStepSizeTaken();
+        times.clear();
+        for (Real frac : {0.75, 0.5, 0.25, 0.})
+            times.push_back(t1 - frac*h);
+        integ.interpolateMany(times, y);
+        ASSERT(y.ncol() == (int)times.size());
+        ASSERT((y(times.size()-1) - integ.getAdvancedState().getY())
+               .normInf() < 1e-12);
+        for (int j=0; j < (int)times.size(); ++j) {
+            allTimes.push_back(times[j]);
+            allY.push_back(y(j));
+        }
+        bool threw = false;
+        try {integ.interpolateMany(Array_<Real>(1, t1+h), y);}
+        catch (const std::exception&) {threw = true;}
+        ASSERT(threw);
+    }
+
+    for (int i=0; i < (int)allTimes.size(); ++i) {
+        while (reference.getTime() < allTimes[i])
+            reference.stepTo(allTimes[i]);
+        ASSERT((reference.getState().getY() - allY[i]).normInf() < 1e-10);
+    }
+}
+
+// Localizing Velocity-stage triggers at Velocity stage must find the same
+// events, and so produce the same trajectory, as realizing every trial state
+// through Acceleration, but with fewer acceleration evaluations.
+void testLocalizeEventsAtTriggerStage() {
+    PendulumSystem sys;
+    sys.addEventHandler(new ZeroVelocityHandler(sys));
+    sys.realizeTopology();
+    const Real qi[] = {1,0}, ui[] = {0,0};
+    sys.setDefaultMass(10);
+    sys.setDefaultTimeAndState(0, Vector(2, qi), Vector(2, ui));
+
+    Vector yFinal[2];
+    int nEvents[2], nAccelerations[2];
+    for (int atTriggerStage=0; atTriggerStage <= 1; ++atTriggerStage) {
+        ZeroVelocityHandler::eventCount = 0;
+        ZeroVelocityHandler::lastEventTime = 0;
+        sys.resetAllCountersToZero();
+
+        RungeKuttaMersonIntegrator integ(sys);
+        ASSERT(integ.getLocalizeEventsAtTriggerStage());
+        integ.setLocalizeEventsAtTriggerStage(atTriggerStage != 0);
+        ASSERT(integ.getLocalizeEventsAtTriggerStage() == (atTriggerStage!=0));
+        integ.setAccuracy(1e-4);
+        TimeStepper ts(sys, integ);
+        ts.initialize(sys.getDefaultState());
+        ts.stepTo(10);
+
+        yFinal[atTriggerStage] = ts.getState().getY();
+        nEvents[atTriggerStage] = ZeroVelocityHandler::eventCount;
+        nAccelerations[atTriggerStage] = 
+            sys.getNumRealizationsOfThisStage(Stage::Acceleration);
+    }
+    ASSERT(nEvents[0] > 0 && nEvents[1] == nEvents[0]);
+    ASSERT((yFinal[1] - yFinal[0]).normInf() == 0);
+    ASSERT(nAccelerations[1] < nAccelerations[0]);
+}
+
 int main () {
   try {
+    testInterpolateMany();
+    testLocalizeEventsAtTriggerStage();
+
     PendulumSystem sys;
     sys.addEventHandler(new ZeroVelocityHandler(sys));
     sys.addEventHandler(PeriodicHandler::handler = new PeriodicHandler());
@@ -48,6 +139,8 @@ int main () {
         testIntegrator(integ, sys);
         integ.setReturnEveryInternalStep(true);
         testIntegrator(integ, sys);
+        integ.setLocalizeEventsAtTriggerStage(false);
+        testIntegrator(integ, sys);
     }
     cout << "Done" << endl;
     return 0;
@@ -0,0 +1,174 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKmath.h"
+
+#include <set>
+#include <utility>
+
+using namespace SimTK;
+using namespace std;
+
+typedef set< pair<int,int> > PairSet;
+
+PairSet findPairs(SpatialIndex& index) {
+    Array_< pair<int,int> > pairs;
+    index.findOverlappingPairs(pairs);
+    PairSet found;
+    for (const pair<int,int>& p : pairs) {
+        SimTK_TEST(p.first != p.second);
+        const pair<int,int> sorted(min(p.first,p.second),
+                                   max(p.first,p.second));
+        SimTK_TEST(found.insert(sorted).second); // no duplicates
+    }
+    return found;
+}
+
+// Check the exact tests for each combination of bound types, using pairs
+// whose axis-aligned enclosing boxes overlap but which don't intersect.
+void testBoundTypes() {
+    SpatialIndex index;
+    index.resize(2);
+
+    // Spheres.
+    index.setSphere(0, Vec3(0), 1);
+    index.setSphere(1, Vec3(1.5, 1.5, 0), 1);
+    SimTK_TEST(!index.boundsIntersect(0, 1));
+    index.setSphere(1, Vec3(1.4, 0, 0), 1);
+    SimTK_TEST(index.boundsIntersect(0, 1));
+
+    // Sphere and AABB near a corner.
+    index.setAABB(1, Vec3(0.8, 0.8, -1), Vec3(2, 2, 1));
+    SimTK_TEST(!index.boundsIntersect(0, 1));
+    SimTK_TEST(!index.boundsIntersect(1, 0));
+    index.setAABB(1, Vec3(0.6, 0.6, -1), Vec3(2, 2, 1));
+    SimTK_TEST(index.boundsIntersect(1, 0));
+
+    // AABBs.
+    index.setAABB(0, Vec3(0), Vec3(1));
+    index.setAABB(1, Vec3(1, 0.5, 0.5), Vec3(2)); // touching face
+    SimTK_TEST(index.boundsIntersect(0, 1));
+    index.setAABB(1, Vec3(1.01, 0, 0), Vec3(2));
+    SimTK_TEST(!index.boundsIntersect(0, 1));
+
+    // An OBB rotated 45 degrees about z, whose corner points at an AABB
+    // and a sphere that its enclosing box overlaps.
+    const Rotation R(Pi/4, ZAxis);
+    index.setOBB(0, OrientedBoundingBox(Transform(R, Vec3(0)), Vec3(1)));
+    index.setAABB(1, Vec3(0.6, 0.9, 0), Vec3(2));
+    SimTK_TEST(!index.boundsIntersect(0, 1));
+    index.setAABB(1, Vec3(0.2, 0.6, 0), Vec3(2));
+    SimTK_TEST(index.boundsIntersect(0, 1));
+    index.setSphere(1, Vec3(0.65, 0.95, 0.5), Real(0.1));
+    SimTK_TEST(!index.boundsIntersect(1, 0));
+    index.setSphere(1, Vec3(0, 0.6, 0.5), Real(0.1));
+    SimTK_TEST(index.boundsIntersect(1, 0));
+    index.setOBB(1, OrientedBoundingBox(Transform(Vec3(0.6, 0.9, 0)),
+                                        Vec3(1)));
+    SimTK_TEST(!index.boundsIntersect(0, 1));
+    index.setOBB(1, OrientedBoundingBox(Transform(Vec3(0, 0.6, 0)),
+                                        Vec3(1)));
+    SimTK_TEST(index.boundsIntersect(0, 1));
+}
+
+// Set a random mix of bounds around the given centers.
+void setBounds(SpatialIndex& index, const Array_<Vec3>& centers,
+               Random::Uniform& random) {
+    for (int i=0; i < (int)centers.size(); ++i) {
+        const Real size = Real(0.05) + Real(0.05)*random.getValue();
+        switch (i % 3) {
+        case 0:
+            index.setSphere(i, centers[i], size);
+            break;
+        case 1:
+            index.setAABB(i, centers[i]-size, centers[i]+size);
+            break;
+        case 2: {
+            const Rotation R(BodyRotationSequence,
+                             Pi*random.getValue(), XAxis,
+                             Pi*random.getValue(), YAxis,
+                             Pi*random.getValue(), ZAxis);
+            index.setOBB(i, OrientedBoundingBox
+               (Transform(R, centers[i] - R*Vec3(size)), Vec3(2*size)));
+            break;
+        }
+        }
+    }
+}
+
+// The sweep remembers its order from one call to the next; make sure it
+// finds the same pairs as checking every pair, whether the objects move a
+// little at a time, jump to unrelated positions, change which axis they're
+// spread along, or change in number.
+void testSweepAndPrune() {
+    const int NumObjects = 400;
+    SpatialIndex sweep, brute;
+    brute.setAlgorithm(SpatialIndex::BruteForce);
+    SimTK_TEST(sweep.getAlgorithm() == SpatialIndex::SweepAndPrune);
+    sweep.resize(NumObjects); brute.resize(NumObjects);
+    SimTK_TEST(sweep.getNumObjects() == NumObjects);
+
+    Random::Uniform random(-1, 1);
+    random.setSeed(0);
+    Array_<Vec3> centers(NumObjects);
+    for (Vec3& center : centers)
+        center = Vec3(random.getValue(), random.getValue(),
+                      random.getValue());
+
+    int numNonEmpty = 0;
+    for (int trial=0; trial < 60; ++trial) {
+        if (trial == 20) { // jump to new positions
+            for (Vec3& center : centers)
+                center = Vec3(random.getValue(), random.getValue(),
+                              random.getValue());
+        } else if (trial == 40) { // spread the objects out along z
+            for (Vec3& center : centers)
+                center = Vec3(center[0]/2, center[1]/2, 5*center[2]);
+        } else if (trial == 50) { // drop some objects
+            centers.resize(NumObjects/2);
+            sweep.resize(NumObjects/2); brute.resize(NumObjects/2);
+        } else { // small motions
+            for (Vec3& center : centers)
+                center += Real(0.02)*Vec3(random.getValue(),
+                                          random.getValue(),
+                                          random.getValue());
+        }
+        // Both get the same bounds, which are random shapes.
+        random.setSeed(trial);
+        setBounds(sweep, centers, random);
+        random.setSeed(trial);
+        setBounds(brute, centers, random);
+
+        const PairSet expected = findPairs(brute);
+        SimTK_TEST(findPairs(sweep) == expected);
+        if (!expected.empty()) ++numNonEmpty;
+    }
+    SimTK_TEST(numNonEmpty == 60); // make sure the test tested something
+}
+
+int main() {
+    SimTK_START_TEST("TestSpatialIndex");
+        SimTK_SUBTEST(testBoundTypes);
+        SimTK_SUBTEST(testSweepAndPrune);
+    SimTK_END_TEST();
+}
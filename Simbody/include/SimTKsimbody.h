@@ -53,6 +53,7 @@ will include this one). **/
 #include "simbody/internal/ElasticFoundationForce.h"
 #include "simbody/internal/Force.h"
 #include "simbody/internal/Force_BuiltIns.h"
+#include "simbody/internal/ForceJacobian.h"
 #include "simbody/internal/ForceSubsystem.h"
 #include "simbody/internal/ForceSubsystemGuts.h"
 #include "simbody/internal/SimbodyMatterSubsystem.h"
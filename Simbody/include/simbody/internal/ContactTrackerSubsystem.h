@@ -243,6 +243,22 @@ be false. If no tracker was registered, this will be the default tracker. **/
 const ContactTracker& getContactTracker(ContactGeometryTypeId surface1, 
                                         ContactGeometryTypeId surface2,
                                         bool& reverseOrder) const;
+
+/** Set the number of threads that may be used to track surface pairs in
+parallel once the broad phase has found them. By default, the subsystem uses
+ParallelExecutor::getSharedExecutor(); calling this method gives it a private
+executor with its own threads instead. Pass 1 to track every pair serially.
+The resulting contacts, and their ContactIds, are the same however many
+threads are used. Pairs are only tracked in parallel when there are enough of
+them to be worth it, and pairs involving a ContactGeometry::SmoothHeightMap
+are always tracked serially.
+
+@note This method should NOT be called while contacts are being tracked. **/
+void setNumberOfThreads(unsigned numThreads);
+
+/** Return the number of threads that may be used to track surface pairs in
+parallel; see setNumberOfThreads(). **/
+int getNumberOfThreads() const;
 /**@}**/
 
 /**@name                     Advanced/Obscure
@@ -0,0 +1,179 @@
+#ifndef SimTK_SIMBODY_FORCE_JACOBIAN_H_
+#define SimTK_SIMBODY_FORCE_JACOBIAN_H_
+
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon.h"
+#include "simbody/internal/common.h"
+
+#include <cassert>
+
+namespace SimTK {
+
+class SimbodyMatterSubsystem;
+
+/** This is a sparse accumulator for the derivatives of the generalized forces
+f produced by force elements with respect to the generalized coordinates and
+speeds. It is filled in by GeneralForceSubsystem::calcForceJacobian(), which
+calls each force element's optional calcForceJacobian() method in turn; see
+Force::Custom::Implementation::calcForceJacobian().
+
+Both matrices are nu X nu and are kept as unsorted lists of (row, column,
+value) triplets; entries with the same row and column are summed.
+  - The <em>position derivatives</em> are df/dq*N, the change in f due to a
+    change in the configuration along the generalized speeds (so that
+    dq=N*du). When qdot=u, which is true for all mobilizers except those
+    using quaternions, this is just df/dq.
+  - The <em>velocity derivatives</em> are df/du.
+
+These are the derivatives of the element's scalar force law only. The terms
+that come from the change of the kinematic Jacobians themselves with the
+configuration (for example, a constant force applied to a rotating body) are
+neglected. That makes the result well suited to forming the iteration matrix
+of an implicit integrator or a sensitivity estimate for stiff force elements,
+for which these are the dominant terms, but it is not the exact Jacobian of the
+accelerations.
+
+A force element that is applied between points or frames on two bodies
+should use addStationPairDerivatives() or addFramePairDerivatives(); these
+project a small dense derivative matrix given in Ground through the kinematic
+Jacobians of the two bodies, touching only the mobilities of their ancestors.
+**/
+class SimTK_SIMBODY_EXPORT ForceJacobian {
+public:
+    /** One stored element: value is added at (row,col). **/
+    struct Entry {
+        Entry() {}
+        Entry(UIndex row, UIndex col, Real value)
+        :   row(row), col(col), value(value) {}
+        UIndex row, col;
+        Real   value = NaN;
+    };
+
+    ForceJacobian() {}
+
+    /** Discard any entries and prepare to accumulate derivatives for the
+    given \a state, which must have been realized through Position stage. The
+    \a matter subsystem must remain alive while entries are being added. **/
+    void initialize(const SimbodyMatterSubsystem& matter, const State& state);
+
+    /** Discard the entries, but keep the size and kinematics of the last call
+    to initialize(). **/
+    void clear() {positionDerivs.clear(); velocityDerivs.clear();}
+
+    /** Return nu, the dimension of the matrices. **/
+    int getNumMobilities() const {return nu;}
+
+    /** Add \a value to the element (row,col) of the position derivatives
+    df/dq*N. **/
+    void addPositionDerivative(UIndex row, UIndex col, Real value) {
+        assert(0 <= row && row < nu && 0 <= col && col < nu);
+        positionDerivs.push_back(Entry(row, col, value));
+    }
+    /** Add \a value to the element (row,col) of the velocity derivatives
+    df/du. **/
+    void addVelocityDerivative(UIndex row, UIndex col, Real value) {
+        assert(0 <= row && row < nu && 0 <= col && col < nu);
+        velocityDerivs.push_back(Entry(row, col, value));
+    }
+
+    /** Add the derivatives of a force element that applies a force F to a
+    station on body 2 and -F to a station on body 1, where F (expressed in
+    Ground) depends on the Ground-frame position p = p2-p1 and velocity
+    v = v2-v1 of the second station relative to the first. The two stations
+    are given in their own body frames and need not be coincident.
+    @param[in]      state       as given to initialize()
+    @param[in]      body1,station1,body2,station2   the two stations
+    @param[in]      dFdp        the derivative of F with respect to p
+    @param[in]      dFdv        the derivative of F with respect to v **/
+    void addStationPairDerivatives(const State&       state,
+                                   MobilizedBodyIndex body1,
+                                   const Vec3&        station1,
+                                   MobilizedBodyIndex body2,
+                                   const Vec3&        station2,
+                                   const Mat33&       dFdp,
+                                   const Mat33&       dFdv);
+
+    /** Add the derivatives of a force element that applies a spatial force F
+    (moment, force) to a frame on body 2 and -F to a frame on body 1, where F
+    (expressed in Ground) depends on the relative configuration and spatial
+    velocity (angular, linear) of the second frame with respect to the first.
+    Only the origins of the frames matter; these are given in their own body
+    frames. The linear part of the relative velocity is that of the second
+    origin with respect to the point of body 1 at the first origin.
+    @param[in]      state       as given to initialize()
+    @param[in]      body1,origin1,body2,origin2     the two frame origins
+    @param[in]      dFdX        the derivative of F with respect to a small
+                                relative rotation and displacement
+    @param[in]      dFdV        the derivative of F with respect to the
+                                relative spatial velocity **/
+    void addFramePairDerivatives(const State&       state,
+                                 MobilizedBodyIndex body1,
+                                 const Vec3&        origin1,
+                                 MobilizedBodyIndex body2,
+                                 const Vec3&        origin2,
+                                 const SpatialMat&  dFdX,
+                                 const SpatialMat&  dFdV);
+
+    /** Get the stored elements of the position derivatives df/dq*N. **/
+    const Array_<Entry>& getPositionDerivatives() const
+    {   return positionDerivs; }
+    /** Get the stored elements of the velocity derivatives df/du. **/
+    const Array_<Entry>& getVelocityDerivatives() const
+    {   return velocityDerivs; }
+
+    /** Form the position derivatives df/dq*N as a dense nu X nu Matrix. **/
+    void getPositionDerivatives(Matrix& dfdq) const
+    {   toDense(positionDerivs, dfdq); }
+    /** Form the velocity derivatives df/du as a dense nu X nu Matrix. **/
+    void getVelocityDerivatives(Matrix& dfdu) const
+    {   toDense(velocityDerivs, dfdu); }
+
+private:
+    // Collect the columns of the relative spatial Jacobian of origin2 on
+    // body2 with respect to origin1 on body1 into relCols/relJ.
+    void calcRelativeJacobian(const State& state,
+                              MobilizedBodyIndex body1, const Vec3& origin1,
+                              MobilizedBodyIndex body2, const Vec3& origin2);
+    void toDense(const Array_<Entry>& entries, Matrix& m) const;
+
+    const SimbodyMatterSubsystem*   matter = nullptr;
+    int                             nu = 0;
+
+    // The sparse system Jacobian (see
+    // SimbodyMatterSubsystem::calcSparseSystemJacobian()), shared by all the
+    // elements that use the station or frame pair helpers.
+    Array_<int>                     rowStart, colIndex;
+    Array_<SpatialVec>              J_G;
+
+    // Scratch for the pair helpers.
+    Array_<UIndex>                  relCols;
+    Array_<SpatialVec>              relJ, dFdXJ, dFdVJ;
+
+    Array_<Entry>                   positionDerivs, velocityDerivs;
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SIMBODY_FORCE_JACOBIAN_H_
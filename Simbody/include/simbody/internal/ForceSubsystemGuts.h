@@ -35,6 +35,8 @@
 
 namespace SimTK {
 
+class ForceJacobian;
+
 /// Public declaration of internals for ForceSubsystem extension
 class ForceSubsystem::Guts : public Subsystem::Guts {
 public:
@@ -58,6 +60,15 @@ public:
     /// be at Dynamics stage or later.
     virtual Real calcPotentialEnergy(const State& state) const = 0;
 
+    /// Add the derivatives of this subsystem's generalized forces to an
+    /// already-initialized \a jacobian; see ForceJacobian. The state must be
+    /// at Dynamics stage or later. Return false if this subsystem can't
+    /// supply them, which is the default.
+    virtual bool addInForceJacobian(const State& state, 
+                                    ForceJacobian& jacobian) const {
+        return false;
+    }
+
     SimTK_DOWNCAST(ForceSubsystem::Guts, Subsystem::Guts);
 };
 
@@ -26,6 +26,7 @@
 
 #include "SimTKcommon.h"
 #include "simbody/internal/Force.h"
+#include "simbody/internal/ForceJacobian.h"
 
 /** @file
 This contains the user-visible API ("handle" class) for the SimTK::Force 
@@ -231,14 +232,59 @@ public:
      *                       this is ignored.
      * @param mobilityForces forces on individual mobilities (elements of the state's u vector) are accumulated in this.
      *                       To apply a force to a mobility, add it to the appropriate element of this vector.
+     *
+     * You must override either this method or, for a force that only affects a few bodies, getSparsity() and
+     * calcSparseForce(); the default implementation throws an exception.
+     */
+    virtual void calcForce(const State& state, Vector_<SpatialVec>& bodyForces, Vector_<Vec3>& particleForces, Vector& mobilityForces) const;
+    /**
+     * (Optional) Declare that this force only affects a fixed, small set of bodies and mobilities. If you override
+     * this to fill in the lists and return true, Simbody calls calcSparseForce() instead of calcForce(), giving it
+     * compact arrays with one entry per listed body and mobility. This saves the force from touching full-length
+     * arrays, and lets a GeneralForceSubsystem that is calculating forces in parallel add the result directly 
+     * into the System's force arrays rather than into a full-length per-thread copy. This is called once, when
+     * the topology is realized, and the lists must not change afterwards.
+     *
+     * @param bodies         the mobilized bodies on which this force may apply spatial forces
+     * @param mobilityBodies the mobilized bodies whose mobilities (generalized speeds) this force may apply 
+     *                       generalized forces to
+     * @return true to use calcSparseForce(), false (the default) to use calcForce()
      */
-    virtual void calcForce(const State& state, Vector_<SpatialVec>& bodyForces, Vector_<Vec3>& particleForces, Vector& mobilityForces) const = 0;
+    virtual bool getSparsity(Array_<MobilizedBodyIndex>& bodies, Array_<MobilizedBodyIndex>& mobilityBodies) const {
+        return false;
+    }
+    /**
+     * Calculate the force for a given state into compact arrays. This is only called if getSparsity() returned
+     * true; like calcForce(), it must \e add in its forces.
+     *
+     * @param state          the State for which to calculate the force
+     * @param bodyForces     bodyForces[i] accumulates the spatial force on the i'th body listed by getSparsity()
+     * @param mobilityForces accumulates the generalized forces on the mobilities of the bodies listed in
+     *                       \a mobilityBodies by getSparsity(): first all the mobilities of the first body in 
+     *                       the order of its u's, then those of the second, and so on
+     */
+    virtual void calcSparseForce(const State& state, Vector_<SpatialVec>& bodyForces, Vector& mobilityForces) const {}
     /**
      * Calculate this force's contribution to the potential energy of the System.
      * 
      * @param state          the State for which to calculate the potential energy
      */
     virtual Real calcPotentialEnergy(const State& state) const = 0;
+    /**
+     * (Optional) Calculate the derivatives of this force's generalized forces with respect to the generalized
+     * coordinates and speeds, and add them to \a jacobian. This is called by 
+     * GeneralForceSubsystem::calcForceJacobian(), and by MultibodySystem's System::calcYDotJacobian(), which
+     * SDIRKIntegrator uses in place of numerical differentiation when every enabled force element supports it. Use ForceJacobian::addStationPairDerivatives() or
+     * ForceJacobian::addFramePairDerivatives() for forces acting between two bodies. The default implementation
+     * returns false to indicate that this force can't calculate its derivatives.
+     *
+     * @param state          the State for which to calculate the derivatives, realized through Dynamics stage
+     * @param jacobian       the derivatives are accumulated in this
+     * @return true if the derivatives were added, false if this force doesn't provide them
+     */
+    virtual bool calcForceJacobian(const State& state, ForceJacobian& jacobian) const {
+        return false;
+    }
     /**
      * Get whether this force depends only on the position variables (q), not on the velocies (u) or auxiliary variables (z).
      * The default implementation returns false.  If the force depends only on positions, you should override this to return
@@ -34,6 +34,7 @@ namespace SimTK {
 class MultibodySystem;
 class SimbodyMatterSubsystem;
 class Force;
+class ForceJacobian;
 
 /** This is a concrete subsystem which can apply arbitrary forces to a 
 MultibodySystem. Each force element is represented by a Force object. For 
@@ -89,8 +90,10 @@ public:
     /** Set the number of threads that the GeneralForceSubsystem can use to
     calculate computationally expensive forces (that have the
     shouldBeParallelIfPossible() method overridden). By default, the
-    number of threads is the number of total processors (including hyperthreads)
-    on the machine.
+    subsystem uses ParallelExecutor::getSharedExecutor(), whose thread count
+    is the number of total processors (including hyperthreads) on the machine
+    unless it has been changed. Calling this method gives the subsystem a
+    private executor with its own threads instead.
     
     @note This method should NOT be called while realizing Stage::Dynamics.**/
     void setNumberOfThreads(unsigned numThreads);
@@ -103,6 +106,33 @@ public:
     computations**/
     int getNumberOfThreads() const;
 
+    /** Return the measured wall-clock time, in seconds, that the given force
+    element's calculation takes, smoothed over recent evaluations. This is
+    recorded whenever the subsystem contains forces that have overridden
+    shouldBeParallelIfPossible(), and is used to distribute the forces over
+    the available threads so that one expensive force doesn't leave the other
+    threads idle. Returns 0 if the force hasn't been timed yet. **/
+    Real getEstimatedForceCost(ForceIndex index) const;
+
+    /** Return the estimated time, in seconds, of the share of the force
+    calculation assigned to each thread in the current distribution of forces
+    over threads; that is, the sum of getEstimatedForceCost() over the forces
+    assigned to each thread. Comparing the entries shows how well balanced
+    the parallel force calculation is. This is empty until parallel forces
+    have been calculated at least once. **/
+    const Array_<Real>& getEstimatedThreadLoads() const;
+
+    /** Calculate the derivatives of the generalized forces produced by the 
+    enabled force elements with respect to the generalized coordinates and 
+    speeds, by asking each element for its contribution; see ForceJacobian
+    for what is and isn't included. The \a state must be realized through 
+    Dynamics stage, since some elements (such as HuntCrossleyForce) use 
+    results computed there.
+    @return true if every enabled force element supplied its derivatives; 
+    false if any didn't, in which case \a jacobian is incomplete and the 
+    caller should fall back to differentiating the forces numerically. **/
+    bool calcForceJacobian(const State& state, ForceJacobian& jacobian) const;
+
     /** Every Subsystem is owned by a System; a GeneralForceSubsystem expects
     to be owned by a MultibodySystem. This method returns a const reference
     to the containing MultibodySystem and will throw an exception if there is
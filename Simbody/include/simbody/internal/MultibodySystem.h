@@ -81,6 +81,24 @@ public:
         return calcPotentialEnergy(s)+calcKineticEnergy(s);
     }
 
+    /// Realize each of a collection of States, all belonging to this System,
+    /// through Stage \a g. This is equivalent to calling realize() on each
+    /// State in turn but the States are distributed over up to \a numThreads
+    /// threads (by default, those of ParallelExecutor::getSharedExecutor()).
+    /// This is intended for Monte-Carlo and optimization workloads that
+    /// evaluate many independent States of the same System. While a batch
+    /// is running, the subsystems do not use their own parallelism (see 
+    /// GeneralForceSubsystem::setNumberOfThreads() and
+    /// SimbodyMatterSubsystem::setNumberOfThreads()); all the work for a 
+    /// given State is done on one thread. Any Force::Custom or other
+    /// user-written elements in the System must be safe to evaluate 
+    /// concurrently for different States. If realizing any State throws an
+    /// exception, the first such exception is rethrown here after the
+    /// remaining States have been processed.
+    void realizeBatch(const Array_<State*>& states, 
+                      Stage g = Stage::HighestRuntime,
+                      int numThreads = 0) const;
+
     // These methods are for use by our constituent subsystems to communicate 
     // with each other and with the MultibodySystem as a whole.
 
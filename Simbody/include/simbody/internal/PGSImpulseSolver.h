@@ -50,6 +50,10 @@ When piUnknown_z[k] hits its upper limit of 0, we must have v_z[k] >= 0
 depends on all diag(A)[z[k]] > 0. That means that if v_z[k]<0 we could improve
 the solution by making piUnknown_z[k] negative, so it wouldn't have hit the
 limit.
+
+The two friction multipliers of a unilateral contact are updated together as
+a block, using 2x2 diagonal blocks of [A+D] that are Cholesky-factored as a
+batch once per solve.
 **/
 
 class SimTK_SIMBODY_EXPORT PGSImpulseSolver : public ImpulseSolver {
@@ -96,6 +100,9 @@ public:
 
 private:
     Real m_SOR; 
+    // Factored 2x2 friction blocks, reused by each solve() to avoid heap
+    // allocation.
+    mutable SymMatBatch<2> m_frictionBlocks;
 };
 
 } // namespace SimTK
@@ -146,11 +146,13 @@ private:
 
     // Each of these is indexed by ActiveIndex; they have dimension na.
     mutable Matrix m_JacActive;  // Jacobian for Newton iteration
+    mutable FactorQTZ m_JacActiveFactor; // reused across Newton iterations
     mutable Vector m_rhsActive;  // per-interval RHS for Newton iteration
     mutable Vector m_piActive;   // Current impulse during Newton.
     mutable Vector m_errActive;  // Error(piActive)
 
     mutable Matrix m_bilateralActive;  // temp for use by solveBilateral()
+    mutable FactorQTZ m_bilateralFactor; // same
 };
 
 } // namespace SimTK
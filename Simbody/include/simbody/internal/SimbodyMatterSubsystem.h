@@ -205,6 +205,50 @@ void setShowDefaultGeometry(bool show);
 geometry that can be used to visualize this multibody system. **/
 bool getShowDefaultGeometry() const;
 
+/** Set the number of threads the matter subsystem may use for its base-to-tip
+and tip-to-base sweeps (articulated body inertias, the two passes of the
+forward dynamics recursion, and the Y operator). All the mobilized bodies at a
+given level of the multibody tree are independent of one another during a
+sweep, so each level can be divided among the threads. When the system is a
+"forest" of several mechanisms attached to Ground that are not coupled by any
+Constraint, each such subtree is instead swept as a single task, including
+the position and velocity kinematics, and the constraint projection blocks
+belonging to different subtrees are factored concurrently. This pays off only
+for wide trees or forests; the default of 1 thread performs the sweeps serially, as before.
+Results are identical either way. Custom mobilizers used with more than one
+thread must be safe to evaluate concurrently.
+
+@note This method should NOT be called while the subsystem is being
+realized. **/
+void setNumberOfThreads(unsigned numThreads);
+
+/** Return the number of threads the matter subsystem may use for its
+level-by-level sweeps; see setNumberOfThreads(). The default is 1. **/
+int getNumberOfThreads() const;
+
+/** Request that position kinematics be recomputed incrementally. When this is
+enabled, the matter subsystem remembers the generalized coordinates q for which
+its position kinematics (the transforms X_FM, X_PB and X_GB, the hinge matrices,
+and spatial inertias in Ground) were last computed. The next time they have to
+be recomputed, only the mobilized bodies whose own q's have changed and the
+bodies outboard of those are recalculated; the rest keep their previous values.
+This is useful when a few q's at a time are perturbed many times for the same
+Instance-stage settings, as when a Differentiator or the Assembler computes a
+Jacobian by finite differences. The remembered q's are discarded after any
+change at Stage::Instance or below. Constraint position errors are always
+recomputed fully. The default is false; results are identical either way.
+
+@warning Custom mobilizers whose position kinematics depends on anything other
+than their own q's and Instance-stage information (time for example) must not
+be used with this option.
+@note This method should NOT be called while the subsystem is being
+realized. **/
+void setUseIncrementalPositionKinematics(bool useIncremental);
+
+/** Return true if incremental position kinematics has been requested; see
+setUseIncrementalPositionKinematics(). The default is false. **/
+bool getUseIncrementalPositionKinematics() const;
+
 /** The number of bodies includes all mobilized bodies \e including Ground,
 which is the first mobilized body, at MobilizedBodyIndex 0. (Note: if 
 special particle handling were implemented, the count here would \e not 
@@ -866,6 +910,57 @@ void calcStationJacobian(const State&       state,
 }
 
 
+/** Calculate the whole-system kinematic Jacobian J_G (see calcSystemJacobian())
+in compressed sparse row (CSR) form, with each element a SpatialVec. Row B of
+J_G (the spatial velocity of body B) depends only on the mobilities of B's own
+mobilizer and those of its ancestors, so only those elements are stored; for a
+long chain this is about half of the dense matrix, and for a wide tree or
+forest much less than that. The nonzeros of row B are 
+J_G[rowStart[B] .. rowStart[B+1]-1], and colIndex holds the corresponding 
+mobility (u) index of each element, in increasing order.
+
+@param[in]      state
+    A State that has already been realized through Position stage.
+@param[out]     rowStart
+    Resized to nb+1. Entry B is the position in \a colIndex and \a J_G of 
+    the first stored element of row B; the last entry is the total number 
+    of stored elements nnz. Row 0 (Ground) is always empty.
+@param[out]     colIndex
+    Resized to nnz; the mobility index of each stored element.
+@param[out]     J_G
+    Resized to nnz; the stored elements, row by row.
+
+<h3>Performance discussion</h3>
+Each stored element costs about 12 flops to compute directly from the
+mobilizer's hinge matrix, so the cost is O(nnz) time and memory rather than
+the O(n^2) of calcSystemJacobian(). It is still usually better to use 
+multiplyBySystemJacobian() if you need only a few matrix-vector products.
+
+@see calcSystemJacobian(), calcSparseStationJacobian() **/
+void calcSparseSystemJacobian(const State&              state,
+                              Array_<int>&              rowStart,
+                              Array_<int>&              colIndex,
+                              Array_<SpatialVec>&       J_G) const;
+
+/** Calculate the station Jacobian JS for a set of nt station tasks (see 
+calcStationJacobian()) in compressed sparse row form, with one row of Vec3 
+elements per task. Only the mobilities of the task body's mobilizer and those 
+of its ancestors are stored, in increasing order. The layout of \a rowStart, 
+\a colIndex, and \a JS is the same as for calcSparseSystemJacobian(), except 
+that there are nt rows instead of nb. Cost is O(nt + nnz) where nnz is the 
+total number of stored elements, about 12 flops each; compare with
+calcStationJacobian() which works on the full 3*nt X n matrix.
+
+@see calcStationJacobian(), calcSparseSystemJacobian() **/
+void calcSparseStationJacobian
+   (const State&                        state,
+    const Array_<MobilizedBodyIndex>&   onBodyB,
+    const Array_<Vec3>&                 stationPInB,
+    Array_<int>&                        rowStart,
+    Array_<int>&                        colIndex,
+    Array_<Vec3>&                       JS) const;
+
+
 /** Calculate the acceleration bias term for a station Jacobian, that is, the
 part of the station's acceleration that is due only to velocities. This term 
 is also known as the Coriolis acceleration, and it is returned here as a linear
@@ -1224,6 +1319,68 @@ SpatialVec calcBiasForFrameJacobian(const State&         state,
     return JFDotu[0];
 }
 
+/** Calculate the 3*nt X 3*nt inverse operational-space (task-space) inertia
+matrix LambdaInv = JS M^-1 ~JS for a set of nt station tasks, where JS is the
+station task Jacobian described in calcStationJacobian(). Rows and columns 
+3i..3i+2 correspond to station i's Ground-frame x,y,z directions.
+
+Neither M nor JS is formed. Each column of ~JS is one O(n) ~J_G sweep, then 
+all the columns of M^-1 ~JS are formed together with 
+multiplyByMInvColumns(), and each column of the result is 
+one O(n) J_G sweep. Total cost is O(nt*(n+nt)). As with multiplyByMInv(), 
+prescribed mobilities are treated as having infinite mass. Constraints are 
+ignored. The result is symmetric.
+
+@par Required stage
+  \c Stage::Position (articulated body inertias realized first if necessary)
+@see calcStationTaskInertia(), calcFrameTaskInertiaInverse() **/
+void calcStationTaskInertiaInverse
+   (const State&                        state,
+    const Array_<MobilizedBodyIndex>&   onBodyB,
+    const Array_<Vec3>&                 stationPInB,
+    Matrix&                             LambdaInv) const;
+
+/** Calculate the 3*nt X 3*nt operational-space inertia matrix 
+Lambda = (JS M^-1 ~JS)^-1 for a set of nt station tasks. This is 
+calcStationTaskInertiaInverse() followed by an LU inversion of the small 
+task-space matrix, so Lambda is meaningless if the tasks are redundant or 
+the configuration is singular for them; use the inverse in that case.
+@par Required stage
+  \c Stage::Position (articulated body inertias realized first if necessary)
+@see calcStationTaskInertiaInverse() **/
+void calcStationTaskInertia
+   (const State&                        state,
+    const Array_<MobilizedBodyIndex>&   onBodyB,
+    const Array_<Vec3>&                 stationPInB,
+    Matrix&                             Lambda) const;
+
+/** Calculate the 6*nt X 6*nt inverse operational-space inertia matrix
+LambdaInv = JF M^-1 ~JF for a set of nt frame tasks, where JF is the frame 
+task Jacobian in the scalar form returned by calcFrameJacobian(). Rows
+6i..6i+2 are task frame i's angular directions and 6i+3..6i+5 its linear 
+directions, in Ground. Otherwise this is the same as 
+calcStationTaskInertiaInverse().
+@par Required stage
+  \c Stage::Position (articulated body inertias realized first if necessary)
+@see calcFrameTaskInertia(), calcStationTaskInertiaInverse() **/
+void calcFrameTaskInertiaInverse
+   (const State&                        state,
+    const Array_<MobilizedBodyIndex>&   onBodyB,
+    const Array_<Vec3>&                 originAoInB,
+    Matrix&                             LambdaInv) const;
+
+/** Calculate the 6*nt X 6*nt operational-space inertia matrix
+Lambda = (JF M^-1 ~JF)^-1 for a set of nt frame tasks. See 
+calcStationTaskInertia() for caveats.
+@par Required stage
+  \c Stage::Position (articulated body inertias realized first if necessary)
+@see calcFrameTaskInertiaInverse() **/
+void calcFrameTaskInertia
+   (const State&                        state,
+    const Array_<MobilizedBodyIndex>&   onBodyB,
+    const Array_<Vec3>&                 originAoInB,
+    Matrix&                             Lambda) const;
+
 /**@}**/
 
 //==============================================================================
@@ -1261,6 +1418,18 @@ realization of composite-body or articulated-body inertias.
   \c Stage::Position **/
 void multiplyByM(const State& state, const Vector& a, Vector& Ma) const;
 
+/** Same as the Vector version of multiplyByM() but applied to each column of
+an nu X k matrix \a A at once, producing MA=M*A. The tree is swept once per 
+pass for all k columns rather than k times, which amortizes the per-body
+overhead when k is large (for example, when forming M*~G or similar products).
+\a A and \a MA need not have contiguous storage but this is faster if
+their columns are contiguous, as they are by default. This is not an
+overload of multiplyByM() so that passing Matrix column views to the Vector
+version is not ambiguous.
+@par Required stage
+  \c Stage::Position **/
+void multiplyByMColumns(const State& state, const Matrix& A, Matrix& MA) const;
+
 /** This operator calculates in O(n) time the product M^-1*v where M is the 
 system mass matrix and v is a supplied vector with one entry per u-space
 mobility. If v is a set of generalized forces f, the result is a generalized 
@@ -1344,6 +1513,18 @@ void multiplyByMInv(const State&    state,
                     const Vector&   v,
                     Vector&         MinvV) const;
 
+/** Same as the Vector version of multiplyByMInv() but applied to each column
+of an nu X k matrix \a V at once, producing MinvV=M^-1*V. Each articulated
+body inertia is visited once per pass for all k columns, which is much faster 
+than calling the Vector version k times when k is large. Prescribed entries
+of the result are set to zero as described above.
+@par Required stage
+  \c Stage::Position (articulated body inertias realized first if necessary)
+@see multiplyByMInv(const State&,const Vector&,Vector&) **/
+void multiplyByMInvColumns(const State&    state,
+                           const Matrix&   V,
+                           Matrix&         MinvV) const;
+
 /** This operator explicitly calculates the n X n mass matrix M. Note that this
 is inherently an O(n^2) operation since the mass matrix has n^2 elements 
 (although only n(n+1)/2 are unique due to symmetry). <em>DO NOT USE THIS CALL 
@@ -1378,6 +1559,39 @@ with the calcM() method.
 @see multiplyByMInv(), calcM() **/
 void calcMInv(const State&, Matrix& MInv) const;
 
+/** This operator factors the n X n mass matrix M as M = ~L*L where L is lower
+triangular, taking advantage of the "tree sparse" structure of M, and saves the
+factor in the \a state for use by solveM(). Element M(i,j) for i > j can be 
+nonzero only if mobility j belongs to the mobilizer of mobility i or one of 
+its ancestors, and L has exactly the same pattern so there is no fill-in. For
+a tree whose branches are at most d mobilities deep this costs O(n*d^2) time
+and O(n*d) memory, rather than the O(n^2) memory and O(n^3) time needed to
+form and factor M densely. If the factor is already up to date with the
+current configuration q this returns immediately. 
+
+Unlike multiplyByMInv(), this uses the entire mass matrix regardless of
+prescribed motion.
+
+@par Required stage
+  \c Stage::Position, or \c Stage::Instance and \c PositionKinematics 
+  (composite body inertias realized first if necessary)
+
+@see solveM(), calcM(), realizeCompositeBodyInertias() **/
+void calcMFactorSparse(const State& state) const;
+
+/** Solve M*udot = f for udot using the sparse factor of the mass matrix M
+computed by calcMFactorSparse(), calculating that factor first if necessary.
+Once the factor is available each solve takes about 4*nnz flops, where nnz is
+the number of stored elements of L. That is faster than multiplyByMInv() for
+shallow trees and avoids the articulated body inertias entirely. It is fine
+for \a f and \a udot to be the same Vector.
+
+@par Required stage
+  \c Stage::Position, or \c Stage::Instance and \c PositionKinematics
+
+@see calcMFactorSparse(), multiplyByMInv() **/
+void solveM(const State& state, const Vector& f, Vector& udot) const;
+
 /** This operator calculates in O(m*n) time the m X m "projected inverse mass 
 matrix" or "constraint compliance matrix" W=G*M^-1*~G, where G (mXn) is the 
 acceleration-level constraint Jacobian mapped to generalized coordinates,
@@ -2098,6 +2312,21 @@ void calcResidualForceIgnoringConstraints
     const Vector&              knownUdot,
     Vector&                    residualMobilityForces) const;
 
+/** Same as the Vector version of calcResidualForceIgnoringConstraints() but
+evaluates the residual for each column of an nu X k matrix \a knownUdot, 
+sweeping the tree once per pass for all k columns. The applied forces (which 
+may be zero length), as well as the inertial forces from the velocities in
+\a state, are the same for every column. Column j of the nu X k result 
+\a residualMobilityForces is the residual for column j of \a knownUdot.
+@par Required stage
+  \c Stage::Velocity **/
+void calcResidualForceColumnsIgnoringConstraints
+   (const State&               state,
+    const Vector&              appliedMobilityForces,
+    const Vector_<SpatialVec>& appliedBodyForces,
+    const Matrix&              knownUdot,
+    Matrix&                    residualMobilityForces) const;
+
 
 /** This is the inverse dynamics operator for when you know both the 
 accelerations and Lagrange multipliers for a constrained system. Prescribed
@@ -395,7 +395,7 @@ calcPositionInfo(const State& state,
     // direction df. y = z X x = n X df.
     pc.p_AQf = p_APf + pc.tf * pc.df_A;             //  6 flops
     pc.p_AQb = p_APb + pc.tb * pc.db_A;             //  6
-    const Vec3 p_ACo = 0.5*(pc.p_AQf + pc.p_AQb);   //  6
+    const Vec3 p_ACo = (pc.p_AQf + pc.p_AQb)/2;     //  6
     pc.X_AC.updP() = p_ACo;
 
     // Since unit vector n is perpendicular to df (and db), n X df 
@@ -477,7 +477,7 @@ calcVelocityInfo(const State& state,
 
     const Vec3 dQf = v_APf + dtf * pc.df_A + pc.tf * vc.ddf_A;  // 12 flops
     const Vec3 dQb = v_APb + dtb * pc.db_A + pc.tb * vc.ddb_A;  // 12
-    const Vec3 dCo = 0.5*(dQf + dQb);                           //  6
+    const Vec3 dCo = (dQf + dQb)/2;                             //  6
     const Vec3 dp_FCo = dCo - v_AF;                             //  3
     const Vec3 dp_BCo = dCo - v_AB;                             //  3
 
@@ -558,7 +558,7 @@ calcDecorativeGeometryAndAppendVirtual
     geom.push_back(DecorativeLine(p_GQf-half_Lf, p_GQf+half_Lf)
         .setColor(Green));
     geom.push_back(DecorativeFrame().setTransform(X_GEf)
-        .setColor(Green*.9).setLineThickness(1).setScale(0.5)); // F color        
+        .setColor(Green*Real(.9)).setLineThickness(1).setScale(0.5)); // F color        
     geom.push_back(DecorativePoint(p_GQf)
         .setColor(Orange).setLineThickness(2)); // B color
 
@@ -566,7 +566,7 @@ calcDecorativeGeometryAndAppendVirtual
     geom.push_back(DecorativeLine(p_GQb-half_Lb, p_GQb+half_Lb)
         .setColor(Orange));
     geom.push_back(DecorativeFrame().setTransform(X_GEb)
-        .setColor(Orange*.9).setLineThickness(1).setScale(0.5)); // B color
+        .setColor(Orange*Real(.9)).setLineThickness(1).setScale(0.5)); // B color
     geom.push_back(DecorativePoint(p_GQb)
         .setColor(Green).setLineThickness(2)); // F color
 
@@ -32,6 +32,7 @@ using std::pair; using std::make_pair;
 #include <iostream>
 using std::cout; using std::endl;
 #include <set>
+#include <algorithm>
 
 using namespace SimTK;
 
@@ -67,22 +68,54 @@ static std::ostream& operator<<(std::ostream& o, const Bubble& bb) {
     return o;
 }
 
-// For spatial sorting of bubbles.
-class BubbleExtent {
+// One surface pair that needs a narrow phase investigation, with everything
+// its ContactTracker needs so that the pairs can be tracked independently of
+// one another, and in parallel. The surfaces are in the order required by
+// the tracker.
+struct NarrowPhasePair {
+    void track() {
+        UntrackedContact untracked; // empty handle in case we need it
+        if (!prev) untracked = UntrackedContact(surf1, surf2);
+        tracker->trackContact(prev ? *prev : untracked, X_GS1, *geom1,
+                              X_GS2, *geom2, 0/*TODO*/, next);
+    }
+
+    ContactSurfaceIndex     surf1, surf2;
+    Transform               X_GS1, X_GS2;
+    const ContactGeometry*  geom1;
+    const ContactGeometry*  geom2;
+    const ContactTracker*   tracker;
+    const Contact*          prev;       // null if not being tracked
+    bool                    mustBeSerial;
+    Contact                 next;       // result; empty if no contact
+};
+
+// Tracks the selected pairs; each is written only by the thread that tracks
+// it so no locking is needed.
+class TrackPairsTask : public ParallelExecutor::Task {
 public:
-    BubbleExtent(Real start, Real end, BubbleIndex index) 
-    :   start(start), end(end), index(index) {}
-    BubbleExtent() {}
-    bool operator<(const BubbleExtent& e) const 
-    {   return start < e.start; }
-    Real        start, end; // span along chosen sort axis
-    BubbleIndex index;
+    TrackPairsTask(Array_<NarrowPhasePair>& pairs, const Array_<int>& which)
+    :   pairs(pairs), which(which) {}
+    void execute(int i) override {pairs[which[i]].track();}
+private:
+    Array_<NarrowPhasePair>&    pairs;
+    const Array_<int>&          which;
 };
-static std::ostream& operator<<(std::ostream& o, const BubbleExtent& bx) {
-    o << bx.index << ":(" << bx.start << "," << bx.end << ")";
-    return o;
+
+// A SmoothHeightMap keeps a hint of where on the surface it was last
+// evaluated, so two threads must not evaluate the same one at once. Pairs
+// involving one are tracked serially.
+static bool canTrackInParallel(const ContactGeometry& geom) {
+    return !ContactGeometry::SmoothHeightMap::isInstance(geom);
 }
 
+// Parallel tracking pays off only if there is enough work to amortize
+// starting the threads. A pair involving a triangle mesh costs very roughly
+// this many times as much as a pair of simple shapes; we go parallel once the
+// pairs add up to MinParallelWork simple ones.
+static const int MeshPairWork    = 50;
+static const int MinParallelWork = 64;
+
 typedef std::map< pair<ContactGeometryTypeId,ContactGeometryTypeId>,
                   pair<ContactTracker*,bool> > TrackerMap;
 
@@ -167,6 +200,21 @@ void adoptContactTracker(ContactTracker* tracker) {
     m_contactTrackers[make_pair(low,high)] = make_pair(tracker, mustReverse);
 }
 
+void setNumberOfThreads(unsigned numThreads) {
+    SimTK_APIARGCHECK_ALWAYS(numThreads > 0, "ContactTrackerSubsystem",
+                "setNumberOfThreads", "Number of threads must be positive");
+    m_executor = new ParallelExecutor(numThreads);
+}
+
+int getNumberOfThreads() const {
+    return getExecutor().getMaxThreads();
+}
+
+ParallelExecutor& getExecutor() const {
+    return m_executor.empty() ? ParallelExecutor::getSharedExecutor() 
+                              : m_executor.updRef();
+}
+
 // Return the MultibodySystem which owns this ContactTrackerSubsystem.
 const MultibodySystem& getMultibodySystem() const 
 {   return MultibodySystem::downcast(getSystem()); }
@@ -208,6 +256,14 @@ ContactSnapshot& updNextPredictedContacts(const State& state) const {
         (updDiscreteVarUpdateValue(state, m_predictedContactsIx));
     return contacts;
 }
+// The broad phase spatial index remembers the order it sorted the bubbles
+// into last time, which speeds up the next sort when the bodies have moved
+// only a little. It lives in a lazy cache entry that depends only on Instance
+// stage so that it survives position changes.
+SpatialIndex& updBroadPhaseIndex(const State& state) const {
+    return Value<SpatialIndex>::updDowncast
+        (updCacheEntry(state, m_broadPhaseIndexIx));
+}
 
 // Run through all the bodies to find the contact surfaces, assigning each
 // a unique ContactSurfaceIndex. Then for each surface, get its geometry
@@ -224,6 +280,8 @@ int realizeSubsystemTopologyImpl(State& state) const override {
     wThis->m_predictedContactsIx = allocateAutoUpdateDiscreteVariable
         (state, Stage::Dynamics, new Value<ContactSnapshot>(), 
          Stage::Acceleration);  // update depends on accelerations
+    wThis->m_broadPhaseIndexIx = allocateLazyCacheEntry
+        (state, Stage::Instance, new Value<SpatialIndex>());
 
     const SimbodyMatterSubsystem& matter = getMatterSubsystem();
 
@@ -277,81 +335,44 @@ int realizeSubsystemVelocityImpl(const State& state) const override {
 // Adds new pairs to the existing set, if not already present.
 void addInBroadPhasePairs(const State& state, PairMap& pairs) const {
     const int numBubbles = getNumBubbles();
-    
-    // Perform a sweep-and-prune on a single axis to identify potential 
-    // contacts. First, find which axis has the most variation in body 
-    // locations. That is the axis we will use.
-    // TODO: this one-axis method is not good enough in general
-    
-    Vector_<Vec3> centers(numBubbles);
+    SpatialIndex& index = updBroadPhaseIndex(state);
+    if (!isCacheValueRealized(state, m_broadPhaseIndexIx)) {
+        index.resize(0); // no usable order
+        markCacheValueRealized(state, m_broadPhaseIndexIx);
+    }
+
+    // Find which bubbles overlap using the bubble spheres in Ground.
+    index.resize(numBubbles);
     for (BubbleIndex bbx(0); bbx < numBubbles; ++bbx) {
         const Bubble&  bubb = m_bubbles[bbx];
         const Surface& surf = m_surfaces[bubb.surface];
-        centers[bbx] = surf.mobod->getBodyTransform(state) 
-                        * bubb.getCenter();
-    }
-    Vec3 average = mean(centers);
-    Vec3 var(0);
-    for (BubbleIndex bbx(0); bbx < numBubbles; ++bbx)
-        var += abs(centers[bbx]-average);
-    int axis = (var[0] > var[1] ? 0 : 1);
-    if (var[2] > var[axis])
-        axis = 2;
-    
-    // Find the extent of each bubble along the axis and sort them by 
-    // starting location.
-    Array_<BubbleExtent,int> extents(numBubbles);
-    for (BubbleIndex bbx(0); bbx < numBubbles; ++bbx) {
-        const Real radius = m_bubbles[bbx].getRadius();
-        const Real center = centers[bbx][axis];
-        extents[bbx] = BubbleExtent(center-radius, center+radius, bbx);
+        index.setSphere(bbx, surf.mobod->getBodyTransform(state) 
+                               * bubb.getCenter(), bubb.getRadius());
     }
-    //cout << "Bubble extents:" << extents << "\n";
-
-    // Expensive: O(n log n)
-    std::sort(extents.begin(), extents.end());
-    
-    // Now sweep along the axis, finding potential contacts.
-    
-    for (int ex1=0; ex1 < numBubbles; ++ex1) {
-        const BubbleExtent& extent1 = extents[ex1];
-        const Bubble&       bubb1   = m_bubbles[extent1.index];
-        const Real          radius1 = bubb1.getRadius();
-        const Vec3&         center1 = centers[extent1.index];
-
-        // Loop over just the overlapping bubbles.
-        for (int ex2(ex1+1); ex2 < numBubbles; ++ex2) {
-            const BubbleExtent& extent2 = extents[ex2];
-            if (extent2.start > extent1.end)
-                break;  // no more bubbles can overlap with extent1
-
-            // These bubbles do overlap along this axis. See if they are
-            // actually touching.
-            const Bubble& bubb2   = m_bubbles[extent2.index];
-            const Real    radius2 = bubb2.getRadius();
-            const Vec3&   center2 = centers[extent2.index];
-            if ((center1-center2).normSqr() > square(radius1+radius2))
-                continue; // nope
-
-            // The bubbles are touching. We'll add the corresponding surfaces
-            // to the narrow-phase list unless there are relevant exclusions.
-            const Surface& surf1 = m_surfaces[bubb1.surface];
-            const Surface& surf2 = m_surfaces[bubb2.surface];
-            // Ignore if on the same body.
-            if (surf1.mobod == surf2.mobod) continue;
-            assert(bubb1.surface != bubb2.surface); // duh!
-            // Ignore if surfaces are in a common clique.
-            if (surf1.surface->isInSameClique(*surf2.surface)) continue;
-            // We'll need to do a narrow phase investigation of these two
-            // surfaces; use the lower-numbered one as the index to avoid
-            // duplicates.
-            ContactSurfaceIndex low=bubb1.surface, high=bubb2.surface;
-            if (low > high) std::swap(low,high);
-            ContactSurfaceSet& surfSet = pairs[low];
-            // Insert this pair with null Contact if the pair isn't already
-            // in the PairMap.
-            surfSet.insert(make_pair(high,(Contact*)0));
-        }
+    Array_< pair<int,int> > overlaps;
+    index.findOverlappingPairs(overlaps);
+
+    for (const pair<int,int>& overlap : overlaps) {
+        // The bubbles are touching. We'll add the corresponding surfaces
+        // to the narrow-phase list unless there are relevant exclusions.
+        const Bubble& bubb1 = m_bubbles[BubbleIndex(overlap.first)];
+        const Bubble& bubb2 = m_bubbles[BubbleIndex(overlap.second)];
+        const Surface& surf1 = m_surfaces[bubb1.surface];
+        const Surface& surf2 = m_surfaces[bubb2.surface];
+        // Ignore if on the same body.
+        if (surf1.mobod == surf2.mobod) continue;
+        assert(bubb1.surface != bubb2.surface); // duh!
+        // Ignore if surfaces are in a common clique.
+        if (surf1.surface->isInSameClique(*surf2.surface)) continue;
+        // We'll need to do a narrow phase investigation of these two
+        // surfaces; use the lower-numbered one as the index to avoid
+        // duplicates.
+        ContactSurfaceIndex low=bubb1.surface, high=bubb2.surface;
+        if (low > high) std::swap(low,high);
+        ContactSurfaceSet& surfSet = pairs[low];
+        // Insert this pair with null Contact if the pair isn't already
+        // in the PairMap.
+        surfSet.insert(make_pair(high,(Contact*)0));
     }
 }
 
@@ -408,6 +429,9 @@ void ensureActiveContactsUpdated(const State& state) const {
     addInBroadPhasePairs(state, interesting);
     //cout << "Interesting pairs:\n" << interesting << "\n";
 
+    // Collect the pairs that have a tracker, in PairMap order.
+    Array_<NarrowPhasePair> pairs;
+    int work = 0;
     PairMap::const_iterator p = interesting.begin();
     for (; p != interesting.end(); ++p) {
         const ContactSurfaceIndex index1 = p->first;
@@ -429,49 +453,79 @@ void ensureActiveContactsUpdated(const State& state) const {
             const ContactGeometryTypeId typeId2 = geom2.getTypeId();
             if (!hasContactTracker(typeId1,typeId2))
                 continue; // No algorithm available for detecting collisions between these two objects.
-            bool mustReverse;
+            bool mustReverse = false;
             const ContactTracker& tracker = 
                 getContactTracker(typeId1, typeId2, mustReverse);
 
             // Put the surfaces in the order required by the tracker.
-            const ContactSurfaceIndex trackSurf1 = (mustReverse? index2:index1);
-            const ContactSurfaceIndex trackSurf2 = (mustReverse? index1:index2);
-
-            UntrackedContact untracked; // empty handle in case we need it
-            const Contact* prev = q->second;
-            if (prev && prev->getCondition() == Contact::Broken)
-                prev = 0; // that contact expired
-            if (!prev) { 
-                untracked = UntrackedContact(trackSurf1, trackSurf2);
-                prev = &untracked;
-            }
-            Contact next; // empty handle
-            if (mustReverse)
-                tracker.trackContact
-                   (*prev, transform2,geom2, transform1,geom1, 0/*TODO*/, next);
-            else
-                tracker.trackContact
-                   (*prev, transform1,geom1, transform2,geom2, 0/*TODO*/, next);
-
-            if (!next.isEmpty()) {
-                next.setSurfaces(trackSurf1,trackSurf2);
-                next.setContactId(prev->getCondition()==Contact::Untracked
-                                    ? Contact::createNewContactId()
-                                    : prev->getContactId()); // persistent
-                if (   prev->getCondition()==Contact::Untracked
-                    || prev->getCondition()==Contact::Anticipated)
-                    next.setCondition(Contact::NewContact);
-                else { // was NewContact or Ongoing; now Ongoing or Broken
-                    assert(prev->getCondition()==Contact::NewContact
-                           || prev->getCondition()==Contact::Ongoing);
-                    if (next.getTypeId() != BrokenContact::classTypeId())
-                        next.setCondition(Contact::Ongoing);
-                    // Condition will already by Broken for a BrokenContact
-                }
-                nextActive.adoptContact(next);
-            }
+            pairs.push_back(); // default construct
+            NarrowPhasePair& pair = pairs.back();
+            pair.surf1 = (mustReverse? index2:index1);
+            pair.surf2 = (mustReverse? index1:index2);
+            pair.X_GS1 = (mustReverse? transform2:transform1);
+            pair.X_GS2 = (mustReverse? transform1:transform2);
+            pair.geom1 = (mustReverse? &geom2:&geom1);
+            pair.geom2 = (mustReverse? &geom1:&geom2);
+            pair.tracker = &tracker;
+            pair.prev = q->second;
+            if (pair.prev && pair.prev->getCondition() == Contact::Broken)
+                pair.prev = 0; // that contact expired
+            pair.mustBeSerial = 
+                !(canTrackInParallel(geom1) && canTrackInParallel(geom2));
+            work += (   ContactGeometry::TriangleMesh::isInstance(geom1)
+                     || ContactGeometry::TriangleMesh::isInstance(geom2))
+                    ? MeshPairWork : 1;
+        }
+    }
+
+    // Track the pairs, in parallel if that's worthwhile. Every pair is 
+    // independent of the others.
+    ParallelExecutor& executor = getExecutor();
+    Array_<int> parallelPairs;
+    if (work >= MinParallelWork && executor.getMaxThreads() > 1)
+        for (int i=0; i < (int)pairs.size(); ++i)
+            if (!pairs[i].mustBeSerial) parallelPairs.push_back(i);
+    if (parallelPairs.size() > 1) {
+        TrackPairsTask task(pairs, parallelPairs);
+        executor.execute(task, parallelPairs.size());
+        for (NarrowPhasePair& pair : pairs)
+            if (pair.mustBeSerial) pair.track();
+    } else {
+        for (NarrowPhasePair& pair : pairs)
+            pair.track();
+    }
+
+    // Now merge the results serially so that they don't depend on how the
+    // work was divided up. New contacts get their ContactIds in PairMap
+    // order, and the contacts are added to the snapshot in ContactId order.
+    Array_<int> found;
+    for (int i=0; i < (int)pairs.size(); ++i) {
+        NarrowPhasePair& pair = pairs[i];
+        Contact& next = pair.next;
+        if (next.isEmpty())
+            continue;
+        const Contact::Condition prevCondition = 
+            pair.prev ? pair.prev->getCondition() : Contact::Untracked;
+        next.setSurfaces(pair.surf1,pair.surf2);
+        next.setContactId(prevCondition==Contact::Untracked
+                            ? Contact::createNewContactId()
+                            : pair.prev->getContactId()); // persistent
+        if (   prevCondition==Contact::Untracked
+            || prevCondition==Contact::Anticipated)
+            next.setCondition(Contact::NewContact);
+        else { // was NewContact or Ongoing; now Ongoing or Broken
+            assert(prevCondition==Contact::NewContact
+                   || prevCondition==Contact::Ongoing);
+            if (next.getTypeId() != BrokenContact::classTypeId())
+                next.setCondition(Contact::Ongoing);
+            // Condition will already by Broken for a BrokenContact
         }
+        found.push_back(i);
     }
+    std::sort(found.begin(), found.end(), [&pairs](int i, int j)
+        {return pairs[i].next.getContactId() < pairs[j].next.getContactId();});
+    for (int i : found)
+        nextActive.adoptContact(pairs[i].next);
 
     markDiscreteVarUpdateValueRealized(state, m_activeContactsIx);
 }
@@ -582,6 +636,9 @@ friend class ContactTrackerSubsystem;
 TrackerMap          m_contactTrackers;
 ContactTracker*     m_defaultTracker;
 
+// Empty unless setNumberOfThreads() was called; see getExecutor().
+mutable ClonePtr<ParallelExecutor>  m_executor;
+
     // TOPOLOGY CACHE
 // The pair is the first assigned index, and the number of contact surfaces
 // for a mobod, at last realizeSubsystemTopology() call.
@@ -591,6 +648,7 @@ Array_<Surface,ContactSurfaceIndex>     m_surfaces;
 Array_<Bubble,BubbleIndex>              m_bubbles;
 DiscreteVariableIndex                   m_activeContactsIx;
 DiscreteVariableIndex                   m_predictedContactsIx;
+CacheEntryIndex                         m_broadPhaseIndexIx;
 };
 
 } // namespace SimTK
@@ -658,6 +716,12 @@ void ContactTrackerSubsystem::
 adoptContactTracker(ContactTracker* tracker)
 {   updImpl().adoptContactTracker(tracker); }
 
+void ContactTrackerSubsystem::setNumberOfThreads(unsigned numThreads)
+{   updImpl().setNumberOfThreads(numThreads); }
+
+int ContactTrackerSubsystem::getNumberOfThreads() const
+{   return getImpl().getNumberOfThreads(); }
+
 bool ContactTrackerSubsystem::
 hasContactTracker(ContactGeometryTypeId surface1, 
                   ContactGeometryTypeId surface2) const
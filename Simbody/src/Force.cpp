@@ -120,6 +120,24 @@ void Force::TwoPointLinearSpringImpl::calcForce(const State& state, Vector_<Spat
     bodyForces[body2] -=  SpatialVec(s2_G % f1_G, f1_G);
 }
 
+// The force on point 2 is -k(d-x0)r/d with d=|r|, so its derivative with 
+// respect to r is -k(I - x0/d (I - rr'/d^2)).
+bool Force::TwoPointLinearSpringImpl::calcForceJacobian
+   (const State& state, ForceJacobian& jacobian) const {
+    const Transform& X_GB1 = matter.getMobilizedBody(body1).getBodyTransform(state);
+    const Transform& X_GB2 = matter.getMobilizedBody(body2).getBodyTransform(state);
+
+    const Vec3 r_G = (X_GB2*station2) - (X_GB1*station1);
+    const Real d   = r_G.norm();
+    const Vec3 u_G = r_G/d; // unit vector from point1 to point2
+
+    const Mat33 I(1);
+    const Mat33 dFdr = -k*(I - (x0/d)*(I - outer(u_G, u_G)));
+    jacobian.addStationPairDerivatives(state, body1, station1, body2, station2,
+                                       dFdr, Mat33(0));
+    return true;
+}
+
 Real Force::TwoPointLinearSpringImpl::calcPotentialEnergy(const State& state) const {
     const Transform& X_GB1 = matter.getMobilizedBody(body1).getBodyTransform(state);
     const Transform& X_GB2 = matter.getMobilizedBody(body2).getBodyTransform(state);
@@ -360,6 +378,15 @@ calcPotentialEnergy(const State& state) const {
     return k*square(q-q0)/2;
 }
 
+bool Force::MobilityLinearSpringImpl::
+calcForceJacobian(const State& state, ForceJacobian& jacobian) const {
+    const MobilizedBody& mb = m_matter.getMobilizedBody(m_mobodIx);
+    // Like calcForce() this depends on qdot=u.
+    const UIndex ux(mb.getFirstUIndex(state) + (int)m_whichQ);
+    jacobian.addPositionDerivative(ux, ux, -getParams(state).first);
+    return true;
+}
+
 
 
 //--------------------------- MobilityLinearDamper -----------------------------
@@ -447,6 +474,14 @@ calcPotentialEnergy(const State& state) const {
     return 0;
 }
 
+bool Force::MobilityLinearDamperImpl::
+calcForceJacobian(const State& state, ForceJacobian& jacobian) const {
+    const MobilizedBody& mb = m_matter.getMobilizedBody(m_mobodIx);
+    const UIndex ux(mb.getFirstUIndex(state) + (int)m_whichU);
+    jacobian.addVelocityDerivative(ux, ux, -getDamping(state));
+    return true;
+}
+
 
 
 //-------------------------- MobilityConstantForce -----------------------------
@@ -1001,6 +1036,12 @@ Real Force::GlobalDamperImpl::calcPotentialEnergy(const State& state) const {
     return 0;
 }
 
+bool Force::GlobalDamperImpl::calcForceJacobian(const State& state, ForceJacobian& jacobian) const {
+    for (UIndex ux(0); ux < matter.getNumMobilities(); ++ux)
+        jacobian.addVelocityDerivative(ux, ux, -damping);
+    return true;
+}
+
 
 //------------------------------ UniformGravity --------------------------------
 //------------------------------------------------------------------------------
@@ -1106,13 +1147,78 @@ Force::Custom::Implementation& Force::Custom::updImplementation() {
 Force::CustomImpl::CustomImpl(Force::Custom::Implementation* implementation) : implementation(implementation) {
 }
 
+// Compact arrays for a sparse force that is asked for full-length forces.
+// They are kept per thread so that they aren't reallocated at every 
+// evaluation, and so that different States may be realized concurrently.
+struct CompactForces {
+    Vector_<SpatialVec> bodyForces;
+    Vector              mobilityForces;
+};
+static ThreadLocal<CompactForces> compactForcesScratch;
+
 void Force::CustomImpl::calcForce(const State& state, Vector_<SpatialVec>& bodyForces, Vector_<Vec3>& particleForces, Vector& mobilityForces) const {
-    implementation->calcForce(state, bodyForces, particleForces, mobilityForces);
+    if (!isSparse) {
+        implementation->calcForce(state, bodyForces, particleForces, mobilityForces);
+        return;
+    }
+    const SimbodyMatterSubsystem& matter = 
+        getForceSubsystem().getMultibodySystem().getMatterSubsystem();
+    CompactForces& compact = compactForcesScratch.upd();
+    sparsity.prepareCompact(state, matter, compact.bodyForces, 
+                            compact.mobilityForces);
+    implementation->calcSparseForce(state, compact.bodyForces, 
+                                    compact.mobilityForces);
+    sparsity.addInto(state, matter, compact.bodyForces, compact.mobilityForces,
+                     bodyForces, mobilityForces);
 }
 
 Real Force::CustomImpl::calcPotentialEnergy(const State& state) const {
     return implementation->calcPotentialEnergy(state);
 }
 
+void Force::Custom::Implementation::calcForce(const State& state, Vector_<SpatialVec>& bodyForces, Vector_<Vec3>& particleForces, Vector& mobilityForces) const {
+    SimTK_ERRCHK_ALWAYS(!"calcForce() not overridden", 
+        "Force::Custom::Implementation::calcForce()",
+        "A custom force must override either calcForce(), or getSparsity() and"
+        " calcSparseForce().");
+}
+
+
+
+//------------------------------------------------------------------------------
+//                              FORCE SPARSITY
+//------------------------------------------------------------------------------
+
+void ForceSparsity::prepareCompact(const State& state, 
+    const SimbodyMatterSubsystem& matter, 
+    Vector_<SpatialVec>& compactBodyForces, Vector& compactMobilityForces) const
+{
+    int nu = 0;
+    for (MobilizedBodyIndex mbx : mobilityBodies)
+        nu += matter.getMobilizedBody(mbx).getNumU(state);
+    compactBodyForces.resize(bodies.size());
+    compactBodyForces.setToZero();
+    compactMobilityForces.resize(nu);
+    compactMobilityForces.setToZero();
+}
+
+void ForceSparsity::addInto(const State& state, 
+    const SimbodyMatterSubsystem& matter,
+    const Vector_<SpatialVec>& compactBodyForces, 
+    const Vector& compactMobilityForces,
+    Vector_<SpatialVec>& bodyForces, Vector& mobilityForces) const
+{
+    for (int i = 0; i < (int)bodies.size(); ++i)
+        bodyForces[bodies[i]] += compactBodyForces[i];
+    int next = 0;
+    for (MobilizedBodyIndex mbx : mobilityBodies) {
+        const MobilizedBody& mobod = matter.getMobilizedBody(mbx);
+        const UIndex u0 = mobod.getFirstUIndex(state);
+        const int nu = mobod.getNumU(state);
+        for (int j = 0; j < nu; ++j)
+            mobilityForces[u0+j] += compactMobilityForces[next++];
+    }
+}
+
 } // namespace SimTK
 
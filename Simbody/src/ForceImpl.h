@@ -28,9 +28,28 @@
 #include "simbody/internal/common.h"
 #include "simbody/internal/Force.h"
 #include "simbody/internal/Force_BuiltIns.h"
+#include "simbody/internal/ForceJacobian.h"
 
 namespace SimTK {
 
+// The bodies and mobilities that a sparse force element affects; see
+// Force::Custom::Implementation::getSparsity(). A sparse force calculates
+// into compact arrays with one entry per listed body and per mobility of the
+// listed mobility bodies, which addInto() then adds into full-length arrays.
+struct ForceSparsity {
+    Array_<MobilizedBodyIndex> bodies;
+    Array_<MobilizedBodyIndex> mobilityBodies;
+
+    // Resize the compact arrays for the given State and set them to zero.
+    void prepareCompact(const State& state, const SimbodyMatterSubsystem& matter,
+                        Vector_<SpatialVec>& compactBodyForces,
+                        Vector& compactMobilityForces) const;
+    void addInto(const State& state, const SimbodyMatterSubsystem& matter,
+                 const Vector_<SpatialVec>& compactBodyForces,
+                 const Vector& compactMobilityForces,
+                 Vector_<SpatialVec>& bodyForces, Vector& mobilityForces) const;
+};
+
 // This is what a Force handle points to.
 class ForceImpl : public PIMPLImplementation<Force, ForceImpl> {
 public:
@@ -49,6 +68,12 @@ public:
     virtual bool dependsOnlyOnPositions() const {
         return false;
     }
+    // A force element that dependsOnlyOnPositions() and whose forces also
+    // depend on discrete variables it owns in the force subsystem should
+    // append their indices here (valid after realizeTopology()). The cached
+    // forces will then be recomputed when one of those variables changes.
+    virtual void appendParameterVariables
+       (Array_<DiscreteVariableIndex>& params) const {}
     virtual bool shouldBeParallelIfPossible() const{
         return false;
     }
@@ -71,6 +96,22 @@ public:
                            Vector&              mobilityForces) const = 0;
     virtual Real calcPotentialEnergy(const State& state) const = 0;
 
+    // A force element that only affects a few bodies and mobilities may 
+    // return its ForceSparsity here (valid after realizeTopology()), in which
+    // case calcSparseForce() may be used in place of calcForce().
+    virtual const ForceSparsity* getSparsity() const {return nullptr;}
+    virtual void calcSparseForce(const State&         state,
+                                 Vector_<SpatialVec>& compactBodyForces,
+                                 Vector&              compactMobilityForces) 
+                                 const {}
+
+    // A force element that can calculate the derivatives of its generalized
+    // forces should add them to the given ForceJacobian and return true; see
+    // Force::Custom::Implementation::calcForceJacobian().
+    virtual bool calcForceJacobian(const State&   state,
+                                   ForceJacobian& jacobian) const
+    {   return false; }
+
     virtual void realizeTopology    (State& state) const {}
     virtual void realizeModel       (State& state) const {}
     virtual void realizeInstance    (const State& state) const {}
@@ -124,6 +165,8 @@ public:
                    Vector_<Vec3>&       particleForces, 
                    Vector&              mobilityForces) const override;
     Real calcPotentialEnergy(const State& state) const override;
+    bool calcForceJacobian(const State&   state, 
+                           ForceJacobian& jacobian) const override;
 
     void calcDecorativeGeometryAndAppend(const State& s, Stage stage, 
                                          Array_<DecorativeGeometry>& geom) 
@@ -204,10 +247,15 @@ friend class MobilityLinearSpring;
     MobilityLinearSpringImpl* clone() const override
     {   return new MobilityLinearSpringImpl(*this); }
     bool dependsOnlyOnPositions() const override {return true;}
+    void appendParameterVariables
+       (Array_<DiscreteVariableIndex>& params) const override
+    {   params.push_back(m_paramsIx); }
     void calcForce(const State& state, Vector_<SpatialVec>& bodyForces, 
                    Vector_<Vec3>& particleForces, Vector& mobilityForces) const
                    override;
     Real calcPotentialEnergy(const State& state) const override;
+    bool calcForceJacobian(const State& state, ForceJacobian& jacobian) const
+                           override;
 
     // Allocate the discrete state variable for the parameters. 
     void realizeTopology(State& s) const override {
@@ -258,6 +306,8 @@ friend class MobilityLinearDamper;
                    Vector_<Vec3>& particleForces, Vector& mobilityForces) const
                    override;
     Real calcPotentialEnergy(const State& state) const override;
+    bool calcForceJacobian(const State& state, ForceJacobian& jacobian) const
+                           override;
 
     // Allocate the discrete state variable for the parameters. 
     void realizeTopology(State& s) const override {
@@ -316,6 +366,10 @@ friend class MobilityConstantForce;
 
     Real calcPotentialEnergy(const State& state) const override {return 0;}
 
+    // The force doesn't depend on q or u.
+    bool calcForceJacobian(const State& state, ForceJacobian& jacobian) const
+                           override {return true;}
+
     // Allocate the discrete state variable for the force. 
     void realizeTopology(State& s) const override {
         m_forceIx = getForceSubsystem()
@@ -561,6 +615,7 @@ public:
     }
     void calcForce(const State& state, Vector_<SpatialVec>& bodyForces, Vector_<Vec3>& particleForces, Vector& mobilityForces) const override;
     Real calcPotentialEnergy(const State& state) const override;
+    bool calcForceJacobian(const State& state, ForceJacobian& jacobian) const override;
 private:
     const SimbodyMatterSubsystem& matter;
     Real damping;
@@ -579,6 +634,8 @@ public:
     }
     void calcForce(const State& state, Vector_<SpatialVec>& bodyForces, Vector_<Vec3>& particleForces, Vector& mobilityForces) const override;
     Real calcPotentialEnergy(const State& state) const override;
+    // The body forces are constant; only the neglected Jacobian terms remain.
+    bool calcForceJacobian(const State& state, ForceJacobian& jacobian) const override {return true;}
     Vec3 getGravity() const {
         return g;
     }
@@ -620,6 +677,19 @@ public:
     bool shouldBeParallelIfPossible() const override {
         return implementation->shouldBeParallelIfPossible();
     }
+    const ForceSparsity* getSparsity() const override {
+        return isSparse ? &sparsity : nullptr;
+    }
+    void calcSparseForce(const State& state, 
+                         Vector_<SpatialVec>& compactBodyForces,
+                         Vector& compactMobilityForces) const override {
+        implementation->calcSparseForce(state, compactBodyForces,
+                                        compactMobilityForces);
+    }
+    bool calcForceJacobian(const State& state, 
+                           ForceJacobian& jacobian) const override {
+        return implementation->calcForceJacobian(state, jacobian);
+    }
     ~CustomImpl() {
         delete implementation;
     }
@@ -631,6 +701,10 @@ public:
     }
 protected:
     void realizeTopology(State& state) const override {
+        sparsity.bodies.clear();
+        sparsity.mobilityBodies.clear();
+        isSparse = implementation->getSparsity(sparsity.bodies, 
+                                               sparsity.mobilityBodies);
         implementation->realizeTopology(state);
     }
     void realizeModel(State& state) const override {
@@ -664,6 +738,10 @@ protected:
     }
 private:
     Force::Custom::Implementation* implementation;
+
+    // TOPOLOGY CACHE
+    mutable bool          isSparse = false;
+    mutable ForceSparsity sparsity;
 };
 
 } // namespace SimTK
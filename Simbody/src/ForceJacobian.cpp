@@ -0,0 +1,130 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon.h"
+
+#include "simbody/internal/common.h"
+#include "simbody/internal/ForceJacobian.h"
+#include "simbody/internal/MobilizedBody.h"
+#include "simbody/internal/SimbodyMatterSubsystem.h"
+
+namespace SimTK {
+
+void ForceJacobian::initialize(const SimbodyMatterSubsystem& matterSubsys,
+                               const State& state) {
+    matter = &matterSubsys;
+    nu = matter->getNumMobilities();
+    matter->calcSparseSystemJacobian(state, rowStart, colIndex, J_G);
+    clear();
+}
+
+void ForceJacobian::addStationPairDerivatives
+   (const State& state, MobilizedBodyIndex body1, const Vec3& station1,
+    MobilizedBodyIndex body2, const Vec3& station2,
+    const Mat33& dFdp, const Mat33& dFdv)
+{
+    // A pure force at a station doesn't depend on the relative rotation or
+    // angular velocity, so this is a frame pair with only the translational
+    // blocks filled in.
+    const Mat33 zero(0);
+    addFramePairDerivatives(state, body1, station1, body2, station2,
+                            SpatialMat(zero, zero, zero, dFdp),
+                            SpatialMat(zero, zero, zero, dFdv));
+}
+
+void ForceJacobian::addFramePairDerivatives
+   (const State& state, MobilizedBodyIndex body1, const Vec3& origin1,
+    MobilizedBodyIndex body2, const Vec3& origin2,
+    const SpatialMat& dFdX, const SpatialMat& dFdV)
+{
+    SimTK_ERRCHK(matter, "ForceJacobian::addFramePairDerivatives()",
+        "initialize() must be called first.");
+
+    // With Jrel the relative spatial Jacobian, the generalized forces are
+    // f = ~Jrel*F and the relative velocity is Jrel*u, so the derivatives are
+    // ~Jrel*dFdX*Jrel and ~Jrel*dFdV*Jrel restricted to the columns of Jrel
+    // that aren't structurally zero.
+    calcRelativeJacobian(state, body1, origin1, body2, origin2);
+    const int nc = (int)relCols.size();
+
+    const bool hasPosition = dFdX.normSqr() > 0;
+    const bool hasVelocity = dFdV.normSqr() > 0;
+    dFdXJ.resize(nc); dFdVJ.resize(nc);
+    for (int c=0; c < nc; ++c) {
+        if (hasPosition) dFdXJ[c] = dFdX * relJ[c];
+        if (hasVelocity) dFdVJ[c] = dFdV * relJ[c];
+    }
+
+    for (int r=0; r < nc; ++r) {
+        const SpatialVec& Jr = relJ[r];
+        for (int c=0; c < nc; ++c) {
+            if (hasPosition)
+                positionDerivs.push_back(Entry(relCols[r], relCols[c],
+                    ~Jr[0]*dFdXJ[c][0] + ~Jr[1]*dFdXJ[c][1]));
+            if (hasVelocity)
+                velocityDerivs.push_back(Entry(relCols[r], relCols[c],
+                    ~Jr[0]*dFdVJ[c][0] + ~Jr[1]*dFdVJ[c][1]));
+        }
+    }
+}
+
+// Each stored row of the sparse system Jacobian gives the spatial velocity of
+// a body origin; shift it to the given origin, then merge the two bodies'
+// (sorted) column lists, subtracting body 1's contribution.
+void ForceJacobian::calcRelativeJacobian
+   (const State& state, MobilizedBodyIndex body1, const Vec3& origin1,
+    MobilizedBodyIndex body2, const Vec3& origin2)
+{
+    const Vec3 p1_G = matter->getMobilizedBody(body1).getBodyRotation(state)
+                      * origin1;
+    const Vec3 p2_G = matter->getMobilizedBody(body2).getBodyRotation(state)
+                      * origin2;
+
+    relCols.clear(); relJ.clear();
+    int i1 = rowStart[body1], i2 = rowStart[body2];
+    const int end1 = rowStart[body1+1], end2 = rowStart[body2+1];
+    while (i1 < end1 || i2 < end2) {
+        const int c1 = i1 < end1 ? colIndex[i1] : nu;
+        const int c2 = i2 < end2 ? colIndex[i2] : nu;
+        SpatialVec J(Vec3(0), Vec3(0));
+        if (c2 <= c1) {
+            const SpatialVec& H = J_G[i2++];
+            J += SpatialVec(H[0], H[1] + H[0] % p2_G);
+        }
+        if (c1 <= c2) {
+            const SpatialVec& H = J_G[i1++];
+            J -= SpatialVec(H[0], H[1] + H[0] % p1_G);
+        }
+        relCols.push_back(UIndex(std::min(c1, c2)));
+        relJ.push_back(J);
+    }
+}
+
+void ForceJacobian::toDense(const Array_<Entry>& entries, Matrix& m) const {
+    m.resize(nu, nu);
+    m = 0;
+    for (const Entry& e : entries)
+        m(e.row, e.col) += e.value;
+}
+
+} // namespace SimTK
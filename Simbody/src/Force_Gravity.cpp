@@ -157,6 +157,11 @@ friend class Force::Gravity;
                    override;
     Real calcPotentialEnergy(const State& state) const override;
 
+    // The gravitational body forces don't depend on q or u; only the 
+    // Jacobian terms that ForceJacobian neglects remain.
+    bool calcForceJacobian(const State& state, ForceJacobian& jacobian) const
+                           override {return true;}
+
     // Allocate the state variables and cache entries.
     void realizeTopology(State& s) const override;
 
@@ -71,6 +71,8 @@ public:
     void calcForce(const State& state, Vector_<SpatialVec>& bodyForces,
                    Vector_<Vec3>& particleForces, Vector& mobilityForces) const override;
     Real calcPotentialEnergy(const State& state) const override;
+    bool calcForceJacobian(const State& state, 
+                           ForceJacobian& jacobian) const override;
 
     // Allocate the position and velocity cache entries. These are all
     // lazy-evaluation entries - be sure to check whether they have already
@@ -612,6 +614,43 @@ calcPotentialEnergy(const State& state) const {
     return getPotentialEnergyCache(state);
 }
 
+// The bushing coordinate rates are qdot = A*V_FM_G where V_FM_G is the spatial
+// velocity of M relative to the point of body 1 at OM, and 
+// A = diag(N_FM*~R_GM, ~R_GF) as in ensureVelocityCacheValid(). The force
+// on body 2 at OM is ~A*f with f = -(k*q + c*qdot), so with respect to that
+// relative motion it has derivatives -~A*diag(k)*A and -~A*diag(c)*A. We
+// treat A as constant.
+bool Force::LinearBushingImpl::
+calcForceJacobian(const State& state, ForceJacobian& jacobian) const {
+    const InstanceVars& iv = getInstanceVars(state);
+    ensurePositionCacheValid(state);
+    const PositionCache& pc = getPositionCache(state);
+
+    const Mat33 N_FM = 
+        Rotation::calcNForBodyXYZInBodyFrame(pc.q.getSubVec<3>(0));
+    const Mat33 A_rot   = N_FM * ~pc.X_GM.R().asMat33();
+    const Mat33 A_trans = ~pc.X_GF.R().asMat33();
+
+    // Return -~A*diag(w)*A.
+    auto project = [&](const Vec6& w) {
+        Mat33 Wrot(0), Wtrans(0);
+        Wrot.updDiag()   = w.getSubVec<3>(0);
+        Wtrans.updDiag() = w.getSubVec<3>(3);
+        const Mat33 zero(0);
+        return SpatialMat(-(~A_rot*Wrot*A_rot), zero,
+                          zero, -(~A_trans*Wtrans*A_trans));
+    };
+
+    // OM, on body 1 and on body 2.
+    const Rotation& R_GB1 = matter.getMobilizedBody(body1x).getBodyRotation(state);
+    const Vec3 p_B1M = iv.X_B1F.p() + ~R_GB1*pc.p_FM_G;
+    const Vec3& p_B2M = iv.X_B2M.p();
+
+    jacobian.addFramePairDerivatives(state, body1x, p_B1M, body2x, p_B2M,
+                                     project(iv.k), project(iv.c));
+    return true;
+}
+
 
 } // namespace SimTK
 
@@ -47,18 +47,6 @@ public:
     mutable Array_<Real,ContactSurfaceIndex>    sphereRadii;
 };
 
-class ContactBodyExtent {
-public:
-    ContactBodyExtent(Real start, Real end, ContactSurfaceIndex index) 
-    :   start(start), end(end), index(index) {}
-    ContactBodyExtent() {}
-    bool operator<(const ContactBodyExtent& e) const 
-    {   return start < e.start; }
-    Real start, end;
-    ContactSurfaceIndex index;
-};
-
-
 //==============================================================================
 //                      GENERAL CONTACT SUBSYSTEM IMPL
 //==============================================================================
@@ -136,6 +124,11 @@ public:
     int realizeSubsystemTopologyImpl(State& state) const override {
         contactsCacheIndex = state.allocateCacheEntry(getMySubsystemIndex(), Stage::Dynamics, new Value<Array_<Array_<Contact> > >());
         contactsValidCacheIndex = state.allocateCacheEntry(getMySubsystemIndex(), Stage::Position, new Value<bool>());
+        // The spatial indices remember how they sorted the bodies last time,
+        // which speeds up the next sort when they have moved only a little;
+        // they depend only on Instance stage so that they survive position
+        // changes.
+        broadPhaseIndicesCacheIndex = state.allocateLazyCacheEntry(getMySubsystemIndex(), Stage::Instance, new Value<Array_<SpatialIndex> >());
         for (int i = 0; i < (int) sets.size(); ++i) {
             const ContactSet& set = sets[i];
             int numBodies = set.bodies.size();
@@ -161,6 +154,13 @@ public:
         Array_<Array_<Contact> >& contacts = Value<Array_<Array_<Contact> > >::updDowncast(updCacheEntry(state, contactsCacheIndex)).upd();
         int numSets = getNumContactSets();
         contacts.resize(numSets);
+        Array_<SpatialIndex>& broadPhaseIndices = Value<Array_<SpatialIndex> >::updDowncast(updCacheEntry(state, broadPhaseIndicesCacheIndex)).upd();
+        if (!isCacheValueRealized(state, broadPhaseIndicesCacheIndex)) {
+            broadPhaseIndices.clear(); // no usable order
+            markCacheValueRealized(state, broadPhaseIndicesCacheIndex);
+        }
+        broadPhaseIndices.resize(numSets);
+        Array_<std::pair<int,int> > overlaps;
         
         // Loop over all contact sets.
         
@@ -169,63 +169,42 @@ public:
             const ContactSet& set = sets[setIndex];
             int numBodies = set.bodies.size();
             
-            // Perform a sweep-and-prune on a single axis to identify potential contacts.  First, find which
-            // axis has the most variation in body locations.  That is the axis we will use.
-            
-            Vector_<Vec3> centers(numBodies);
-            for (ContactSurfaceIndex i(0); i < numBodies; i++)
-                centers[i] = set.bodies[i].getBodyTransform(state)*set.sphereCenters[i];
-            Vec3 average = mean(centers);
-            Vec3 var(0);
-            for (int i = 0; i < numBodies; i++)
-                var += abs(centers[i]-average);
-            int axis = (var[0] > var[1] ? 0 : 1);
-            if (var[2] > var[axis])
-                axis = 2;
-            
-            // Find the extent of each body along the axis and sort them by starting location.
-            
-            Array_<ContactBodyExtent> extents(numBodies);
+            // Find which bodies' bounding spheres overlap.
+
+            SpatialIndex& index = broadPhaseIndices[setIndex];
+            index.resize(numBodies);
             for (ContactSurfaceIndex i(0); i < numBodies; i++)
-                extents[i] = ContactBodyExtent(centers[i][axis]-set.sphereRadii[i], centers[i][axis]+set.sphereRadii[i], i);
-            std::sort(extents.begin(), extents.end());
-            
-            // Now sweep along the axis, finding potential contacts.
-            
-            for (int i = 0; i < numBodies; i++) {
-                const ContactSurfaceIndex index1 = extents[i].index;
+                index.setSphere(i, set.bodies[i].getBodyTransform(state)*set.sphereCenters[i], set.sphereRadii[i]);
+            overlaps.clear();
+            index.findOverlappingPairs(overlaps);
+
+            // Do a full collision detection on each of those pairs.
+
+            for (const std::pair<int,int>& overlap : overlaps) {
+                const ContactSurfaceIndex index1(overlap.first);
+                const ContactSurfaceIndex index2(overlap.second);
                 const Transform transform1 = set.bodies[index1].getBodyTransform(state)*set.transforms[index1];
                 const ContactGeometry& geom1 = set.geometry[index1];
                 const ContactGeometryTypeId typeId1 = geom1.getTypeId();
-                for (int j = i+1; j < numBodies && extents[j].start <= extents[i].end; j++) {
-                    // They overlap along this axis.  See if the bounding spheres overlap.
-                    
-                    const ContactSurfaceIndex index2 = extents[j].index;
-                    const Real sumRadius = set.sphereRadii[index1]+set.sphereRadii[index2];
-                    if ((centers[index1]-centers[index2]).normSqr() <= sumRadius*sumRadius) {
-                        // Do a full collision detection.
-
-                        const Transform transform2 = set.bodies[index2].getBodyTransform(state)*set.transforms[index2];
-                        const ContactGeometry& geom2 = set.geometry[index2];
-                        const ContactGeometryTypeId typeId2 = geom2.getTypeId();
-                        CollisionDetectionAlgorithm* algorithm = 
-                            CollisionDetectionAlgorithm::getAlgorithm
-                                                            (typeId1, typeId2);
-                        if (algorithm == NULL) {
-                            algorithm = CollisionDetectionAlgorithm::
-                                                getAlgorithm(typeId2, typeId1);
-                            if (algorithm == NULL)
-                                continue; // No algorithm available for detecting collisions between these two objects.
-                            algorithm->processObjects(index2, geom2, transform2,
-                                                      index1, geom1, transform1,
-                                                      contacts[setIndex]);
-                        }
-                        else {
-                            algorithm->processObjects(index1, geom1, transform1,
-                                                      index2, geom2, transform2,
-                                                      contacts[setIndex]);
-                        }
-                    }
+                const Transform transform2 = set.bodies[index2].getBodyTransform(state)*set.transforms[index2];
+                const ContactGeometry& geom2 = set.geometry[index2];
+                const ContactGeometryTypeId typeId2 = geom2.getTypeId();
+                CollisionDetectionAlgorithm* algorithm = 
+                    CollisionDetectionAlgorithm::getAlgorithm
+                                                    (typeId1, typeId2);
+                if (algorithm == NULL) {
+                    algorithm = CollisionDetectionAlgorithm::
+                                        getAlgorithm(typeId2, typeId1);
+                    if (algorithm == NULL)
+                        continue; // No algorithm available for detecting collisions between these two objects.
+                    algorithm->processObjects(index2, geom2, transform2,
+                                              index1, geom1, transform1,
+                                              contacts[setIndex]);
+                }
+                else {
+                    algorithm->processObjects(index1, geom1, transform1,
+                                              index2, geom2, transform2,
+                                              contacts[setIndex]);
                 }
             }
         }
@@ -240,6 +219,7 @@ private:
 
     mutable CacheEntryIndex contactsCacheIndex;
     mutable CacheEntryIndex contactsValidCacheIndex;
+    mutable CacheEntryIndex broadPhaseIndicesCacheIndex;
 };
 
 
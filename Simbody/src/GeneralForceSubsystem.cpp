@@ -39,7 +39,10 @@
 
 #include "ForceImpl.h"
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
+#include <mutex>
 
 //Threading constants used by CalcForcesTask
 namespace {
@@ -48,14 +51,34 @@ using namespace SimTK;
 const int NumNonParallelThreads = 1;
 const int NonParallelForcesIndex = 0;
 
+// How many force evaluations we do before redistributing the forces over the
+// threads according to their measured cost, and how strongly each new
+// measurement updates a force's smoothed cost.
+const int  RebalanceInterval = 20;
+const Real CostSmoothing = Real(0.25);
+
+// Below this many array entries (summed over the contributing threads) the
+// per-thread force arrays are merged serially.
+const long long MinParallelReductionSize = 20000;
+
 /* Base class for CalcForcesParallelTask and CalcForcesNonParallelTask - lays 
 out common methods that will be implemented to suit the parallel/non-parallel
 use cases*/
+struct ForceSchedule;
+
 class CalcForcesTask : public ParallelExecutor::Task {
 public:
     CalcForcesTask() = default;
     
     virtual CalcForcesTask* clone() const = 0;
+
+    // Only the parallel task makes use of a schedule.
+    virtual void setSchedule(ForceSchedule* schedule) {}
+
+    // Called after the task has been executed, to merge any per-thread 
+    // results into the State. The executor, if given, may be used to do the
+    // merging in parallel.
+    virtual void reduce(ParallelExecutor* executor) {}
     
     virtual void initializeAll(
             const State& s,
@@ -83,10 +106,115 @@ public:
             Vector& mobilityForces) = 0;
     
 };
+/* One thread's private force accumulators for CalcForcesParallelTask. They
+are only set up if the thread calculates a force that needs full-length
+arrays (see ForceSparsity for the alternative). They are zeroed when
+allocated and then kept zero between evaluations by the reduction that
+merges them into the State, so they needn't be cleared at the start of every
+evaluation. The flags record whether a reduction is still owed (for example,
+because a force threw).*/
+struct LocalForces {
+    Vector_<SpatialVec> rigidBodyForces;
+    Vector_<Vec3>       particleForces;
+    Vector              mobilityForces;
+    Vector_<SpatialVec> rigidBodyForceCache;
+    Vector_<Vec3>       particleForceCache;
+    Vector              mobilityForceCache;
+    bool                forcesDirty = false;
+    bool                cacheDirty = false;
+    bool                inUse = false; // by the current calculation?
+
+    // Scratch space for forces that calculate into compact arrays.
+    Vector_<SpatialVec> compactBodyForces;
+    Vector              compactMobilityForces;
+};
+
+// Resize v to n and zero it unless it is already that size and known to be
+// zero.
+template <class T>
+void prepareLocal(Vector_<T>& v, int n, bool dirty) {
+    if (v.size() != n) {
+        v.resize(n);
+        v.setToZero();
+    } else if (dirty)
+        v.setToZero();
+}
+
+// Add entries [begin,end) of each thread's local array into the target, and
+// leave those local entries zero for next time.
+template <class T>
+void addAndZero(Vector_<T>& target, const Array_<Vector_<T>*>& locals,
+                int begin, int end, const T& zero) {
+    for (Vector_<T>* local : locals) {
+        Vector_<T>& v = *local;
+        for (int i = begin; i < end; ++i) {
+            target[i] += v[i];
+            v[i] = zero;
+        }
+    }
+}
+
+/* Merges the LocalForces of the threads that took part in a calculation into
+the State's force arrays. Task index c handles the c'th of numSlices
+contiguous slices of the body, particle and mobility index ranges, so slices
+can be merged in parallel without any locking.*/
+class ReduceForcesTask : public ParallelExecutor::Task {
+public:
+    ReduceForcesTask(int numSlices,
+            Vector_<SpatialVec>& rigidBodyForces, 
+            const Array_<Vector_<SpatialVec>*>& rigidBodyLocals,
+            Vector_<Vec3>& particleForces,
+            const Array_<Vector_<Vec3>*>& particleLocals,
+            Vector& mobilityForces,
+            const Array_<Vector*>& mobilityLocals)
+    :   m_numSlices(numSlices),
+        m_rigidBodyForces(rigidBodyForces), m_rigidBodyLocals(rigidBodyLocals),
+        m_particleForces(particleForces), m_particleLocals(particleLocals),
+        m_mobilityForces(mobilityForces), m_mobilityLocals(mobilityLocals) {}
+
+    void execute(int slice) override {
+        reduceSlice(m_rigidBodyForces, m_rigidBodyLocals, slice,
+                    SpatialVec(Vec3(0), Vec3(0)));
+        reduceSlice(m_particleForces, m_particleLocals, slice, Vec3(0));
+        reduceSlice(m_mobilityForces, m_mobilityLocals, slice, Real(0));
+    }
+private:
+    template <class T>
+    void reduceSlice(Vector_<T>& target, const Array_<Vector_<T>*>& locals,
+                     int slice, const T& zero) const {
+        const long long n = target.size();
+        addAndZero(target, locals, int(n*slice/m_numSlices), 
+                   int(n*(slice+1)/m_numSlices), zero);
+    }
+
+    const int m_numSlices;
+    Vector_<SpatialVec>& m_rigidBodyForces;
+    const Array_<Vector_<SpatialVec>*>& m_rigidBodyLocals;
+    Vector_<Vec3>& m_particleForces;
+    const Array_<Vector_<Vec3>*>& m_particleLocals;
+    Vector& m_mobilityForces;
+    const Array_<Vector*>& m_mobilityLocals;
+};
+
+/* An assignment of force calculations to ParallelExecutor task indices. Each
+bin lists the items that one task index calculates: item -1 stands for the
+whole group of non-parallel forces, which must stay together on one thread,
+and item k >= 0 is the k'th enabled parallel force. The bins are built by
+GeneralForceSubsystemRep from the measured cost of each force, and the task
+records how long each force took so that the costs can be kept up to date.
+A time of -1 means the force was not calculated.*/
+struct ForceSchedule {
+    Array_<Array_<int>> bins;
+    Array_<Real>        binLoads;         // estimated seconds per bin
+    Array_<Real>        nonParallelTimes; // index like enabled...Forces
+    Array_<Real>        parallelTimes;
+};
+
 /*Calculates each enabled force's contribution in the MultibodySystem.
 CalcForcesParallelTask allows force calculations to occur in parallel with
-non-parallel forces being calculated on Thread NonParallelForcesIndex and all
-other parallel forces being calculated on separate threads.*/
+the non-parallel forces being calculated together on one thread and all
+other parallel forces distributed over the remaining task indices, either one
+per index or according to a ForceSchedule.*/
 
 //Implementation of CalcForcesTask for parallel forces
 class CalcForcesParallelTask : public CalcForcesTask {
@@ -102,6 +230,13 @@ public:
     CalcForcesParallelTask* clone() const override {
         return new CalcForcesParallelTask();
     }
+
+    // Without a schedule, task index 0 calculates the non-parallel forces and
+    // index i calculates parallel force i-1.
+    void setSchedule(ForceSchedule* schedule) override {
+        m_schedule = schedule;
+    }
+
     // Each different force calculation Mode requires different parameters
     //
     // Note: Execute MUST be called directly after CalcForceTask is initialized
@@ -121,6 +256,7 @@ public:
         m_mobilityForces = &mobilityForces;
         
         m_mode = All;
+        m_contributions.clear();
     }
     void initializeCachedAndNonCached(
             const State& s,
@@ -144,6 +280,7 @@ public:
         m_mobilityForceCache = &mobilityForceCache;
 
         m_mode = CachedAndNonCached;
+        m_contributions.clear();
     }
     void initializeNonCached(
             const State& s,
@@ -161,115 +298,193 @@ public:
         m_mobilityForces = &mobilityForces;
 
         m_mode = NonCached;
+        m_contributions.clear();
     }
     
-    // Set all of the local force contribution arrays to 0. This is so that
-    // each local thread can sum up it's force contribution to be later
-    // added into the total force array.
+    // A thread's local arrays are only set up when it first needs them; see
+    // useLocalForces().
     void initialize() override {
-        m_rigidBodyForcesLocalStatic.upd().resize(m_rigidBodyForces->size());
-        m_rigidBodyForcesLocalStatic.upd().setToZero();
-        m_particleForcesLocalStatic.upd().resize(m_particleForces->size());
-        m_particleForcesLocalStatic.upd().setToZero();
-        m_mobilityForcesLocalStatic.upd().resize(m_mobilityForces->size());
-        m_mobilityForcesLocalStatic.upd().setToZero();
-
-        if (m_mode == CachedAndNonCached) {
-            m_rigidBodyForceCacheLocalStatic.upd().resize(m_rigidBodyForceCache->size());
-            m_rigidBodyForceCacheLocalStatic.upd().setToZero();
-            m_particleForceCacheLocalStatic.upd().resize(m_particleForceCache->size());
-            m_particleForceCacheLocalStatic.upd().setToZero();
-            m_mobilityForceCacheLocalStatic.upd().resize(m_mobilityForceCache->size());
-            m_mobilityForceCacheLocalStatic.upd().setToZero();
+        m_localForcesStatic.upd().inUse = false;
+    }
+    
+    // Calculate the forces assigned to this task index.
+    void execute(int taskIndex) override {
+        if (!m_schedule) {
+            calcItem(taskIndex - NumNonParallelThreads);
+            return;
         }
+        for (int item : m_schedule->bins[taskIndex])
+            calcItem(item);
     }
     
-    // Calculate all enabled forces (taking into account mode and parallelism)
-    void execute(int threadIndex) override {
-      switch (m_mode) {
-        case All:
-            if (threadIndex == NonParallelForcesIndex) {
-                // Process all non-parallel forces
-                for (Force* force : *m_enabledNonParallelForces) {
-                    force->getImpl().calcForce(*m_state, m_rigidBodyForcesLocalStatic.upd(), m_particleForcesLocalStatic.upd(), m_mobilityForcesLocalStatic.upd());
-                }
-            } else {
-                // Process a single parallel force. Subtract 1 from index b/c
-                // we use 0 for the non-parallel forces.
-                const auto& impl =
-                    m_enabledParallelForces->getElt(threadIndex-1)->getImpl();
-                impl.calcForce(*m_state, m_rigidBodyForcesLocalStatic.upd(), m_particleForcesLocalStatic.upd(), m_mobilityForcesLocalStatic.upd());
+    //Once a thread has finished it's force calculations, we remember its
+    //contribution so that reduce() can add it into the force arrays in the
+    //State.
+    void finish() override {
+        LocalForces& local = m_localForcesStatic.upd();
+        if (local.inUse)
+            m_contributions.push_back(&local);
+    }
 
-            }
-            break;
+    // Add the contributing threads' local arrays into the State's arrays,
+    // zeroing the local arrays as we go. For big systems this is done in
+    // parallel, one slice of the arrays per thread.
+    void reduce(ParallelExecutor* executor) override {
+        if (m_contributions.empty())
+            return;
+        const long long work = (long long)m_contributions.size()
+            * (m_mobilityForces->size() + m_rigidBodyForces->size()
+               + m_particleForces->size());
+        const int numSlices = executor && work >= MinParallelReductionSize
+            ? executor->getMaxThreads() : 1;
+
+        Array_<Vector_<SpatialVec>*> rigidBody;
+        Array_<Vector_<Vec3>*> particle;
+        Array_<Vector*> mobility;
+        for (LocalForces* local : m_contributions) {
+            rigidBody.push_back(&local->rigidBodyForces);
+            particle.push_back(&local->particleForces);
+            mobility.push_back(&local->mobilityForces);
+        }
+        ReduceForcesTask forcesTask(numSlices, *m_rigidBodyForces, rigidBody,
+            *m_particleForces, particle, *m_mobilityForces, mobility);
+        runReduction(forcesTask, numSlices, executor);
 
-        case CachedAndNonCached:
-            if (threadIndex == NonParallelForcesIndex) {
-                // Process all non-parallel forces.
-                for (Force* force : *m_enabledNonParallelForces) {
-                    const auto& impl = force->getImpl();
-                    if (impl.dependsOnlyOnPositions()) {
-                        impl.calcForce(*m_state, *m_rigidBodyForceCache, *m_particleForceCache, *m_mobilityForceCache);
-                    } else { // ordinary velocity dependent force
-                        impl.calcForce(*m_state, *m_rigidBodyForces, *m_particleForces, *m_mobilityForces);
-                    }
-                }
-            } else {
-                // Process a single parallel force. Subtract 1 from threadIndex b/c
-                // we use 0 for the non-parallel forces.
-                const auto& impl =
-                    m_enabledParallelForces->getElt(threadIndex-1)->getImpl();
-                if (impl.dependsOnlyOnPositions()) {
-                    impl.calcForce(*m_state, m_rigidBodyForceCacheLocalStatic.upd(), m_particleForceCacheLocalStatic.upd(), m_mobilityForceCacheLocalStatic.upd());
-                } else { // ordinary velocity dependent force
-                    impl.calcForce(*m_state, m_rigidBodyForcesLocalStatic.upd(), m_particleForcesLocalStatic.upd(), m_mobilityForcesLocalStatic.upd());
-                }
+        if (m_mode == CachedAndNonCached) {
+            for (int i = 0; i < (int)m_contributions.size(); ++i) {
+                rigidBody[i] = &m_contributions[i]->rigidBodyForceCache;
+                particle[i] = &m_contributions[i]->particleForceCache;
+                mobility[i] = &m_contributions[i]->mobilityForceCache;
             }
-            break;
+            ReduceForcesTask cacheTask(numSlices, *m_rigidBodyForceCache, 
+                rigidBody, *m_particleForceCache, particle, 
+                *m_mobilityForceCache, mobility);
+            runReduction(cacheTask, numSlices, executor);
+        }
 
-        case NonCached:
-            if (threadIndex == NonParallelForcesIndex) {
-                // Process all non-parallel forces.
-                for (Force* force : *m_enabledNonParallelForces) {
-                    const auto& impl = force->getImpl();
-                    if (!impl.dependsOnlyOnPositions()) {
-                        impl.calcForce(*m_state,
-                                *m_rigidBodyForces, *m_particleForces,
-                                *m_mobilityForces);
-                    }
-                }
-            } else {
-                // Process a single parallel force. Subtract 1 from index b/c
-                // we use 0 for the non-parallel forces.
-                const auto& impl =
-                    m_enabledParallelForces->getElt(threadIndex-1)->getImpl();
-                    if (!impl.dependsOnlyOnPositions()) {
-                        impl.calcForce(*m_state,
-                                m_rigidBodyForcesLocalStatic.upd(), m_particleForcesLocalStatic.upd(),
-                                m_mobilityForcesLocalStatic.upd());
-                    }
+        for (LocalForces* local : m_contributions) {
+            local->forcesDirty = false;
+            if (m_mode == CachedAndNonCached)
+                local->cacheDirty = false;
+        }
+        m_contributions.clear();
+    }
+private:
+    static void runReduction(ReduceForcesTask& task, int numSlices,
+                             ParallelExecutor* executor) {
+        if (numSlices > 1)
+            executor->execute(task, numSlices);
+        else
+            task.execute(0);
+    }
+
+    // Calculate one schedule item (see ForceSchedule), timing each force if
+    // we have a schedule to record the times in.
+    void calcItem(int item) {
+        if (item < 0) {
+            const Array_<Force*>& nonParallel = *m_enabledNonParallelForces;
+            for (int k = 0; k < (int)nonParallel.size(); ++k) {
+                const Real t = calcOneForce(nonParallel[k]->getImpl());
+                if (m_schedule) m_schedule->nonParallelTimes[k] = t;
             }
-            break;
+        } else {
+            const Real t = calcOneForce
+                                (m_enabledParallelForces->getElt(item)->getImpl());
+            if (m_schedule) m_schedule->parallelTimes[item] = t;
         }
     }
-    
-    //Once a thread has finished it's force calculations, we add in the thread's
-    //contribution into the cached force arrays in the State
-    void finish() override {
-        *m_rigidBodyForces += m_rigidBodyForcesLocalStatic.get();
-        *m_particleForces += m_particleForcesLocalStatic.get();
-        *m_mobilityForces += m_mobilityForcesLocalStatic.get();
+
+    // Calculate one force's contribution (taking into account mode) into this
+    // thread's local arrays. Returns the elapsed time in seconds, or -1 if
+    // the force didn't need to be calculated. The clock is only read when
+    // there is a schedule to report to.
+    Real calcOneForce(const ForceImpl& impl) {
+        if (m_mode == NonCached && impl.dependsOnlyOnPositions())
+            return -1;
+        typedef std::chrono::steady_clock Clock;
+        const Clock::time_point start = m_schedule ? Clock::now() 
+                                                   : Clock::time_point();
+        const bool toCache = 
+            m_mode == CachedAndNonCached && impl.dependsOnlyOnPositions();
+        if (const ForceSparsity* sparsity = impl.getSparsity()) {
+            calcSparseForce(impl, *sparsity, toCache);
+        } else if (toCache) {
+            LocalForces& local = useLocalForces();
+            impl.calcForce(*m_state, local.rigidBodyForceCache, local.particleForceCache, local.mobilityForceCache);
+        } else { // ordinary velocity dependent force
+            LocalForces& local = useLocalForces();
+            impl.calcForce(*m_state, local.rigidBodyForces, local.particleForces, local.mobilityForces);
+        }
+        if (!m_schedule)
+            return 0;
+        return std::chrono::duration<Real>(Clock::now() - start).count();
+    }
+
+    // Calculate a force that only affects a few entries into this thread's
+    // compact scratch arrays, then add those entries into this thread's 
+    // full-length local arrays if it already has them for other forces. 
+    // Otherwise we add them straight into the State's arrays, which is cheap 
+    // enough to do under a lock and saves us from needing full-length local
+    // arrays for this thread.
+    void calcSparseForce(const ForceImpl& impl, const ForceSparsity& sparsity,
+                         bool toCache) {
+        const SimbodyMatterSubsystem& matter = 
+            impl.getForceSubsystem().getMultibodySystem().getMatterSubsystem();
+        LocalForces& local = m_localForcesStatic.upd();
+        sparsity.prepareCompact(*m_state, matter, local.compactBodyForces,
+                                local.compactMobilityForces);
+        impl.calcSparseForce(*m_state, local.compactBodyForces,
+                             local.compactMobilityForces);
+        if (local.inUse) {
+            sparsity.addInto(*m_state, matter, 
+                local.compactBodyForces, local.compactMobilityForces,
+                toCache ? local.rigidBodyForceCache : local.rigidBodyForces,
+                toCache ? local.mobilityForceCache : local.mobilityForces);
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_addLock);
+        sparsity.addInto(*m_state, matter, 
+            local.compactBodyForces, local.compactMobilityForces,
+            toCache ? *m_rigidBodyForceCache : *m_rigidBodyForces, 
+            toCache ? *m_mobilityForceCache : *m_mobilityForces);
+    }
+
+    // Get this thread's local force arrays, making sure the first time 
+    // they're used in this calculation that they are the right size and zero
+    // so that each local thread can sum up its force contribution to be later
+    // added into the total force array.
+    LocalForces& useLocalForces() {
+        LocalForces& local = m_localForcesStatic.upd();
+        if (local.inUse)
+            return local;
+        prepareLocal(local.rigidBodyForces, m_rigidBodyForces->size(),
+                     local.forcesDirty);
+        prepareLocal(local.particleForces, m_particleForces->size(),
+                     local.forcesDirty);
+        prepareLocal(local.mobilityForces, m_mobilityForces->size(),
+                     local.forcesDirty);
+        local.forcesDirty = true;
 
         if (m_mode == CachedAndNonCached) {
-            *m_rigidBodyForceCache += m_rigidBodyForceCacheLocalStatic.get();
-            *m_particleForceCache += m_particleForceCacheLocalStatic.get();
-            *m_mobilityForceCache += m_mobilityForceCacheLocalStatic.get();
+            prepareLocal(local.rigidBodyForceCache, 
+                         m_rigidBodyForceCache->size(), local.cacheDirty);
+            prepareLocal(local.particleForceCache, 
+                         m_particleForceCache->size(), local.cacheDirty);
+            prepareLocal(local.mobilityForceCache,
+                         m_mobilityForceCache->size(), local.cacheDirty);
+            local.cacheDirty = true;
         }
+        local.inUse = true;
+        return local;
     }
-private:
+
     Mode m_mode;
 
     ReferencePtr<const State> m_state;
+    ForceSchedule* m_schedule = nullptr;
+
+    // Serializes adding sparse forces directly into the State's arrays.
+    std::mutex m_addLock;
 
     // Constant state-cache variables for the enabled parallel and non-parallel
     // forces.
@@ -289,35 +504,17 @@ private:
     // These variables are local to a thread. They are set to their default
     // value when the threads are spawned. We use them to keep track of each
     // thread's contribution that we will later add in to the final state cache.
-    static ThreadLocal<Vector_<SpatialVec>> m_rigidBodyForcesLocalStatic;
-    static ThreadLocal<Vector_<Vec3>> m_particleForcesLocalStatic;
-    static ThreadLocal<Vector> m_mobilityForcesLocalStatic;
+    static ThreadLocal<LocalForces> m_localForcesStatic;
 
-    static ThreadLocal<Vector_<SpatialVec>> m_rigidBodyForceCacheLocalStatic;
-    static ThreadLocal<Vector_<Vec3>> m_particleForceCacheLocalStatic;
-    static ThreadLocal<Vector> m_mobilityForceCacheLocalStatic;
+    // The local arrays of the threads that took part in the current 
+    // calculation; appended to in (synchronized) finish().
+    Array_<LocalForces*> m_contributions;
 };
 
 //local declarations of static member variables
-/*static*/ ThreadLocal<Vector_<SpatialVec>>
-                            CalcForcesParallelTask::m_rigidBodyForcesLocalStatic
-                                           = ThreadLocal<Vector_<SpatialVec>>();
-/*static*/ ThreadLocal<Vector_<Vec3>>
-                            CalcForcesParallelTask::m_particleForcesLocalStatic
-                                                 = ThreadLocal<Vector_<Vec3>>();
-/*static*/ ThreadLocal<Vector>
-                            CalcForcesParallelTask::m_mobilityForcesLocalStatic
-                                                        = ThreadLocal<Vector>();
-
-/*static*/ ThreadLocal<Vector_<SpatialVec>>
-                       CalcForcesParallelTask::m_rigidBodyForceCacheLocalStatic
-                                           = ThreadLocal<Vector_<SpatialVec>>();
-/*static*/ ThreadLocal<Vector_<Vec3>>
-                        CalcForcesParallelTask::m_particleForceCacheLocalStatic
-                                                 = ThreadLocal<Vector_<Vec3>>();
-/*static*/ ThreadLocal<Vector>
-                        CalcForcesParallelTask::m_mobilityForceCacheLocalStatic
-                                                        = ThreadLocal<Vector>();
+/*static*/ ThreadLocal<LocalForces>
+            CalcForcesParallelTask::m_localForcesStatic
+                                                 = ThreadLocal<LocalForces>();
 
 /* Calculates each enabled force's contribution in the MultibodySystem. These
 calculations occur on the main thread, without use of local thread variables.*/
@@ -522,9 +719,8 @@ public:
     GeneralForceSubsystemRep()
      : ForceSubsystemRep("GeneralForceSubsystem", "0.0.1")
     {
-        //The default number of threads is the physical number of processors
-        //call setNumberOfThreads() if you want to override the thread count
-        calcForcesExecutor = new ParallelExecutor();
+        //By default we use the process-wide shared executor; call 
+        //setNumberOfThreads() if you want a private one with its own count.
     }
 
     ~GeneralForceSubsystemRep() {
@@ -568,17 +764,11 @@ public:
         Array_<bool>& forceEnabled = Value< Array_<bool> >::updDowncast
             (updDiscreteVariable(s, forceEnabledIndex));
 
+        // The cached position-dependent forces have the enabled flags as a
+        // prerequisite so they get invalidated here.
         const bool shouldEnable = !shouldDisable; // sorry
-        if (forceEnabled[index] != shouldEnable) {
+        if (forceEnabled[index] != shouldEnable)
             forceEnabled[index] = shouldEnable;
-
-            // If we're caching position-dependent forces, make sure they are
-            // marked invalid here.
-            if (cachedForcesAreValidCacheIndex.isValid()) {
-                Value<bool>::updDowncast
-                   (updCacheEntry(s, cachedForcesAreValidCacheIndex)) = false;
-            }
-        }
     }
 
     void setNumberOfThreads(unsigned numThreads) {
@@ -588,7 +778,41 @@ public:
     }
     
     int getNumberOfThreads() const{
-      return calcForcesExecutor->getMaxThreads();
+      return getExecutor().getMaxThreads();
+    }
+
+    ParallelExecutor& getExecutor() const {
+        return calcForcesExecutor.empty() 
+            ? ParallelExecutor::getSharedExecutor() 
+            : calcForcesExecutor.updRef();
+    }
+
+    Real getEstimatedForceCost(ForceIndex index) const {
+        SimTK_INDEXCHECK_ALWAYS(index, getNumForces(), 
+            "GeneralForceSubsystem::getEstimatedForceCost()");
+        return index < (int)forceCost.size() ? forceCost[index] : Real(0);
+    }
+
+    const Array_<Real>& getEstimatedThreadLoads() const {
+        return forceSchedule.binLoads;
+    }
+
+    bool calcForceJacobian(const State& state, ForceJacobian& jacobian) const {
+        const SimbodyMatterSubsystem& matter = 
+            getMultibodySystem().getMatterSubsystem();
+        jacobian.initialize(matter, state);
+        return addInForceJacobian(state, jacobian);
+    }
+
+    bool addInForceJacobian(const State& state, 
+                            ForceJacobian& jacobian) const override {
+        for (ForceIndex i(0); i < forces.size(); ++i) {
+            if (isForceDisabled(state, i))
+                continue;
+            if (!forces[i]->getImpl().calcForceJacobian(state, jacobian))
+                return false;
+        }
+        return true;
     }
 
     // These override default implementations of virtual methods in the
@@ -601,10 +825,7 @@ public:
         forceEnabledIndex.invalidate();
         enabledParallelForcesIndex.invalidate();
         enabledNonParallelForcesIndex.invalidate();
-        cachedForcesAreValidCacheIndex.invalidate();
-        rigidBodyForceCacheIndex.invalidate();
-        mobilityForceCacheIndex.invalidate();
-        particleForceCacheIndex.invalidate();
+        cachedForcesCacheIndex.invalidate();
 
         // Some forces are disabled by default; initialize the enabled flags
         // accordingly. Also, see if we're going to need to do any caching
@@ -670,24 +891,35 @@ public:
             calcForcesTask = new CalcForcesParallelTask();
         else
             calcForcesTask = new CalcForcesNonParallelTask();
+        calcForcesInParallel = hasParallelForces;
         
-        // Note that we'll allocate these even if all the needs-caching
-        // elements are presently disabled. That way they'll be around when
-        // the force gets enabled.
-        if (someForceElementNeedsCaching) {
-            cachedForcesAreValidCacheIndex =
-                allocateCacheEntry(s, Stage::Position, new Value<bool>());
-            rigidBodyForceCacheIndex = allocateCacheEntry(s, Stage::Dynamics,
-                new Value<Vector_<SpatialVec> >());
-            mobilityForceCacheIndex = allocateCacheEntry(s, Stage::Dynamics,
-                new Value<Vector>());
-            particleForceCacheIndex = allocateCacheEntry(s, Stage::Dynamics,
-                new Value<Vector_<Vec3> >());
-        }
-
         // We must realizeTopology() even if the force is disabled by default.
         for (int i = 0; i < (int) forces.size(); ++i)
             forces[i]->getImpl().realizeTopology(s);
+
+        // Note that we'll allocate this even if all the needs-caching
+        // elements are presently disabled. That way it'll be around when
+        // the force gets enabled. Besides q (through the Position stage) the
+        // cached forces depend on the enabled flags and on any parameter
+        // variables the cached elements declare, so changing one of those
+        // recomputes them without throwing away the rest of Dynamics stage.
+        // This has to follow the elements' realizeTopology() so that their
+        // parameter variables exist.
+        if (someForceElementNeedsCaching) {
+            const SubsystemIndex sx = getMySubsystemIndex();
+            Array_<DiscreteVarKey> prereqs;
+            prereqs.push_back(DiscreteVarKey(sx, forceEnabledIndex));
+            Array_<DiscreteVariableIndex> params;
+            for (int i = 0; i < (int) forces.size(); ++i)
+                if (forces[i]->getImpl().dependsOnlyOnPositions())
+                    forces[i]->getImpl().appendParameterVariables(params);
+            for (DiscreteVariableIndex dx : params)
+                prereqs.push_back(DiscreteVarKey(sx, dx));
+            cachedForcesCacheIndex = s.allocateCacheEntryWithPrerequisites
+               (sx, Stage::Position, Stage::Infinity,
+                false /*q*/, false /*u*/, false /*z*/, prereqs, {} /*ce*/,
+                new Value<CachedForces>());
+        }
         return 0;
     }
 
@@ -745,12 +977,6 @@ public:
     int realizeSubsystemPositionImpl(const State& s) const override {
         const Array_<bool>& enabled = Value<Array_<bool> >::downcast
             (getDiscreteVariable(s, forceEnabledIndex));
-        // If we're caching position-dependent forces, make sure they are
-        // marked invalid here.
-        if (cachedForcesAreValidCacheIndex.isValid()) {
-            Value<bool>::updDowncast
-               (updCacheEntry(s, cachedForcesAreValidCacheIndex)) = false;
-        }
         for (int i = 0; i < (int) forces.size(); ++i)
             if (enabled[i]) forces[i]->getImpl().realizePosition(s);
         return 0;
@@ -777,6 +1003,43 @@ public:
         const Array_<Force*>& enabledParallelForces = Value<Array_<Force*>>::
                          downcast(getCacheEntry(s, enabledParallelForcesIndex));
 
+        // If we're already on a worker thread (for example, this State is one
+        // of a batch being realized by MultibodySystem::realizeBatch()), the
+        // shared task and executor may be in use for another State. In that
+        // case run a private copy of the task serially on this thread.
+        std::unique_ptr<CalcForcesTask> privateTask;
+        if (ParallelExecutor::isWorkerThread())
+            privateTask.reset(calcForcesTask->clone());
+        CalcForcesTask& calcTask = 
+            privateTask ? *privateTask : calcForcesTask.updRef();
+
+        // Otherwise distribute the forces over the threads according to
+        // their measured cost.
+        int numTasks = 
+            (int)enabledParallelForces.size() + NumNonParallelThreads;
+        ForceSchedule* schedule = nullptr;
+        if (!privateTask && calcForcesInParallel) {
+            numTasks = updateForceSchedule(enabledNonParallelForces,
+                                           enabledParallelForces);
+            schedule = &forceSchedule;
+        }
+        calcTask.setSchedule(schedule);
+        auto runCalcTask = [&]() {
+            if (!privateTask) {
+                getExecutor().execute(calcTask, numTasks);
+                calcTask.reduce(&getExecutor());
+                if (schedule)
+                    recordForceTimes(enabledNonParallelForces, 
+                                     enabledParallelForces);
+                return;
+            }
+            calcTask.initialize();
+            for (int i = 0; i < numTasks; ++i)
+                calcTask.execute(i);
+            calcTask.finish();
+            calcTask.reduce(nullptr);
+        };
+
         // Get access to System-global force cache arrays.
         Vector_<SpatialVec>&   rigidBodyForces =
                                     mbs.updRigidBodyForces(s, Stage::Dynamics);
@@ -788,13 +1051,12 @@ public:
         // Short circuit if we're not doing any caching here. Note that we're
         // checking whether the *index* is valid (i.e. does the cache entry
         // exist?), not the contents.
-        if (!cachedForcesAreValidCacheIndex.isValid()) {
+        if (!cachedForcesCacheIndex.isValid()) {
             // Call calcForce() on all Forces, in parallel.
-            calcForcesTask->initializeAll(s,
+            calcTask.initializeAll(s,
                     enabledNonParallelForces, enabledParallelForces,
                     rigidBodyForces, particleForces, mobilityForces);
-            calcForcesExecutor->execute(calcForcesTask.updRef(),
-                          enabledParallelForces.size() + NumNonParallelThreads);
+            runCalcTask();
 
             // Allow forces to do their own realization, but wait until all
             // forces have executed calcForce(). TODO: not sure if that is
@@ -806,22 +1068,14 @@ public:
         }
 
         // OK, we're doing some caching. This is a little messier.
-        // Get access to subsystem force cache entries.
-        bool& cachedForcesAreValid = Value<bool>::updDowncast
-                          (updCacheEntry(s, cachedForcesAreValidCacheIndex));
-
-        Vector_<SpatialVec>&
-            rigidBodyForceCache = Value<Vector_<SpatialVec> >::updDowncast
-                                 (updCacheEntry(s, rigidBodyForceCacheIndex));
-        Vector_<Vec3>&
-            particleForceCache  = Value<Vector_<Vec3> >::updDowncast
-                                 (updCacheEntry(s, particleForceCacheIndex));
-        Vector&
-            mobilityForceCache  = Value<Vector>::updDowncast
-                                 (updCacheEntry(s, mobilityForceCacheIndex));
-
-
-        if (!cachedForcesAreValid) {
+        // Get access to the subsystem force cache entry.
+        CachedForces& cachedForces = Value<CachedForces>::updDowncast
+                                    (updCacheEntry(s, cachedForcesCacheIndex));
+        Vector_<SpatialVec>& rigidBodyForceCache = cachedForces.rigidBodyForces;
+        Vector_<Vec3>&       particleForceCache  = cachedForces.particleForces;
+        Vector&              mobilityForceCache  = cachedForces.mobilityForces;
+
+        if (!isCacheValueRealized(s, cachedForcesCacheIndex)) {
             // We need to calculate the velocity independent forces.
             rigidBodyForceCache.resize(matter.getNumBodies());
             rigidBodyForceCache = SpatialVec(Vec3(0), Vec3(0));
@@ -832,22 +1086,20 @@ public:
 
             // Run through all the forces, accumulating directly into the
             // force arrays or indirectly into the cache as appropriate.
-            calcForcesTask->initializeCachedAndNonCached(s,
+            calcTask.initializeCachedAndNonCached(s,
                                 enabledNonParallelForces, enabledParallelForces,
                                 rigidBodyForces, particleForces, mobilityForces,
                                 rigidBodyForceCache, particleForceCache,
                                 mobilityForceCache);
-            calcForcesExecutor->execute(calcForcesTask.updRef(),
-                          enabledParallelForces.size() + NumNonParallelThreads);
-            cachedForcesAreValid = true;
+            runCalcTask();
+            markCacheValueRealized(s, cachedForcesCacheIndex);
         } else {
             // Cache already valid; just need to do the non-cached ones (the
             // ones for which dependsOnlyOnPositions is false).
-            calcForcesTask->initializeNonCached(s,
+            calcTask.initializeNonCached(s,
                                enabledNonParallelForces, enabledParallelForces,
                                rigidBodyForces, particleForces, mobilityForces);
-            calcForcesExecutor->execute(calcForcesTask.updRef(),
-                          enabledParallelForces.size() + NumNonParallelThreads);
+            runCalcTask();
         }
 
         // Accumulate the values from the cache into the global arrays.
@@ -904,11 +1156,116 @@ public:
     }
 
 private:
+    // Bin-pack the enabled forces onto at most getNumberOfThreads() task
+    // indices using the longest-processing-time-first rule, so that one
+    // expensive force doesn't leave the other threads idle. The schedule is
+    // only rebuilt every RebalanceInterval evaluations or when the number of
+    // threads or enabled forces changes. Returns the number of task indices.
+    int updateForceSchedule(const Array_<Force*>& nonParallel,
+                            const Array_<Force*>& parallel) const {
+        ForceSchedule& sched = forceSchedule;
+        sched.nonParallelTimes.assign(nonParallel.size(), Real(-1));
+        sched.parallelTimes.assign(parallel.size(), Real(-1));
+        if (forceCost.size() != forces.size())
+            forceCost.resize(forces.size(), Real(0));
+
+        const int numItems = 
+            (nonParallel.empty() ? 0 : 1) + (int)parallel.size();
+        const int numBins = 
+            std::max(1, std::min(getExecutor().getMaxThreads(), numItems));
+        int numScheduled = 0;
+        for (const Array_<int>& bin : sched.bins)
+            numScheduled += (int)bin.size();
+        if ((int)sched.bins.size() == numBins && numScheduled == numItems
+            && ++evaluationsSinceRebalance < RebalanceInterval)
+            return numBins;
+        evaluationsSinceRebalance = 0;
+
+        // Forces we haven't timed yet are assumed to cost the average of 
+        // those we have.
+        Real knownCost = 0; int numKnown = 0;
+        for (Real c : forceCost)
+            if (c > 0) {knownCost += c; ++numKnown;}
+        const Real guess = numKnown ? knownCost/numKnown : Real(1);
+        auto costOf = [&](const Force* f) {
+            const Real c = forceCost[f->getImpl().getForceIndex()];
+            return c > 0 ? c : guess;
+        };
+
+        Array_<std::pair<Real,int>> items;
+        items.reserve(numItems);
+        if (!nonParallel.empty()) {
+            Real groupCost = 0;
+            for (const Force* f : nonParallel)
+                groupCost += costOf(f);
+            items.push_back(std::make_pair(groupCost, -1));
+        }
+        for (int k = 0; k < (int)parallel.size(); ++k)
+            items.push_back(std::make_pair(costOf(parallel[k]), k));
+        std::sort(items.begin(), items.end(),
+                  [](const std::pair<Real,int>& a, const std::pair<Real,int>& b)
+                  {   return a.first > b.first; });
+
+        sched.bins.clear();
+        sched.bins.resize(numBins);
+        sched.binLoads.assign(numBins, Real(0));
+        for (const std::pair<Real,int>& item : items) {
+            const int b = int(std::min_element(sched.binLoads.begin(),
+                                         sched.binLoads.end()) 
+                              - sched.binLoads.begin());
+            sched.bins[b].push_back(item.second);
+            sched.binLoads[b] += item.first;
+        }
+        return numBins;
+    }
+
+    // Fold the times measured during the last execution of the schedule into
+    // the smoothed per-force costs, and bring the bin loads up to date with
+    // them so that they always agree with getEstimatedForceCost().
+    void recordForceTimes(const Array_<Force*>& nonParallel,
+                          const Array_<Force*>& parallel) const {
+        auto costOf = [&](const Force* f) -> Real& {
+            return forceCost[f->getImpl().getForceIndex()];
+        };
+        auto record = [&](const Force* f, Real t) {
+            if (t < 0) return; // not calculated this time
+            Real& c = costOf(f);
+            c = c > 0 ? c + CostSmoothing*(t - c) : t;
+        };
+        for (int k = 0; k < (int)nonParallel.size(); ++k)
+            record(nonParallel[k], forceSchedule.nonParallelTimes[k]);
+        for (int k = 0; k < (int)parallel.size(); ++k)
+            record(parallel[k], forceSchedule.parallelTimes[k]);
+
+        for (int b = 0; b < (int)forceSchedule.bins.size(); ++b) {
+            Real load = 0;
+            for (int item : forceSchedule.bins[b]) {
+                if (item < 0) { // the whole non-parallel group
+                    for (const Force* f : nonParallel)
+                        load += costOf(f);
+                } else
+                    load += costOf(parallel[item]);
+            }
+            forceSchedule.binLoads[b] = load;
+        }
+    }
+
     Array_<Force*>                  forces;
 
     // For parallel calculation of forces.
+    // Empty unless setNumberOfThreads() was called; see getExecutor().
     mutable ClonePtr<ParallelExecutor>               calcForcesExecutor;
     mutable ClonePtr<CalcForcesTask>                 calcForcesTask;
+    mutable bool                                     calcForcesInParallel
+                                                                     = false;
+
+    // Cost-based assignment of forces to threads, and the smoothed measured
+    // wall-clock cost in seconds of each force's calcForce(), indexed by
+    // ForceIndex (0 if not yet measured).
+    mutable ForceSchedule                            forceSchedule;
+    mutable Array_<Real>                             forceCost;
+    mutable int                                      evaluationsSinceRebalance
+                                                                         = 0;
     
     // TOPOLOGY "CACHE"
     // These indices must be filled in during realizeTopology and treated
@@ -922,12 +1279,15 @@ private:
     mutable CacheEntryIndex   enabledParallelForcesIndex;
     mutable CacheEntryIndex   enabledNonParallelForcesIndex;
 
-    // This set of cache entries is allocated only if some force element
-    // overrode dependsOnlyOnPositions().
-    mutable CacheEntryIndex         cachedForcesAreValidCacheIndex;
-    mutable CacheEntryIndex         rigidBodyForceCacheIndex;
-    mutable CacheEntryIndex         mobilityForceCacheIndex;
-    mutable CacheEntryIndex         particleForceCacheIndex;
+    // This cache entry is allocated only if some force element overrode
+    // dependsOnlyOnPositions(). It holds the sum of the forces produced by
+    // those elements.
+    struct CachedForces {
+        Vector_<SpatialVec> rigidBodyForces;
+        Vector_<Vec3>       particleForces;
+        Vector              mobilityForces;
+    };
+    mutable CacheEntryIndex         cachedForcesCacheIndex;
 };
 
     ///////////////////////////
@@ -996,6 +1356,16 @@ void GeneralForceSubsystem::setNumberOfThreads(unsigned numThreads)
 int GeneralForceSubsystem::getNumberOfThreads() const
 {   return getRep().getNumberOfThreads(); }
 
+Real GeneralForceSubsystem::getEstimatedForceCost(ForceIndex index) const
+{   return getRep().getEstimatedForceCost(index); }
+
+const Array_<Real>& GeneralForceSubsystem::getEstimatedThreadLoads() const
+{   return getRep().getEstimatedThreadLoads(); }
+
+bool GeneralForceSubsystem::calcForceJacobian
+   (const State& state, ForceJacobian& jacobian) const
+{   return getRep().calcForceJacobian(state, jacobian); }
+
 const MultibodySystem& GeneralForceSubsystem::getMultibodySystem() const
 {   return MultibodySystem::downcast(getSystem()); }
 
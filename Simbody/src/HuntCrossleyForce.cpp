@@ -98,6 +98,20 @@ void HuntCrossleyForceImpl::setTransitionVelocity(Real v) {
     subsystem.invalidateSubsystemTopologyCache();
 }
 
+// Combine the static, dynamic, and viscous friction coefficients of the two
+// surfaces.
+static void calcFrictionCoefficients
+   (const HuntCrossleyForceImpl::Parameters& param1, 
+    const HuntCrossleyForceImpl::Parameters& param2,
+    Real& us, Real& ud, Real& uv) {
+    const bool hasStatic = (param1.staticFriction != 0 || param2.staticFriction != 0);
+    const bool hasDynamic= (param1.dynamicFriction != 0 || param2.dynamicFriction != 0);
+    const bool hasViscous = (param1.viscousFriction != 0 || param2.viscousFriction != 0);
+    us = hasStatic ? 2*param1.staticFriction*param2.staticFriction/(param1.staticFriction+param2.staticFriction) : 0;
+    ud = hasDynamic ? 2*param1.dynamicFriction*param2.dynamicFriction/(param1.dynamicFriction+param2.dynamicFriction) : 0;
+    uv = hasViscous ? 2*param1.viscousFriction*param2.viscousFriction/(param1.viscousFriction+param2.viscousFriction) : 0;
+}
+
 void HuntCrossleyForceImpl::calcForce(const State& state, Vector_<SpatialVec>& bodyForces, 
                                       Vector_<Vec3>& particleForces, Vector& mobilityForces) const {
     const Array_<Contact>& contacts = subsystem.getContacts(state, set);
@@ -142,7 +156,7 @@ void HuntCrossleyForceImpl::calcForce(const State& state, Vector_<SpatialVec>& b
         
         const Real f = fH*(1+Real(1.5)*c*vnormal);
         if (f <= 0) 
-            return;
+            continue;
 
         Vec3 force = f*normal;
         
@@ -150,12 +164,8 @@ void HuntCrossleyForceImpl::calcForce(const State& state, Vector_<SpatialVec>& b
         
         const Real vslip = vtangent.norm();
         if (vslip != 0) {
-            const bool hasStatic = (param1.staticFriction != 0 || param2.staticFriction != 0);
-            const bool hasDynamic= (param1.dynamicFriction != 0 || param2.dynamicFriction != 0);
-            const bool hasViscous = (param1.viscousFriction != 0 || param2.viscousFriction != 0);
-            const Real us = hasStatic ? 2*param1.staticFriction*param2.staticFriction/(param1.staticFriction+param2.staticFriction) : 0;
-            const Real ud = hasDynamic ? 2*param1.dynamicFriction*param2.dynamicFriction/(param1.dynamicFriction+param2.dynamicFriction) : 0;
-            const Real uv = hasViscous ? 2*param1.viscousFriction*param2.viscousFriction/(param1.viscousFriction+param2.viscousFriction) : 0;
+            Real us, ud, uv;
+            calcFrictionCoefficients(param1, param2, us, ud, uv);
             const Real vrel = vslip/getTransitionVelocity();
             const Real ffriction = f*(std::min(vrel, Real(1))*(ud+2*(us-ud)/(1+vrel*vrel))+uv*vslip);
             force += ffriction*vtangent/vslip;
@@ -168,6 +178,85 @@ void HuntCrossleyForceImpl::calcForce(const State& state, Vector_<SpatialVec>& b
     }
 }
 
+// The force on body 2 is F = f*(n + g*t) where n is the normal, t the 
+// direction of slip, f the Hunt-Crossley normal force, and g the friction 
+// coefficient as a function of the slip speed. This differentiates F with 
+// respect to the depth and the relative velocity v = v1-v2 and then projects
+// that through the contact point Jacobians; the motion of the contact point
+// and normal is neglected.
+bool HuntCrossleyForceImpl::calcForceJacobian(const State& state, ForceJacobian& jacobian) const {
+    const Array_<Contact>& contacts = subsystem.getContacts(state, set);
+    for (int i = 0; i < (int) contacts.size(); i++) {
+        if (!PointContact::isInstance(contacts[i]))
+            continue;
+        const PointContact& contact = static_cast<const PointContact&>(contacts[i]);
+        const Parameters& param1 = getParameters(contact.getSurface1());
+        const Parameters& param2 = getParameters(contact.getSurface2());
+
+        // Everything up to the friction force is the same as in calcForce().
+
+        const Real s1 = param2.stiffness/(param1.stiffness+param2.stiffness);
+        const Real s2 = 1-s1;
+        const Real depth = contact.getDepth();
+        const Vec3& normal = contact.getNormal();
+        const Vec3 location = contact.getLocation()+(depth*(Real(0.5)-s1))*normal;
+        const Real k = param1.stiffness*s1;
+        const Real c = param1.dissipation*s1 + param2.dissipation*s2;
+        const Real radius = contact.getEffectiveRadiusOfCurvature();
+        const Real fH = Real(4./3.)*k*depth*std::sqrt(radius*k*depth);
+        const MobilizedBody& body1 = subsystem.getBody(set, contact.getSurface1());
+        const MobilizedBody& body2 = subsystem.getBody(set, contact.getSurface2());
+        const Vec3 station1 = body1.findStationAtGroundPoint(state, location);
+        const Vec3 station2 = body2.findStationAtGroundPoint(state, location);
+        const Vec3 v1 = body1.findStationVelocityInGround(state, station1);
+        const Vec3 v2 = body2.findStationVelocityInGround(state, station2);
+        const Vec3 v = v1-v2;
+        const Real vnormal = dot(v, normal);
+        const Vec3 vtangent = v-vnormal*normal;
+        const Real f = fH*(1+Real(1.5)*c*vnormal);
+        if (f <= 0)
+            continue;
+
+        // f is proportional to depth^(3/2), and linear in vnormal.
+        const Real dfdDepth = Real(1.5)*f/depth;
+        const Vec3 dfdv = (Real(1.5)*c*fH)*normal;
+
+        // The friction coefficient g(vslip) and its derivative. With no slip
+        // the friction force is zero but its derivative is the isotropic
+        // limit g(vslip)/vslip as vslip -> 0.
+        Real us, ud, uv;
+        calcFrictionCoefficients(param1, param2, us, ud, uv);
+        const Real vt = getTransitionVelocity();
+        const Real vslip = vtangent.norm();
+        const Real vrel = vslip/vt;
+        const Real h = ud+2*(us-ud)/(1+vrel*vrel);
+        const Real dhdvrel = -4*(us-ud)*vrel/square(1+vrel*vrel);
+        const Mat33 P = Mat33(1) - outer(normal, normal); // tangent plane
+        Vec3  dir = normal; // direction of F
+        Mat33 dFdv = outer(normal, dfdv);
+        if (vslip != 0) {
+            const Vec3 t = vtangent/vslip;
+            const Real g = std::min(vrel, Real(1))*h + uv*vslip;
+            const Real dgdvslip = (vrel < 1 ? (h + vrel*dhdvrel) : dhdvrel)/vt
+                                  + uv;
+            const Mat33 tt = outer(t, t);
+            dir += g*t;
+            dFdv += outer(g*t, dfdv) + f*(dgdvslip*tt + (g/vslip)*(P - tt));
+        } else {
+            dFdv += f*(h/vt + uv)*P;
+        }
+
+        // Our force is a function of the relative position and velocity of
+        // body 1 with respect to body 2, and the depth increases with the
+        // normal component of that, so both derivatives change sign.
+        jacobian.addStationPairDerivatives(state, 
+            body1.getMobilizedBodyIndex(), station1,
+            body2.getMobilizedBodyIndex(), station2,
+            -dfdDepth*outer(dir, normal), -dFdv);
+    }
+    return true;
+}
+
 Real HuntCrossleyForceImpl::calcPotentialEnergy(const State& state) const {
     return Value<Real>::downcast(state.getCacheEntry(subsystem.getMySubsystemIndex(), energyCacheIndex)).get();
 }
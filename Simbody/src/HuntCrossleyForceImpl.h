@@ -48,6 +48,7 @@ public:
     ContactSetIndex getContactSetIndex() const {return set;}
     void calcForce(const State& state, Vector_<SpatialVec>& bodyForces, Vector_<Vec3>& particleForces, Vector& mobilityForces) const override;
     Real calcPotentialEnergy(const State& state) const override;
+    bool calcForceJacobian(const State& state, ForceJacobian& jacobian) const override;
     void realizeTopology(State& state) const override;
 private:
     const GeneralContactSubsystem&          subsystem;
@@ -28,10 +28,15 @@
 
 #include "simbody/internal/common.h"
 #include "simbody/internal/MultibodySystem.h"
+#include "simbody/internal/ForceJacobian.h"
 
 #include "MultibodySystemRep.h"
 #include "DecorationSubsystemRep.h"
 
+#include <algorithm>
+#include <exception>
+#include <mutex>
+
 namespace SimTK {
 
 
@@ -170,11 +175,70 @@ MultibodySystem::updMobilityForces(const State& s, Stage g) const {
     return getRep().updMobilityForces(s,g);
 }
 
+void MultibodySystem::realizeBatch(const Array_<State*>& states, Stage g,
+                                   int numThreads) const {
+    getRep().realizeBatch(states, g, numThreads);
+}
+
 
     //////////////////////////
     // MULTIBODY SYSTEM REP //
     //////////////////////////
 
+namespace {
+// Realize one State of a batch per execute() index. ParallelExecutor swallows
+// exceptions on worker threads, so we remember the first one for rethrowing.
+class RealizeBatchTask : public ParallelExecutor::Task {
+public:
+    RealizeBatchTask(const System& system, const Array_<State*>& states,
+                     Stage g) : system(system), states(states), g(g) {}
+
+    void execute(int i) override {
+        try {
+            system.realize(*states[i], g);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorLock);
+            if (!firstError) firstError = std::current_exception();
+        }
+    }
+
+    void rethrowFirstError() const {
+        if (firstError) std::rethrow_exception(firstError);
+    }
+private:
+    const System&           system;
+    const Array_<State*>&   states;
+    const Stage             g;
+    std::mutex              errorLock;
+    std::exception_ptr      firstError;
+};
+}
+
+void MultibodySystemRep::realizeBatch(const Array_<State*>& states, Stage g,
+                                      int numThreads) const {
+    SimTK_APIARGCHECK_ALWAYS(numThreads >= 0, "MultibodySystem",
+        "realizeBatch", "Number of threads must be nonnegative.");
+
+    const System& system = getSystem();
+    for (const State* s : states)
+        SimTK_APIARGCHECK_ALWAYS(s != nullptr, "MultibodySystem",
+            "realizeBatch", "A null State pointer was supplied.");
+
+    // By default use the shared executor so that batches draw on the same
+    // thread budget as everything else.
+    if (numThreads == 0)
+        batchExecutor.reset();
+    else if (batchExecutor.empty() 
+             || batchExecutor->getMaxThreads() != numThreads)
+        batchExecutor = new ParallelExecutor(numThreads);
+    ParallelExecutor& executor = batchExecutor.empty() 
+        ? ParallelExecutor::getSharedExecutor() : batchExecutor.updRef();
+
+    RealizeBatchTask task(system, states, g);
+    executor.execute(task, (int)states.size());
+    task.rethrowFirstError();
+}
+
 int MultibodySystemRep::realizeTopologyImpl(State& s) const {
     assert(globalSub.isValid());
     assert(matterSub.isValid());
@@ -300,6 +364,62 @@ int MultibodySystemRep::realizeReportImpl(const State& s) const {
     return 0;
 }
 
+// Assemble d(ydot)/dy for y={q,u} from the derivatives of the force laws:
+//      d(qdot)/du = N
+//      d(udot)/du = M^-1 * df/du
+//      d(udot)/dq = M^-1 * (df/dq*N) * pinv(N)
+// This neglects d(qdot)/dq and the dependence of M, the kinematic Jacobians
+// and the inertial forces on q and u. Those are small compared to the terms
+// from stiff force elements, which are why an integrator needs a Jacobian in
+// the first place. We can't differentiate constraint forces or the
+// derivatives of auxiliary state variables, so we decline if there are any,
+// or if any force subsystem can't supply its derivatives.
+bool MultibodySystemRep::calcYDotJacobianImpl(const State& s, 
+                                              Matrix& dYdotdY) const {
+    const SimbodyMatterSubsystem& matter = getMatterSubsystem();
+    const int nq = s.getNQ(), nu = s.getNU();
+    if (s.getNZ() || s.getNMultipliers() 
+        || matter.getNQ(s) != nq || matter.getNU(s) != nu)
+        return false;
+
+    ForceJacobian forceJacobian;
+    forceJacobian.initialize(matter, s);
+    for (int i=0; i < (int)forceSubs.size(); ++i)
+        if (!getForceSubsystem(forceSubs[i]).getRep()
+                .addInForceJacobian(s, forceJacobian))
+            return false;
+
+    Matrix& J = dYdotdY;
+    J.resize(nq+nu, nq+nu);
+    J = 0;
+
+    // d(qdot)/du, a column at a time.
+    Vector unitU(nu, Real(0)), colQ(nq);
+    for (int j=0; j < nu; ++j) {
+        unitU[j] = 1;
+        multiplyByNImpl(s, unitU, colQ);
+        for (int i=0; i < nq; ++i) J(i, nq+j) = colQ[i];
+        unitU[j] = 0;
+    }
+
+    Matrix dfdX, MinvdfdX; // nu X nu
+    forceJacobian.getVelocityDerivatives(dfdX);
+    matter.multiplyByMInvColumns(s, dfdX, MinvdfdX);
+    for (int j=0; j < nu; ++j)
+        for (int i=0; i < nu; ++i) J(nq+i, nq+j) = MinvdfdX(i,j);
+
+    // d(udot)/dq, a row at a time: row i is ~(~pinv(N) * ~row_i).
+    forceJacobian.getPositionDerivatives(dfdX);
+    matter.multiplyByMInvColumns(s, dfdX, MinvdfdX);
+    Vector rowU(nu), rowQ(nq);
+    for (int i=0; i < nu; ++i) {
+        for (int j=0; j < nu; ++j) rowU[j] = MinvdfdX(i,j);
+        multiplyByNPInvTransposeImpl(s, rowU, rowQ);
+        for (int k=0; k < nq; ++k) J(nq+i, k) = rowQ[k];
+    }
+    return true;
+}
+
 
     ///////////////////////////////////////
     // MULTIBODY SYSTEM GLOBAL SUBSYSTEM //
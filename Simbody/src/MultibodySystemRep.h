@@ -444,6 +444,9 @@ public:
         mech.getRep().multiplyByNInv(s,true,fu,fq);
     }  
 
+    bool calcYDotJacobianImpl(const State& s, 
+                              Matrix& dYdotdY) const override;
+
     // Currently prescribe() and project() affect only the Matter subsystem.
     bool prescribeQImpl(State& state) const override {
         const SimbodyMatterSubsystem& mech = getMatterSubsystem();
@@ -497,6 +500,9 @@ public:
         (const State&, Real& tNextEvent, Array<EventId>& eventIds) const;
     */
 
+    void realizeBatch(const Array_<State*>& states, Stage g, 
+                      int numThreads) const;
+
     SimTK_DOWNCAST(MultibodySystemRep, System::Guts);
 private:
     SubsystemIndex         globalSub;       // index of global subsystem
@@ -504,6 +510,10 @@ private:
     Array_<SubsystemIndex> forceSubs;       // indices of force subsystems
     SubsystemIndex         decorationSub;   // index of DecorationSubsystem if any, else -1
     SubsystemIndex         contactSub;      // index of contact subsystem if any, else -1
+
+    // Used by realizeBatch(); allocated on first use and replaced if a 
+    // different number of threads is requested.
+    mutable ClonePtr<ParallelExecutor> batchExecutor;
 };
 
 
@@ -144,6 +144,26 @@ Real doUpdates(const Array_<int>& rows, // These are MultiplierIndex ints
     return er2;
 }
 
+// Update a friction pair together, using the already-factored 2x2 diagonal
+// block of [A+D] for those rows, and return the sum of the squared errors.
+// This is a block Gauss-Seidel step, so the two tangential directions see
+// each other's coupling exactly rather than through the next iteration.
+Real doBlockUpdate(const Array_<MultiplierIndex>& rows,
+                   const SymMatBatch<2>&          blocks,
+                   int                            k, // which block
+                   const Vector&                  rhs,
+                   const Real&                    SOR,
+                   const Array_<Real>&            rowSums,
+                   Vector&                        pi)
+{
+    Vec2 er(rhs[rows[0]]-rowSums[0], rhs[rows[1]]-rowSums[1]);
+    const Real er2 = er.normSqr();
+    blocks.solveInPlace(k, er);
+    pi[rows[0]] += SOR * er[0];
+    pi[rows[1]] += SOR * er[1];
+    return er2;
+}
+
 // Multiply the active entries of a row of the full matrix A (mXm) by a sparse,
 // full-length (m) column containing only the indicated non-zero entries. 
 // Useful for A[r]*piExpand.
@@ -388,6 +408,22 @@ solve(int                                 phase,
         return true;
     }
 
+    // The diagonal blocks of [A+D] for the friction pairs don't change during
+    // the iterations, so factor them all together now. A contact without a
+    // friction pair gets an identity block that is never used.
+    m_frictionBlocks.resize(mUniCont);
+    for (int k=0; k < mUniCont; ++k) {
+        const UniContactRT& rt = uniContact[k];
+        SymMat22 block(1, 0, 1);
+        if (rt.m_type != Observing && rt.m_Fk.size() == 2) {
+            const MultiplierIndex f0 = rt.m_Fk[0], f1 = rt.m_Fk[1];
+            block(0,0) = A(f0,f0); block(1,0) = A(f1,f0); block(1,1) = A(f1,f1);
+            if (D.size()) {block(0,0) += D[f0]; block(1,1) += D[f1];}
+        }
+        m_frictionBlocks.setMat(k, block);
+    }
+    m_frictionBlocks.factorCholeskyInPlace();
+
     // Track total error for all included equations, and the error for just
     // those equations that are being enforced.
     bool converged = false;
@@ -431,7 +467,10 @@ solve(int                                 phase,
             const MultiplierIndex Nk = rt.m_Nk;
             const Array_<MultiplierIndex>& Fk = rt.m_Fk;
             doRowSums(participating,Fk,A,D,pi,rowSums);
-            const Real er2=doUpdates(Fk,A,D,verrStart,sor,rowSums,pi);
+            const Real er2 =
+                Fk.size() == 2 && !m_frictionBlocks.isFactorFailed(k)
+                ? doBlockUpdate(Fk,m_frictionBlocks,k,verrStart,sor,rowSums,pi)
+                : doUpdates(Fk,A,D,verrStart,sor,rowSums,pi);
             sum2all += er2;
             Real N = std::abs(pi[Nk] + piExpand[Nk]);
             rt.m_frictionCond=boundVector(rt.m_effMu*N, Fk, pi);
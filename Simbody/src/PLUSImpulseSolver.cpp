@@ -311,8 +311,8 @@ solve(int                                 phase,
             while (errNorm > m_convergenceTol) {
                 ++newtIter;
                 // Solve for deltaPi.
-                FactorQTZ fac(m_JacActive);
-                fac.solve(m_errActive, dpi);
+                m_JacActiveFactor.factor(m_JacActive);
+                m_JacActiveFactor.solve(m_errActive, dpi);
                 const Real deltaNorm = dpi.norm();
 
                 #ifndef NDEBUG
@@ -763,8 +763,8 @@ solveBilateral
 
     // Calculate the pseudoinverse of P*A*~P, and then solve to get
     //     piActive = pinv(P*A*~P) * rhsActive
-    FactorQTZ pinv(m_bilateralActive);
-    pinv.solve(m_rhsActive, m_piActive);
+    m_bilateralFactor.factor(m_bilateralActive);
+    m_bilateralFactor.solve(m_rhsActive, m_piActive);
     // Distribute the active result into the full impulse vector.
     for (ActiveIndex ai(0); ai < p; ++ai) {
         const MultiplierIndex mi = participating[ai];
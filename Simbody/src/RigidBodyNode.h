@@ -557,6 +557,91 @@ virtual void multiplyByMInvPass2Outward(
     SpatialVec*                             allA_GB,
     Real*                                   allUDot) const=0;
 
+// Batched forms of the sweep methods above. Each one is invoked on the first
+// of nNodes nodes at the same level that all have the same concrete type as
+// this one, and does the same thing as calling the unbatched method on each
+// of them. These defaults just make that virtual call; RigidBodyNodeSpec
+// overrides them with a loop that calls its own implementation directly so
+// that the whole per-node computation can be inlined for the run.
+virtual void realizeArticulatedBodyInertiasInwardRun(
+    const RigidBodyNode* const*     nodes,
+    int                             nNodes,
+    const SBInstanceCache&          ic,
+    const SBTreePositionCache&      pc,
+    SBArticulatedBodyInertiaCache&  abc) const
+{   for (int i=0; i < nNodes; ++i)
+        nodes[i]->realizeArticulatedBodyInertiasInward(ic,pc,abc); }
+
+virtual void realizeYOutwardRun(
+    const RigidBodyNode* const*           nodes,
+    int                                   nNodes,
+    const SBInstanceCache&                ic,
+    const SBTreePositionCache&            pc,
+    const SBArticulatedBodyInertiaCache&  abc,
+    SBDynamicsCache&                      dc) const
+{   for (int i=0; i < nNodes; ++i)
+        nodes[i]->realizeYOutward(ic,pc,abc,dc); }
+
+virtual void calcUDotPass1InwardRun(
+    const RigidBodyNode* const*             nodes,
+    int                                     nNodes,
+    const SBInstanceCache&                  ic,
+    const SBTreePositionCache&              pc,
+    const SBArticulatedBodyInertiaCache&    abc,
+    const SBArticulatedBodyVelocityCache&   abvc,
+    const Real*                             jointForces,
+    const SpatialVec*                       bodyForces,
+    const Real*                             allUDot,
+    SpatialVec*                             allZ,
+    SpatialVec*                             allGepsilon,
+    Real*                                   allEpsilon) const
+{   for (int i=0; i < nNodes; ++i)
+        nodes[i]->calcUDotPass1Inward(ic,pc,abc,abvc,jointForces,bodyForces,
+                                      allUDot,allZ,allGepsilon,allEpsilon); }
+
+virtual void calcUDotPass2OutwardRun(
+    const RigidBodyNode* const*             nodes,
+    int                                     nNodes,
+    const SBInstanceCache&                  ic,
+    const SBTreePositionCache&              pc,
+    const SBArticulatedBodyInertiaCache&    abc,
+    const SBTreeVelocityCache&              vc,
+    const SBDynamicsCache&                  dc,
+    const Real*                             epsilonTmp,
+    SpatialVec*                             allA_GB,
+    Real*                                   allUDot,
+    Real*                                   allTau) const
+{   for (int i=0; i < nNodes; ++i)
+        nodes[i]->calcUDotPass2Outward(ic,pc,abc,vc,dc,epsilonTmp,
+                                       allA_GB,allUDot,allTau); }
+
+virtual void multiplyByMInvPass1InwardRun(
+    const RigidBodyNode* const*             nodes,
+    int                                     nNodes,
+    const SBInstanceCache&                  ic,
+    const SBTreePositionCache&              pc,
+    const SBArticulatedBodyInertiaCache&    abc,
+    const Real*                             f,
+    SpatialVec*                             allZ,
+    SpatialVec*                             allGepsilon,
+    Real*                                   allEpsilon) const
+{   for (int i=0; i < nNodes; ++i)
+        nodes[i]->multiplyByMInvPass1Inward(ic,pc,abc,f,
+                                            allZ,allGepsilon,allEpsilon); }
+
+virtual void multiplyByMInvPass2OutwardRun(
+    const RigidBodyNode* const*             nodes,
+    int                                     nNodes,
+    const SBInstanceCache&                  ic,
+    const SBTreePositionCache&              pc,
+    const SBArticulatedBodyInertiaCache&    abc,
+    const Real*                             epsilonTmp,
+    SpatialVec*                             allA_GB,
+    Real*                                   allUDot) const
+{   for (int i=0; i < nNodes; ++i)
+        nodes[i]->multiplyByMInvPass2Outward(ic,pc,abc,epsilonTmp,
+                                             allA_GB,allUDot); }
+
 // Also serves as pass 1 for inverse dynamics.
 virtual void calcBodyAccelerationsFromUdotOutward(
     const SBTreePositionCache&  pc,
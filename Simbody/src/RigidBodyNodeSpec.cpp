@@ -274,10 +274,10 @@ realizeArticulatedBodyInertiasInward(
         const PhiMatrix&          phiChild   = children[i]->getPhi(pc);
         const ArticulatedInertia& PPlusChild = children[i]->getPPlus(abc);
 
-        // Apply the articulated body shift.
+        // Apply the articulated body shift, accumulating directly into P.
         // This takes 93 flops (72 for the shift and 21 to add it in).
         // (Note that PPlusChild==PChild if child's mobilizer is prescribed.)
-        P += PPlusChild.shift(phiChild.l());
+        P.addShifted(PPlusChild, phiChild.l());
     }
 
     // Now compute PPlus. P+ = P for a prescribed mobilizer. Otherwise
@@ -846,6 +846,125 @@ RigidBodyNodeSpec<dof, noR_FM, noX_MB, noR_PF>::calcEquivalentJointForces(
     eps  = ~getH(pc) * z;
 }
 
+//==============================================================================
+//                               BATCHED SWEEPS
+//==============================================================================
+// Each of these is called on the first of a run of nodes that all have the
+// same concrete type as this one, so the static_casts are safe. The qualified
+// calls are not virtual, and since their definitions are above the compiler
+// can inline the per-node computation into the loop. No derived node class
+// overrides these sweep methods; if one ever did it would have to override
+// the Run method too.
+
+template<int dof, bool noR_FM, bool noX_MB, bool noR_PF> void
+RigidBodyNodeSpec<dof, noR_FM, noX_MB, noR_PF>::
+realizeArticulatedBodyInertiasInwardRun(
+    const RigidBodyNode* const*     nodes,
+    int                             nNodes,
+    const SBInstanceCache&          ic,
+    const SBTreePositionCache&      pc,
+    SBArticulatedBodyInertiaCache&  abc) const
+{
+    for (int i=0; i < nNodes; ++i)
+        static_cast<const RigidBodyNodeSpec*>(nodes[i])->
+            RigidBodyNodeSpec::realizeArticulatedBodyInertiasInward(ic,pc,abc);
+}
+
+template<int dof, bool noR_FM, bool noX_MB, bool noR_PF> void
+RigidBodyNodeSpec<dof, noR_FM, noX_MB, noR_PF>::
+realizeYOutwardRun(
+    const RigidBodyNode* const*             nodes,
+    int                                     nNodes,
+    const SBInstanceCache&                  ic,
+    const SBTreePositionCache&              pc,
+    const SBArticulatedBodyInertiaCache&    abc,
+    SBDynamicsCache&                        dc) const
+{
+    for (int i=0; i < nNodes; ++i)
+        static_cast<const RigidBodyNodeSpec*>(nodes[i])->
+            RigidBodyNodeSpec::realizeYOutward(ic,pc,abc,dc);
+}
+
+template<int dof, bool noR_FM, bool noX_MB, bool noR_PF> void
+RigidBodyNodeSpec<dof, noR_FM, noX_MB, noR_PF>::
+calcUDotPass1InwardRun(
+    const RigidBodyNode* const*             nodes,
+    int                                     nNodes,
+    const SBInstanceCache&                  ic,
+    const SBTreePositionCache&              pc,
+    const SBArticulatedBodyInertiaCache&    abc,
+    const SBArticulatedBodyVelocityCache&   abvc,
+    const Real*                             jointForces,
+    const SpatialVec*                       bodyForces,
+    const Real*                             allUDot,
+    SpatialVec*                             allZ,
+    SpatialVec*                             allGepsilon,
+    Real*                                   allEpsilon) const
+{
+    for (int i=0; i < nNodes; ++i)
+        static_cast<const RigidBodyNodeSpec*>(nodes[i])->
+            RigidBodyNodeSpec::calcUDotPass1Inward(ic,pc,abc,abvc,
+                jointForces,bodyForces,allUDot,allZ,allGepsilon,allEpsilon);
+}
+
+template<int dof, bool noR_FM, bool noX_MB, bool noR_PF> void
+RigidBodyNodeSpec<dof, noR_FM, noX_MB, noR_PF>::
+calcUDotPass2OutwardRun(
+    const RigidBodyNode* const*             nodes,
+    int                                     nNodes,
+    const SBInstanceCache&                  ic,
+    const SBTreePositionCache&              pc,
+    const SBArticulatedBodyInertiaCache&    abc,
+    const SBTreeVelocityCache&              vc,
+    const SBDynamicsCache&                  dc,
+    const Real*                             epsilonTmp,
+    SpatialVec*                             allA_GB,
+    Real*                                   allUDot,
+    Real*                                   allTau) const
+{
+    for (int i=0; i < nNodes; ++i)
+        static_cast<const RigidBodyNodeSpec*>(nodes[i])->
+            RigidBodyNodeSpec::calcUDotPass2Outward(ic,pc,abc,vc,dc,
+                epsilonTmp,allA_GB,allUDot,allTau);
+}
+
+template<int dof, bool noR_FM, bool noX_MB, bool noR_PF> void
+RigidBodyNodeSpec<dof, noR_FM, noX_MB, noR_PF>::
+multiplyByMInvPass1InwardRun(
+    const RigidBodyNode* const*             nodes,
+    int                                     nNodes,
+    const SBInstanceCache&                  ic,
+    const SBTreePositionCache&              pc,
+    const SBArticulatedBodyInertiaCache&    abc,
+    const Real*                             f,
+    SpatialVec*                             allZ,
+    SpatialVec*                             allGepsilon,
+    Real*                                   allEpsilon) const
+{
+    for (int i=0; i < nNodes; ++i)
+        static_cast<const RigidBodyNodeSpec*>(nodes[i])->
+            RigidBodyNodeSpec::multiplyByMInvPass1Inward(ic,pc,abc,
+                f,allZ,allGepsilon,allEpsilon);
+}
+
+template<int dof, bool noR_FM, bool noX_MB, bool noR_PF> void
+RigidBodyNodeSpec<dof, noR_FM, noX_MB, noR_PF>::
+multiplyByMInvPass2OutwardRun(
+    const RigidBodyNode* const*             nodes,
+    int                                     nNodes,
+    const SBInstanceCache&                  ic,
+    const SBTreePositionCache&              pc,
+    const SBArticulatedBodyInertiaCache&    abc,
+    const Real*                             epsilonTmp,
+    SpatialVec*                             allA_GB,
+    Real*                                   allUDot) const
+{
+    for (int i=0; i < nNodes; ++i)
+        static_cast<const RigidBodyNodeSpec*>(nodes[i])->
+            RigidBodyNodeSpec::multiplyByMInvPass2Outward(ic,pc,abc,
+                epsilonTmp,allA_GB,allUDot);
+}
+
 
     ////////////////////
     // INSTANTIATIONS //
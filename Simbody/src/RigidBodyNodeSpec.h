@@ -419,6 +419,72 @@ void multiplyByMInvPass2Outward(
     SpatialVec*                 allA_GB,
     Real*                       allUDot) const override;
 
+// Batched sweeps over a run of nodes of this same type. These call the
+// methods above non-virtually so the compiler can inline them; see
+// RigidBodyNode for the contract.
+void realizeArticulatedBodyInertiasInwardRun(
+    const RigidBodyNode* const* nodes,
+    int                         nNodes,
+    const SBInstanceCache&      ic,
+    const SBTreePositionCache&  pc,
+    SBArticulatedBodyInertiaCache& abc) const override;
+
+void realizeYOutwardRun(
+    const RigidBodyNode* const*             nodes,
+    int                                     nNodes,
+    const SBInstanceCache&                  ic,
+    const SBTreePositionCache&              pc,
+    const SBArticulatedBodyInertiaCache&    abc,
+    SBDynamicsCache&                        dc) const override;
+
+void calcUDotPass1InwardRun(
+    const RigidBodyNode* const* nodes,
+    int                         nNodes,
+    const SBInstanceCache&      ic,
+    const SBTreePositionCache&  pc,
+    const SBArticulatedBodyInertiaCache&,
+    const SBArticulatedBodyVelocityCache&,
+    const Real*                 jointForces,
+    const SpatialVec*           bodyForces,
+    const Real*                 allUDot,
+    SpatialVec*                 allZ,
+    SpatialVec*                 allGepsilon,
+    Real*                       allEpsilon) const override;
+
+void calcUDotPass2OutwardRun(
+    const RigidBodyNode* const* nodes,
+    int                         nNodes,
+    const SBInstanceCache&      ic,
+    const SBTreePositionCache&  pc,
+    const SBArticulatedBodyInertiaCache&,
+    const SBTreeVelocityCache&  vc,
+    const SBDynamicsCache&      dc,
+    const Real*                 epsilonTmp,
+    SpatialVec*                 allA_GB,
+    Real*                       allUDot,
+    Real*                       allTau) const override;
+
+void multiplyByMInvPass1InwardRun(
+    const RigidBodyNode* const* nodes,
+    int                         nNodes,
+    const SBInstanceCache&      ic,
+    const SBTreePositionCache&  pc,
+    const SBArticulatedBodyInertiaCache&,
+    const Real*                 f,
+    SpatialVec*                 allZ,
+    SpatialVec*                 allGepsilon,
+    Real*                       allEpsilon) const override;
+
+void multiplyByMInvPass2OutwardRun(
+    const RigidBodyNode* const* nodes,
+    int                         nNodes,
+    const SBInstanceCache&      ic,
+    const SBTreePositionCache&  pc,
+    const SBArticulatedBodyInertiaCache&,
+    const Real*                 epsilonTmp,
+    SpatialVec*                 allA_GB,
+    Real*                       allUDot) const override;
+
 // Also serves as pass 1 for inverse dynamics.
 void calcBodyAccelerationsFromUdotOutward(
     const SBTreePositionCache&  pc,
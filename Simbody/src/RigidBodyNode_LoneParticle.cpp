@@ -170,6 +170,15 @@ void realizePosition(const SBStateDigest& sbs) const override {
     updPhi(pc) = PhiMatrix(q);
     updCOM_G(pc) = q + getCOM_B(); // 3 flops
     updMk_G(pc) = SpatialInertia(getMass(), getCOM_B(), getUnitInertia_OB_B());
+
+    // H and H_FM are constant, but they are kept in the cache so that
+    // getHCol() and getH_FMCol() can return references to them.
+    Mat<2,3,Vec3>& H = Mat<2,3,Vec3>::updAs(&pc.storageForH[2*uIndex]);
+    Mat<2,3,Vec3>& H_FM = Mat<2,3,Vec3>::updAs(&pc.storageForH_FM[2*uIndex]);
+    H.setToZero();
+    for (int j=0; j < 3; ++j)
+        H(j)[1][j] = 1;
+    H_FM = H;
 }
 
 void realizeVelocity(const SBStateDigest& sbs) const override {
@@ -407,20 +416,12 @@ void multiplyByMPass2Inward(
 
 const SpatialVec& getHCol(const SBTreePositionCache& pc, 
                           int j) const override {
-    Mat<2,3,Vec3> H = Mat<2,3,Vec3>::getAs(&pc.storageForH[2*uIndex]);
-    SpatialVec& col = H(j);
-    col = SpatialVec(Vec3(0), Vec3(0));
-    col[1][j] = 1;
-    return col;
+    return Mat<2,3,Vec3>::getAs(&pc.storageForH[2*uIndex])(j);
 }
 
 const SpatialVec& getH_FMCol(const SBTreePositionCache& pc, 
                              int j) const override {
-    Mat<2,3,Vec3> H = Mat<2,3,Vec3>::getAs(&pc.storageForH_FM[2*uIndex]);
-    SpatialVec& col = H(j);
-    col = SpatialVec(Vec3(0), Vec3(0));
-    col[1][j] = 1;
-    return col;
+    return Mat<2,3,Vec3>::getAs(&pc.storageForH_FM[2*uIndex])(j);
 }
 
 void setQToFitTransformImpl(const SBStateDigest&, const Transform& X_F0M0, 
@@ -107,6 +107,23 @@ void SimbodyMatterSubsystem::setShowDefaultGeometry(bool show) {
     updRep().setShowDefaultGeometry(show);
 }
 
+void SimbodyMatterSubsystem::setNumberOfThreads(unsigned numThreads) {
+    updRep().setNumberOfThreads(numThreads);
+}
+
+int SimbodyMatterSubsystem::getNumberOfThreads() const {
+    return getRep().getNumberOfThreads();
+}
+
+void SimbodyMatterSubsystem::
+setUseIncrementalPositionKinematics(bool useIncremental) {
+    updRep().setUseIncrementalPositionKinematics(useIncremental);
+}
+
+bool SimbodyMatterSubsystem::getUseIncrementalPositionKinematics() const {
+    return getRep().getUseIncrementalPositionKinematics();
+}
+
 
 ConstraintIndex SimbodyMatterSubsystem::
 adoptConstraint(Constraint& child) {return updRep().adoptConstraint(child);}
@@ -303,6 +320,75 @@ void SimbodyMatterSubsystem::calcResidualForceIgnoringConstraints
         residualMobilityForces = *cresid;
 }
 
+// Multiple right hand side version; see above. The applied forces are shared
+// by every column of knownUdot.
+void SimbodyMatterSubsystem::calcResidualForceColumnsIgnoringConstraints
+   (const State&               state,
+    const Vector&              appliedMobilityForces,
+    const Vector_<SpatialVec>& appliedBodyForcesInG,
+    const Matrix&              knownUdot,
+    Matrix&                    residualMobilityForces) const
+{
+    const SimbodyMatterSubsystemRep& rep = getRep();
+    const int nb = rep.getNumBodies();
+    const int nu = rep.getNU(state);
+
+    SimTK_APIARGCHECK2_ALWAYS(
+        appliedMobilityForces.size()==0 || appliedMobilityForces.size()==nu,
+        "SimbodyMatterSubsystem", "calcResidualForceColumnsIgnoringConstraints",
+        "Got %d appliedMobilityForces but there are %d mobilities.",
+        appliedMobilityForces.size(), nu);
+    SimTK_APIARGCHECK2_ALWAYS(
+        appliedBodyForcesInG.size()==0 || appliedBodyForcesInG.size()==nb,
+        "SimbodyMatterSubsystem", "calcResidualForceColumnsIgnoringConstraints",
+        "Got %d appliedBodyForces but there are %d bodies (including Ground).",
+        appliedBodyForcesInG.size(), nb);
+    SimTK_APIARGCHECK2_ALWAYS(knownUdot.nrow()==nu,
+        "SimbodyMatterSubsystem", "calcResidualForceColumnsIgnoringConstraints",
+        "Got %d rows of knownUdot but there are %d mobilities.",
+        knownUdot.nrow(), nu);
+
+    const int ncol = knownUdot.ncol();
+    residualMobilityForces.resize(nu, ncol);
+    if (ncol == 0) return;
+
+    const Vector*               cmobForces  = &appliedMobilityForces;
+    const Vector_<SpatialVec>*  cbodyForces = &appliedBodyForcesInG;
+    const Matrix*               cudot       = &knownUdot;
+    Matrix*                     cresid      = &residualMobilityForces;
+    bool needToCopyBack = false;
+
+    Vector contig_mobForces;
+    Vector_<SpatialVec> contig_bodyForces;
+    Matrix contig_udot, contig_resid;
+
+    if (!appliedMobilityForces.hasContiguousData()) {
+        contig_mobForces.resize(nu); // contiguous memory
+        contig_mobForces(0, nu) = appliedMobilityForces; // copy, no reallocation
+        cmobForces = (const Vector*)&contig_mobForces;
+    }
+    if (!appliedBodyForcesInG.hasContiguousData()) {
+        contig_bodyForces.resize(nb); // contiguous memory
+        contig_bodyForces(0, nb) = appliedBodyForcesInG; // copy, no reallocation
+        cbodyForces = (const Vector_<SpatialVec>*)&contig_bodyForces;
+    }
+    if (nu && !knownUdot(0).hasContiguousData()) {
+        contig_udot = knownUdot; // copy into column-major storage
+        cudot = (const Matrix*)&contig_udot;
+    }
+    if (nu && !residualMobilityForces(0).hasContiguousData()) {
+        contig_resid.resize(nu, ncol);
+        cresid = (Matrix*)&contig_resid;
+        needToCopyBack = true;
+    }
+
+    rep.calcTreeResidualForces(state,
+        *cmobForces, *cbodyForces, *cudot, *cresid);
+
+    if (needToCopyBack)
+        residualMobilityForces = *cresid;
+}
+
 
 
 //==============================================================================
@@ -421,6 +507,48 @@ void SimbodyMatterSubsystem::multiplyByM(const State&  state,
         Ma = *cMa;
 }
 
+// Multiple right hand side version. The implementation needs only the 
+// individual columns to be contiguous.
+void SimbodyMatterSubsystem::multiplyByMColumns(const State&  state, 
+                                                const Matrix& A, 
+                                                Matrix&       MA) const
+{
+    const SimbodyMatterSubsystemRep& rep = getRep();
+    const int nu = rep.getNU(state);
+
+    SimTK_ERRCHK2_ALWAYS(A.nrow() == nu,
+        "SimbodyMatterSubsystem::multiplyByMColumns()",
+        "Argument 'A' had %d rows but should have one row for each"
+        " of the %d mobilities (generalized speeds u).", 
+        A.nrow(), nu);
+
+    const int ncol = A.ncol();
+    MA.resize(nu, ncol);
+    if (nu==0 || ncol==0) return;
+
+    const Matrix* cA  = &A;
+    Matrix*       cMA = &MA;
+    bool needToCopyBack = false;
+
+    Matrix contig_A, contig_MA;
+
+    if (!A(0).hasContiguousData()) {
+        contig_A = A; // copy into column-major storage
+        cA = (const Matrix*)&contig_A;
+    }
+
+    if (!MA(0).hasContiguousData()) {
+        contig_MA.resize(nu, ncol);
+        cMA = (Matrix*)&contig_MA;
+        needToCopyBack = true;
+    }
+
+    rep.multiplyByM(state, *cA, *cMA);
+
+    if (needToCopyBack)
+        MA = *cMA;
+}
+
 
 
 //==============================================================================
@@ -470,6 +598,50 @@ void SimbodyMatterSubsystem::multiplyByMInv(const State&    state,
         MInvV = *cMInvV;
 }
 
+// Multiple right hand side version. The implementation needs only the 
+// individual columns to be contiguous.
+void SimbodyMatterSubsystem::multiplyByMInvColumns(const State&    state,
+                                                   const Matrix&   V,
+                                                   Matrix&         MInvV) const
+{
+    const SimbodyMatterSubsystemRep& rep = getRep();
+    const int nu = rep.getNU(state);
+
+    SimTK_ERRCHK2_ALWAYS(V.nrow() == nu,
+        "SimbodyMatterSubsystem::multiplyByMInvColumns()",
+        "Argument 'V' had %d rows but should have one row for each"
+        " of the %d mobilities (generalized speeds u).", 
+        V.nrow(), nu);
+
+    const int ncol = V.ncol();
+    MInvV.resize(nu, ncol);
+    if (nu==0 || ncol==0) return;
+
+    const Matrix* cV     = &V;
+    Matrix*       cMInvV = &MInvV;
+    bool needToCopyBack = false;
+
+    Matrix contig_V, contig_MInvV;
+
+    if (!V(0).hasContiguousData()) {
+        contig_V = V; // copy into column-major storage
+        cV = (const Matrix*)&contig_V;
+    }
+
+    if (!MInvV(0).hasContiguousData()) {
+        contig_MInvV.resize(nu, ncol);
+        cMInvV = (Matrix*)&contig_MInvV;
+        needToCopyBack = true;
+    }
+
+    // Prescribed entries are not written by the implementation.
+    cMInvV->setToZero();
+    rep.multiplyByMInv(state, *cV, *cMInvV);
+
+    if (needToCopyBack)
+        MInvV = *cMInvV;
+}
+
 
 
 void SimbodyMatterSubsystem::calcM(const State& s, Matrix& M) const 
@@ -478,6 +650,13 @@ void SimbodyMatterSubsystem::calcM(const State& s, Matrix& M) const
 void SimbodyMatterSubsystem::calcMInv(const State& s, Matrix& MInv) const 
 {   getRep().calcMInv(s, MInv); }
 
+void SimbodyMatterSubsystem::calcMFactorSparse(const State& s) const 
+{   getRep().calcMFactorSparse(s); }
+
+void SimbodyMatterSubsystem::solveM(const State& s, const Vector& f, 
+                                    Vector& udot) const 
+{   getRep().solveM(s, f, udot); }
+
 
 // Note: the implementation methods that generate matrices do *not* require 
 // contiguous storage, so we can just forward to them with no preliminaries.
@@ -1469,6 +1648,109 @@ void SimbodyMatterSubsystem::calcStationJacobian
 }
 
 
+//------------------------------------------------------------------------------
+//                         CALC SPARSE SYSTEM JACOBIAN
+//------------------------------------------------------------------------------
+// Row B of J_G is nonzero only in the columns belonging to the mobilizers on
+// the path from Ground to B. For each such mobilizer A, column j of A's hinge
+// matrix H_A (the velocity of A's body frame origin due to u_j) is shifted 
+// from Ao to Bo: [w, v + w X p_AB_G]. Ancestors have lower indices than their
+// descendents, and their u's come first, so columns come out in order.
+// Cost is 12 flops per stored element.
+void SimbodyMatterSubsystem::calcSparseSystemJacobian
+   (const State&            state,
+    Array_<int>&            rowStart,
+    Array_<int>&            colIndex,
+    Array_<SpatialVec>&     J_G) const
+{
+    const SimbodyMatterSubsystemRep& rep = getRep();
+    const int nb = rep.getNumBodies();
+    const SBTreePositionCache& tpc = rep.getTreePositionCache(state);
+
+    rowStart.resize(nb+1);
+    colIndex.clear(); J_G.clear();
+
+    Array_<const RigidBodyNode*> path; // ancestors of B, then B
+    for (MobilizedBodyIndex mbx(0); mbx < nb; ++mbx) {
+        rowStart[mbx] = (int)colIndex.size();
+        const RigidBodyNode& body = rep.getRigidBodyNode(mbx);
+        const Vec3& p_GB = body.getX_GB(tpc).p();
+
+        path.clear();
+        for (const RigidBodyNode* n = &body; n->getParent(); n = n->getParent())
+            path.push_back(n);
+
+        for (int i = (int)path.size()-1; i >= 0; --i) {
+            const RigidBodyNode& anc = *path[i];
+            const Vec3 p_AB_G = p_GB - anc.getX_GB(tpc).p();
+            for (int j=0; j < anc.getDOF(); ++j) {
+                const SpatialVec& H = anc.getHCol(tpc, j);
+                colIndex.push_back(anc.getUIndex() + j);
+                J_G.push_back(SpatialVec(H[0], H[1] + H[0] % p_AB_G));
+            }
+        }
+    }
+    rowStart[nb] = (int)colIndex.size();
+}
+
+
+//------------------------------------------------------------------------------
+//                        CALC SPARSE STATION JACOBIAN
+//------------------------------------------------------------------------------
+// Same as above, but each row is the linear velocity of a task station S
+// rather than the spatial velocity of a body frame. Cost is 18*nt flops plus
+// 12 flops per stored element.
+void SimbodyMatterSubsystem::calcSparseStationJacobian
+   (const State&                        state,
+    const Array_<MobilizedBodyIndex>&   onBodyB,
+    const Array_<Vec3>&                 p_BS,
+    Array_<int>&                        rowStart,
+    Array_<int>&                        colIndex,
+    Array_<Vec3>&                       JS) const
+{
+    const SimbodyMatterSubsystemRep& rep = getRep();
+    const int nb = rep.getNumBodies();
+    const int nt = (int)onBodyB.size(); // number of tasks
+
+    SimTK_ERRCHK2_ALWAYS((int)p_BS.size() == nt,
+        "SimbodyMatterSubsystem::calcSparseStationJacobian()",
+        "The given number of task bodies (%d) and station tasks (%d) must "
+        "be the same.", nt, (int)p_BS.size());
+
+    const SBTreePositionCache& tpc = rep.getTreePositionCache(state);
+
+    rowStart.resize(nt+1);
+    colIndex.clear(); JS.clear();
+
+    Array_<const RigidBodyNode*> path; // ancestors of B, then B
+    for (int task=0; task < nt; ++task) {
+        const MobilizedBodyIndex mobodx = onBodyB[task];
+        SimTK_INDEXCHECK_ALWAYS(mobodx, nb,
+            "SimbodyMatterSubsystem::calcSparseStationJacobian()");
+
+        rowStart[task] = (int)colIndex.size();
+        const RigidBodyNode& body = rep.getRigidBodyNode(mobodx);
+        const Transform& X_GB = body.getX_GB(tpc);
+        const Vec3 p_GS = X_GB.p() + X_GB.R()*p_BS[task];       // 18 flops
+
+        path.clear();
+        for (const RigidBodyNode* n = &body; n->getParent(); n = n->getParent())
+            path.push_back(n);
+
+        for (int i = (int)path.size()-1; i >= 0; --i) {
+            const RigidBodyNode& anc = *path[i];
+            const Vec3 p_AS_G = p_GS - anc.getX_GB(tpc).p();
+            for (int j=0; j < anc.getDOF(); ++j) {
+                const SpatialVec& H = anc.getHCol(tpc, j);
+                colIndex.push_back(anc.getUIndex() + j);
+                JS.push_back(H[1] + H[0] % p_AS_G);
+            }
+        }
+    }
+    rowStart[nt] = (int)colIndex.size();
+}
+
+
 //------------------------------------------------------------------------------
 //                 CALC BIAS FOR STATION JACOBIAN (spatial)
 //------------------------------------------------------------------------------
@@ -1869,6 +2151,150 @@ void SimbodyMatterSubsystem::calcBiasForFrameJacobian
 
 
 
+//------------------------------------------------------------------------------
+//                      CALC TASK INERTIA INVERSE (helper)
+//------------------------------------------------------------------------------
+// Form LambdaInv = J M^-1 ~J for nt station tasks (3 rows each: the linear
+// part) or frame tasks (6 rows each: angular then linear) without forming M
+// or J. Each column of ~J is one O(n) sweep of ~J_G, all the columns of 
+// M^-1 ~J are then formed together in one pair of sweeps, and each column of
+// the result is one O(n) sweep of J_G followed by cheap per-task shifts.
+// Cost is about k*(18nb+11n) + k*(80n) + k*(12(nb+n)+27nt) flops for k=3nt
+// or 6nt rows; that is, O(k*(n+k)) rather than the O(k*n^2) of composing 
+// explicit matrices.
+static void calcTaskInertiaInverse
+   (const SimbodyMatterSubsystemRep&    rep,
+    const State&                        state,
+    const Array_<MobilizedBodyIndex>&   onBodyB,
+    const Array_<Vec3>&                 p_BS,
+    bool                                isFrameTask,
+    const char*                         methodName,
+    Matrix&                             LambdaInv)
+{
+    const int nb = rep.getNumBodies(), nu = rep.getNumMobilities();
+    const int nt = (int)onBodyB.size(); // number of tasks
+    const int rowsPerTask = isFrameTask ? 6 : 3;
+    const int nrow = rowsPerTask*nt;
+
+    SimTK_ERRCHK3_ALWAYS((int)p_BS.size() == nt, methodName,
+        "The given number of task bodies (%d) and %s tasks (%d) must "
+        "be the same.", nt, isFrameTask ? "frame" : "station", 
+        (int)p_BS.size());
+
+    LambdaInv.resize(nrow, nrow);
+    if (nrow == 0) return;
+
+    // Task station locations re-expressed in Ground.
+    Array_<Vec3> p_BS_G(nt);
+    for (int task=0; task < nt; ++task) {
+        const MobilizedBodyIndex mobodx = onBodyB[task];
+        SimTK_INDEXCHECK(mobodx, nb, methodName);
+        p_BS_G[task] = rep.getMobilizedBody(mobodx)
+                          .expressVectorInGroundFrame(state, p_BS[task]);
+    }
+
+    if (nu == 0) {LambdaInv.setToZero(); return;}
+
+    // Columns of ~J, one per task row.
+    Matrix Jt(nu, nrow);
+    Vector_<SpatialVec> F_G(nb); F_G.setToZero();
+    for (int task=0; task < nt; ++task) {
+        SpatialVec& Fb = F_G[onBodyB[task]]; // the only one we'll change
+        for (int r=0; r < rowsPerTask; ++r) {
+            const bool isLinear = !isFrameTask || r >= 3;
+            const int  i = isFrameTask ? r % 3 : r;
+            if (isLinear) {
+                Fb[1][i] = 1;
+                Fb[0] = p_BS_G[task] % Fb[1]; // r X F
+            } else
+                Fb[0][i] = 1;
+            Vector col(nu, &Jt(0, rowsPerTask*task + r), true); // shallow
+            rep.multiplyBySystemJacobianTranspose(state, F_G, col);
+            Fb = SpatialVec(Vec3(0),Vec3(0));
+        }
+    }
+
+    // All the columns of M^-1 ~J at once. Entries for prescribed mobilities
+    // are not written so must be zero beforehand.
+    Matrix MInvJt(nu, nrow); MInvJt.setToZero();
+    rep.multiplyByMInv(state, Jt, MInvJt);
+
+    // Now LambdaInv = J * (M^-1 ~J), column by column.
+    Vector_<SpatialVec> Ju(nb);
+    for (int c=0; c < nrow; ++c) {
+        const Vector col(nu, &MInvJt(0,c), true); // shallow
+        rep.multiplyBySystemJacobian(state, col, Ju);
+        for (int task=0; task < nt; ++task) {
+            const SpatialVec V_GS = 
+                shiftVelocityBy(Ju[onBodyB[task]], p_BS_G[task]);
+            if (isFrameTask)
+                for (int k=0; k < 3; ++k) {
+                    LambdaInv(6*task+k,   c) = V_GS[0][k];
+                    LambdaInv(6*task+3+k, c) = V_GS[1][k];
+                }
+            else 
+                for (int k=0; k < 3; ++k)
+                    LambdaInv(3*task+k, c) = V_GS[1][k];
+        }
+    }
+
+    // Remove roundoff asymmetry.
+    for (int j=0; j < nrow; ++j)
+        for (int i=j+1; i < nrow; ++i)
+            LambdaInv(i,j) = LambdaInv(j,i) = 
+                (LambdaInv(i,j) + LambdaInv(j,i)) / 2;
+}
+
+void SimbodyMatterSubsystem::calcStationTaskInertiaInverse
+   (const State&                        state,
+    const Array_<MobilizedBodyIndex>&   onBodyB,
+    const Array_<Vec3>&                 stationPInB,
+    Matrix&                             LambdaInv) const
+{
+    calcTaskInertiaInverse(getRep(), state, onBodyB, stationPInB, false,
+        "SimbodyMatterSubsystem::calcStationTaskInertiaInverse()", LambdaInv);
+}
+
+void SimbodyMatterSubsystem::calcStationTaskInertia
+   (const State&                        state,
+    const Array_<MobilizedBodyIndex>&   onBodyB,
+    const Array_<Vec3>&                 stationPInB,
+    Matrix&                             Lambda) const
+{
+    Matrix LambdaInv;
+    calcTaskInertiaInverse(getRep(), state, onBodyB, stationPInB, false,
+        "SimbodyMatterSubsystem::calcStationTaskInertia()", LambdaInv);
+    Lambda.resize(LambdaInv.nrow(), LambdaInv.ncol());
+    if (LambdaInv.nrow() == 0) return;
+    FactorLU(LambdaInv).inverse(Lambda);
+}
+
+void SimbodyMatterSubsystem::calcFrameTaskInertiaInverse
+   (const State&                        state,
+    const Array_<MobilizedBodyIndex>&   onBodyB,
+    const Array_<Vec3>&                 originAoInB,
+    Matrix&                             LambdaInv) const
+{
+    calcTaskInertiaInverse(getRep(), state, onBodyB, originAoInB, true,
+        "SimbodyMatterSubsystem::calcFrameTaskInertiaInverse()", LambdaInv);
+}
+
+void SimbodyMatterSubsystem::calcFrameTaskInertia
+   (const State&                        state,
+    const Array_<MobilizedBodyIndex>&   onBodyB,
+    const Array_<Vec3>&                 originAoInB,
+    Matrix&                             Lambda) const
+{
+    Matrix LambdaInv;
+    calcTaskInertiaInverse(getRep(), state, onBodyB, originAoInB, true,
+        "SimbodyMatterSubsystem::calcFrameTaskInertia()", LambdaInv);
+    Lambda.resize(LambdaInv.nrow(), LambdaInv.ncol());
+    if (LambdaInv.nrow() == 0) return;
+    FactorLU(LambdaInv).inverse(Lambda);
+}
+
+
+
 //==============================================================================
 //                              MISC OPERATORS
 //==============================================================================
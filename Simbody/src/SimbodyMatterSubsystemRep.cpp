@@ -37,6 +37,9 @@
 
 #include <string>
 #include <iostream>
+#include <exception>
+#include <mutex>
+#include <typeinfo>
 using std::cout; using std::endl;
 
 SimbodyMatterSubsystemRep::SimbodyMatterSubsystemRep
@@ -102,10 +105,164 @@ void SimbodyMatterSubsystemRep::clearTopologyCache() {
     // be deleted when the MobilizedBodyImpl objects are.
     rbNodeLevels.clear();
     nodeNum2NodeMap.clear();
+    independentSubtrees.clear();
+    constraintSubtree.clear();
+    sameTypeNodeRuns.clear();
 
     showDefaultGeometry = true;
 }
 
+namespace {
+// This is the cached factorization of G M^-1 ~G used to calculate 
+// multipliers. The matrix is block diagonal, with one block for the 
+// constraint equations acting on each independent subtree; rows[k] lists the
+// multiplier indices belonging to block k, which is factored by factors[k].
+class SBConstraintOperatorCache {
+public:
+    Array_< Array_<int> >   rows;
+    Array_<FactorQTZ>       factors;
+};
+
+// These tasks apply a node operation to parts of the multibody tree, either
+// one node of a level per execute() index, or one whole independent subtree
+// per index. ParallelExecutor swallows exceptions thrown on worker threads,
+// so we capture the first one here and let the caller rethrow it on the
+// calling thread.
+class NodeSweepTaskBase : public ParallelExecutor::Task {
+public:
+    void rethrowFirstError() const {
+        if (firstError) std::rethrow_exception(firstError);
+    }
+protected:
+    template <class F> void guarded(const F& f) {
+        try {
+            f();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorLock);
+            if (!firstError) firstError = std::current_exception();
+        }
+    }
+private:
+    std::mutex              errorLock;
+    std::exception_ptr      firstError;
+};
+
+template <class NodeOp>
+class LevelSweepTask : public NodeSweepTaskBase {
+public:
+    LevelSweepTask(const RBNodePtrList& nodes, const NodeOp& nodeOp) 
+    :   nodes(nodes), nodeOp(nodeOp) {}
+
+    void execute(int j) override {
+        guarded([&]() {nodeOp(*nodes[j]);});
+    }
+private:
+    const RBNodePtrList&    nodes;
+    const NodeOp&           nodeOp;
+};
+
+// Subtree node lists are in base-to-tip order; an inward sweep processes
+// them backwards.
+template <class NodeOp>
+class SubtreeSweepTask : public NodeSweepTaskBase {
+public:
+    SubtreeSweepTask(const Array_<RBNodePtrList>& subtrees, bool inward,
+                     const NodeOp& nodeOp) 
+    :   subtrees(subtrees), inward(inward), nodeOp(nodeOp) {}
+
+    void execute(int k) override {
+        const RBNodePtrList& nodes = subtrees[k];
+        guarded([&]() {
+            if (inward)
+                for (int j=(int)nodes.size()-1; j >= 0; --j) nodeOp(*nodes[j]);
+            else
+                for (int j=0; j < (int)nodes.size(); ++j) nodeOp(*nodes[j]);
+        });
+    }
+private:
+    const Array_<RBNodePtrList>&    subtrees;
+    const bool                      inward;
+    const NodeOp&                   nodeOp;
+};
+}
+
+// Nested use of the executor isn't allowed, and if we're already on a worker
+// thread (e.g. from MultibodySystem::realizeBatch()) the executor may be busy
+// with another State.
+bool SimbodyMatterSubsystemRep::useParallelSweeps() const {
+    return !levelExecutor.empty() && !ParallelExecutor::isWorkerThread();
+}
+
+template <class NodeOp> void SimbodyMatterSubsystemRep::
+forEachNodeAtLevel(int level, const NodeOp& nodeOp) const {
+    const RBNodePtrList& nodes = rbNodeLevels[level];
+    if (!useParallelSweeps() || nodes.size() < 2) {
+        for (int j=0; j < (int)nodes.size(); ++j)
+            nodeOp(*nodes[j]);
+        return;
+    }
+
+    LevelSweepTask<NodeOp> task(nodes, nodeOp);
+    levelExecutor->execute(task, (int)nodes.size());
+    task.rethrowFirstError();
+}
+
+template <class NodeOp> void SimbodyMatterSubsystemRep::
+forEachNodeBaseToTip(const NodeOp& nodeOp) const {
+    if (!useParallelSweeps() || independentSubtrees.size() < 2) {
+        for (int i=0 ; i<(int)rbNodeLevels.size() ; ++i)
+            forEachNodeAtLevel(i, nodeOp);
+        return;
+    }
+
+    nodeOp(*rbNodeLevels[0][0]); // Ground
+    SubtreeSweepTask<NodeOp> task(independentSubtrees, false, nodeOp);
+    levelExecutor->execute(task, (int)independentSubtrees.size());
+    task.rethrowFirstError();
+}
+
+template <class NodeOp> void SimbodyMatterSubsystemRep::
+forEachNodeTipToBase(const NodeOp& nodeOp) const {
+    if (!useParallelSweeps() || independentSubtrees.size() < 2) {
+        for (int i=rbNodeLevels.size()-1 ; i>=0 ; --i)
+            forEachNodeAtLevel(i, nodeOp);
+        return;
+    }
+
+    SubtreeSweepTask<NodeOp> task(independentSubtrees, true, nodeOp);
+    levelExecutor->execute(task, (int)independentSubtrees.size());
+    task.rethrowFirstError();
+    nodeOp(*rbNodeLevels[0][0]); // Ground
+}
+
+template <class RunOp> void SimbodyMatterSubsystemRep::
+forEachNodeRunBaseToTip(const RunOp& runOp) const {
+    if (useParallelSweeps()) {
+        forEachNodeBaseToTip([&runOp](const RigidBodyNode& node) {
+            const RigidBodyNode* run = &node;
+            runOp(&run, 1);
+        });
+        return;
+    }
+    for (int i=0 ; i<(int)sameTypeNodeRuns.size() ; ++i)
+        for (const RBNodePtrList& run : sameTypeNodeRuns[i])
+            runOp(run.cbegin(), (int)run.size());
+}
+
+template <class RunOp> void SimbodyMatterSubsystemRep::
+forEachNodeRunTipToBase(const RunOp& runOp) const {
+    if (useParallelSweeps()) {
+        forEachNodeTipToBase([&runOp](const RigidBodyNode& node) {
+            const RigidBodyNode* run = &node;
+            runOp(&run, 1);
+        });
+        return;
+    }
+    for (int i=sameTypeNodeRuns.size()-1 ; i>=0 ; --i)
+        for (const RBNodePtrList& run : sameTypeNodeRuns[i])
+            runOp(run.cbegin(), (int)run.size());
+}
+
 MobilizedBodyIndex SimbodyMatterSubsystemRep::adoptMobilizedBody
    (MobilizedBodyIndex parentIx, MobilizedBody& child) 
 {
@@ -327,6 +484,102 @@ void SimbodyMatterSubsystemRep::endConstruction(State& s) {
         }
         */
     }
+
+    findIndependentSubtrees();
+    findSameTypeNodeRuns();
+}
+
+// Group the nodes at each level by their concrete type (that is, by mobilizer
+// type and by the template arguments of RigidBodyNodeSpec). Nodes at the same
+// level are independent during a sweep so they may be processed in any order;
+// within a level the runs appear in order of first occurrence and each run
+// keeps its nodes in their original order.
+void SimbodyMatterSubsystemRep::findSameTypeNodeRuns() {
+    sameTypeNodeRuns.clear();
+    sameTypeNodeRuns.resize(rbNodeLevels.size());
+    for (int i=0 ; i<(int)rbNodeLevels.size() ; ++i) {
+        Array_<RBNodePtrList>& runs = sameTypeNodeRuns[i];
+        for (const RigidBodyNode* node : rbNodeLevels[i]) {
+            int r = 0;
+            while (r < (int)runs.size() 
+                   && typeid(*runs[r].front()) != typeid(*node))
+                ++r;
+            if (r == (int)runs.size()) runs.push_back();
+            runs[r].push_back(node);
+        }
+    }
+}
+
+// Partition the non-Ground mobilized bodies into groups that can be swept
+// independently: each base (level 1) body and its outboard bodies form a
+// subtree, and subtrees are merged if any Constraint connects them. (A
+// Constraint that involves only Ground and one subtree couples nothing.) Each
+// group's nodes are recorded in base-to-tip order. For a system with one
+// base body, or one in which everything is coupled, there will be only a 
+// single group and the sweeps fall back to level-by-level processing.
+void SimbodyMatterSubsystemRep::findIndependentSubtrees() {
+    independentSubtrees.clear();
+    constraintSubtree.clear();
+    constraintSubtree.resize(getNumConstraints(), -1);
+    if (rbNodeLevels.size() < 2)
+        return; // only Ground
+
+    // Map each mobilized body to the index of its base body within level 1,
+    // and start with each base body in its own group.
+    Array_<int,MobilizedBodyIndex> baseOf(getNumMobilizedBodies(), -1);
+    for (int i=1 ; i<(int)rbNodeLevels.size() ; ++i)
+        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; ++j) {
+            const RigidBodyNode& node = *rbNodeLevels[i][j];
+            baseOf[node.getNodeNum()] = 
+                i==1 ? j : baseOf[node.getParent()->getNodeNum()];
+        }
+
+    const int nBase = (int)rbNodeLevels[1].size();
+    Array_<int> group(nBase);
+    for (int b=0; b < nBase; ++b) group[b] = b;
+    auto findGroup = [&group](int b) {
+        while (group[b] != b) b = group[b] = group[group[b]];
+        return b;
+    };
+
+    Array_<int,ConstraintIndex> firstBase(getNumConstraints(), -1);
+    for (ConstraintIndex cx(0); cx<getNumConstraints(); ++cx) {
+        const ConstraintImpl& crep = getConstraint(cx).getImpl();
+        int& first = firstBase[cx];
+        auto join = [&](MobilizedBodyIndex mbx) {
+            const int b = baseOf[mbx];
+            if (b < 0) return; // Ground
+            if (first < 0) first = findGroup(b);
+            else group[findGroup(b)] = first;
+        };
+        for (ConstrainedBodyIndex cb(0); cb < crep.getNumConstrainedBodies();
+             ++cb)
+            join(crep.getMobilizedBodyIndexOfConstrainedBody(cb));
+        for (ConstrainedMobilizerIndex cm(0); 
+             cm < crep.getNumConstrainedMobilizers(); ++cm)
+            join(crep.getMobilizedBodyIndexOfConstrainedMobilizer(cm));
+    }
+
+    // Number the groups in order of their first base body, then collect 
+    // nodes level by level so that each list is in base-to-tip order.
+    Array_<int> groupNum(nBase, -1);
+    for (int b=0; b < nBase; ++b) {
+        const int g = findGroup(b);
+        if (groupNum[g] < 0) {
+            groupNum[g] = (int)independentSubtrees.size();
+            independentSubtrees.push_back();
+        }
+    }
+    for (int i=1 ; i<(int)rbNodeLevels.size() ; ++i)
+        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; ++j) {
+            const RigidBodyNode* node = rbNodeLevels[i][j];
+            const int g = groupNum[findGroup(baseOf[node->getNodeNum()])];
+            independentSubtrees[g].push_back(node);
+        }
+
+    for (ConstraintIndex cx(0); cx<getNumConstraints(); ++cx)
+        if (firstBase[cx] >= 0)
+            constraintSubtree[cx] = groupNum[findGroup(firstBase[cx])];
 }
 
 int SimbodyMatterSubsystemRep::realizeSubsystemTopologyImpl(State& s) const {
@@ -410,6 +663,36 @@ int SimbodyMatterSubsystemRep::realizeSubsystemTopologyImpl(State& s) const {
         {CacheEntryKey(getMySubsystemIndex(), tc.treePositionCacheIndex)},
         new Value<SBCompositeBodyInertiaCache>());
 
+    // The factored constraint operator G M^-1 ~G is computed on demand when
+    // multipliers are needed and reused until it depends on something that
+    // changed. If all the constraints are holonomic G=P(t,q) so u changes
+    // don't matter; otherwise it can depend on u too.
+    tc.holonomicConstraintOperatorCacheIndex = 
+        s.allocateCacheEntryWithPrerequisites
+       (getMySubsystemIndex(), Stage::Time, Stage::Infinity,
+        true /*q*/, false /*u*/, false /*z*/, {} /*dv*/, {} /*ce*/,
+        new Value<SBConstraintOperatorCache>());
+    tc.constraintOperatorCacheIndex = s.allocateCacheEntryWithPrerequisites
+       (getMySubsystemIndex(), Stage::Time, Stage::Infinity,
+        true /*q*/, true /*u*/, false /*z*/, {} /*dv*/, {} /*ce*/,
+        new Value<SBConstraintOperatorCache>());
+
+    // The sparse mass matrix factorization is built from the composite body
+    // inertias and is likewise computed only on request.
+    tc.massMatrixFactorCacheIndex = s.allocateCacheEntryWithPrerequisites
+       (getMySubsystemIndex(), Stage::Instance, Stage::Infinity,
+        false /*q*/, false /*u*/, false /*z*/, {} /*dv*/, 
+        {CacheEntryKey(getMySubsystemIndex(), 
+                       tc.compositeBodyInertiaCacheIndex)},
+        new Value<SBMassMatrixFactorCache>());
+
+    // Projections that are permitted to use an out-of-date iteration matrix
+    // keep their factorizations here for the next projection of this State.
+    // This is never invalidated by q or u changes.
+    tc.projectionFactorCacheIndex = 
+        allocateLazyCacheEntry(s, Stage::Instance,
+                               new Value<SBProjectionFactorCache>());
+
     // Articulated body inertias *can* be calculated any time after 
     // PositionKinematics are available but we want to put them off until 
     // Acceleration stage if possible.
@@ -993,6 +1276,7 @@ realizeSubsystemInstanceImpl(const State& s) const {
     updTreePositionCache(s).allocate(topologyCache, mc, ic);
     updConstrainedPositionCache(s).allocate(topologyCache, mc, ic);
     updCompositeBodyInertiaCache(s).allocate(topologyCache, mc, ic);
+    updMassMatrixFactorCache(s).allocate(topologyCache, mc, ic);
     updArticulatedBodyInertiaCache(s).allocate(topologyCache, mc, ic);
     updTreeVelocityCache(s).allocate(topologyCache, mc, ic);
     updConstrainedVelocityCache(s).allocate(topologyCache, mc, ic);
@@ -1130,9 +1414,46 @@ realizePositionKinematics(const State& state) const {
     // Any body which is using quaternions should calculate the quaternion
     // constraint here and put it in the appropriate slot of qErr.
     // Set generalized coordinates: sweep from base to tips.
-    for (int i=0 ; i<(int)rbNodeLevels.size() ; i++) 
-        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++)
-            rbNodeLevels[i][j]->realizePosition(stateDigest); 
+    const Vector& q = stateDigest.getQ();
+    const bool incremental = incrementalPositionKinematics 
+                             && tpc.lastQValid && tpc.lastQ.size() == q.size();
+    tpc.lastQValid = false; // in case we don't finish
+
+    if (!incremental) {
+        forEachNodeBaseToTip([&](const RigidBodyNode& node) {
+            node.realizePosition(stateDigest); 
+        });
+    } else {
+        // Only a mobilizer whose own q's changed, or one outboard of such a
+        // mobilizer, needs to be recomputed; everything else in the cache is
+        // still good. Mobilizers using quaternions are always recomputed
+        // since they must fill in their qErr slot, but if their q's are the
+        // same their children don't have to be.
+        const SBModelCache& mc = stateDigest.getModelCache();
+        Array_<bool,MobilizedBodyIndex> dirty(getNumBodies(), false);
+        forEachNodeBaseToTip([&](const RigidBodyNode& node) {
+            const MobilizedBodyIndex mbx = node.getNodeNum();
+            const RigidBodyNode* parent = node.getParent();
+            if (!parent) {
+                node.realizePosition(stateDigest); // Ground
+                return;
+            }
+            const SBModelPerMobodInfo& mInfo = mc.getMobodModelInfo(mbx);
+            bool changed = dirty[parent->getNodeNum()];
+            for (int i=0; !changed && i < mInfo.nQInUse; ++i) {
+                const int qx = mInfo.firstQIndex + i;
+                changed = (q[qx] != tpc.lastQ[qx]);
+            }
+            dirty[mbx] = changed;
+            if (changed || mInfo.hasQuaternionInUse)
+                node.realizePosition(stateDigest);
+        });
+    }
+
+    if (incrementalPositionKinematics) {
+        tpc.lastQ = q;
+        tpc.lastQValid = true;
+    }
 
     // Ask the constraints to calculate ancestor-relative kinematics (still 
     // goes in TreePositionCache).
@@ -1238,9 +1559,9 @@ realizeArticulatedBodyInertias(const State& state) const {
     SBArticulatedBodyInertiaCache&  abc = updArticulatedBodyInertiaCache(state);
 
     // tip-to-base sweep
-    for (int i=rbNodeLevels.size()-1 ; i>=0 ; --i) 
-        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; ++j)
-            rbNodeLevels[i][j]->realizeArticulatedBodyInertiasInward(ic,tpc,abc);
+    forEachNodeRunTipToBase([&](const RigidBodyNode* const* run, int n) {
+        run[0]->realizeArticulatedBodyInertiasInwardRun(run,n,ic,tpc,abc);
+    });
 
     markCacheValueRealized(state, abx);
 }
@@ -1374,9 +1695,9 @@ realizeVelocityKinematics(const State& state) const {
     // and all global velocities relative to Ground (G). Also computes qdots.
 
     // Set generalized speeds: sweep from base to tips.
-    for (int i=0 ; i<(int)rbNodeLevels.size() ; ++i) 
-        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; ++j)
-            rbNodeLevels[i][j]->realizeVelocity(stateDigest); 
+    forEachNodeBaseToTip([&](const RigidBodyNode& node) {
+        node.realizeVelocity(stateDigest); 
+    });
 
     // Ask the constraints to calculate ancestor-relative velocity kinematics 
     // (still goes in TreeVelocityCache).
@@ -3531,9 +3852,12 @@ calcGMInvGt(const State&   s,
     const bool columnsAreContiguous = GMInvGt(0).hasContiguousData();
     Vector GMInvGt_j(columnsAreContiguous ? 0 : m);
 
-    // These two temporaries are always needed to hold one column of Gt,
-    // then one column of M^-1 * Gt.
-    Vector Gtcol(nu), MInvGtcol(nu);
+    // These temporaries hold a block of columns of Gt, then the same
+    // columns of M^-1 * Gt. We do the M^-1 multiplies a block at a time so
+    // that each sweep of the tree serves many columns.
+    const int BlockSize = std::min(m, 16);
+    Matrix Gt(nu, BlockSize), MInvGt(nu, BlockSize);
+    Vector Gtcol(nu);
 
     // Precalculate bias so we can perform multiplication by G efficiently.
     Vector bias(m);
@@ -3543,40 +3867,148 @@ calcGMInvGt(const State&   s,
     // element at a time of lambda will be 1, the rest are 0.
     Vector lambda(m, Real(0));
 
-    for (int j=0; j < m; ++j) {
-        lambda[j] = 1;
-        multiplyByPVATranspose(s, true, true, true, lambda, Gtcol);
-        lambda[j] = 0;
-        multiplyByMInv(s, Gtcol, MInvGtcol);
-        if (columnsAreContiguous)
-            multiplyByPVA(s, true, true, true, bias, MInvGtcol, GMInvGt(j));
-        else {
-            multiplyByPVA(s, true, true, true, bias, MInvGtcol, GMInvGt_j);
-            GMInvGt(j) = GMInvGt_j;
+    for (int j0=0; j0 < m; j0 += BlockSize) {
+        const int ncol = std::min(BlockSize, m-j0);
+        if (ncol != Gt.ncol()) Gt.resize(nu, ncol);
+        for (int c=0; c < ncol; ++c) {
+            lambda[j0+c] = 1;
+            multiplyByPVATranspose(s, true, true, true, lambda, Gtcol);
+            lambda[j0+c] = 0;
+            Gt(c) = Gtcol;
+        }
+        multiplyByMInv(s, Gt, MInvGt);
+        for (int c=0; c < ncol; ++c) {
+            const int j = j0+c;
+            const Vector MInvGtcol(nu, &MInvGt(0,c), true); // shallow ref
+            if (columnsAreContiguous)
+                multiplyByPVA(s, true, true, true, bias, MInvGtcol, GMInvGt(j));
+            else {
+                multiplyByPVA(s, true, true, true, bias, MInvGtcol, GMInvGt_j);
+                GMInvGt(j) = GMInvGt_j;
+            }
         }
     }
 } 
 
 
 
+// =============================================================================
+//                             SOLVE G MInv G^T
+// =============================================================================
+// The factorization is computed the first time it is needed for a given set
+// of t, q (and u if there are non-holonomic or acceleration-only constraints)
+// and reused after that. Constraint equations are grouped by the independent
+// subtree their Constraint acts on; groups are uncoupled in both G and M so
+// each diagonal block of G M^-1 ~G is factored on its own. The conditioning
+// tolerance is the one we would use for the whole matrix.
+void SimbodyMatterSubsystemRep::
+solveGMInvGt(const State&   s, 
+             const Vector&  rhs,
+             Vector&        x) const
+{
+    const SBInstanceCache& ic = getInstanceCache(s);
+    const int mHolo    = ic.totalNHolonomicConstraintEquationsInUse;
+    const int mNonholo = ic.totalNNonholonomicConstraintEquationsInUse;
+    const int mAccOnly = ic.totalNAccelerationOnlyConstraintEquationsInUse;
+    const int m        = mHolo+mNonholo+mAccOnly;
+    assert(rhs.size() == m);
+
+    x.resize(m);
+    if (m==0) return;
+
+    const CacheEntryIndex cox = mNonholo+mAccOnly == 0 
+        ? topologyCache.holonomicConstraintOperatorCacheIndex
+        : topologyCache.constraintOperatorCacheIndex;
+    SBConstraintOperatorCache& coc = 
+        Value<SBConstraintOperatorCache>::updDowncast(updCacheEntry(s, cox));
+
+    if (!isCacheValueRealized(s, cox)) {
+        Matrix GMInvGt(m,m);
+        calcGMInvGt(s, GMInvGt);
+        // Conditioning tolerance. This determines when we'll drop a 
+        // constraint. 
+        // TODO: this is probably too tight; should depend on constraint 
+        // tolerance and should be consistent with position and velocity 
+        // projection ranks. Tricky here because conditioning depends on mass
+        // matrix as well as constraints.
+        const Real conditioningTol = m 
+            //* SignificantReal;
+            * SqrtEps*std::sqrt(SqrtEps); // Eps^(3/4)
+
+        // Assign each multiplier to the block of its Constraint's subtree;
+        // Ground-only Constraints share an extra block at the end.
+        const int nSubtrees = (int)independentSubtrees.size();
+        Array_<int> rowBlock(m);
+        for (ConstraintIndex cx(0); cx < getNumConstraints(); ++cx) {
+            const SBInstancePerConstraintInfo& 
+                                  cInfo = ic.getConstraintInstanceInfo(cx);
+            const int block = constraintSubtree[cx] < 0 
+                                ? nSubtrees : constraintSubtree[cx];
+            const Segment& holoSeg    = cInfo.holoErrSegment;
+            const Segment& nonholoSeg = cInfo.nonholoErrSegment;
+            const Segment& accOnlySeg = cInfo.accOnlyErrSegment;
+            for (int i=0; i<holoSeg.length; ++i) 
+                rowBlock[holoSeg.offset + i] = block;
+            for (int i=0; i<nonholoSeg.length; ++i) 
+                rowBlock[mHolo + nonholoSeg.offset + i] = block;
+            for (int i=0; i<accOnlySeg.length; ++i) 
+                rowBlock[mHolo+mNonholo + accOnlySeg.offset + i] = block;
+        }
+
+        Array_<int> blockNum(nSubtrees+1, -1);
+        coc.rows.clear();
+        for (int r=0; r < m; ++r) {
+            int& b = blockNum[rowBlock[r]];
+            if (b < 0) {b = (int)coc.rows.size(); coc.rows.push_back();}
+            coc.rows[b].push_back(r);
+        }
+
+        coc.factors.resize(coc.rows.size());
+        if (coc.rows.size() == 1)
+            coc.factors[0] = FactorQTZ(GMInvGt, conditioningTol);
+        else {
+            for (int b=0; b < (int)coc.rows.size(); ++b) {
+                const Array_<int>& rows = coc.rows[b];
+                const int mb = (int)rows.size();
+                Matrix block(mb, mb);
+                for (int j=0; j < mb; ++j)
+                    for (int i=0; i < mb; ++i)
+                        block(i,j) = GMInvGt(rows[i], rows[j]);
+                coc.factors[b] = FactorQTZ(block, conditioningTol);
+            }
+        }
+        markCacheValueRealized(s, cox);
+    }
+
+    if (coc.rows.size() == 1) {
+        coc.factors[0].solve(rhs, x);
+        return;
+    }
+
+    Vector rhsb, xb;
+    for (int b=0; b < (int)coc.rows.size(); ++b) {
+        const Array_<int>& rows = coc.rows[b];
+        const int mb = (int)rows.size();
+        rhsb.resize(mb);
+        for (int i=0; i < mb; ++i) rhsb[i] = rhs[rows[i]];
+        coc.factors[b].solve(rhsb, xb);
+        for (int i=0; i < mb; ++i) x[rows[i]] = xb[i];
+    }
+}
+
+
+
 // =============================================================================
 //                     SOLVE FOR CONSTRAINT IMPULSES
 // =============================================================================
-// Current implementation computes G*M^-1*~G, factors it, and does a single
-// solve all at great expense.
-// TODO: should realize factored matrix if needed and reuse if possible.
+// This uses the same factored G*M^-1*~G as forward dynamics, computing it
+// only if it isn't already available for the current state.
 void SimbodyMatterSubsystemRep::
 solveForConstraintImpulses(const State&     state,
                            const Vector&    deltaV,
                            Vector&          impulse) const
 {
-    Matrix GMInvGt;
-    calcGMInvGt(state, GMInvGt);
-    // MUST DUPLICATE SIMBODY'S METHOD HERE:
-    const Real conditioningTol = GMInvGt.nrow() 
-                                    * SqrtEps*std::sqrt(SqrtEps); // Eps^(3/4)
-    FactorQTZ qtz(GMInvGt, conditioningTol); 
-    qtz.solve(deltaV, impulse);
+    solveGMInvGt(state, deltaV, impulse);
 }
 
 
@@ -4201,9 +4633,11 @@ int SimbodyMatterSubsystemRep::projectQ
     // initialization.
     const bool localOnly = opts.isOptionSet(ProjectOptions::LocalOnly);
     // We are permitted to use an out-of-date Jacobian for projection unless
-    // this is set. TODO: always using full Newton at the moment.
+    // this is set. We only take advantage of that for local projections,
+    // since a stale Jacobian is a poor guide far from the solution.
     const bool forceFullNewton =
         opts.isOptionSet(ProjectOptions::ForceFullNewton);
+    const bool useModifiedNewton = localOnly && !forceFullNewton;
 
     // Get problem dimensions.
     const SBInstanceCache& ic = getInstanceCache(s);
@@ -4229,11 +4663,13 @@ int SimbodyMatterSubsystemRep::projectQ
     // (diagonal weights are symmetric). We only retain rows that 
     // correspond to free (non prescribed) q's.
     //
-    // This is a nonlinear least squares problem. Below is a full Newton 
-    // iteration since we recalculate the iteration matrix each time around the
-    // loop. TODO: a solution could be found using the same iteration matrix, 
-    // since we are projecting from (presumably) not too far away. Q1: will it
-    // be the same solution? Q2: if not, does it matter?
+    // This is a nonlinear least squares problem. With full Newton we 
+    // recalculate the iteration matrix each time around the loop. With
+    // modified Newton we keep using the factorization left in the projection
+    // factor cache, possibly by an earlier call at a nearby q, and refactor
+    // only when convergence slows down (or reverses, in which case we also
+    // undo the step). Either way we converge to a point on the constraint
+    // manifold near the starting q; it need not be exactly the same point.
 
     // These will be updated as we go.
     Real perrNormAchieved = perrNormOnEntry;
@@ -4265,21 +4701,43 @@ int SimbodyMatterSubsystemRep::projectQ
     Vector dfq_WLS(nfq), du(nu), dq(nq); // = Wq^+ dq_WLS
     Vector udfq_WLS(hasPrescribedMotion ? nq : 0); // unpacked if needed
     udfq_WLS.setToZero(); // must initialize unwritten elements
-    FactorQTZ Pqwr_qtz;
+    // The iteration matrix is block diagonal with a block for each group of
+    // Constraints acting on an independent subtree; the blocks are factored
+    // separately. Pqwr_qtz points to the current block factorizations, if
+    // any. Note that pfc must be refreshed whenever the cache is updated.
+    const SBProjectionFactorCache* pfc = &realizeProjectionBlocks(s);
+    Array_<FactorQTZ> fullNewtonQtz;
+    const Array_<FactorQTZ>* Pqwr_qtz = 
+        useModifiedNewton && pfc->hasQFactor ? &pfc->qFactors : nullptr;
+    // Modified Newton refactors if the error isn't being reduced at least
+    // this much per iteration.
+    const Real MaxConvergenceRate = Real(0.2);
+    bool needRefactor = false;
+    int nFactorizations = 0;
     Real prevPerrNormAchieved = perrNormAchieved; // watch for divergence
     bool diverged = false;
     const int MaxIterations  = 20;
     do {
-        calcWeightedPqrTranspose(s, perrWeights, uAbsScale, Pqwrt);//nfq X mp
-
-        // This factorization acts like a pseudoinverse.
-        Pqwr_qtz.factor<Real>(~Pqwrt, conditioningTol); 
+        const bool isFreshFactor = 
+            !useModifiedNewton || !Pqwr_qtz || needRefactor;
+        needRefactor = false;
+        if (isFreshFactor) {
+            ++nFactorizations;
+            calcWeightedPqrTranspose(s, perrWeights, uAbsScale, Pqwrt);
 
-        //printf("projectQ %d: m=%d condTol=%g rank=%d rcond=%g\n",
-        //    nItsUsed, Pqwrt.ncol(), conditioningTol, Pqwr_qtz.getRank(),
-        //    Pqwr_qtz.getRCondEstimate());
+            // This factorization acts like a pseudoinverse.
+            if (useModifiedNewton) {
+                pfc = &refactorProjectionQ(s, Pqwrt, conditioningTol);
+                Pqwr_qtz = &pfc->qFactors;
+            } else {
+                factorProjectionBlocks(pfc->qBlocks, Pqwrt, conditioningTol,
+                                       fullNewtonQtz); 
+                Pqwr_qtz = &fullNewtonQtz;
+            }
+        }
 
-        Pqwr_qtz.solve(scaledPerrs, dfq_WLS); // this is weighted dq_WLS=Wq*dq
+        // this is weighted dq_WLS=Wq*dq
+        solveProjectionBlocks(pfc->qBlocks, *Pqwr_qtz, scaledPerrs, dfq_WLS);
         lastChangeMadeWRMS = dfq_WLS.normRMS(); // change in weighted norm
 
         // switch back to unweighted dq=Wq^+*dq_WLS
@@ -4307,8 +4765,21 @@ int SimbodyMatterSubsystemRep::projectQ
         perrNormAchieved = useNormInf ? scaledPerrs.normInf()
                                       : scaledPerrs.normRMS();
         ++nItsUsed;
-
-        if (localOnly && nItsUsed >= 2 
+        if (!isFreshFactor && perrNormAchieved 
+                              > MaxConvergenceRate*prevPerrNormAchieved) {
+            // An old iteration matrix isn't good enough anymore; refactor
+            // at the current q next time around. If the norm got worse,
+            // first undo the step.
+            needRefactor = true;
+            if (perrNormAchieved > prevPerrNormAchieved) {
+                updQ(s) += dq;
+                realizeSubsystemPosition(s); // pErrs changes here
+                scaledPerrs = pErrs.rowScale(perrWeights);
+                perrNormAchieved = useNormInf ? scaledPerrs.normInf()
+                                              : scaledPerrs.normRMS();
+            }
+        }
+        else if (localOnly && nItsUsed >= 2 
             && perrNormAchieved > prevPerrNormAchieved) {
             // perr norm got worse; restore to end of previous iteration
             updQ(s) += dq;
@@ -4326,6 +4797,7 @@ int SimbodyMatterSubsystemRep::projectQ
                 && nItsUsed < MaxIterations);
 
     results.setNumIterations(nItsUsed);
+    results.setNumFactorizations(nFactorizations);
 
     //printf("        perrNormAchieved=%g in %d its\n",perrNormAchieved, nItsUsed);
 
@@ -4394,13 +4866,15 @@ int SimbodyMatterSubsystemRep::projectQ
             zeroKnownQ(s, qErrest_0); // zero out prescribed entries
             multiplyByPq(s, bias_p, qErrest_0, Tp_Pq_qErrest); // (Pq*qErrest)_r
             Tp_Pq_qErrest.rowScaleInPlace(perrWeights); // now Tp*(Pq*qErrest)_r
-            Pqwr_qtz.solve(Tp_Pq_qErrest, dfq_WLS); // weighted
+            solveProjectionBlocks(pfc->qBlocks, *Pqwr_qtz, 
+                                  Tp_Pq_qErrest, dfq_WLS); // weighted
             unpackFreeQ(s, dfq_WLS, udfq_WLS); // zeroes in q_p slots
             multiplyByNInv(s,false,udfq_WLS,du);
         } else {
             multiplyByPq(s, bias_p, qErrest, Tp_Pq_qErrest); // Pq*qErrest
             Tp_Pq_qErrest.rowScaleInPlace(perrWeights); // now Tp*Pq*qErrest
-            Pqwr_qtz.solve(Tp_Pq_qErrest, dfq_WLS); // weighted
+            solveProjectionBlocks(pfc->qBlocks, *Pqwr_qtz, 
+                                  Tp_Pq_qErrest, dfq_WLS); // weighted
             multiplyByNInv(s,false,dfq_WLS,du);
         }
         // Here du = du_WLS = N^+ * dq_WLS
@@ -4660,6 +5134,201 @@ void SimbodyMatterSubsystemRep::enforceVelocityConstraints
 //........................ ENFORCE VELOCITY CONSTRAINTS ........................
 
 
+//==============================================================================
+//                             PROJECTION BLOCKS
+//==============================================================================
+// Constraint equations are grouped by the independent subtree their Constraint
+// acts on, and free q's and u's by the subtree of their mobilizer. There are
+// no cross terms between groups so the projection iteration matrices are 
+// block diagonal. Ground-only Constraints don't depend on any q or u; their
+// equations are left out.
+namespace {
+void setProjectionBlocks
+   (const Array_<int>& varSubtree,  // subtree of each free var, or -1
+    const Array_<int>& eqnSubtree,  // subtree of each equation, or -1
+    int                nSubtrees,
+    SBProjectionBlocks& blocks)
+{
+    blocks.nVars = (int)varSubtree.size();
+    blocks.nEqns = (int)eqnSubtree.size();
+    Array_<Array_<int> > vars(nSubtrees), eqns(nSubtrees);
+    for (int i=0; i < blocks.nVars; ++i)
+        if (varSubtree[i] >= 0) vars[varSubtree[i]].push_back(i);
+    for (int i=0; i < blocks.nEqns; ++i)
+        if (eqnSubtree[i] >= 0) eqns[eqnSubtree[i]].push_back(i);
+
+    blocks.vars.clear(); blocks.eqns.clear();
+    for (int k=0; k < nSubtrees; ++k) {
+        if (vars[k].empty() || eqns[k].empty()) 
+            continue;
+        blocks.vars.push_back(vars[k]);
+        blocks.eqns.push_back(eqns[k]);
+    }
+    blocks.isWhole = blocks.vars.size() == 1
+                     && (int)blocks.vars[0].size() == blocks.nVars
+                     && (int)blocks.eqns[0].size() == blocks.nEqns;
+}
+
+// Factor the transpose of one block of At.
+void factorProjectionBlock(const SBProjectionBlocks& blocks, const Matrix& At,
+                           Real conditioningTol, int b, FactorQTZ& factor)
+{
+    const Array_<int>& vars = blocks.vars[b];
+    const Array_<int>& eqns = blocks.eqns[b];
+    Matrix A((int)eqns.size(), (int)vars.size());
+    for (int j=0; j < (int)vars.size(); ++j)
+        for (int i=0; i < (int)eqns.size(); ++i)
+            A(i,j) = At(vars[j], eqns[i]);
+    factor.factor<Real>(A, conditioningTol);
+}
+
+class ProjectionBlockFactorTask : public NodeSweepTaskBase {
+public:
+    ProjectionBlockFactorTask(const SBProjectionBlocks& blocks, 
+                              const Matrix& At, Real conditioningTol,
+                              Array_<FactorQTZ>& factors)
+    :   blocks(blocks), At(At), conditioningTol(conditioningTol), 
+        factors(factors) {}
+
+    void execute(int b) override {
+        guarded([&]() {
+            factorProjectionBlock(blocks, At, conditioningTol, b, factors[b]);
+        });
+    }
+private:
+    const SBProjectionBlocks&   blocks;
+    const Matrix&               At;
+    const Real                  conditioningTol;
+    Array_<FactorQTZ>&          factors;
+};
+}
+
+const SBProjectionFactorCache& SimbodyMatterSubsystemRep::
+realizeProjectionBlocks(const State& s) const {
+    const CacheEntryIndex pfx = topologyCache.projectionFactorCacheIndex;
+    if (isCacheValueRealized(s, pfx))
+        return getProjectionFactorCache(s);
+
+    SBProjectionFactorCache& pfc = updProjectionFactorCache(s);
+    const SBModelCache&    mc = getModelCache(s);
+    const SBInstanceCache& ic = getInstanceCache(s);
+    const int nSubtrees = (int)independentSubtrees.size();
+
+    // Find the subtree of every q and u.
+    Array_<int> qSubtree(getNQ(s), -1), uSubtree(getNU(s), -1);
+    for (int k=0; k < nSubtrees; ++k)
+        for (const RigidBodyNode* node : independentSubtrees[k]) {
+            const SBModelPerMobodInfo& mInfo = 
+                mc.getMobodModelInfo(node->getNodeNum());
+            for (int i=0; i < mInfo.nQInUse; ++i) 
+                qSubtree[mInfo.firstQIndex + i] = k;
+            for (int i=0; i < mInfo.nUInUse; ++i) 
+                uSubtree[mInfo.firstUIndex + i] = k;
+        }
+
+    const Array_<QIndex>& freeQX = getFreeQIndex(s);
+    const Array_<UIndex>& freeUX = getFreeUIndex(s);
+    Array_<int> freeQSubtree(freeQX.size()), freeUSubtree(freeUX.size());
+    for (int i=0; i < (int)freeQX.size(); ++i) 
+        freeQSubtree[i] = qSubtree[freeQX[i]];
+    for (int i=0; i < (int)freeUX.size(); ++i) 
+        freeUSubtree[i] = uSubtree[freeUX[i]];
+
+    // Holonomic equations come first among the velocity-level ones.
+    const int mHolo    = ic.totalNHolonomicConstraintEquationsInUse;
+    const int mNonholo = ic.totalNNonholonomicConstraintEquationsInUse;
+    Array_<int> eqnSubtree(mHolo+mNonholo, -1);
+    for (ConstraintIndex cx(0); cx < getNumConstraints(); ++cx) {
+        const SBInstancePerConstraintInfo& 
+                              cInfo = ic.getConstraintInstanceInfo(cx);
+        const Segment& holoSeg    = cInfo.holoErrSegment;
+        const Segment& nonholoSeg = cInfo.nonholoErrSegment;
+        for (int i=0; i<holoSeg.length; ++i) 
+            eqnSubtree[holoSeg.offset + i] = constraintSubtree[cx];
+        for (int i=0; i<nonholoSeg.length; ++i) 
+            eqnSubtree[mHolo + nonholoSeg.offset + i] = constraintSubtree[cx];
+    }
+
+    setProjectionBlocks(freeUSubtree, eqnSubtree, nSubtrees, pfc.uBlocks);
+    eqnSubtree.resize(mHolo);
+    setProjectionBlocks(freeQSubtree, eqnSubtree, nSubtrees, pfc.qBlocks);
+
+    pfc.hasQFactor = pfc.hasUFactor = false;
+    markCacheValueRealized(s, pfx);
+    return pfc;
+}
+
+void SimbodyMatterSubsystemRep::factorProjectionBlocks
+   (const SBProjectionBlocks& blocks, const Matrix& At, Real conditioningTol,
+    Array_<FactorQTZ>& factors) const
+{
+    if (blocks.isWhole) {
+        factors.resize(1);
+        factors[0].factor<Real>(~At, conditioningTol);
+        return;
+    }
+
+    const int nBlocks = (int)blocks.vars.size();
+    factors.resize(nBlocks);
+    if (!useParallelSweeps() || nBlocks < 2) {
+        for (int b=0; b < nBlocks; ++b)
+            factorProjectionBlock(blocks, At, conditioningTol, b, factors[b]);
+        return;
+    }
+
+    ProjectionBlockFactorTask task(blocks, At, conditioningTol, factors);
+    levelExecutor->execute(task, nBlocks);
+    task.rethrowFirstError();
+}
+
+void SimbodyMatterSubsystemRep::solveProjectionBlocks
+   (const SBProjectionBlocks& blocks, const Array_<FactorQTZ>& factors,
+    const Vector& rhs, Vector& x) const
+{
+    assert(rhs.size() == blocks.nEqns);
+    if (blocks.isWhole) {
+        factors[0].solve(rhs, x);
+        return;
+    }
+
+    x.resize(blocks.nVars);
+    x.setToZero();
+    Vector rhsb, xb;
+    for (int b=0; b < (int)blocks.vars.size(); ++b) {
+        const Array_<int>& vars = blocks.vars[b];
+        const Array_<int>& eqns = blocks.eqns[b];
+        rhsb.resize((int)eqns.size());
+        for (int i=0; i < (int)eqns.size(); ++i) rhsb[i] = rhs[eqns[i]];
+        factors[b].solve(rhsb, xb);
+        for (int j=0; j < (int)vars.size(); ++j) x[vars[j]] = xb[j];
+    }
+}
+
+const SBProjectionFactorCache& SimbodyMatterSubsystemRep::refactorProjectionQ
+   (const State& s, const Matrix& Pqwrt, Real conditioningTol) const
+{
+    realizeProjectionBlocks(s);
+    SBProjectionFactorCache& pfc = updProjectionFactorCache(s);
+    factorProjectionBlocks(pfc.qBlocks, Pqwrt, conditioningTol, pfc.qFactors);
+    pfc.hasQFactor = true;
+    return pfc;
+}
+
+const SBProjectionFactorCache& SimbodyMatterSubsystemRep::refactorProjectionU
+   (const State& s, const Matrix& PVwrt, const Vector& uScale, 
+    Real conditioningTol) const
+{
+    realizeProjectionBlocks(s);
+    SBProjectionFactorCache& pfc = updProjectionFactorCache(s);
+    factorProjectionBlocks(pfc.uBlocks, PVwrt, conditioningTol, pfc.uFactors);
+    pfc.uScale = uScale;
+    pfc.hasUFactor = true;
+    return pfc;
+}
+//............................. PROJECTION BLOCKS ..............................
+
+
+
 //==============================================================================
 //                                 PROJECT U
 //==============================================================================
@@ -4744,9 +5413,12 @@ int SimbodyMatterSubsystemRep::projectU
     // initialization.
     const bool localOnly = opts.isOptionSet(ProjectOptions::LocalOnly);
     // We are permitted to use an out-of-date Jacobian for projection unless
-    // this is set. TODO: always using modified Newton at the moment.
+    // this is set, in which case we still factor only once per call (see
+    // below). Otherwise we start from the factorization left by an earlier
+    // local projection if there is one.
     const bool forceFullNewton =
         opts.isOptionSet(ProjectOptions::ForceFullNewton);
+    const bool useModifiedNewton = localOnly && !forceFullNewton;
 
     // Get problem dimensions.
     const SBInstanceCache& ic = getInstanceCache(s);
@@ -4804,30 +5476,51 @@ int SimbodyMatterSubsystemRep::projectU
     if (hasPrescribedMotion)
         du.setToZero(); // must initialize unwritten elements
 
-    calcWeightedPVrTranspose(s, pverrWeights, uRelScale, PVwrt);
-    // PVwrt is now Eu^-1 (Pt Vt) Tpv
-
-    // Calculate pseudoinverse (just once)
-    FactorQTZ PVwr_qtz;
-    PVwr_qtz.factor<Real>(~PVwrt, conditioningTol);
-
-    //printf("projectU m=%d condTol=%g rank=%d rcond=%g\n",
-    //    PVwrt.ncol(), conditioningTol, PVwr_qtz.getRank(),
-    //    PVwr_qtz.getRCondEstimate());
+    // The matrix is block diagonal, like the one in projectQ(). An old 
+    // factorization must be used with the scaling it was made with.
+    const SBProjectionFactorCache* pfc = &realizeProjectionBlocks(s);
+    Array_<FactorQTZ> fullNewtonQtz;
+    const Array_<FactorQTZ>* PVwr_qtz = nullptr;
+    const Vector* uScale = &uRelScale;
+    if (useModifiedNewton && pfc->hasUFactor) 
+    {   PVwr_qtz = &pfc->uFactors; uScale = &pfc->uScale; }
+    bool isOldFactor = (PVwr_qtz != nullptr), needRefactor = false;
+    // An old factorization is replaced if the error isn't being reduced at
+    // least this much per iteration.
+    const Real MaxConvergenceRate = Real(0.2);
+    int nFactorizations = 0;
 
     Real prevPVerrNormAchieved = pverrNormAchieved; // watch for divergence
     bool diverged = false;
     const int MaxIterations  = 7;
     do {
-        PVwr_qtz.solve(scaledPVerrs, dfu_WLS);
+        if (!PVwr_qtz || needRefactor) {
+            ++nFactorizations;
+            calcWeightedPVrTranspose(s, pverrWeights, uRelScale, PVwrt);
+            // PVwrt is now Eu^-1 (Pt Vt) Tpv
+
+            // Calculate pseudoinverse (just once per call)
+            if (useModifiedNewton) {
+                pfc = &refactorProjectionU(s, PVwrt, uRelScale, 
+                                           conditioningTol);
+                PVwr_qtz = &pfc->uFactors; uScale = &pfc->uScale;
+            } else {
+                factorProjectionBlocks(pfc->uBlocks, PVwrt, conditioningTol,
+                                       fullNewtonQtz);
+                PVwr_qtz = &fullNewtonQtz; uScale = &uRelScale;
+            }
+            isOldFactor = needRefactor = false;
+        }
+
+        solveProjectionBlocks(pfc->uBlocks, *PVwr_qtz, scaledPVerrs, dfu_WLS);
         lastChangeMadeWRMS = dfu_WLS.normRMS(); // change in weighted norm
 
         // switch back to unweighted du=Eu^-1*du_WLS
         if (hasPrescribedMotion) {
             unpackFreeU(s, dfu_WLS, du);    // zeroes in u_p slots
-            du.rowScaleInPlace(uRelScale); // du=Eu^-1*unpack(dfu_WLS)
+            du.rowScaleInPlace(*uScale); // du=Eu^-1*unpack(dfu_WLS)
         } else {
-            du = dfu_WLS.rowScale(uRelScale); // unscale: du=Eu^-1*du_WLS
+            du = dfu_WLS.rowScale(*uScale); // unscale: du=Eu^-1*du_WLS
         }
         updU(s) -= du;
         results.setAnyChangeMade(true);
@@ -4838,8 +5531,20 @@ int SimbodyMatterSubsystemRep::projectU
         pverrNormAchieved = useNormInf ? scaledPVerrs.normInf()
                                        : scaledPVerrs.normRMS();
         ++nItsUsed;
-
-        if (localOnly && nItsUsed >= 2 
+        if (isOldFactor && pverrNormAchieved 
+                           > MaxConvergenceRate*prevPVerrNormAchieved) {
+            // The factorization from an earlier call isn't good enough here;
+            // make a new one. If the norm got worse, first undo the step.
+            needRefactor = true;
+            if (pverrNormAchieved > prevPVerrNormAchieved) {
+                updU(s) += du;
+                realizeSubsystemVelocity(s); // pvErrs changes here
+                scaledPVerrs = pvErrs.rowScale(pverrWeights);
+                pverrNormAchieved = useNormInf ? scaledPVerrs.normInf()
+                                               : scaledPVerrs.normRMS();
+            }
+        }
+        else if (localOnly && nItsUsed >= 2 
             && pverrNormAchieved > prevPVerrNormAchieved) {
             // Velocity norm worse -- restore to end of previous iteration.
             updU(s) += du;
@@ -4857,6 +5562,7 @@ int SimbodyMatterSubsystemRep::projectU
                 && nItsUsed < MaxIterations);
 
     results.setNumIterations(nItsUsed);
+    results.setNumFactorizations(nFactorizations);
 
     // Make sure we achieved at least the required constraint accuracy. If not 
     // we'll return with an error. If we see that the norm has been made worse
@@ -4921,14 +5627,16 @@ int SimbodyMatterSubsystemRep::projectU
             multiplyByPVA(s,true,true,false,bias_pv,
                             uErrest_0,Tpv_PV_uErrest);
             Tpv_PV_uErrest.rowScaleInPlace(pverrWeights); // = Tpv*PV*uErrest_0
-            PVwr_qtz.solve(Tpv_PV_uErrest, dfu_WLS);
+            solveProjectionBlocks(pfc->uBlocks, *PVwr_qtz, 
+                                  Tpv_PV_uErrest, dfu_WLS);
             unpackFreeU(s, dfu_WLS, du); // still weighted
         } else {
             multiplyByPVA(s,true,true,false,bias_pv,uErrest,Tpv_PV_uErrest);
             Tpv_PV_uErrest.rowScaleInPlace(pverrWeights); // = Tpv PV uErrEst
-            PVwr_qtz.solve(Tpv_PV_uErrest, du);
+            solveProjectionBlocks(pfc->uBlocks, *PVwr_qtz, 
+                                  Tpv_PV_uErrest, du);
         }
-        du.rowScaleInPlace(uRelScale); // now du=Eu^-1*unpack(dfu_WLS)
+        du.rowScaleInPlace(*uScale); // now du=Eu^-1*unpack(dfu_WLS)
         uErrest -= du; // this is unweighted now
     }
    
@@ -5107,32 +5815,13 @@ void SimbodyMatterSubsystemRep::calcLoopForwardDynamicsOperator
     if (m==0) return;
     if (nu==0) {multipliers.setToZero(); return;}
 
-    // Conditioning tolerance. This determines when we'll drop a 
-    // constraint. 
-    // TODO: this is probably too tight; should depend on constraint tolerance
-    // and should be consistent with position and velocity projection ranks.
-    // Tricky here because conditioning depends on mass matrix as well as
-    // constraints.
-    const Real conditioningTol = m 
-        //* SignificantReal;
-        * SqrtEps*std::sqrt(SqrtEps); // Eps^(3/4)
-
     // Calculate multipliers lambda as
     //     (G M^-1 ~G) lambda = aerr
-    // The method here calculates the mXm matrix G*M^-1*G^T as fast as 
-    // I know how to do, O(m*n) with O(n) temporary memory, using a series
-    // of O(n) operators. Then we'll factor it here in O(m^3) time. 
-    Matrix GMInvGt(m,m);
-    calcGMInvGt(s, GMInvGt);
-    
-    // specify 1/cond at which we declare rank deficiency
-    FactorQTZ qtz(GMInvGt, conditioningTol); 
-
-    //printf("fwdDynamics: m=%d condTol=%g rank=%d rcond=%g\n",
-    //    GMInvGt.nrow(), conditioningTol, qtz.getRank(),
-    //    qtz.getRCondEstimate());
-
-    qtz.solve(udotErr, multipliers);
+    // The mXm matrix G*M^-1*G^T is calculated in O(m*n) time using a series
+    // of O(n) operators, then factored in O(m^3) time (less if it splits
+    // into independent blocks). The factorization is kept in the State and
+    // reused as long as it is still valid.
+    solveGMInvGt(s, udotErr, multipliers);
 
     // We have the multipliers, now turn them into forces.
 
@@ -5220,9 +5909,9 @@ void SimbodyMatterSubsystemRep::realizeY(const State& s) const {
     const SBArticulatedBodyInertiaCache&  abc = getArticulatedBodyInertiaCache(s);
     SBDynamicsCache&                      dc  = updDynamicsCache(s);
 
-    for (int i=0; i < (int)rbNodeLevels.size(); i++)
-        for (int j=0; j < (int)rbNodeLevels[i].size(); j++)
-            rbNodeLevels[i][j]->realizeYOutward(ic,tpc,abc,dc);
+    forEachNodeRunBaseToTip([&](const RigidBodyNode* const* run, int n) {
+        run[0]->realizeYOutwardRun(run,n,ic,tpc,abc,dc);
+    });
 }
 //.................................. REALIZE Y .................................
 
@@ -5324,22 +6013,19 @@ void SimbodyMatterSubsystemRep::calcTreeAccelerations(const State& s,
     for (int i=0; i < (int)ic.zeroUDot.size(); ++i)
         udotPtr[ic.zeroUDot[i]] = 0;
 
-    for (int i=rbNodeLevels.size()-1 ; i>=0 ; i--) 
-        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++) {
-            const RigidBodyNode& node = *rbNodeLevels[i][j];
-            node.calcUDotPass1Inward(ic,tpc,abc,abvc,
-                mobilityForcePtr, bodyForcePtr, udotPtr, zPtr, zPlusPtr,
-                hingeForcePtr);
-        }
+    forEachNodeRunTipToBase([&](const RigidBodyNode* const* run, int n) {
+        run[0]->calcUDotPass1InwardRun(run,n,ic,tpc,abc,abvc,
+            mobilityForcePtr, bodyForcePtr, udotPtr, zPtr, zPlusPtr,
+            hingeForcePtr);
+    });
 
-    for (int i=0 ; i<(int)rbNodeLevels.size() ; i++)
-        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++) {
-            const RigidBodyNode& node = *rbNodeLevels[i][j];
-            node.calcUDotPass2Outward(ic,tpc,abc,tvc,dc, 
-                hingeForcePtr, aPtr, udotPtr, tauPtr);
-            node.calcQDotDot(sbs, &udotPtr[node.getUIndex()], 
-                             &qdotdotPtr[node.getQIndex()]);
-        }
+    forEachNodeRunBaseToTip([&](const RigidBodyNode* const* run, int n) {
+        run[0]->calcUDotPass2OutwardRun(run,n,ic,tpc,abc,tvc,dc, 
+            hingeForcePtr, aPtr, udotPtr, tauPtr);
+        for (int j=0; j < n; ++j)
+            run[j]->calcQDotDot(sbs, &udotPtr[run[j]->getUIndex()], 
+                                &qdotdotPtr[run[j]->getQIndex()]);
+    });
 }
 //......................... CALC TREE ACCELERATIONS ............................
 
@@ -5384,21 +6070,64 @@ void SimbodyMatterSubsystemRep::multiplyByMInv(const State& s,
     const Real* fPtr     = &f[0];       
     Real*       MInvfPtr = &MInvf[0];
 
+    for (int i=sameTypeNodeRuns.size()-1 ; i>=0 ; i--) 
+        for (const RBNodePtrList& run : sameTypeNodeRuns[i])
+            run[0]->multiplyByMInvPass1InwardRun(run.cbegin(),(int)run.size(),
+                ic,tpc,abc, fPtr, z.begin(), zPlus.begin(), eps.begin());
+
+    for (int i=0 ; i<(int)sameTypeNodeRuns.size() ; i++)
+        for (const RBNodePtrList& run : sameTypeNodeRuns[i])
+            run[0]->multiplyByMInvPass2OutwardRun(run.cbegin(),(int)run.size(),
+                ic,tpc,abc, eps.cbegin(), A_GB.begin(), MInvfPtr);
+}
+//............................. CALC M INVERSE F ...............................
+
+// Multiple right hand side version. The temporaries for each column are
+// kept side by side so that a node's articulated body quantities, once
+// fetched, are applied to all the columns before moving on.
+void SimbodyMatterSubsystemRep::multiplyByMInv(const State& s,
+    const Matrix&                                           F,
+    Matrix&                                                 MInvF) const 
+{
+    const SBInstanceCache&                  ic  = getInstanceCache(s);
+    const SBTreePositionCache&              tpc = getTreePositionCache(s);
+
+    realizeArticulatedBodyInertias(s); // (may already have been realized)
+    const SBArticulatedBodyInertiaCache&    abc = getArticulatedBodyInertiaCache(s);
+
+    const int nb = getNumBodies();
+    const int nu = getNU(s);
+    const int ncol = F.ncol();
+
+    assert(F.nrow() == nu);
+
+    MInvF.resize(nu, ncol);
+    if (nu==0 || ncol==0)
+        return;
+
+    assert(F(0).hasContiguousData());
+    assert(MInvF(0).hasContiguousData());
+
+    // Temporaries, one set per column.
+    Array_<Real>        eps(nu*ncol);
+    Array_<SpatialVec>  z(nb*ncol), zPlus(nb*ncol), A_GB(nb*ncol);
+
     for (int i=rbNodeLevels.size()-1 ; i>=0 ; i--) 
         for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++) {
             const RigidBodyNode& node = *rbNodeLevels[i][j];
-            node.multiplyByMInvPass1Inward(ic,tpc,abc,
-                fPtr, z.begin(), zPlus.begin(), eps.begin());
+            for (int c=0; c < ncol; ++c)
+                node.multiplyByMInvPass1Inward(ic,tpc,abc, &F(0,c),
+                    z.begin()+c*nb, zPlus.begin()+c*nb, eps.begin()+c*nu);
         }
 
     for (int i=0 ; i<(int)rbNodeLevels.size() ; i++)
         for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++) {
             const RigidBodyNode& node = *rbNodeLevels[i][j];
-            node.multiplyByMInvPass2Outward(ic,tpc,abc, 
-                eps.cbegin(), A_GB.begin(), MInvfPtr);
+            for (int c=0; c < ncol; ++c)
+                node.multiplyByMInvPass2Outward(ic,tpc,abc, 
+                    eps.cbegin()+c*nu, A_GB.begin()+c*nb, &MInvF(0,c));
         }
 }
-//............................. CALC M INVERSE F ...............................
 
 
 
@@ -5446,6 +6175,44 @@ void SimbodyMatterSubsystemRep::multiplyByM(const State&    s,
         }
 }
 
+// Multiple right hand side version; see multiplyByMInv() above. 
+void SimbodyMatterSubsystemRep::multiplyByM(const State&    s,
+                                            const Matrix&   A,
+                                            Matrix&         MA) const 
+{
+    const SBTreePositionCache& tpc = getTreePositionCache(s);
+    const int nb = getNumBodies();
+    const int nu = getNU(s);
+    const int ncol = A.ncol();
+
+    assert(A.nrow() == nu);
+    MA.resize(nu, ncol);
+
+    if (nu==0 || ncol==0)
+        return;
+
+    assert(A(0).hasContiguousData());
+    assert(MA(0).hasContiguousData());
+
+    // Temporaries, one set per column.
+    Array_<SpatialVec>  fTmp(nb*ncol), A_GB(nb*ncol);
+
+    for (int i=0 ; i<(int)rbNodeLevels.size() ; i++)
+        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++) {
+            const RigidBodyNode& node = *rbNodeLevels[i][j];
+            for (int c=0; c < ncol; ++c)
+                node.multiplyByMPass1Outward(tpc, &A(0,c), A_GB.begin()+c*nb);
+        }
+
+    for (int i=rbNodeLevels.size()-1 ; i>=0 ; i--) 
+        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++) {
+            const RigidBodyNode& node = *rbNodeLevels[i][j];
+            for (int c=0; c < ncol; ++c)
+                node.multiplyByMPass2Inward(tpc, A_GB.cbegin()+c*nb,
+                                            fTmp.begin()+c*nb, &MA(0,c));
+        }
+}
+
 
 
 //==============================================================================
@@ -5482,6 +6249,150 @@ void SimbodyMatterSubsystemRep::calcM(const State& s, Matrix& M) const {
 
 
 
+//==============================================================================
+//                           CALC M FACTOR SPARSE
+//==============================================================================
+// Factor M = ~L*L using the tree-sparse algorithm from R. Featherstone,
+// "Efficient Factorization of the Joint-Space Inertia Matrix for Branched
+// Kinematic Trees", Int. J. Robotics Research 24(6), 2005. The elements of
+// M that can be nonzero are formed directly from the composite body inertias
+// then factored in place from the last mobility to the first. There is no
+// fill-in, so the cost is O(n*d^2) for a tree of depth d (in mobilities)
+// rather than O(n^3). Member solveM() then uses the factor to obtain M^-1*f
+// in about 4*nnz flops.
+void SimbodyMatterSubsystemRep::calcMFactorSparse(const State& s) const {
+    const CacheEntryIndex mfx = topologyCache.massMatrixFactorCacheIndex;
+    if (isCacheValueRealized(s, mfx))
+        return; // already realized
+
+    realizeCompositeBodyInertias(s); // fails if no position kinematics
+
+    const SBTreePositionCache&         tpc = getTreePositionCache(s);
+    const SBCompositeBodyInertiaCache& cbc = getCompositeBodyInertiaCache(s);
+    SBMassMatrixFactorCache& mfc = Value<SBMassMatrixFactorCache>::
+                                        updDowncast(updCacheEntry(s, mfx));
+
+    const int nb = getNumBodies();
+    const int nu = getTotalDOF();
+
+    // Determine the sparsity pattern if we haven't already; it doesn't 
+    // change until the next Instance-stage change.
+    if ((int)mfc.mobParent.size() != nu) {
+        mfc.mobParent.resize(nu); mfc.depth.resize(nu); 
+        mfc.rowStart.resize(nu+1);
+        Array_<int,MobilizedBodyIndex> lastMob(nb, -1);
+        int nnz = 0;
+        for (MobilizedBodyIndex mbx(1); mbx < nb; ++mbx) {
+            const RigidBodyNode& node = getRigidBodyNode(mbx);
+            const MobilizedBodyIndex px = node.getParent()->getNodeNum();
+            int parent = lastMob[px];
+            for (int j=0; j < node.getDOF(); ++j) {
+                const int k = node.getUIndex() + j;
+                mfc.mobParent[k] = parent;
+                mfc.depth[k] = parent < 0 ? 0 : mfc.depth[parent] + 1;
+                mfc.rowStart[k] = nnz;
+                nnz += mfc.depth[k];
+                parent = k;
+            }
+            lastMob[mbx] = parent;
+        }
+        mfc.rowStart[nu] = nnz;
+        mfc.diag.resize(nu);
+        mfc.offDiag.resize(nnz);
+    }
+
+    // Form the lower triangle of M. For mobility k=(B,a), column a of B's
+    // hinge matrix H_B times B's composite body inertia is the spatial force
+    // needed at Bo to produce a unit udot_k. Element M(k,j) is the dot
+    // product of that force, shifted to the mobilizer of j, with j's H
+    // column.
+    for (MobilizedBodyIndex mbx(1); mbx < nb; ++mbx) {
+        const RigidBodyNode& node = getRigidBodyNode(mbx);
+        const SpatialInertia& R = node.getR(cbc);
+        const Vec3& p_GB = node.getX_GB(tpc).p();
+        for (int a=0; a < node.getDOF(); ++a) {
+            const int k = node.getUIndex() + a;
+            SpatialVec F = R * node.getHCol(tpc, a);
+            mfc.diag[k] = ~node.getHCol(tpc, a) * F;
+            Real* row = mfc.offDiag.begin() + mfc.rowStart[k];
+            for (int b=a-1; b >= 0; --b)
+                *row++ = ~node.getHCol(tpc, b) * F;
+            Vec3 p_GF = p_GB; // point at which F is applied
+            for (const RigidBodyNode* anc = node.getParent(); 
+                 anc->getParent(); anc = anc->getParent())
+            {
+                const Vec3& p_GA = anc->getX_GB(tpc).p();
+                F[0] += (p_GF - p_GA) % F[1]; // shift moment to Ao
+                p_GF = p_GA;
+                for (int c=anc->getDOF()-1; c >= 0; --c)
+                    *row++ = ~anc->getHCol(tpc, c) * F;
+            }
+        }
+    }
+
+    // Factor in place, tip to base. 
+    for (int k=nu-1; k >= 0; --k) {
+        SimTK_ERRCHK1_ALWAYS(mfc.diag[k] > 0,
+            "SimbodyMatterSubsystem::calcMFactorSparse()",
+            "The mass matrix is not positive definite (pivot for mobility %d "
+            "is not positive).", k);
+        const Real Lkk = std::sqrt(mfc.diag[k]);
+        mfc.diag[k] = Lkk;
+        const int dk = mfc.depth[k];
+        Real* rowk = mfc.offDiag.begin() + mfc.rowStart[k];
+        for (int m=0; m < dk; ++m)
+            rowk[m] /= Lkk;
+        // Update the rows of the ancestors of k.
+        int i = mfc.mobParent[k];
+        for (int m=0; m < dk; ++m, i = mfc.mobParent[i]) {
+            const Real Lki = rowk[m];
+            mfc.diag[i] -= Lki*Lki;
+            Real* rowi = mfc.offDiag.begin() + mfc.rowStart[i];
+            for (int n=m+1; n < dk; ++n)
+                rowi[n-m-1] -= Lki*rowk[n];
+        }
+    }
+
+    markCacheValueRealized(s, mfx);
+}
+
+// Solve M*x = f using the sparse factor, as ~L*y = f then L*x = y. It is OK
+// for f and x to be the same Vector, or non-contiguous.
+void SimbodyMatterSubsystemRep::
+solveM(const State& s, const Vector& f, Vector& x) const {
+    const int nu = getTotalDOF();
+    SimTK_ERRCHK2_ALWAYS(f.size() == nu, "SimbodyMatterSubsystem::solveM()",
+        "The supplied right hand side had length %d; expected %d.", 
+        f.size(), nu);
+
+    calcMFactorSparse(s);
+    const SBMassMatrixFactorCache& mfc = Value<SBMassMatrixFactorCache>::
+        downcast(getCacheEntry(s, topologyCache.massMatrixFactorCacheIndex));
+
+    if (&x != &f) 
+        x = f;
+
+    // ~L is upper triangular; work from the last mobility to the first.
+    for (int k=nu-1; k >= 0; --k) {
+        x[k] /= mfc.diag[k];
+        const Real* rowk = mfc.offDiag.cbegin() + mfc.rowStart[k];
+        int i = mfc.mobParent[k];
+        for (int m=0; m < mfc.depth[k]; ++m, i = mfc.mobParent[i])
+            x[i] -= rowk[m]*x[k];
+    }
+
+    // L is lower triangular; work from the first mobility to the last.
+    for (int k=0; k < nu; ++k) {
+        const Real* rowk = mfc.offDiag.cbegin() + mfc.rowStart[k];
+        int i = mfc.mobParent[k];
+        for (int m=0; m < mfc.depth[k]; ++m, i = mfc.mobParent[i])
+            x[k] -= rowk[m]*x[i];
+        x[k] /= mfc.diag[k];
+    }
+}
+
+
+
 //==============================================================================
 //                                CALC MInv
 //==============================================================================
@@ -5614,6 +6525,85 @@ void SimbodyMatterSubsystemRep::calcTreeResidualForces(const State& s,
                 tempPtr,residualPtr);
         }
 }
+
+// Multiple right hand side version. The applied forces are the same for
+// every column of knownUdot.
+void SimbodyMatterSubsystemRep::calcTreeResidualForces(const State& s,
+    const Vector&              appliedMobilityForces,
+    const Vector_<SpatialVec>& appliedBodyForces,
+    const Matrix&              knownUdot,
+    Matrix&                    residualMobilityForces) const
+{
+    const SBTreePositionCache& tpc = getTreePositionCache(s);
+    const SBTreeVelocityCache& tvc = getTreeVelocityCache(s);
+
+    const int nb = getNumBodies();
+    const int nu = getNumMobilities();
+    const int ncol = knownUdot.ncol();
+
+    const Vector*              pAppliedMobForces  = &appliedMobilityForces;
+    const Vector_<SpatialVec>* pAppliedBodyForces = &appliedBodyForces;
+
+    Vector              zeroPerMobility;
+    Vector_<SpatialVec> zeroPerBody;
+    if (appliedMobilityForces.size()==0) {
+        zeroPerMobility.resize(nu);
+        zeroPerMobility = 0;
+        pAppliedMobForces = &zeroPerMobility;
+    }
+    if (appliedBodyForces.size()==0) {
+        zeroPerBody.resize(nb);
+        zeroPerBody = SpatialVec(Vec3(0),Vec3(0));
+        pAppliedBodyForces = &zeroPerBody;
+    }
+
+    assert(pAppliedMobForces->size()  == nu);
+    assert(pAppliedBodyForces->size() == nb);
+    assert(knownUdot.nrow()           == nu);
+
+    residualMobilityForces.resize(nu, ncol);
+    if (ncol == 0)
+        return;
+
+    assert(pAppliedMobForces->hasContiguousData());
+    assert(pAppliedBodyForces->hasContiguousData());
+    assert(knownUdot(0).hasContiguousData());
+    assert(residualMobilityForces(0).hasContiguousData());
+
+    const Real* mobilityForcePtr = nu ? &(*pAppliedMobForces)[0] : NULL;
+    const SpatialVec* bodyForcePtr = &(*pAppliedBodyForces)[0];
+
+    // Temporaries, one set per column.
+    Array_<SpatialVec> A_GB(nb*ncol), allFTmp(nb*ncol);
+
+    // With nu==0 the udot and residual columns have no data; the nodes 
+    // never dereference these in that case.
+    Array_<const Real*> udotPtr(ncol, (const Real*)NULL);
+    Array_<Real*>       residPtr(ncol, (Real*)NULL);
+    if (nu) 
+        for (int c=0; c < ncol; ++c) {
+            udotPtr[c]  = &knownUdot(0,c);
+            residPtr[c] = &residualMobilityForces(0,c);
+        }
+
+    for (int i=0 ; i<(int)rbNodeLevels.size() ; i++)
+        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++) {
+            const RigidBodyNode& node = *rbNodeLevels[i][j];
+            for (int c=0; c < ncol; ++c)
+                node.calcBodyAccelerationsFromUdotOutward
+                   (tpc,tvc,udotPtr[c],A_GB.begin()+c*nb);
+        }
+
+    for (int i=rbNodeLevels.size()-1 ; i>=0 ; i--) 
+        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++) {
+            const RigidBodyNode& node = *rbNodeLevels[i][j];
+            for (int c=0; c < ncol; ++c)
+                node.calcInverseDynamicsPass2Inward(
+                    tpc,tvc,A_GB.cbegin()+c*nb,
+                    mobilityForcePtr,bodyForcePtr,
+                    allFTmp.begin()+c*nb,residPtr[c]);
+        }
+}
 //........................ CALC TREE RESIDUAL FORCES ...........................
 
 
@@ -6397,6 +7387,29 @@ void SimbodyMatterSubsystemRep::setShowDefaultGeometry(bool show) {
     showDefaultGeometry = show;
 }
 
+void SimbodyMatterSubsystemRep::setNumberOfThreads(unsigned numThreads) {
+    SimTK_APIARGCHECK_ALWAYS(numThreads > 0, "SimbodyMatterSubsystem",
+                "setNumberOfThreads", "Number of threads must be positive");
+    this->numThreads = (int)numThreads;
+    if (numThreads == 1)
+        levelExecutor.reset();
+    else
+        levelExecutor = new ParallelExecutor((int)numThreads);
+}
+
+int SimbodyMatterSubsystemRep::getNumberOfThreads() const {
+    return numThreads;
+}
+
+void SimbodyMatterSubsystemRep::
+setUseIncrementalPositionKinematics(bool useIncremental) {
+    incrementalPositionKinematics = useIncremental;
+}
+
+bool SimbodyMatterSubsystemRep::getUseIncrementalPositionKinematics() const {
+    return incrementalPositionKinematics;
+}
+
 std::ostream& operator<<(std::ostream& o, const SimbodyMatterSubsystemRep& tree) {
     o << "SimbodyMatterSubsystemRep has " << tree.getNumBodies() << " bodies (incl. G) in "
       << tree.rbNodeLevels.size() << " levels." << std::endl;
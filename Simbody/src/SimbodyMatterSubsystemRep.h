@@ -490,6 +490,38 @@ public:
                  const ProjectOptions& opts,
                  ProjectResults& results) const;
 
+    // Return the State's projection factor cache after making sure it holds
+    // the projection block structure for the current Instance. Any 
+    // factorizations saved before an Instance-stage change are forgotten.
+    const SBProjectionFactorCache& 
+    realizeProjectionBlocks(const State& s) const;
+
+    // Factor a projection iteration matrix block by block, given its 
+    // transpose At (nVars X nEqns). If parallel sweeps are enabled the
+    // blocks are factored concurrently.
+    void factorProjectionBlocks(const SBProjectionBlocks& blocks, 
+                                const Matrix&             At,
+                                Real                      conditioningTol,
+                                Array_<FactorQTZ>&        factors) const;
+
+    // Solve for the least squares x (nVars) given rhs (nEqns) using the block
+    // factors. Variables that aren't in any block get zero.
+    void solveProjectionBlocks(const SBProjectionBlocks& blocks, 
+                               const Array_<FactorQTZ>&  factors,
+                               const Vector&             rhs,
+                               Vector&                   x) const;
+
+    // Factor a projection iteration matrix, given its transpose, and keep
+    // the factorization in the State's projection factor cache for reuse by
+    // later modified Newton iterations. These are used by projectQ() and
+    // projectU().
+    const SBProjectionFactorCache& 
+    refactorProjectionQ(const State& s, const Matrix& Pqwrt,
+                        Real conditioningTol) const;
+    const SBProjectionFactorCache& 
+    refactorProjectionU(const State& s, const Matrix& PVwrt,
+                        const Vector& uScale, Real conditioningTol) const;
+
         // REALIZATIONS //
 
 
@@ -588,6 +620,12 @@ public:
         const Vector&             a,
         Vector&                   Ma) const;
 
+    // Same as above but for all the columns of A at once. A's columns must
+    // be contiguous; MA is resized to match A.
+    void multiplyByM(const State& s,
+        const Matrix&             A,
+        Matrix&                   MA) const;
+
     // Multiply by the mass matrix inverse in O(n) time. Works only with the
     // non-prescribed submatrix Mrr of M; entries f_p in f are not accessed,
     // and entries MInvf_p in MInvf are not written.
@@ -595,6 +633,13 @@ public:
         const Vector&                   f,
         Vector&                         MInvf) const; 
 
+    // Same as above but for all the columns of F at once, with each sweep
+    // processing every column at one node before moving to the next. F's
+    // columns must be contiguous; MInvF is resized to match F.
+    void multiplyByMInv(const State&    s,
+        const Matrix&                   F,
+        Matrix&                         MInvF) const; 
+
     // Calculate the mass matrix in O(n^2) time. State must have already
     // been realized to Position stage. M must be resizeable or already the
     // right size (nXn). The result is symmetric but the entire matrix is
@@ -608,6 +653,12 @@ public:
     // are not written.
     void calcMInv(const State& s, Matrix& MInv) const;
 
+    // Factor M=~L*L exploiting the tree structure (no fill-in) and cache the
+    // factor in the State, then use it to solve M*x=f. The factor is 
+    // recomputed only after q or Instance-stage changes.
+    void calcMFactorSparse(const State& s) const;
+    void solveM(const State& s, const Vector& f, Vector& x) const;
+
     void calcTreeResidualForces(const State&,
         const Vector&               appliedMobilityForces,
         const Vector_<SpatialVec>&  appliedBodyForces,
@@ -615,6 +666,15 @@ public:
         Vector_<SpatialVec>&        A_GB,
         Vector&                     residualMobilityForces) const;
 
+    // Same as above but for each column of knownUdot, with the applied 
+    // forces shared by all columns. Zero-length applied forces are treated
+    // as zero; knownUdot's columns must be contiguous.
+    void calcTreeResidualForces(const State&,
+        const Vector&               appliedMobilityForces,
+        const Vector_<SpatialVec>&  appliedBodyForces,
+        const Matrix&               knownUdot,
+        Matrix&                     residualMobilityForces) const;
+
 
 
     // Must be in Stage::Position to calculate out_q = N(q)*in_u (e.g., qdot=N*u)
@@ -944,6 +1004,15 @@ public:
                                     const Vector&    deltaV,
                                     Vector&          impulse) const;
 
+    // Solve (G M^-1 ~G) x = rhs using a factorization of G M^-1 ~G that is
+    // saved in the State and reused until t, q, Instance-stage information
+    // or (unless all constraints are holonomic) u change. The matrix is
+    // block diagonal with a block for each group of constraints that act on
+    // independent subtrees, and each block is factored separately.
+    void solveGMInvGt(const State&  state,
+                      const Vector& rhs,
+                      Vector&       x) const;
+
     // Given an array of nu udots, return nb body accelerations in G (including
     // Ground as the 0th body with A_GB[0]=0). The returned accelerations are
     // A = J*udot + Jdot*u, with the Jdot*u (coriolis acceleration) term
@@ -1067,6 +1136,20 @@ public:
             (updCacheEntry(s,topologyCache.compositeBodyInertiaCacheIndex));
     }
 
+    SBMassMatrixFactorCache& updMassMatrixFactorCache(const State& s) const { //mutable
+        return Value<SBMassMatrixFactorCache>::updDowncast
+            (updCacheEntry(s,topologyCache.massMatrixFactorCacheIndex));
+    }
+
+    const SBProjectionFactorCache& getProjectionFactorCache(const State& s) const {
+        return Value<SBProjectionFactorCache>::downcast
+            (getCacheEntry(s,topologyCache.projectionFactorCacheIndex));
+    }
+    SBProjectionFactorCache& updProjectionFactorCache(const State& s) const { //mutable
+        return Value<SBProjectionFactorCache>::updDowncast
+            (updCacheEntry(s,topologyCache.projectionFactorCacheIndex));
+    }
+
     const SBArticulatedBodyInertiaCache& getArticulatedBodyInertiaCache(const State& s) const {
         return Value<SBArticulatedBodyInertiaCache>::downcast
             (getCacheEntry(s,topologyCache.articulatedBodyInertiaCacheIndex));
@@ -1210,6 +1293,12 @@ public:
     bool getShowDefaultGeometry() const;
     void setShowDefaultGeometry(bool show);
 
+    void setNumberOfThreads(unsigned numThreads);
+    int getNumberOfThreads() const;
+
+    void setUseIncrementalPositionKinematics(bool useIncremental);
+    bool getUseIncrementalPositionKinematics() const;
+
     void calcTreeForwardDynamicsOperator(const State&,
         const Vector&                   mobilityForces,
         const Vector_<Vec3>&            particleForces,
@@ -1364,6 +1453,47 @@ private:
     // Map nodeNum (a.k.a. MobilizedBodyIndex) to (level,offset).
     Array_<RigidBodyNodeIndex,MobilizedBodyIndex> nodeNum2NodeMap;
 
+    // Groups of non-Ground nodes that are not coupled by the tree or by any
+    // Constraint, each in base-to-tip order. See findIndependentSubtrees().
+    Array_<RBNodePtrList>      independentSubtrees;
+    // The independent subtree containing each Constraint's bodies, or -1
+    // for a Constraint that involves only Ground.
+    Array_<int,ConstraintIndex> constraintSubtree;
+    void findIndependentSubtrees();
+
+    // Apply nodeOp to every node at the given level. The nodes at a level
+    // are independent during a sweep, so this is done in parallel if more
+    // than one thread has been requested. Any exception thrown by nodeOp is
+    // rethrown here on the calling thread.
+    template <class NodeOp>
+    void forEachNodeAtLevel(int level, const NodeOp& nodeOp) const;
+    bool useParallelSweeps() const;
+
+    // Apply nodeOp to every node (including Ground) in an order that visits
+    // parents before children (BaseToTip) or children before parents 
+    // (TipToBase). If parallel sweeps are enabled and there are several
+    // independent subtrees, each subtree is a separate task; otherwise we
+    // go level by level using forEachNodeAtLevel().
+    template <class NodeOp>
+    void forEachNodeBaseToTip(const NodeOp& nodeOp) const;
+    template <class NodeOp>
+    void forEachNodeTipToBase(const NodeOp& nodeOp) const;
+
+    // The nodes at each level grouped into runs of the same concrete type,
+    // so that a serial sweep can make one virtual call per run rather than
+    // one per node. See findSameTypeNodeRuns().
+    Array_< Array_<RBNodePtrList> > sameTypeNodeRuns;
+    void findSameTypeNodeRuns();
+
+    // Like forEachNodeBaseToTip() and forEachNodeTipToBase() but runOp is
+    // given a run of same-type nodes (const RigidBodyNode* const*, int) to 
+    // pass on to one of the batched RigidBodyNode "Run" methods. When the
+    // sweep is done in parallel, each run is a single node.
+    template <class RunOp>
+    void forEachNodeRunBaseToTip(const RunOp& runOp) const;
+    template <class RunOp>
+    void forEachNodeRunTipToBase(const RunOp& runOp) const;
+
         // Constraints
 
     // Here we sort the above constraints by branch (ancestor's base body), then by
@@ -1436,6 +1566,15 @@ private:
     
     // Specifies whether default decorative geometry should be shown.
     bool showDefaultGeometry;
+
+    // For parallel level-by-level sweeps. The executor is allocated only
+    // when more than one thread is requested; otherwise sweeps are serial.
+    int                                 numThreads = 1;
+    mutable ClonePtr<ParallelExecutor>  levelExecutor;
+
+    // If set, realizePositionKinematics() recomputes only the mobilizers
+    // whose q's changed since the last time, and their descendents.
+    bool                                incrementalPositionKinematics = false;
 };
 
 std::ostream& operator<<(std::ostream&, const SimbodyMatterSubsystemRep&);
@@ -65,9 +65,15 @@ allocated if necessary), and then advance to stage Whatever. */
 
 #include "simbody/internal/common.h"
 #include "simbody/internal/Motion.h"
+#include "simmath/LinearAlgebra.h"
 
 #include <cassert>
+#include <cstddef>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <new>
+#include <type_traits>
 using std::cout; using std::endl;
 
 using namespace SimTK;
@@ -103,6 +109,99 @@ class SBAccelerationVars;
 
 
 
+// =============================================================================
+//                                 CACHE ARENA
+// =============================================================================
+// The arrays of the tree sweep caches below don't change size between calls
+// to their allocate() methods. An SBCacheArena places all of one cache entry's
+// arrays end to end in a single heap block, binding each Array_ to its slice
+// with shareData(). A sweep then walks one compact region of memory, and
+// copying the cache entry (which happens when a copied State is realized)
+// costs one allocation rather than one per array.
+//
+// The owning cache lists its arena arrays once, in a method
+//      template <class V> void forEachArenaArray(V& v, const Cache& src)
+// that calls v(array, src.array) for each of them. The cache's allocate()
+// must unpack() the arrays, resize them as usual, and then pack(*this,*this).
+// Its copy constructor and copy assignment must pack(*this,src). Element
+// types must be trivially destructible because the block is freed without
+// running destructors.
+class SBCacheArena {
+public:
+    SBCacheArena() {}
+    // The owning cache does the copying; see above.
+    SBCacheArena(const SBCacheArena&) {}
+    SBCacheArena& operator=(const SBCacheArena&) {return *this;}
+    ~SBCacheArena() {std::free(block);}
+
+    // Detach the arena arrays, leaving them empty and resizable, and free
+    // the block.
+    template <class Cache> void unpack(Cache& cache) {
+        Unbinder unbind;
+        cache.forEachArenaArray(unbind, cache);
+        std::free(block); block = nullptr;
+    }
+
+    // Make the arena arrays of cache copies of those of src, all in one new
+    // block. cache and src may be the same object.
+    template <class Cache> void pack(Cache& cache, const Cache& src) {
+        Measurer measure;
+        cache.forEachArenaArray(measure, src);
+        char* newBlock = nullptr;
+        if (measure.size) {
+            newBlock = static_cast<char*>(std::malloc(measure.size));
+            if (!newBlock) throw std::bad_alloc();
+        }
+        Binder bind(newBlock);
+        cache.forEachArenaArray(bind, src);
+        std::free(block); // src's data may have been here
+        block = newBlock;
+    }
+
+private:
+    template <class T> static std::size_t alignUp(std::size_t offset) {
+        static_assert(alignof(T) <= alignof(std::max_align_t),
+            "SBCacheArena: element type is over-aligned.");
+        return (offset + alignof(T) - 1) / alignof(T) * alignof(T);
+    }
+
+    struct Measurer {
+        template <class T, class X>
+        void operator()(Array_<T,X>&, const Array_<T,X>& src)
+        {   size = alignUp<T>(size) + src.size()*sizeof(T); }
+        std::size_t size = 0;
+    };
+
+    struct Binder {
+        explicit Binder(char* block) : block(block) {}
+        template <class T, class X>
+        void operator()(Array_<T,X>& dest, const Array_<T,X>& src) {
+            static_assert(std::is_trivially_destructible<T>::value,
+                "SBCacheArena: element type needs a destructor.");
+            const std::size_t n = src.size();
+            if (n == 0) {dest.deallocate(); return;}
+            offset = alignUp<T>(offset);
+            T* data = reinterpret_cast<T*>(block + offset);
+            std::uninitialized_copy(src.cbegin(), src.cend(), data);
+            dest.shareData(data, data + n);
+            offset += n*sizeof(T);
+        }
+        char*       block;
+        std::size_t offset = 0;
+    };
+
+    struct Unbinder {
+        template <class T, class X>
+        void operator()(Array_<T,X>& dest, const Array_<T,X>&)
+        {   dest.deallocate(); }
+    };
+
+    char* block = nullptr;
+};
+//................................ CACHE ARENA .................................
+
+
+
 // =============================================================================
 //                               TOPOLOGY CACHE
 // =============================================================================
@@ -151,12 +250,16 @@ public:
     CacheEntryIndex       modelingCacheIndex,instanceCacheIndex, timeCacheIndex, 
                           treePositionCacheIndex, constrainedPositionCacheIndex,
                           compositeBodyInertiaCacheIndex, 
+                          massMatrixFactorCacheIndex,
                           articulatedBodyInertiaCacheIndex,
                           treeVelocityCacheIndex, constrainedVelocityCacheIndex,
                           articulatedBodyVelocityCacheIndex,
                           dynamicsCacheIndex, 
                           treeAccelerationCacheIndex, 
-                          constrainedAccelerationCacheIndex;
+                          constrainedAccelerationCacheIndex,
+                          holonomicConstraintOperatorCacheIndex,
+                          constraintOperatorCacheIndex,
+                          projectionFactorCacheIndex;
 
 
     // These are instance variables that exist regardless of modeling
@@ -698,17 +801,56 @@ public:
     // the Ancestor frame rather than Ground.
     Array_<Transform> constrainedBodyConfigInAncestor;   // nacb (X_AB)
 
+        // Incremental position kinematics
+
+    // When incremental position kinematics is enabled, these are the q's
+    // for which the above per-body entries were last completely computed.
+    // Only mobilizers whose q's differ from these (and their descendents)
+    // are recomputed. The snapshot is discarded whenever this entry is
+    // reallocated, that is, after any Instance-stage (or lower) change.
+    Vector lastQ;
+    bool   lastQValid = false;
+
 public:
+    SBTreePositionCache() {}
+    SBTreePositionCache(const SBTreePositionCache& src)
+    :   lastQ(src.lastQ), lastQValid(src.lastQValid)
+    {   arena.pack(*this, src); }
+    SBTreePositionCache& operator=(const SBTreePositionCache& src) {
+        if (&src != this) {
+            arena.pack(*this, src);
+            lastQ = src.lastQ; lastQValid = src.lastQValid;
+        }
+        return *this;
+    }
+
+    // All the arrays above live in the arena; see SBCacheArena.
+    template <class V> void forEachArenaArray(V& v,
+                                              const SBTreePositionCache& src) {
+        v(mobilizerQCache, src.mobilizerQCache);
+        v(storageForH_FM, src.storageForH_FM);
+        v(storageForH, src.storageForH);
+        v(bodyJointInParentJointFrame, src.bodyJointInParentJointFrame);
+        v(bodyConfigInParent, src.bodyConfigInParent);
+        v(bodyConfigInGround, src.bodyConfigInGround);
+        v(bodyToParentShift, src.bodyToParentShift);
+        v(bodySpatialInertiaInGround, src.bodySpatialInertiaInGround);
+        v(bodyCOMInGround, src.bodyCOMInGround);
+        v(constrainedBodyConfigInAncestor,
+          src.constrainedBodyConfigInAncestor);
+    }
+
     void allocate(const SBTopologyCache& tree,
                   const SBModelCache&    model,
-                  const SBInstanceCache& instance) 
+                  const SBInstanceCache& instance)
     {
         // Pull out construction-stage information from the tree.
         const int nBodies = tree.nBodies;
         const int nDofs   = tree.nDOFs;   // this is the number of u's (nu)
-        const int maxNQs  = tree.maxNQs;  // allocate the max # q's we'll ever need
         const int nacb    = tree.nAncestorConstrainedBodies;
 
+        arena.unpack(*this);
+
         // These contain uninitialized junk. Body-indexed entries get their
         // ground elements set appropriately now and forever.
 
@@ -738,7 +880,15 @@ public:
         bodyCOMInGround[GroundIndex] = Vec3(0);
 
         constrainedBodyConfigInAncestor.resize(nacb);
+
+        arena.pack(*this, *this);
+
+        lastQ.clear();
+        lastQValid = false;
     }
+
+private:
+    SBCacheArena arena;
 };
 //.......................... TREE POSITION CACHE ...............................
 
@@ -820,6 +970,91 @@ public:
 
 
 
+// =============================================================================
+//                          MASS MATRIX FACTOR CACHE
+// =============================================================================
+// This holds a factorization M = ~L*L of the mobility-space mass matrix that
+// takes advantage of its "tree sparse" structure. Element M(i,j), i>j, can be
+// nonzero only if mobility j belongs to an ancestor of i's mobilizer (or to
+// i's own mobilizer), and the factor L has exactly that same pattern; there is
+// no fill-in. For that we treat the mobilities as a tree in which each one's
+// parent is the previous mobility of the same mobilizer, or else the last
+// mobility of the nearest inboard mobilizer that has any.
+//
+// Row k of L below the diagonal is stored in offDiag starting at rowStart[k],
+// with the elements for mobility k's ancestors in order from the nearest
+// ancestor (mobParent[k]) to the most distant. Like composite body inertias
+// these are not needed internally, so they are computed only on request.
+
+class SBMassMatrixFactorCache {
+public:
+    Array_<int>  mobParent;   // nu; -1 if no ancestor mobility
+    Array_<int>  depth;       // nu; number of ancestor mobilities
+    Array_<int>  rowStart;    // nu+1; index of first element of each row
+    Array_<Real> diag;        // nu; L(k,k)
+    Array_<Real> offDiag;     // rowStart[nu]; L(k,anc) for each ancestor
+
+public:
+    void allocate(const SBTopologyCache& tree,
+                  const SBModelCache&    model,
+                  const SBInstanceCache& instance) 
+    {
+        // The sparsity pattern is filled in the first time the factor is
+        // needed since it requires the RigidBodyNodes.
+        mobParent.clear(); depth.clear(); rowStart.clear();
+        diag.clear(); offDiag.clear();
+    }
+};
+//......................... MASS MATRIX FACTOR CACHE ...........................
+
+
+
+// =============================================================================
+//                          PROJECTION FACTOR CACHE
+// =============================================================================
+// The position and velocity projection iteration matrices are block diagonal
+// (after permuting), with one block for the constraint equations of each 
+// group of Constraints acting on an independent subtree, and the free q's or
+// u's of that subtree. Each block is factored and solved on its own. The
+// block structure is determined when this cache entry is first needed after
+// an Instance-stage change. Free variables of subtrees with no constraint
+// equations are left out of every block, as are equations that involve no
+// free variables; they can't take part in projection.
+//
+// When projectQ() and projectU() are allowed to use modified Newton iterations
+// they keep their factorizations here so that the next call can start from
+// them rather than refactoring. These are deliberately not invalidated when
+// q or u change; the projection methods monitor the rate of convergence and
+// refactor when a stale matrix no longer does the job. The position and 
+// velocity projections solve with different matrices so each has its own
+// factorizations. uScale is the u scaling that was folded into the velocity
+// iteration matrix, which must be used again to unscale solutions.
+
+class SBProjectionBlocks {
+public:
+    Array_< Array_<int> > vars; // packed free q or u indices of each block
+    Array_< Array_<int> > eqns; // constraint equations of each block
+    int  nVars, nEqns;          // full matrix dimensions
+    bool isWhole;               // one block with all variables and equations
+};
+
+class SBProjectionFactorCache {
+public:
+    SBProjectionBlocks  qBlocks;    // (Tp P Wu^-1 N^+)_r
+    SBProjectionBlocks  uBlocks;    // (Tpv [P;V] Eu^-1)_r
+    Array_<FactorQTZ>   qFactors;   // one per q block
+    Array_<FactorQTZ>   uFactors;   // one per u block
+    Vector              uScale;     // nu; Eu^-1 used in uFactors
+    bool                hasQFactor;
+    bool                hasUFactor;
+
+public:
+    SBProjectionFactorCache() : hasQFactor(false), hasUFactor(false) {}
+};
+//......................... PROJECTION FACTOR CACHE ...........................
+
+
+
 // =============================================================================
 //                       ARTICULATED BODY INERTIA CACHE
 // =============================================================================
@@ -875,6 +1110,27 @@ public:
     Array_<Vec3>        storageForG;    // 2 X ndof
 
 public:
+    SBArticulatedBodyInertiaCache() {}
+    SBArticulatedBodyInertiaCache(const SBArticulatedBodyInertiaCache& src)
+    :   storageForD(src.storageForD), storageForDI(src.storageForDI)
+    {   arena.pack(*this, src); }
+    SBArticulatedBodyInertiaCache&
+    operator=(const SBArticulatedBodyInertiaCache& src) {
+        if (&src != this) {
+            arena.pack(*this, src);
+            storageForD = src.storageForD; storageForDI = src.storageForDI;
+        }
+        return *this;
+    }
+
+    // The Arrays (but not the Vectors) live in the arena.
+    template <class V> void forEachArenaArray(V& v,
+        const SBArticulatedBodyInertiaCache& src) {
+        v(articulatedBodyInertia, src.articulatedBodyInertia);
+        v(pPlus, src.pPlus);
+        v(storageForG, src.storageForG);
+    }
+
     void allocate(const SBTopologyCache& tree,
                   const SBModelCache&    model,
                   const SBInstanceCache& instance) 
@@ -883,8 +1139,9 @@ public:
         const int nBodies = tree.nBodies;
         const int nDofs   = tree.nDOFs;     // this is the number of u's (nu)
         const int nSqDofs = tree.sumSqDOFs;   // sum(ndof^2) for each joint
-        const int maxNQs  = tree.maxNQs;  // allocate the max # q's we'll ever need     
-        
+
+        arena.unpack(*this);
+
         articulatedBodyInertia.resize(nBodies); // TODO: ground initialization
 
         pPlus.resize(nBodies); // TODO: ground initialization
@@ -892,7 +1149,12 @@ public:
         storageForD.resize(nSqDofs);
         storageForDI.resize(nSqDofs);
         storageForG.resize(2*nDofs);
+
+        arena.pack(*this, *this);
     }
+
+private:
+    SBCacheArena arena;
 };
 //....................... ARTICULATED BODY INERTIA CACHE .......................
 
@@ -968,9 +1230,35 @@ public:
     Array_<SpatialVec> constrainedBodyVelocityInAncestor; // nacb (V_AB)
 
 public:
+    SBTreeVelocityCache() {}
+    SBTreeVelocityCache(const SBTreeVelocityCache& src)
+    {   arena.pack(*this, src); }
+    SBTreeVelocityCache& operator=(const SBTreeVelocityCache& src) {
+        if (&src != this) arena.pack(*this, src);
+        return *this;
+    }
+
+    // All the arrays above live in the arena; see SBCacheArena.
+    template <class V> void forEachArenaArray(V& v,
+                                              const SBTreeVelocityCache& src) {
+        v(mobilizerRelativeVelocity, src.mobilizerRelativeVelocity);
+        v(bodyVelocityInParent, src.bodyVelocityInParent);
+        v(bodyVelocityInGround, src.bodyVelocityInGround);
+        v(storageForHDot_FM, src.storageForHDot_FM);
+        v(storageForHDot, src.storageForHDot);
+        v(bodyVelocityInParentDerivRemainder,
+          src.bodyVelocityInParentDerivRemainder);
+        v(gyroscopicForces, src.gyroscopicForces);
+        v(mobilizerCoriolisAcceleration, src.mobilizerCoriolisAcceleration);
+        v(totalCoriolisAcceleration, src.totalCoriolisAcceleration);
+        v(totalCentrifugalForces, src.totalCentrifugalForces);
+        v(constrainedBodyVelocityInAncestor,
+          src.constrainedBodyVelocityInAncestor);
+    }
+
     void allocate(const SBTopologyCache& tree,
                   const SBModelCache&    model,
-                  const SBInstanceCache& instance) 
+                  const SBInstanceCache& instance)
     {
         // Pull out construction-stage information from the tree.
         const int nBodies = tree.nBodies;
@@ -978,6 +1266,8 @@ public:
         const int maxNQs  = tree.maxNQs; // allocate max # q's we'll ever need
         const int nacb    = tree.nAncestorConstrainedBodies;
 
+        arena.unpack(*this);
+
         const SpatialVec SVZero(Vec3(0),Vec3(0));
 
         mobilizerRelativeVelocity.resize(nBodies);       
@@ -1008,7 +1298,12 @@ public:
         totalCentrifugalForces[GroundIndex] = SVZero;
 
         constrainedBodyVelocityInAncestor.resize(nacb);
+
+        arena.pack(*this, *this);
     }
+
+private:
+    SBCacheArena arena;
 };
 //............................ TREE VELOCITY CACHE .............................
 
@@ -1401,6 +1696,54 @@ public:
 };
 
 
+
+// =============================================================================
+//                          BINARY STATE SNAPSHOTS
+// =============================================================================
+// Let System::serializeState() save the variables above. The empty ones and
+// the Model vars can be copied bitwise.
+namespace SimTK {
+template <> struct BinaryIO<SBModelVars> 
+:   BinaryIOBitwise<SBModelVars> {};
+template <> struct BinaryIO<SBTimeVars> 
+:   BinaryIOBitwise<SBTimeVars> {};
+template <> struct BinaryIO<SBPositionVars> 
+:   BinaryIOBitwise<SBPositionVars> {};
+template <> struct BinaryIO<SBVelocityVars> 
+:   BinaryIOBitwise<SBVelocityVars> {};
+template <> struct BinaryIO<SBDynamicsVars> 
+:   BinaryIOBitwise<SBDynamicsVars> {};
+template <> struct BinaryIO<SBAccelerationVars> 
+:   BinaryIOBitwise<SBAccelerationVars> {};
+
+template <> struct BinaryIO<SBInstanceVars> {
+    static const bool Supported = true;
+    static void write(BinaryWriter& out, const SBInstanceVars& iv) {
+        out.write(iv.bodyMassProperties);
+        out.write(iv.outboardMobilizerFrames);
+        out.write(iv.inboardMobilizerFrames);
+        out.write(iv.mobilizerLockLevel);
+        out.write(iv.lockedQs);
+        out.write(iv.lockedUs);
+        out.write(iv.prescribedMotionIsDisabled);
+        out.write(iv.particleMasses);
+        out.write(iv.constraintIsDisabled);
+    }
+    static void read(BinaryReader& in, SBInstanceVars& iv) {
+        in.read(iv.bodyMassProperties);
+        in.read(iv.outboardMobilizerFrames);
+        in.read(iv.inboardMobilizerFrames);
+        in.read(iv.mobilizerLockLevel);
+        in.read(iv.lockedQs);
+        in.read(iv.lockedUs);
+        in.read(iv.prescribedMotionIsDisabled);
+        in.read(iv.particleMasses);
+        in.read(iv.constraintIsDisabled);
+    }
+};
+} // namespace SimTK
+
+
     /////////////////////
     // SB STATE DIGEST //
     /////////////////////
@@ -723,6 +723,163 @@ void testConstraintAccelerationErrors() {
     }
 }
 
+// A forest of independent closed loops, so that G M^-1 ~G is block diagonal
+// with more rows than are processed in one batch. Forward dynamics must
+// still satisfy the constraints and the equations of motion, including when
+// the cached factorization is reused after a velocity change.
+void testBlockConstraintOperator() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    Body::Rigid body(MassProperties(1.5, Vec3(.1,.2,-.03), 
+                     UnitInertia(1.1, 1.2, 1.3, .01, -.02, .07)));
+    for (int chain = 0; chain < 5; ++chain) {
+        MobilizedBody parent = matter.updGround();
+        MobilizedBody first;
+        for (int i = 0; i < 4; ++i) {
+            parent = MobilizedBody::Ball(parent, 
+                Vec3(i == 0 ? 3*chain : BOND_LENGTH, 0, 0), body, Vec3(0));
+            if (i == 0) first = parent;
+        }
+        Constraint::Ball(first, Vec3(0, BOND_LENGTH, 0), 
+                         parent, Vec3(BOND_LENGTH, 0, 0));
+        Constraint::ConstantAngle(matter.updGround(), UnitVec3(1,0,0), 
+                                  first, UnitVec3(0,1,0));
+    }
+
+    State state;
+    createState(system, state);
+    SimTK_TEST(state.getNUDotErr() > 16); // more than one batch
+
+    for (int trial = 0; trial < 2; ++trial) {
+        if (trial == 1) {
+            // Same positions, so the cached operator is reused.
+            state.updU() = Test::randVector(state.getNU());
+            system.projectU(state, ConstraintTol);
+            system.realize(state, Stage::Acceleration);
+        }
+        SimTK_TEST_EQ_TOL(state.getUDotErr(), Vector(state.getNUDotErr(), 0.),
+                          1e-10);
+        Vector residual;
+        matter.calcResidualForce(state, Vector(), Vector_<SpatialVec>(),
+            state.getUDot(), state.getMultipliers(), residual);
+        SimTK_TEST_EQ_TOL(residual, Vector(state.getNU(), 0.), 1e-10);
+    }
+}
+
+// Projections made while integrating may reuse an iteration matrix that was
+// factored for an earlier state. They must still reach the required accuracy
+// and stay close to what full Newton iterations would have found; the
+// corrections differ slightly in direction since the Jacobian was not
+// updated.
+void testModifiedNewtonProjection() {
+    State state;
+    MultibodySystem& system = createSystem();
+    SimbodyMatterSubsystem& matter = system.updMatterSubsystem();
+    MobilizedBody& first = matter.updMobilizedBody(MobilizedBodyIndex(1));
+    MobilizedBody& last = matter.updMobilizedBody(MobilizedBodyIndex(NUM_BODIES));
+    Constraint::Ball constraint(first, last);
+    createState(system, state);
+
+    ProjectOptions modified(ConstraintTol);
+    modified.setOption(ProjectOptions::LocalOnly);
+    ProjectOptions full(modified);
+    full.setOption(ProjectOptions::ForceFullNewton);
+
+    // Move smoothly away from the constraint manifold and back again.
+    const Vector dq = 1e-3*Test::randVector(state.getNQ());
+    const Vector du = 1e-3*Test::randVector(state.getNU());
+    State fullState = state;
+    Vector noErrEst;
+    ProjectResults results;
+    const int NumSteps = 20;
+    int numModifiedFactorizations = 0;
+    for (int step = 0; step < NumSteps; ++step) {
+        state.updQ() += dq; state.updU() += du;
+        fullState.updQ() = state.getQ(); fullState.updU() = state.getU();
+        for (int i = 0; i < 2; ++i) {
+            State& s = i == 0 ? state : fullState;
+            const ProjectOptions& opts = i == 0 ? modified : full;
+            system.realize(s, Stage::Position);
+            system.projectQ(s, noErrEst, opts, results);
+            SimTK_TEST(results.getExitStatus() == ProjectResults::Succeeded);
+            if (i == 1) // full Newton refactors on every iteration
+                SimTK_TEST(results.getNumFactorizations()
+                           == results.getNumIterations());
+            int nFactorizations = results.getNumFactorizations();
+            system.realize(s, Stage::Velocity);
+            system.projectU(s, noErrEst, opts, results);
+            SimTK_TEST(results.getExitStatus() == ProjectResults::Succeeded);
+            nFactorizations += results.getNumFactorizations();
+            if (i == 0)
+                numModifiedFactorizations += nFactorizations;
+        }
+        CONSTRAINT_TEST(constraint.getPositionErrors(state).norm(), 0);
+        CONSTRAINT_TEST(constraint.getVelocityErrors(state).norm(), 0);
+        SimTK_TEST_EQ_TOL(state.getQ(), fullState.getQ(), 1e-4);
+        SimTK_TEST_EQ_TOL(state.getU(), fullState.getU(), 1e-4);
+    }
+    // Most projections must have reused an earlier factorization.
+    SimTK_TEST(numModifiedFactorizations < NumSteps);
+    delete &system;
+}
+
+// Mechanisms that aren't coupled by any Constraint are projected as separate
+// blocks. Moving one mechanism off its constraint manifold must not disturb
+// the others, and the result must not depend on whether the blocks are
+// factored in parallel.
+void testBlockProjection() {
+    for (int numThreads = 1; numThreads <= 3; numThreads += 2) {
+        MultibodySystem system;
+        SimbodyMatterSubsystem matter(system);
+        matter.setNumberOfThreads(numThreads);
+        Body::Rigid body(MassProperties(1.5, Vec3(.1,.2,-.03), 
+                         UnitInertia(1.1, 1.2, 1.3, .01, -.02, .07)));
+        Array_<MobilizedBody> firsts;
+        for (int chain = 0; chain < 5; ++chain) {
+            MobilizedBody parent = matter.updGround();
+            MobilizedBody first;
+            for (int i = 0; i < 4; ++i) {
+                parent = MobilizedBody::Ball(parent, 
+                    Vec3(i == 0 ? 3*chain : BOND_LENGTH, 0, 0), body, Vec3(0));
+                if (i == 0) first = parent;
+            }
+            Constraint::Ball(first, Vec3(0, BOND_LENGTH, 0), 
+                             parent, Vec3(BOND_LENGTH, 0, 0));
+            firsts.push_back(first);
+        }
+        // Keep the first chain's base from moving, with a Constraint that 
+        // doesn't couple it to anything else.
+        Constraint::ConstantAngle(matter.updGround(), UnitVec3(1,0,0), 
+                                  firsts[0], UnitVec3(0,1,0));
+
+        State state;
+        createState(system, state);
+        const Vector q0 = state.getQ(), u0 = state.getU();
+
+        // Perturb only the last chain, whose q's and u's come last.
+        const int nqChain = 16, nuChain = 12;
+        const int nq = state.getNQ(), nu = state.getNU();
+        state.updQ()(nq-nqChain, nqChain) += 
+            1e-3*Test::randVector(nqChain);
+        state.updU()(nu-nuChain, nuChain) += 
+            1e-3*Test::randVector(nuChain);
+        system.realize(state, Stage::Velocity);
+        system.project(state, ConstraintTol);
+        system.realize(state, Stage::Velocity);
+
+        SimTK_TEST_EQ_TOL(state.getQErr(), Vector(state.getNQErr(), 0.),
+                          ConstraintTol);
+        SimTK_TEST_EQ_TOL(state.getUErr(), Vector(state.getNUErr(), 0.),
+                          ConstraintTol);
+        // The other chains see only their own (already tiny) errors.
+        SimTK_TEST((state.getQ()(0, nq-nqChain) - q0(0, nq-nqChain))
+                   .normInf() < 10*ConstraintTol);
+        SimTK_TEST((state.getU()(0, nu-nuChain) - u0(0, nu-nuChain))
+                   .normInf() < 10*ConstraintTol);
+        SimTK_TEST((state.getQ() - q0).normInf() > 1e-6);
+    }
+}
+
 int main() {
     SimTK_START_TEST("TestConstraints");
         SimTK_SUBTEST(testBallConstraint);
@@ -738,6 +895,9 @@ int main() {
         SimTK_SUBTEST(testConstraintForces);
         SimTK_SUBTEST(testConstraintMatrices);
         SimTK_SUBTEST(testConstraintAccelerationErrors);
+        SimTK_SUBTEST(testBlockConstraintOperator);
         SimTK_SUBTEST(testDisablingConstraints);
+        SimTK_SUBTEST(testModifiedNewtonProjection);
+        SimTK_SUBTEST(testBlockProjection);
     SimTK_END_TEST();
 }
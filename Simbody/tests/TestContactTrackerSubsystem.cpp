@@ -0,0 +1,212 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKsimbody.h"
+
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace SimTK;
+using namespace std;
+
+#define ASSERT(cond) {SimTK_ASSERT_ALWAYS(cond, "Assertion failed");}
+
+typedef set< pair<int,int> > PairSet;
+
+const Real Radius = Real(0.1);
+
+// Find the overlapping pairs of spheres by checking every pair.
+PairSet findOverlapsByBruteForce(const ContactTrackerSubsystem& tracker,
+                                 const Array_<MobilizedBody>& particles,
+                                 const State& state) {
+    PairSet pairs;
+    for (unsigned i=0; i < particles.size(); ++i) {
+        const Vec3 pi = particles[i].getBodyOriginLocation(state);
+        for (unsigned j=i+1; j < particles.size(); ++j) {
+            const Vec3 pj = particles[j].getBodyOriginLocation(state);
+            if ((pi-pj).norm() < 2*Radius) {
+                int s1 = tracker.getContactSurfaceIndex
+                    (particles[i].getMobilizedBodyIndex(), 0);
+                int s2 = tracker.getContactSurfaceIndex
+                    (particles[j].getMobilizedBodyIndex(), 0);
+                if (s1 > s2) std::swap(s1,s2);
+                pairs.insert(make_pair(s1,s2));
+            }
+        }
+    }
+    return pairs;
+}
+
+PairSet getActivePairs(const ContactTrackerSubsystem& tracker,
+                       const State& state) {
+    const ContactSnapshot& contacts = tracker.getActiveContacts(state);
+    PairSet pairs;
+    for (int i=0; i < contacts.getNumContacts(); ++i) {
+        const Contact& contact = contacts.getContact(i);
+        int s1 = contact.getSurface1(), s2 = contact.getSurface2();
+        if (s1 > s2) std::swap(s1,s2);
+        pairs.insert(make_pair(s1,s2));
+    }
+    return pairs;
+}
+
+// The broad phase keeps its sorted order from one call to the next and
+// updates it incrementally; make sure it finds the same contacts as a brute
+// force search whether the particles move a little at a time, jump to
+// unrelated positions, or change which axis they're spread along.
+void testBroadPhaseCoherence() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    ContactTrackerSubsystem tracker(system);
+
+    Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia::sphere(Radius)));
+    body.addContactSurface(Transform(),
+        ContactSurface(ContactGeometry::Sphere(Radius),
+                       ContactMaterial(1e6, 1, 1, 1, 1)));
+    const int NumParticles = 300;
+    Array_<MobilizedBody> particles;
+    for (int i=0; i < NumParticles; ++i)
+        particles.push_back(MobilizedBody::Translation(matter.Ground(), body));
+
+    State state = system.realizeTopology();
+    Random::Uniform random(-1, 1);
+    random.setSeed(0);
+    for (int i=0; i < state.getNQ(); ++i)
+        state.updQ()[i] = random.getValue();
+
+    int numCompared = 0, numNonEmpty = 0;
+    for (int trial=0; trial < 60; ++trial) {
+        if (trial == 20) { // jump to new positions
+            for (int i=0; i < state.getNQ(); ++i)
+                state.updQ()[i] = random.getValue();
+        } else if (trial == 40) { // spread the particles out along z
+            for (int i=0; i < state.getNQ(); ++i)
+                state.updQ()[i] *= (i%3 == 2 ? 5 : Real(0.5));
+        } else { // small motions
+            for (int i=0; i < state.getNQ(); ++i)
+                state.updQ()[i] += Real(0.02)*random.getValue();
+        }
+        system.realize(state, Stage::Position);
+
+        const PairSet expected =
+            findOverlapsByBruteForce(tracker, particles, state);
+        ASSERT(getActivePairs(tracker, state) == expected);
+        ++numCompared;
+        if (!expected.empty()) ++numNonEmpty;
+    }
+    ASSERT(numNonEmpty == numCompared); // make sure the test tested something
+}
+
+struct ContactRecord {
+    ContactRecord(const Contact& c)
+    :   surf1(c.getSurface1()), surf2(c.getSurface2()),
+        condition(c.getCondition()), type(c.getTypeId()) {}
+    bool operator==(const ContactRecord& r) const {
+        return surf1==r.surf1 && surf2==r.surf2 && condition==r.condition
+            && type==r.type;
+    }
+    int surf1, surf2;
+    Contact::Condition condition;
+    ContactTypeId type;
+};
+
+// Move the particles around at random, recording the contacts found at each
+// step in the order they appear in the snapshot.
+vector< vector<ContactRecord> > 
+trackRandomMotion(const MultibodySystem& system,
+                  const ContactTrackerSubsystem& tracker) {
+    State state = system.getDefaultState();
+    Random::Uniform random(-Real(0.3), Real(0.3));
+    random.setSeed(1);
+    for (int i=0; i < state.getNQ(); ++i)
+        state.updQ()[i] = random.getValue();
+
+    vector< vector<ContactRecord> > steps;
+    for (int step=0; step < 20; ++step) {
+        for (int i=0; i < state.getNQ(); ++i)
+            state.updQ()[i] += Real(0.05)*random.getValue();
+        system.realize(state, Stage::Position);
+        const ContactSnapshot& contacts = tracker.getActiveContacts(state);
+        steps.push_back(vector<ContactRecord>());
+        for (int i=0; i < contacts.getNumContacts(); ++i) {
+            steps.back().push_back(ContactRecord(contacts.getContact(i)));
+            if (i > 0) // must be in ContactId order
+                ASSERT(contacts.getContact(i-1).getContactId()
+                       < contacts.getContact(i).getContactId());
+        }
+        state.autoUpdateDiscreteVariables();
+    }
+    return steps;
+}
+
+// The narrow phase may track pairs in parallel; make sure that gives exactly
+// the same contacts, in the same order, as tracking them serially. Half the
+// particles are triangle meshes so that there is enough work to go parallel.
+void testParallelNarrowPhase() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    ContactTrackerSubsystem tracker(system);
+
+    const ContactMaterial material(1e6, 1, 1, 1, 1);
+    Body::Rigid sphere(MassProperties(1, Vec3(0), UnitInertia::sphere(Radius)));
+    sphere.addContactSurface(Transform(),
+        ContactSurface(ContactGeometry::Sphere(Radius), material));
+    Body::Rigid mesh(MassProperties(1, Vec3(0), UnitInertia::sphere(Radius)));
+    mesh.addContactSurface(Transform(),
+        ContactSurface(ContactGeometry::TriangleMesh
+                          (PolygonalMesh::createSphereMesh(Radius, 1)),
+                       material));
+    for (int i=0; i < 40; ++i)
+        MobilizedBody::Translation(matter.Ground(), i%2 ? mesh : sphere);
+    system.realizeTopology();
+
+    tracker.setNumberOfThreads(1);
+    ASSERT(tracker.getNumberOfThreads() == 1);
+    const vector< vector<ContactRecord> > serial = 
+        trackRandomMotion(system, tracker);
+    tracker.setNumberOfThreads(4);
+    ASSERT(tracker.getNumberOfThreads() == 4);
+    const vector< vector<ContactRecord> > parallel = 
+        trackRandomMotion(system, tracker);
+
+    ASSERT(parallel == serial);
+    int numOngoing = 0;
+    for (const vector<ContactRecord>& step : serial)
+        for (const ContactRecord& record : step)
+            if (record.condition == Contact::Ongoing) ++numOngoing;
+    ASSERT(numOngoing > 0); // make sure the test tested something
+}
+
+int main() {
+    try {
+        testBroadPhaseCoherence();
+        testParallelNarrowPhase();
+    }
+    catch(const std::exception& e) {
+        cout << "exception: " << e.what() << endl;
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
@@ -356,12 +356,191 @@ void testDisabling() {
     ASSERT(!forces.isForceDisabled(state, spring.getForceIndex()));
 }
 
+/**
+ * Changing a parameter of a position-only force element must recompute the
+ * cached forces even though q hasn't changed.
+ */
+
+void testCachedForceParameters() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Body::Rigid body(MassProperties(1.0, Vec3(0), Inertia(1)));
+    MobilizedBody::Pin pin(matter.updGround(), Vec3(0), body, Vec3(0));
+    Force::MobilityLinearSpring spring(forces, pin, MobilizerQIndex(0),
+                                       2.0, 0.25);
+
+    State state = system.realizeTopology();
+    pin.setOneQ(state, 0, 1.0);
+    system.realize(state, Stage::Acceleration);
+    ASSERT_EQUAL(-2.0*0.75,
+        system.getMobilityForces(state, Stage::Dynamics)[0]);
+
+    spring.setStiffness(state, 3.0);
+    system.realize(state, Stage::Acceleration);
+    ASSERT_EQUAL(-3.0*0.75,
+        system.getMobilityForces(state, Stage::Dynamics)[0]);
+
+    spring.setQZero(state, 0.5);
+    system.realize(state, Stage::Dynamics);
+    ASSERT_EQUAL(-3.0*0.5,
+        system.getMobilityForces(state, Stage::Dynamics)[0]);
+
+    // A copy computes the same forces from its own variables.
+    State copy(state);
+    spring.setStiffness(copy, 4.0);
+    system.realize(copy, Stage::Dynamics);
+    system.realize(state, Stage::Dynamics);
+    ASSERT_EQUAL(-4.0*0.5,
+        system.getMobilityForces(copy, Stage::Dynamics)[0]);
+    ASSERT_EQUAL(-3.0*0.5,
+        system.getMobilityForces(state, Stage::Dynamics)[0]);
+}
+
+// A viscous damper on one mobility that supplies its derivatives.
+class MyDamperImpl : public Force::Custom::Implementation {
+public:
+    MyDamperImpl(const MobilizedBody& mobod, Real c) : mobod(mobod), c(c) {}
+    void calcForce(const State& state, Vector_<SpatialVec>& bodyForces, Vector_<Vec3>& particleForces, Vector& mobilityForces) const override {
+        mobod.applyOneMobilityForce(state, MobilizerUIndex(0), 
+                                    -c*mobod.getOneU(state, 0), mobilityForces);
+    }
+    Real calcPotentialEnergy(const State& state) const override {
+        return 0.0;
+    }
+    bool calcForceJacobian(const State& state, ForceJacobian& jacobian) const override {
+        const UIndex ux = mobod.getFirstUIndex(state);
+        jacobian.addVelocityDerivative(ux, ux, -c);
+        return true;
+    }
+private:
+    const MobilizedBody& mobod;
+    Real c;
+};
+
+// Return the total generalized force produced by the force elements.
+static Vector calcGeneralizedForces(const MultibodySystem& system, 
+                                    const State& state) {
+    system.realize(state, Stage::Dynamics);
+    Vector tau;
+    system.getMatterSubsystem().multiplyBySystemJacobianTranspose(state,
+        system.getRigidBodyForces(state, Stage::Dynamics), tau);
+    return tau + system.getMobilityForces(state, Stage::Dynamics);
+}
+
+// Central differences of the generalized forces with respect to the 
+// generalized speeds, and with respect to the q's along N*du.
+static void calcNumericalForceJacobian(const MultibodySystem& system,
+                                       const State& state, 
+                                       Matrix& dfdq, Matrix& dfdu) {
+    const SimbodyMatterSubsystem& matter = system.getMatterSubsystem();
+    const int nu = state.getNU();
+    const Real h = 1e-6;
+    dfdq.resize(nu, nu); dfdu.resize(nu, nu);
+    State tmp(state);
+    for (int j=0; j < nu; ++j) {
+        Vector du(nu, 0.0), dq;
+        du[j] = h;
+        matter.multiplyByN(state, false, du, dq);
+
+        tmp.updQ() = state.getQ() + dq;
+        Vector fPlus = calcGeneralizedForces(system, tmp);
+        tmp.updQ() = state.getQ() - dq;
+        dfdq(j) = (fPlus - calcGeneralizedForces(system, tmp))/(2*h);
+        tmp.updQ() = state.getQ();
+
+        tmp.updU() = state.getU() + du;
+        fPlus = calcGeneralizedForces(system, tmp);
+        tmp.updU() = state.getU() - du;
+        dfdu(j) = (fPlus - calcGeneralizedForces(system, tmp))/(2*h);
+        tmp.updU() = state.getU();
+    }
+}
+
+/**
+ * Compare the analytical force Jacobians with numerical ones. The Jacobian
+ * terms due to the motion of the bodies' Jacobians are neglected, so the
+ * model is chosen to make them vanish: the two point spring acts between
+ * translating bodies, and the bushing is at rest when its position 
+ * derivatives are checked.
+ */
+
+void testForceJacobian() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Body::Rigid body(MassProperties(1.0, Vec3(0), Inertia(1)));
+    MobilizedBody::Pin pin(matter.updGround(), Vec3(0), body, Vec3(0, 1, 0));
+    MobilizedBody::Translation trans1(matter.updGround(), Vec3(1, 0, 0), 
+                                      body, Vec3(0));
+    MobilizedBody::Translation trans2(trans1, Vec3(0, 0, 1), body, Vec3(0));
+    MobilizedBody::Free free(pin, Vec3(0, -1, 0), body, Vec3(0));
+
+    Force::MobilityLinearSpring(forces, pin, MobilizerQIndex(0), 3.0, 0.2);
+    Force::MobilityLinearDamper(forces, pin, MobilizerUIndex(0), 0.5);
+    Force::TwoPointLinearSpring(forces, trans1, Vec3(0.1, 0, 0), 
+                                trans2, Vec3(0, 0.2, 0), 5.0, 0.3);
+    const Transform X_B1F(Rotation(0.3, XAxis), Vec3(0, 0.3, 0));
+    const Transform X_B2M(Rotation(-0.2, YAxis), Vec3(0.1, 0, 0));
+    Force::LinearBushing bushing(forces, trans2, X_B1F, free, X_B2M,
+                                 Vec6(1, 2, 3, 4, 5, 6), 
+                                 Vec6(0.1, 0.2, 0.3, 0.4, 0.5, 0.6));
+    Force::Custom(forces, new MyDamperImpl(trans1, 0.7));
+
+    State state = system.realizeTopology();
+    pin.setOneQ(state, 0, 0.4);
+    trans1.setQToFitTranslation(state, Vec3(0.1, 0.2, -0.1));
+    trans2.setQToFitTranslation(state, Vec3(-0.3, 0.1, 0.2));
+
+    // Put the free body where the bushing is relaxed.
+    system.realize(state, Stage::Position);
+    const Transform X_GB2 = trans2.getBodyTransform(state)*X_B1F*~X_B2M;
+    const Transform X_PB2 = ~pin.getBodyTransform(state)*X_GB2;
+    free.setQToFitTransform(state, ~Transform(Vec3(0, -1, 0))*X_PB2);
+    system.realize(state, Stage::Velocity);
+    ASSERT(bushing.getQ(state).norm() < 1e-12);
+
+    ForceJacobian jacobian;
+    ASSERT(forces.calcForceJacobian(state, jacobian));
+    Matrix dfdq, dfdu, numDfdq, numDfdu;
+    jacobian.getPositionDerivatives(dfdq);
+    jacobian.getVelocityDerivatives(dfdu);
+    calcNumericalForceJacobian(system, state, numDfdq, numDfdu);
+    SimTK_TEST_EQ_TOL(dfdq, numDfdq, 1e-6);
+    SimTK_TEST_EQ_TOL(dfdu, numDfdu, 1e-6);
+
+    // The forces are linear in u, so the velocity derivatives are exact
+    // at any velocity.
+    Random::Uniform random(-1, 1);
+    for (int i=0; i < state.getNU(); ++i)
+        state.updU()[i] = random.getValue();
+    system.realize(state, Stage::Velocity);
+    ASSERT(forces.calcForceJacobian(state, jacobian));
+    jacobian.getVelocityDerivatives(dfdu);
+    calcNumericalForceJacobian(system, state, numDfdq, numDfdu);
+    SimTK_TEST_EQ_TOL(dfdu, numDfdu, 1e-6);
+
+    // Gravity adds nothing but doesn't prevent the calculation; a force 
+    // element without derivatives does, unless it is disabled.
+    Force::UniformGravity(forces, matter, Vec3(0, -9.8, 0));
+    Force::TwoPointLinearDamper damper(forces, trans1, Vec3(0), 
+                                       free, Vec3(0), 1.0);
+    state = system.realizeTopology();
+    system.realize(state, Stage::Velocity);
+    ASSERT(!forces.calcForceJacobian(state, jacobian));
+    damper.disable(state);
+    system.realize(state, Stage::Velocity);
+    ASSERT(forces.calcForceJacobian(state, jacobian));
+}
+
 int main() {
     try {
         testStandardForces();
         testEnergyConservation();
         testCustomRealization();
         testDisabling();
+        testCachedForceParameters();
+        testForceJacobian();
     }
     catch(const std::exception& e) {
         cout << "exception: " << e.what() << endl;
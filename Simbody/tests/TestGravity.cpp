@@ -38,7 +38,7 @@ const Vec3 Cube(.5,.5,.5); // half-dimensions of cube
 const Real Mass1=100, Mass2=5, Mass3=1;
 const Vec3 Centroid(.5,0,.5);
 const Vec3 COM1=Centroid, COM2=Centroid, COM3=Centroid+Vec3(0,.5,0);
-const UnitInertia Central(Vec3(.1), Vec3(.05));
+const UnitInertia Central(Vec3(Real(.1)), Vec3(Real(.05)));
 // Simbody requires inertias to be expressed about body origin rather than COM.
 const Inertia Inertia1=Mass1*Central.shiftFromCentroid(-COM1);
 const Inertia Inertia2=Mass2*Central.shiftFromCentroid(-COM2);
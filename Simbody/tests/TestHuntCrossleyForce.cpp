@@ -135,9 +135,150 @@ void testForces() {
     }
 }
 
+// Compare the force Jacobian with central differences. The sphere only
+// translates, so the neglected Jacobian terms are zero.
+void testForceJacobian() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralContactSubsystem contacts(system);
+    GeneralForceSubsystem forces(system);
+    Force::UniformGravity(forces, matter, Vec3(0, -9.8, 0), 0);
+    const Real radius = 0.8;
+    Body::Rigid body(MassProperties(1.0, Vec3(0), Inertia(1)));
+    ContactSetIndex setIndex = contacts.createContactSet();
+    MobilizedBody::Translation sphere(matter.updGround(), Transform(), body, Transform());
+    contacts.addBody(setIndex, sphere, ContactGeometry::Sphere(radius), Transform());
+    contacts.addBody(setIndex, matter.updGround(), ContactGeometry::HalfSpace(), Transform(Rotation(-0.5*Pi, ZAxis), Vec3(0))); // y < 0
+    HuntCrossleyForce hc(forces, contacts, setIndex);
+    hc.setBodyParameters(ContactSurfaceIndex(0), 1.0, 0.5, 1.0, 0.5, 0.1);
+    hc.setBodyParameters(ContactSurfaceIndex(1), 2.0, 1.0, 0.7, 0.2, 0.05);
+    const Real vt = 0.01;
+    hc.setTransitionVelocity(vt);
+    State state = system.realizeTopology();
+
+    // Sticking, in the transition region, sliding, and not slipping at all.
+    const Vec3 velocities[] = {Vec3(0.3*vt, -0.2, 0.5*vt), 
+                               Vec3(5*vt, 0.1, -2*vt),
+                               Vec3(0, 0.1, 0)};
+    const Real h = 1e-7;
+    for (const Vec3& velocity : velocities) {
+        sphere.setQToFitTranslation(state, Vec3(0.1, radius-0.05, 0.2));
+        sphere.setUToFitLinearVelocity(state, velocity);
+        system.realize(state, Stage::Dynamics);
+        ForceJacobian jacobian;
+        ASSERT(forces.calcForceJacobian(state, jacobian));
+        Matrix dfdq, dfdu;
+        jacobian.getPositionDerivatives(dfdq);
+        jacobian.getVelocityDerivatives(dfdu);
+
+        // The generalized forces are the force on the sphere's origin.
+        auto calcF = [&](const State& s) {
+            system.realize(s, Stage::Dynamics);
+            return system.getRigidBodyForces(s, Stage::Dynamics)
+                        [sphere.getMobilizedBodyIndex()][1];
+        };
+        State tmp(state);
+        for (int j = 0; j < 3; ++j) {
+            tmp.updQ()[j] += h;  const Vec3 qPlus = calcF(tmp);
+            tmp.updQ()[j] -= 2*h; const Vec3 qMinus = calcF(tmp);
+            tmp.updQ()[j] += h;
+            tmp.updU()[j] += h;  const Vec3 uPlus = calcF(tmp);
+            tmp.updU()[j] -= 2*h; const Vec3 uMinus = calcF(tmp);
+            tmp.updU()[j] += h;
+            for (int i = 0; i < 3; ++i) {
+                SimTK_TEST_EQ_TOL(dfdq(i,j), (qPlus[i]-qMinus[i])/(2*h), 1e-5);
+                SimTK_TEST_EQ_TOL(dfdu(i,j), (uPlus[i]-uMinus[i])/(2*h), 1e-5);
+            }
+        }
+
+        // So must the System's ydot Jacobian, which is assembled from them.
+        Matrix dydot;
+        ASSERT(system.calcYDotJacobian(state, dydot));
+        for (int j = 0; j < state.getNY(); ++j) {
+            tmp.updY()[j] += h;
+            system.realize(tmp, Stage::Acceleration);
+            const Vector plus = tmp.getYDot();
+            tmp.updY()[j] -= 2*h;
+            system.realize(tmp, Stage::Acceleration);
+            SimTK_TEST_EQ_TOL(dydot(j), (plus-tmp.getYDot())/(2*h), 1e-5);
+            tmp.updY()[j] += h;
+        }
+    }
+}
+
+// A ball sliding to a stop on stiff, damped ground contact.
+// Once it has settled, an explicit integrator is still limited by the contact
+// and friction time constants while a stiff integrator is not.
+void testStiffIntegration() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralContactSubsystem contacts(system);
+    GeneralForceSubsystem forces(system);
+    Force::UniformGravity(forces, matter, Vec3(0, -9.8, 0));
+    const Real radius = 0.1;
+    Body::Rigid body(MassProperties(1.0, Vec3(0), Inertia(1)));
+    ContactSetIndex setIndex = contacts.createContactSet();
+    MobilizedBody::Translation sphere(matter.updGround(), Transform(), body, Transform());
+    contacts.addBody(setIndex, sphere, ContactGeometry::Sphere(radius), Transform());
+    contacts.addBody(setIndex, matter.updGround(), ContactGeometry::HalfSpace(), Transform(Rotation(-0.5*Pi, ZAxis), Vec3(0))); // y < 0
+    HuntCrossleyForce hc(forces, contacts, setIndex);
+    hc.setBodyParameters(ContactSurfaceIndex(0), 1e9, 2.0, 0.8, 0.6, 0.0);
+    hc.setBodyParameters(ContactSurfaceIndex(1), 1e9, 2.0, 0.8, 0.6, 0.0);
+    hc.setTransitionVelocity(1e-3);
+    system.realizeTopology();
+
+    State state = system.getDefaultState();
+    sphere.setQToFitTranslation(state, Vec3(0, radius, 0));
+    sphere.setUToFitLinearVelocity(state, Vec3(0.5, 0, 0));
+
+    // Take a tight-accuracy explicit run as the reference, then compare the
+    // other integrators at a loose accuracy. The stiff integrator is run both
+    // with the Jacobian assembled from the force elements' derivatives and
+    // with a finite difference Jacobian.
+    RungeKuttaMersonIntegrator referenceInteg(system);
+    RungeKuttaMersonIntegrator explicitInteg(system);
+    SDIRKIntegrator stiffInteg(system);
+    SDIRKIntegrator numericalInteg(system);
+    numericalInteg.setUseSystemJacobian(false);
+    ASSERT(stiffInteg.getUseSystemJacobian());
+    Integrator* integs[] = {&referenceInteg, &explicitInteg, &stiffInteg,
+                            &numericalInteg};
+    Vec3 finalPos[4];
+    for (int i = 0; i < 4; ++i) {
+        integs[i]->setAccuracy(i == 0 ? 1e-6 : 1e-3);
+        TimeStepper ts(system, *integs[i]);
+        ts.initialize(state);
+        ts.stepTo(2.0);
+        finalPos[i] = sphere.getBodyOriginLocation(integs[i]->getState());
+    }
+
+    // The ball has come to rest on the ground.
+    ASSERT(std::abs(finalPos[0][1] - radius) < 1e-4);
+    ASSERT((finalPos[2]-finalPos[0]).norm() < 1e-3);
+    ASSERT((finalPos[3]-finalPos[0]).norm() < 1e-3);
+    ASSERT(stiffInteg.getNumJacobianEvaluations() < stiffInteg.getNumStepsTaken());
+    // Every attempted step would need a factorization without reuse.
+    ASSERT(stiffInteg.getNumIterationMatrixFactorizations() 
+           < stiffInteg.getNumStepsAttempted());
+    cout << "RungeKuttaMerson: " << explicitInteg.getNumStepsTaken()
+         << " steps, " << explicitInteg.getNumRealizations() << " realizations\n";
+    cout << "SDIRK: " << stiffInteg.getNumStepsTaken() << " steps, "
+         << stiffInteg.getNumRealizations() << " realizations, "
+         << stiffInteg.getNumJacobianEvaluations() << " Jacobians, "
+         << stiffInteg.getNumIterationMatrixFactorizations() 
+         << " factorizations in " << stiffInteg.getNumStepsAttempted()
+         << " attempts\n";
+    cout << "SDIRK, numerical Jacobian: " << numericalInteg.getNumStepsTaken()
+         << " steps, " << numericalInteg.getNumRealizations()
+         << " realizations\n";
+    ASSERT(10*stiffInteg.getNumStepsTaken() < explicitInteg.getNumStepsTaken());
+}
+
 int main() {
     try {
         testForces();
+        testForceJacobian();
+        testStiffIntegration();
     }
     catch(const std::exception& e) {
         cout << "exception: " << e.what() << endl;
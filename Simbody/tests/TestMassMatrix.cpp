@@ -714,6 +714,16 @@ void testUnconstrainedSystem() {
     SimTK_TEST_EQ_SIZE(MM, M, nu);
     SimTK_TEST_EQ_SIZE(MMInv, MInv, nu);
 
+    // The sparse factor must solve with M the same way M^-1 does, including
+    // when the right hand side is overwritten with the solution.
+    matter.calcMFactorSparse(state);
+    Vector sparseSol;
+    matter.solveM(state, randVec, sparseSol);
+    SimTK_TEST_EQ_SIZE(sparseSol, MInv*randVec, nu);
+    Vector inPlace = randVec;
+    matter.solveM(state, inPlace, inPlace);
+    SimTK_TEST_EQ(inPlace, sparseSol);
+
     //assertIsIdentity(eye);
     //assertIsIdentity(MInv*M);
 
@@ -776,6 +786,44 @@ void testUnconstrainedSystem() {
 
     SimTK_TEST(shouldBeZeroResidualForces.norm() <= Slop);
 
+    // The multiple right hand side operators must match the single-column
+    // ones column by column.
+    const int ncol = 5;
+    Matrix udotCols(nu, ncol), residCols, MCols, MInvCols;
+    for (int c=0; c < ncol; ++c)
+        udotCols(c) = Test::randVector(nu);
+    matter.calcResidualForceColumnsIgnoringConstraints(state,
+        mobilityForces, bodyForces, udotCols, residCols);
+    matter.multiplyByMColumns(state, udotCols, MCols);
+    matter.multiplyByMInvColumns(state, udotCols, MInvCols);
+    SimTK_TEST_EQ(residCols.nrow(), nu); SimTK_TEST_EQ(residCols.ncol(), ncol);
+    for (int c=0; c < ncol; ++c) {
+        Vector residCol, MCol, MInvCol;
+        matter.calcResidualForceIgnoringConstraints(state,
+            mobilityForces, bodyForces, udotCols(c), residCol);
+        matter.multiplyByM(state, udotCols(c), MCol);
+        matter.multiplyByMInv(state, udotCols(c), MInvCol);
+        SimTK_TEST_EQ_TOL(residCols(c), residCol, Slop);
+        SimTK_TEST_EQ_TOL(MCols(c), MCol, Slop);
+        SimTK_TEST_EQ_TOL(MInvCols(c), MInvCol, Slop);
+    }
+    matter.calcResidualForceColumnsIgnoringConstraints(state,
+        Vector(), Vector_<SpatialVec>(), Matrix(nu,ncol,Real(0)), residCols);
+    Vector inertialOnly;
+    matter.calcResidualForceIgnoringConstraints(state,
+        Vector(), Vector_<SpatialVec>(), Vector(), inertialOnly);
+    for (int c=0; c < ncol; ++c)
+        SimTK_TEST_EQ_TOL(residCols(c), inertialOnly, Slop);
+    SimTK_TEST_MUST_THROW(
+        matter.multiplyByMColumns(state, Matrix(2,ncol), MCols));
+
+    // Column views of Matrices must still select the Vector operators.
+    Matrix viewCols(nu, ncol);
+    matter.multiplyByM(state, udotCols(0), viewCols(0));
+    matter.multiplyByMInv(state, udotCols(0), viewCols(1));
+    SimTK_TEST_EQ_TOL(viewCols(0), MCols(0), Slop);
+    SimTK_TEST_EQ_TOL(viewCols(1), MInvCols(0), Slop);
+
     // Now apply these forces in forward dynamics and see if we get the desired
     // acceleration. State must be realized to Dynamics stage.
     system.realize(state, Stage::Dynamics);
@@ -1235,6 +1283,31 @@ void testTaskJacobians() {
     SimTK_TEST_EQ(JS, JSbyrow);
     SimTK_TEST_EQ(JF, JFbyrow);
 
+    // The sparse forms must expand to the same dense matrices, with no
+    // duplicate or out-of-order columns.
+    Array_<int> rowStart, colIndex;
+    Array_<SpatialVec> Jsparse;
+    Array_<Vec3> JSsparse;
+    matter.calcSparseSystemJacobian(state, rowStart, colIndex, Jsparse);
+    SimTK_TEST(rowStart.size() == nb+1 && rowStart[1] == 0);
+    Matrix_<SpatialVec> Jexpanded(nb, nu, SpatialVec(Vec3(0)));
+    for (int i=0; i<nb; ++i)
+        for (int k=rowStart[i]; k < rowStart[i+1]; ++k) {
+            if (k > rowStart[i]) SimTK_TEST(colIndex[k] > colIndex[k-1]);
+            Jexpanded(i, colIndex[k]) = Jsparse[k];
+        }
+    SimTK_TEST_EQ_TOL(Jexpanded, J, Slop);
+
+    matter.calcSparseStationJacobian(state, allBodies, randS, 
+                                     rowStart, colIndex, JSsparse);
+    SimTK_TEST(rowStart.size() == nb+1);
+    SimTK_TEST(rowStart[nb] == (int)JSsparse.size());
+    Matrix_<Vec3> JSexpanded(nb, nu, Vec3(0));
+    for (int i=0; i<nb; ++i)
+        for (int k=rowStart[i]; k < rowStart[i+1]; ++k)
+            JSexpanded(i, colIndex[k]) = JSsparse[k];
+    SimTK_TEST_EQ_TOL(JSexpanded, JS, Slop);
+
     // Calculate JS2=JS and JF2=JF again using multiplication by mobility-space 
     // unit vectors.
     JS2.resize(nb, nu); JF2.resize(nb, nu);
@@ -1342,6 +1415,26 @@ void testTaskJacobians() {
     }
     // These should be exactly the same.
     SimTK_TEST_EQ_TOL(JFmat2, JFmat, SignificantReal);
+
+    // Task-space inertias must match the ones composed from explicit
+    // matrices, using all the stations and frames (so singular).
+    Matrix MInv, LambdaInv, Lambda;
+    matter.calcMInv(state, MInv);
+    matter.calcStationTaskInertiaInverse(state, allBodies, randS, LambdaInv);
+    SimTK_TEST_EQ_TOL(LambdaInv, JSmat*MInv*~JSmat, Slop);
+    matter.calcFrameTaskInertiaInverse(state, allBodies, randS, LambdaInv);
+    SimTK_TEST_EQ_TOL(LambdaInv, JFmat*MInv*~JFmat, Slop);
+
+    // A single task on the outermost body should be nonsingular.
+    const MobilizedBodyIndex tip(nb-1);
+    const Array_<MobilizedBodyIndex> tipBody(1, tip);
+    const Array_<Vec3> tipStation(1, randS[tip]);
+    Matrix identity3(3,3); identity3 = 1;
+    matter.calcStationTaskInertiaInverse(state, tipBody, tipStation, LambdaInv);
+    matter.calcStationTaskInertia(state, tipBody, tipStation, Lambda);
+    SimTK_TEST_EQ_TOL(Lambda*LambdaInv, identity3, Slop);
+    SimTK_TEST_EQ_TOL(LambdaInv, JSmat(3*tip,0,3,nu)*MInv*~JSmat(3*tip,0,3,nu),
+                      Slop);
 }
 
 // Position kinematics should be valid if:
@@ -269,12 +269,177 @@ void testBushing() {
                       c2.getBodyVelocity(integ.getState()), 1e-10);
 }
 
+// A copied State shares its cache entries with the source until one of them
+// is realized again, at which point the matter subsystem's tree caches are
+// copied into a new arena. Either way each State must see only its own
+// results.
+void testCopiedStateCaches() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Force::Gravity(forces, matter, -YAxis, 9.8);
+    Body::Rigid body(MassProperties(1.0, Vec3(0), Inertia(1)));
+    MobilizedBody::Ball ball(matter.Ground(), Vec3(0), body, Vec3(0,1,0));
+    MobilizedBody::Pin pin(ball, Vec3(0,-1,0), body, Vec3(0,1,0));
+    MobilizedBody::Free free(matter.Ground(), Vec3(2,0,0), body, Vec3(0));
+    Constraint::Rod(pin, free, 2);
+
+    system.realizeTopology();
+    State state = system.getDefaultState();
+    Random::Gaussian random;
+    for (int i = 0; i < state.getNY(); ++i)
+        state.updY()[i] = random.getValue();
+    system.realize(state, Stage::Acceleration);
+    const Transform X_GB = pin.getBodyTransform(state);
+    const SpatialVec V_GB = pin.getBodyVelocity(state);
+    const Vector udot = state.getUDot();
+
+    // A copied State keeps only its Instance-stage cache entries valid, but
+    // the storage of the later ones comes along and gets reused.
+    State copy(state);
+    system.realize(copy, Stage::Acceleration);
+    SimTK_TEST_EQ(pin.getBodyTransform(copy), X_GB);
+    SimTK_TEST_EQ(copy.getUDot(), udot);
+
+    // Change and realize the copy. The source must be untouched and the copy
+    // must match a State realized from scratch.
+    for (int i = 0; i < copy.getNQ(); ++i) copy.updQ()[i] += 0.1;
+    for (int i = 0; i < copy.getNU(); ++i) copy.updU()[i] *= 2;
+    system.realize(copy, Stage::Acceleration);
+    SimTK_TEST_EQ(pin.getBodyTransform(state), X_GB);
+    SimTK_TEST_EQ(pin.getBodyVelocity(state), V_GB);
+    SimTK_TEST_EQ(state.getUDot(), udot);
+
+    State fresh = system.getDefaultState();
+    fresh.updY() = copy.getY();
+    system.realize(fresh, Stage::Acceleration);
+    SimTK_TEST_EQ(pin.getBodyTransform(copy), pin.getBodyTransform(fresh));
+    SimTK_TEST_EQ(pin.getBodyVelocity(copy), pin.getBodyVelocity(fresh));
+    SimTK_TEST_EQ(copy.getUDot(), fresh.getUDot());
+
+    // Assigning over a realized State replaces its cache entries too.
+    state = copy;
+    system.realize(state, Stage::Acceleration);
+    SimTK_TEST_EQ(pin.getBodyTransform(state), pin.getBodyTransform(fresh));
+    SimTK_TEST_EQ(state.getUDot(), fresh.getUDot());
+}
+
+// A binary snapshot restores the time, q and u, Model- and Instance-stage
+// settings, and which forces are disabled.
+void testStateSnapshot() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Force::Gravity(forces, matter, -YAxis, 9.8);
+    Body::Rigid body(MassProperties(1.0, Vec3(0), Inertia(1)));
+    MobilizedBody::Ball ball(matter.Ground(), Vec3(0), body, Vec3(0,1,0));
+    MobilizedBody::Pin pin(ball, Vec3(0,-1,0), body, Vec3(0,1,0));
+    MobilizedBody::Free free(matter.Ground(), Vec3(2,0,0), body, Vec3(0));
+    Force::TwoPointLinearSpring spring(forces, pin, Vec3(0), free, Vec3(0), 
+                                       10, 1);
+    system.realizeTopology();
+
+    State state = system.getDefaultState();
+    matter.setUseEulerAngles(state, true);
+    system.realizeModel(state);
+    Random::Gaussian random;
+    for (int i = 0; i < state.getNY(); ++i)
+        state.updY()[i] = random.getValue();
+    pin.lockAt(state, 0.5);
+    spring.disable(state);
+    state.setTime(1.25);
+    system.realize(state, Stage::Acceleration);
+
+    Array_<char> snapshot;
+    system.serializeState(state, snapshot);
+
+    State restored;
+    system.deserializeState(snapshot.data(), snapshot.size(), restored);
+    SimTK_TEST(restored.getTime() == 1.25);
+    SimTK_TEST(matter.getUseEulerAngles(restored));
+    SimTK_TEST_EQ(restored.getY(), state.getY());
+    SimTK_TEST(pin.getLockLevel(restored) == Motion::Position);
+    SimTK_TEST(spring.isDisabled(restored));
+    system.realize(restored, Stage::Acceleration);
+    SimTK_TEST_EQ(restored.getUDot(), state.getUDot());
+
+    // A damaged snapshot or a different System is rejected.
+    SimTK_TEST_MUST_THROW(system.deserializeState(snapshot.data(),
+                                                  snapshot.size()/2, restored));
+    MultibodySystem other;
+    SimbodyMatterSubsystem otherMatter(other);
+    GeneralForceSubsystem otherForces(other);
+    MobilizedBody::Pin(otherMatter.Ground(), Vec3(0), body, Vec3(0));
+    other.realizeTopology();
+    State otherState;
+    SimTK_TEST_MUST_THROW(other.deserializeState(snapshot.data(),
+                                                 snapshot.size(), otherState));
+}
+
+void buildChains(SimbodyMatterSubsystem& matter)
+{
+    Body::Rigid body(MassProperties(1, Vec3(0), Inertia(1)));
+    for (int i = 0; i < 3; ++i) {
+        MobilizedBody parent = MobilizedBody::Ball(matter.Ground(), 
+            Vec3(i,0,0), body, Vec3(0,1,0));
+        for (int j = 0; j < 4; ++j)
+            parent = MobilizedBody::Pin(parent, Vec3(0,-1,0), 
+                                        body, Vec3(0,1,0));
+    }
+    MobilizedBody::Slider(matter.Ground(), body);
+}
+
+// Perturbing a few q's at a time with incremental position kinematics must
+// give the same transforms as recomputing everything, including after an
+// Instance-stage change.
+void testIncrementalPositionKinematics()
+{
+    MultibodySystem system, refSystem;
+    SimbodyMatterSubsystem matter(system), refMatter(refSystem);
+    buildChains(matter);
+    buildChains(refMatter);
+
+    SimTK_TEST(!matter.getUseIncrementalPositionKinematics());
+    matter.setUseIncrementalPositionKinematics(true);
+    SimTK_TEST(matter.getUseIncrementalPositionKinematics());
+
+    system.realizeTopology();
+    refSystem.realizeTopology();
+    State state = system.getDefaultState();
+    State refState = refSystem.getDefaultState();
+    Random::Uniform random(-1, 1);
+    for (int i = 0; i < state.getNQ(); ++i) state.updQ()[i] = random.getValue();
+
+    const int nb = matter.getNumBodies();
+    const int nq = state.getNQ();
+    const MobilizedBodyIndex sliderIx(nb-1);
+    for (int k = 0; k < 2*nq; ++k) {
+        if (k == nq) {
+            // An Instance-stage change must discard the remembered q's.
+            matter.updMobilizedBody(sliderIx).lock(state);
+            refMatter.updMobilizedBody(sliderIx).lock(refState);
+        }
+        state.updQ()[k % nq] += 0.1;
+        if (k % 3 == 0)
+            state.updQ()[(7*k) % nq] -= 0.2;
+        refState.updQ() = state.getQ();
+        system.realize(state, Stage::Position);
+        refSystem.realize(refState, Stage::Position);
+        for (MobilizedBodyIndex mbx(0); mbx < nb; ++mbx)
+            SimTK_TEST_EQ(matter.getMobilizedBody(mbx).getBodyTransform(state),
+                       refMatter.getMobilizedBody(mbx).getBodyTransform(refState));
+    }
+}
+
 int main() {
     SimTK_START_TEST("TestMobilizedBody");
         SimTK_SUBTEST(testCalculationMethods);
         SimTK_SUBTEST(testWeld);
         SimTK_SUBTEST(testGimbal);
         SimTK_SUBTEST(testBushing);
+        SimTK_SUBTEST(testCopiedStateCaches);
+        SimTK_SUBTEST(testStateSnapshot);
+        SimTK_SUBTEST(testIncrementalPositionKinematics);
     SimTK_END_TEST();
 }
 
@@ -0,0 +1,133 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKsimbody.h"
+
+using namespace SimTK;
+using namespace std;
+
+// A force that asks to be evaluated in parallel with the others, so that
+// realizeBatch() has to keep GeneralForceSubsystem from using its own
+// threads while a batch is running.
+class ParallelForceImpl : public Force::Custom::Implementation {
+public:
+    bool shouldBeParallelIfPossible() const override {
+        return true;
+    }
+    void calcForce(const State& state, Vector_<SpatialVec>& bodyForces,
+          Vector_<Vec3>& particleForces, Vector& mobilityForces) const override{
+        mobilityForces[0] += state.getQ()[0];
+    }
+    Real calcPotentialEnergy(const State& state) const override {
+        return 0.0;
+    }
+};
+
+void buildPendulum(MultibodySystem& system, SimbodyMatterSubsystem& matter,
+                   GeneralForceSubsystem& forces)
+{
+    Force::Gravity gravity(forces, matter, -YAxis, 9.8);
+    Body::Rigid body(MassProperties(1, Vec3(0), Inertia(1)));
+    MobilizedBody::Pin first(matter.Ground(), Vec3(0), body, Vec3(0,1,0));
+    MobilizedBody::Ball second(first, Vec3(0,-1,0), body, Vec3(0,1,0));
+    Force::MobilityLinearSpring(forces, first, MobilizerUIndex(0), 10, 0);
+    Force::Custom(forces, new ParallelForceImpl());
+}
+
+void makeRandomStates(const MultibodySystem& system, int numStates,
+                      Array_<State>& states, Array_<State*>& statePtrs)
+{
+    Random::Uniform random(-1, 1);
+    states.assign(numStates, system.getDefaultState());
+    statePtrs.clear();
+    for (State& state : states) {
+        for (int i = 0; i < state.getNQ(); ++i)
+            state.updQ()[i] = random.getValue();
+        for (int i = 0; i < state.getNU(); ++i)
+            state.updU()[i] = random.getValue();
+        statePtrs.push_back(&state);
+    }
+}
+
+// Realizing a batch of States concurrently must give the same results as
+// realizing them one at a time, even with parallel forces in the System.
+void testRealizeBatch()
+{
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    forces.setNumberOfThreads(2);
+    buildPendulum(system, matter, forces);
+
+    system.realizeTopology();
+    Array_<State> states;
+    Array_<State*> statePtrs;
+    makeRandomStates(system, 8, states, statePtrs);
+
+    system.realizeBatch(statePtrs, Stage::Acceleration, 3);
+    for (State& state : states) {
+        SimTK_TEST(state.getSystemStage() >= Stage::Acceleration);
+        State copy = state;
+        copy.invalidateAllCacheAtOrAbove(Stage::Instance);
+        system.realize(copy, Stage::Acceleration);
+        SimTK_TEST_EQ(copy.getUDot(), state.getUDot());
+    }
+}
+
+// The System's realization counts and times are shared by all the threads of
+// a batch; none of the realizations may be lost.
+void testRealizeBatchCounters()
+{
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    buildPendulum(system, matter, forces);
+
+    system.realizeTopology();
+    system.setRealizationTimingEnabled(true);
+    const int NumStates = 200;
+    Array_<State> states;
+    Array_<State*> statePtrs;
+    makeRandomStates(system, NumStates, states, statePtrs);
+
+    system.resetAllCountersToZero();
+    system.realizeBatch(statePtrs, Stage::Acceleration, 4);
+    for (Stage g = Stage::Time; g <= Stage::Acceleration; ++g)
+        SimTK_TEST(system.getNumRealizationsOfThisStage(g) == NumStates);
+    SimTK_TEST(system.getNumRealizationsOfThisStage(Stage::Report) == 0);
+    SimTK_TEST(system.getRealizationTimeOfThisStage(Stage::Position) > 0);
+
+    // Realizing again finds everything already done.
+    system.realizeBatch(statePtrs, Stage::Acceleration, 4);
+    SimTK_TEST(system.getNumRealizationsOfThisStage(Stage::Acceleration)
+               == NumStates);
+}
+
+int main()
+{
+    SimTK_START_TEST("TestMultibodySystem");
+        SimTK_SUBTEST(testRealizeBatch);
+        SimTK_SUBTEST(testRealizeBatchCounters);
+    SimTK_END_TEST();
+    return 0;
+}
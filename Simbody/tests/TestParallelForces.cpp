@@ -23,6 +23,7 @@
 
 #include "SimTKsimbody.h"
 #include <time.h>
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <iostream>
@@ -88,9 +89,175 @@ void testNonParallelForce()
     system.realize(state, Stage::Dynamics);
 }
 
+// Sleeps for a given time (if any) and applies a unit mobility force, so we
+// can check both the measured costs and that every force was applied exactly
+// once.
+class TimedForceImpl : public Force::Custom::Implementation {
+public:
+    TimedForceImpl(int microseconds, bool parallel) 
+    :   microseconds(microseconds), parallel(parallel) {}
+    bool shouldBeParallelIfPossible() const override{
+      return parallel;
+    }
+    void calcForce(const State& state, Vector_<SpatialVec>& bodyForces,
+          Vector_<Vec3>& particleForces, Vector& mobilityForces) const override{
+         if (microseconds)
+             std::this_thread::sleep_for
+                (std::chrono::microseconds(microseconds));
+         mobilityForces[0] += 1;
+    }
+    Real calcPotentialEnergy(const State& state) const override{
+        return 0.0;
+    }
+private:
+    int  microseconds;
+    bool parallel;
+};
+
+// One expensive parallel force among several trivial ones should end up on a
+// thread of its own once its cost has been measured. This checks the
+// schedule that was built from the measured costs, not how long anything
+// took, so it doesn't depend on how busy the machine is.
+void testForceLoadBalancing()
+{
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    forces.setNumberOfThreads(3);
+    Body::Rigid body(MassProperties(1, Vec3(0), Inertia(1)));
+    MobilizedBody::Pin pin(matter.Ground(), Vec3(0), body, Vec3(0,1,0));
+
+    Force::Custom expensive(forces, new TimedForceImpl(5000, true));
+    Array_<ForceIndex> cheap;
+    for (int i = 0; i < 5; ++i)
+        cheap.push_back(Force::Custom(forces, new TimedForceImpl(0, true))
+                        .getForceIndex());
+    cheap.push_back(Force::Custom(forces, new TimedForceImpl(0, false))
+                    .getForceIndex());
+
+    system.realizeTopology();
+    State state = system.getDefaultState();
+    SimTK_TEST(forces.getEstimatedThreadLoads().empty());
+    for (int i = 0; i < 25; ++i) { // enough to rebalance once
+        state.invalidateAllCacheAtOrAbove(Stage::Dynamics);
+        system.realize(state, Stage::Dynamics);
+        SimTK_TEST(system.getMobilityForces(state, Stage::Dynamics)[0] == 7);
+    }
+
+    // Every force has been timed, and the loads account for all of them.
+    const Real expensiveCost = 
+        forces.getEstimatedForceCost(expensive.getForceIndex());
+    SimTK_TEST(expensiveCost > 0);
+    Real totalCost = expensiveCost;
+    for (ForceIndex fx : cheap) {
+        SimTK_TEST(forces.getEstimatedForceCost(fx) > 0);
+        totalCost += forces.getEstimatedForceCost(fx);
+    }
+    const Array_<Real>& loads = forces.getEstimatedThreadLoads();
+    SimTK_TEST(loads.size() == 3);
+    Real totalLoad = 0;
+    for (Real load : loads)
+        totalLoad += load;
+    SimTK_TEST_EQ(totalLoad, totalCost);
+
+    // The expensive force has a thread to itself, so the busiest thread's
+    // load is exactly the cost of that force.
+    SimTK_TEST_EQ(*std::max_element(loads.begin(), loads.end()), 
+                  expensiveCost);
+}
+
+// Applies the same forces either through the sparse interface or through
+// full-length arrays.
+class SparseForceImpl : public Force::Custom::Implementation {
+public:
+    SparseForceImpl(const SimbodyMatterSubsystem& matter, 
+                    MobilizedBodyIndex body, MobilizedBodyIndex mobilizer,
+                    bool sparse, bool parallel)
+    :   matter(matter), body(body), mobilizer(mobilizer), sparse(sparse), 
+        parallel(parallel) {}
+    bool shouldBeParallelIfPossible() const override {
+        return parallel;
+    }
+    bool getSparsity(Array_<MobilizedBodyIndex>& bodies, 
+                     Array_<MobilizedBodyIndex>& mobilityBodies) const override{
+        if (!sparse) return false;
+        bodies.push_back(body);
+        mobilityBodies.push_back(body);
+        mobilityBodies.push_back(mobilizer);
+        return true;
+    }
+    void calcSparseForce(const State& state, Vector_<SpatialVec>& bodyForces,
+                         Vector& mobilityForces) const override {
+        SimTK_TEST(bodyForces.size() == 1);
+        SimTK_TEST(mobilityForces.size() == 4); // pin + ball
+        bodyForces[0] += SpatialVec(Vec3(1,2,3), Vec3(4,5,6));
+        mobilityForces[0] += 7;
+        mobilityForces[3] += state.getTime() + 8;
+    }
+    void calcForce(const State& state, Vector_<SpatialVec>& bodyForces,
+          Vector_<Vec3>& particleForces, Vector& mobilityForces) const override{
+        bodyForces[body] += SpatialVec(Vec3(1,2,3), Vec3(4,5,6));
+        mobilityForces[matter.getMobilizedBody(body).getFirstUIndex(state)] 
+            += 7;
+        mobilityForces[matter.getMobilizedBody(mobilizer).getFirstUIndex(state)
+                       + 2] += state.getTime() + 8;
+    }
+    Real calcPotentialEnergy(const State& state) const override{
+        return 0.0;
+    }
+private:
+    const SimbodyMatterSubsystem& matter;
+    MobilizedBodyIndex body, mobilizer;
+    bool sparse, parallel;
+};
+
+void testSparseForces()
+{
+    Vector_<SpatialVec> denseBodyForces;
+    Vector denseMobilityForces;
+    for (int sparse = 0; sparse <= 1; ++sparse)
+    for (int parallel = 0; parallel <= 1; ++parallel) {
+        MultibodySystem system;
+        SimbodyMatterSubsystem matter(system);
+        GeneralForceSubsystem forces(system);
+        forces.setNumberOfThreads(3);
+        Body::Rigid body(MassProperties(1, Vec3(0), Inertia(1)));
+        MobilizedBody::Pin first(matter.Ground(), Vec3(0), body, Vec3(0,1,0));
+        MobilizedBody::Ball second(first, Vec3(0,-1,0), body, Vec3(0,1,0));
+        MobilizedBody::Pin third(second, Vec3(0,-1,0), body, Vec3(0,1,0));
+        Force::Gravity gravity(forces, matter, -YAxis, 9.8);
+        for (int i = 0; i < 5; ++i)
+            Force::Custom(forces, new SparseForceImpl(matter, third, second,
+                                                      sparse != 0, 
+                                                      parallel != 0));
+        system.realizeTopology();
+        State state = system.getDefaultState();
+        state.setTime(0.5);
+        for (int i = 0; i < 3; ++i) {
+            state.invalidateAllCacheAtOrAbove(Stage::Dynamics);
+            system.realize(state, Stage::Dynamics);
+        }
+        const Vector_<SpatialVec>& bodyForces = 
+            system.getRigidBodyForces(state, Stage::Dynamics);
+        const Vector& mobilityForces = 
+            system.getMobilityForces(state, Stage::Dynamics);
+        SimTK_TEST_EQ(mobilityForces[third.getFirstUIndex(state)], 35);
+        if (!sparse && !parallel) {
+            denseBodyForces = bodyForces;
+            denseMobilityForces = mobilityForces;
+        } else {
+            SimTK_TEST_EQ(bodyForces, denseBodyForces);
+            SimTK_TEST_EQ(mobilityForces, denseMobilityForces);
+        }
+    }
+}
+
 int main()
 {
     SimTK_START_TEST("TestParallelForces");
+        SimTK_SUBTEST(testForceLoadBalancing);
+        SimTK_SUBTEST(testSparseForces);
+
         //Simply pass the test if only one thread is supported on this machine
         unsigned concurrentThreadsSupported = std::thread::hardware_concurrency();
         if(concurrentThreadsSupported <= 1)
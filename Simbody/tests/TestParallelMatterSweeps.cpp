@@ -0,0 +1,157 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKsimbody.h"
+
+using namespace SimTK;
+using namespace std;
+
+// Build a wide tree (many bodies per level) and check that the parallel
+// level-by-level sweeps in the matter subsystem give exactly the same
+// accelerations as the serial ones.
+void testParallelMatterSweeps()
+{
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Force::Gravity gravity(forces, matter, -YAxis, 9.8);
+
+    Body::Rigid body(MassProperties(1, Vec3(0), Inertia(1)));
+    for (int i = 0; i < 20; ++i) {
+        MobilizedBody::Ball base(matter.Ground(), Vec3(i,0,0), 
+                                 body, Vec3(0,1,0));
+        for (int j = 0; j < 3; ++j)
+            MobilizedBody::Pin pin(base, Vec3(0,-1,0), body, Vec3(0,1,0));
+    }
+
+    system.realizeTopology();
+    State state = system.getDefaultState();
+    Random::Uniform random(-1, 1);
+    for (int i = 0; i < state.getNQ(); ++i) state.updQ()[i] = random.getValue();
+    for (int i = 0; i < state.getNU(); ++i) state.updU()[i] = random.getValue();
+    system.realize(state, Stage::Acceleration);
+    const Vector serialUDot = state.getUDot();
+
+    SimTK_TEST(matter.getNumberOfThreads() == 1);
+    matter.setNumberOfThreads(4);
+    SimTK_TEST(matter.getNumberOfThreads() == 4);
+    state.invalidateAllCacheAtOrAbove(Stage::Position);
+    system.realize(state, Stage::Acceleration);
+    SimTK_TEST_EQ(state.getUDot(), serialUDot);
+}
+
+// Serial sweeps process each level's nodes in runs of the same mobilizer
+// type, while parallel ones go node by node. With the types interleaved at
+// every level, and a Constraint so that the Y operator is used, both must 
+// give the same answers.
+void testSameTypeNodeRuns()
+{
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Force::Gravity gravity(forces, matter, -YAxis, 9.8);
+
+    Body::Rigid body(MassProperties(1, Vec3(0), Inertia(1)));
+    const Vec3 down(0,-1,0), up(0,1,0);
+    Array_<MobilizedBody> bases;
+    for (int i = 0; i < 6; ++i) {
+        MobilizedBody base;
+        switch (i % 3) {
+        case 0: base = MobilizedBody::Ball(matter.Ground(), Vec3(i,0,0), 
+                                           body, up); break;
+        case 1: base = MobilizedBody::Pin(matter.Ground(), Vec3(i,0,0), 
+                                          body, up); break;
+        case 2: base = MobilizedBody::Free(matter.Ground(), Vec3(i,0,0), 
+                                           body, up); break;
+        }
+        MobilizedBody::Slider slider(base, down, body, up);
+        MobilizedBody::Pin pin(base, down, body, up);
+        MobilizedBody::Universal univ(pin, down, body, up);
+        bases.push_back(base);
+    }
+    Constraint::Rod(bases[0], bases[3], 3);
+
+    system.realizeTopology();
+    State state = system.getDefaultState();
+    Random::Uniform random(-1, 1);
+    for (int i = 0; i < state.getNQ(); ++i) state.updQ()[i] = random.getValue();
+    for (int i = 0; i < state.getNU(); ++i) state.updU()[i] = random.getValue();
+    system.realize(state, Stage::Acceleration);
+    const Vector runUDot = state.getUDot();
+    Vector f(state.getNU()), runMInvf;
+    for (int i = 0; i < f.size(); ++i) f[i] = random.getValue();
+    matter.multiplyByMInv(state, f, runMInvf);
+
+    matter.setNumberOfThreads(4);
+    state.invalidateAllCacheAtOrAbove(Stage::Position);
+    system.realize(state, Stage::Acceleration);
+    SimTK_TEST_EQ(state.getUDot(), runUDot);
+
+    // multiplyByMInv() always sweeps serially, so check it against M.
+    Vector MMInvf;
+    matter.multiplyByM(state, runMInvf, MMInvf);
+    SimTK_TEST_EQ_TOL(MMInvf, f, 1e-10);
+}
+
+// A "forest" of independent pendulums, two of which are tied together by a
+// Rod constraint so that they must be swept as a single group. Parallel
+// subtree sweeps must match the serial results.
+void testParallelForestSweeps()
+{
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Force::Gravity gravity(forces, matter, -YAxis, 9.8);
+
+    Body::Rigid body(MassProperties(1, Vec3(0), Inertia(1)));
+    Array_<MobilizedBody> tips;
+    for (int i = 0; i < 12; ++i) {
+        MobilizedBody::Free base(matter.Ground(), Vec3(2*i,0,0), 
+                                 body, Vec3(0,1,0));
+        MobilizedBody::Pin tip(base, Vec3(0,-1,0), body, Vec3(0,1,0));
+        tips.push_back(tip);
+    }
+    Constraint::Rod(tips[0], Vec3(0), tips[1], Vec3(0), 2);
+
+    system.realizeTopology();
+    State state = system.getDefaultState();
+    system.realize(state, Stage::Acceleration);
+    const Vector serialUDot = state.getUDot();
+    const Transform serialX_GB = tips[5].getBodyTransform(state);
+
+    matter.setNumberOfThreads(3);
+    state.invalidateAllCacheAtOrAbove(Stage::Instance);
+    system.realize(state, Stage::Acceleration);
+    SimTK_TEST_EQ(state.getUDot(), serialUDot);
+    SimTK_TEST_EQ(tips[5].getBodyTransform(state), serialX_GB);
+}
+
+int main()
+{
+    SimTK_START_TEST("TestParallelMatterSweeps");
+        SimTK_SUBTEST(testParallelMatterSweeps);
+        SimTK_SUBTEST(testParallelForestSweeps);
+        SimTK_SUBTEST(testSameTypeNodeRuns);
+    SimTK_END_TEST();
+    return 0;
+}
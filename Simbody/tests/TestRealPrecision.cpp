@@ -0,0 +1,132 @@
+/* -------------------------------------------------------------------------- *
+ *                     Simbody(tm): Test Real Precision                       *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check the core dynamics operators with tolerances that scale with the
+precision of Real, so that this test is meaningful both in the default double
+build and in a SIMBODY_PRECISION=float build. Everything here must be written
+in terms of Real; don't use double literals where a Real is expected. */
+
+#include "Simbody.h"
+
+#include <iostream>
+
+using namespace SimTK;
+
+// A mix of mobilizer types, including a quaternion and a branch, hanging
+// under gravity.
+static void buildModel(MultibodySystem& system, SimbodyMatterSubsystem& matter,
+                       GeneralForceSubsystem& forces) {
+    Force::Gravity(forces, matter, -YAxis, Real(9.8));
+    Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia(1)));
+    const Vec3 down(0, -1, 0), up(0, 1, 0);
+
+    MobilizedBody::Ball ball(matter.Ground(), Vec3(0), body, up);
+    MobilizedBody::Pin pin(ball, down, body, up);
+    MobilizedBody::Slider slider(pin, down, body, up);
+    MobilizedBody::Universal univ(ball, down, body, up);
+    MobilizedBody::Free free(matter.Ground(), Vec3(2,0,0), body, up);
+    MobilizedBody::Pin pin2(free, down, body, up);
+}
+
+static void setRandomState(State& state) {
+    Random::Uniform random(-1, 1);
+    random.setSeed(17);
+    for (int i=0; i < state.getNQ(); ++i) state.updQ()[i] = random.getValue();
+    for (int i=0; i < state.getNU(); ++i) state.updU()[i] = random.getValue();
+}
+
+void testPrecisionOfReal() {
+    SimTK_TEST(sizeof(Real) == (SimTK_DEFAULT_PRECISION == 1 ? sizeof(float)
+                                                             : sizeof(double)));
+    SimTK_TEST(sizeof(Vec3) == 3*sizeof(Real));
+}
+
+// M*(M^-1*f) = f, and the residual of the forward dynamics accelerations is
+// zero.
+void testDynamicsOperators() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    buildModel(system, matter, forces);
+    system.realizeTopology();
+    State state = system.getDefaultState();
+    setRandomState(state);
+    system.realize(state, Stage::Acceleration);
+
+    const Real tol = 100*SignificantReal;
+
+    Vector f(state.getNU()), MInvf, MMInvf;
+    for (int i=0; i < f.size(); ++i) f[i] = Real(i+1)/f.size();
+    matter.multiplyByMInv(state, f, MInvf);
+    matter.multiplyByM(state, MInvf, MMInvf);
+    SimTK_TEST_EQ_TOL(MMInvf, f, tol);
+
+    Matrix M, MInv;
+    matter.calcM(state, M);
+    matter.calcMInv(state, MInv);
+    Matrix identity(M.nrow(), M.ncol(), Real(0));
+    identity.updDiag() = 1;
+    SimTK_TEST_EQ_TOL(M*MInv, identity, tol);
+
+    const Vector& mobForces = system.getMobilityForces(state, Stage::Dynamics);
+    const Vector_<SpatialVec>& bodyForces =
+        system.getRigidBodyForces(state, Stage::Dynamics);
+    Vector residual;
+    matter.calcResidualForceIgnoringConstraints(state, mobForces, bodyForces,
+                                                state.getUDot(), residual);
+    SimTK_TEST_EQ_TOL(residual, Vector(state.getNU(), Real(0)),
+                      tol*(1 + bodyForces.norm()));
+}
+
+// A conservative system integrated with error control keeps its energy to
+// within the integration accuracy.
+void testEnergyConservation() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    buildModel(system, matter, forces);
+    system.realizeTopology();
+    State state = system.getDefaultState();
+    setRandomState(state);
+    system.realize(state, Stage::Velocity);
+    const Real e0 = system.calcEnergy(state);
+
+    const Real accuracy = SimTK_DEFAULT_PRECISION == 1 ? Real(1e-3)
+                                                       : Real(1e-6);
+    RungeKuttaMersonIntegrator integ(system);
+    integ.setAccuracy(accuracy);
+    TimeStepper ts(system, integ);
+    ts.initialize(state);
+    ts.stepTo(1);
+    system.realize(integ.getState(), Stage::Velocity);
+    const Real e1 = system.calcEnergy(integ.getState());
+    SimTK_TEST_EQ_TOL(e1, e0, 10*accuracy*(1 + std::abs(e0)));
+}
+
+int main() {
+    SimTK_START_TEST("TestRealPrecision");
+        SimTK_SUBTEST(testPrecisionOfReal);
+        SimTK_SUBTEST(testDynamicsOperators);
+        SimTK_SUBTEST(testEnergyConservation);
+    SimTK_END_TEST();
+}
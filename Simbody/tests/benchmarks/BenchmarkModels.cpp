@@ -0,0 +1,316 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "BenchmarkModels.h"
+
+#include <algorithm>
+#include <cmath>
+
+BenchmarkModel::BenchmarkModel(const std::string& name, int size)
+:   name(name), size(size), matter(system), forces(system),
+    gravity(forces, matter, -YAxis, 9.81) {}
+
+void BenchmarkModel::finish() {
+    state = system.realizeTopology();
+    system.realize(state, Stage::Acceleration);
+}
+
+namespace {
+
+const Real LinkLength = Real(0.5);
+
+// A uniform rod lying along x from the body origin.
+Body::Rigid linkBody() {
+    return Body::Rigid(MassProperties(1, Vec3(LinkLength/2, 0, 0),
+        UnitInertia::cylinderAlongX(Real(0.05), LinkLength/2)
+                    .shiftFromCentroid(Vec3(-LinkLength/2, 0, 0))));
+}
+
+// A uniform rod from the body origin to 2*com.
+Body::Rigid segmentBody(Real mass, const Vec3& com) {
+    const Real halfLength = com.norm();
+    return Body::Rigid(MassProperties(mass, com,
+        UnitInertia::cylinderAlongY(Real(0.04), halfLength)
+                    .shiftFromCentroid(-com)));
+}
+
+const ContactMaterial BenchmarkMaterial(1e6, Real(0.5), Real(0.8),
+                                       Real(0.6), Real(0.01));
+
+void addGroundContact(BenchmarkModel& model) {
+    model.tracker.reset(new ContactTrackerSubsystem(model.system));
+    model.contact.reset(new CompliantContactSubsystem(model.system,
+                                                      *model.tracker));
+    model.matter.Ground().updBody().addContactSurface(
+        Rotation(-Pi/2, ZAxis), // the half space normal is -x; make it +y
+        ContactSurface(ContactGeometry::HalfSpace(), BenchmarkMaterial));
+}
+
+// Add a 13-body humanoid skeleton, free to move, with its pelvis at p.
+void addHumanoid(BenchmarkModel& model, const Vec3& p) {
+    const Body::Rigid pelvisBody(MassProperties(10, Vec3(0),
+        UnitInertia::brick(Real(0.1), Real(0.08), Real(0.15))));
+    const Body::Rigid torsoBody = segmentBody(25, Vec3(0, Real(0.25), 0));
+    const Body::Rigid headBody  = segmentBody(5,  Vec3(0, Real(0.1), 0));
+    const Body::Rigid upperArm  = segmentBody(2,  Vec3(0, Real(-0.15), 0));
+    const Body::Rigid forearm   = segmentBody(1,  Vec3(0, Real(-0.13), 0));
+    const Body::Rigid thigh     = segmentBody(8,  Vec3(0, Real(-0.2), 0));
+    const Body::Rigid shank     = segmentBody(4,  Vec3(0, Real(-0.2), 0));
+    const Body::Rigid foot(MassProperties(1, Vec3(Real(0.05), Real(-0.03), 0),
+        UnitInertia::brick(Real(0.1), Real(0.03), Real(0.04))
+                    .shiftFromCentroid(-Vec3(Real(0.05), Real(-0.03), 0))));
+
+    MobilizedBody::Free pelvis(model.matter.Ground(), p, pelvisBody, Vec3(0));
+    MobilizedBody::Ball torso(pelvis, Vec3(0, Real(0.1), 0), torsoBody,
+                              Vec3(0));
+    MobilizedBody::Ball head(torso, Vec3(0, Real(0.55), 0), headBody, Vec3(0));
+    for (int side = -1; side <= 1; side += 2) {
+        MobilizedBody::Ball shoulder(torso, Vec3(0, Real(0.5), side*Real(0.2)),
+                                     upperArm, Vec3(0));
+        MobilizedBody::Pin elbow(shoulder, Vec3(0, Real(-0.3), 0),
+                                 forearm, Vec3(0));
+        MobilizedBody::Ball hip(pelvis, Vec3(0, 0, side*Real(0.1)),
+                                thigh, Vec3(0));
+        MobilizedBody::Pin knee(hip, Vec3(0, Real(-0.4), 0), shank, Vec3(0));
+        MobilizedBody::Universal ankle(knee, Vec3(0, Real(-0.4), 0),
+                                       foot, Vec3(0));
+        elbow.setDefaultAngle(Real(0.5));
+        knee.setDefaultAngle(Real(-0.3));
+    }
+}
+
+} // anonymous namespace
+
+std::unique_ptr<BenchmarkModel> buildChainModel(int n) {
+    std::unique_ptr<BenchmarkModel> model(new BenchmarkModel("chain", n));
+    const Body::Rigid body = linkBody();
+    MobilizedBody parent = model->matter.Ground();
+    for (int i=0; i < n; ++i) {
+        MobilizedBody::Pin link(parent, Vec3(i ? LinkLength : 0, 0, 0),
+                                body, Vec3(0));
+        link.setDefaultAngle(Real(0.1)*std::sin(Real(i)));
+        parent = link;
+    }
+    model->finish();
+    return model;
+}
+
+// Link i is the child of link (i-1)/2.
+std::unique_ptr<BenchmarkModel> buildTreeModel(int n) {
+    std::unique_ptr<BenchmarkModel> model(new BenchmarkModel("tree", n));
+    const Body::Rigid body = linkBody();
+    std::vector<MobilizedBody> links;
+    for (int i=0; i < n; ++i) {
+        MobilizedBody& parent = i ? links[(i-1)/2]
+                                  : model->matter.updGround();
+        const Rotation R(Real(i%2 ? 0.3 : -0.3), ZAxis);
+        links.push_back(MobilizedBody::Ball(parent,
+            Transform(R, Vec3(i ? LinkLength : 0, 0, 0)), body, Vec3(0)));
+    }
+    model->finish();
+    return model;
+}
+
+// Link i is the child of a link chosen uniformly from links 0..i-1, which
+// gives a tree of expected depth O(log n) but with irregular branching.
+std::unique_ptr<BenchmarkModel> buildRandomTreeModel(int n) {
+    std::unique_ptr<BenchmarkModel> model(new BenchmarkModel("randomTree", n));
+    const Body::Rigid body = linkBody();
+    Random::Uniform random;
+    random.setSeed(0);
+    std::vector<MobilizedBody> links;
+    for (int i=0; i < n; ++i) {
+        const int p = std::min(int(i*random.getValue()), i-1);
+        MobilizedBody& parent = i ? links[p] : model->matter.updGround();
+        const Rotation R(BodyRotationSequence,
+                         Real(2*Pi)*random.getValue(), XAxis,
+                         Real(0.5)*random.getValue(), ZAxis);
+        links.push_back(MobilizedBody::Ball(parent,
+            Transform(R, Vec3(i ? LinkLength : 0, 0, 0)), body, Vec3(0)));
+    }
+    model->finish();
+    return model;
+}
+
+// The links zigzag so that the loop is not at a singular (fully stretched)
+// configuration.
+std::unique_ptr<BenchmarkModel> buildClosedChainModel(int n) {
+    std::unique_ptr<BenchmarkModel> model(new BenchmarkModel("closedChain", n));
+    const Body::Rigid body = linkBody();
+    MobilizedBody parent = model->matter.Ground();
+    for (int i=0; i < n; ++i) {
+        const Rotation R(Real(i%2 ? 0.3 : -0.3), ZAxis);
+        parent = MobilizedBody::Ball(parent,
+            Transform(R, Vec3(i ? LinkLength : 0, 0, 0)), body, Vec3(0));
+    }
+    // Tie the tip to wherever it is in the default configuration, so that
+    // the default state satisfies the constraint.
+    State s = model->system.realizeTopology();
+    model->system.realize(s, Stage::Position);
+    const Vec3 tip = parent.findStationLocationInGround(s,
+                                                        Vec3(LinkLength,0,0));
+    Constraint::Ball(model->matter.Ground(), tip,
+                     parent, Vec3(LinkLength, 0, 0));
+    model->finish();
+    return model;
+}
+
+// There are enough humanoids to have at least n bodies, in a square grid.
+std::unique_ptr<BenchmarkModel> buildHumanoidsModel(int n) {
+    std::unique_ptr<BenchmarkModel> model(new BenchmarkModel("humanoids", n));
+    const int BodiesPerHumanoid = 13;
+    const int numHumanoids = std::max(1, (n + BodiesPerHumanoid-1)
+                                         / BodiesPerHumanoid);
+    int side = 1;
+    while (side*side < numHumanoids) ++side;
+    for (int i=0; i < numHumanoids; ++i)
+        addHumanoid(*model, Vec3(i%side, 1, i/side));
+    model->finish();
+    return model;
+}
+
+// The particles are on a jittered lattice spaced so that some pairs overlap,
+// and the bottom layer touches the ground.
+std::unique_ptr<BenchmarkModel> buildSwarmModel(int n) {
+    std::unique_ptr<BenchmarkModel> model(new BenchmarkModel("swarm", n));
+    addGroundContact(*model);
+    const Real radius = Real(0.05), spacing = Real(0.11);
+    Body::Rigid body(MassProperties(Real(0.1), Vec3(0),
+                                    UnitInertia::sphere(radius)));
+    body.addContactSurface(Transform(),
+        ContactSurface(ContactGeometry::Sphere(radius), BenchmarkMaterial));
+
+    int side = 1;
+    while (side*side*side < n) ++side;
+    Random::Uniform jitter(-Real(0.01), Real(0.01));
+    jitter.setSeed(0);
+    for (int i=0; i < n; ++i) {
+        const Vec3 p(spacing*(i%side) + jitter.getValue(),
+                     radius + spacing*(i/(side*side)) + jitter.getValue(),
+                     spacing*((i/side)%side) + jitter.getValue());
+        MobilizedBody::Translation particle(model->matter.Ground(), p,
+                                            body, Vec3(0));
+    }
+    model->finish();
+    return model;
+}
+
+// Four bricks to a column. The bricks are triangle meshes so that they can
+// touch one another.
+std::unique_ptr<BenchmarkModel> buildBricksModel(int n) {
+    std::unique_ptr<BenchmarkModel> model(new BenchmarkModel("bricks", n));
+    addGroundContact(*model);
+    const Vec3 halfDims(Real(0.1), Real(0.05), Real(0.1));
+    const ContactGeometry::TriangleMesh mesh
+       (PolygonalMesh::createBrickMesh(halfDims, 1));
+    Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia::brick(halfDims)));
+    body.addContactSurface(Transform(),
+        ContactSurface(mesh, BenchmarkMaterial, Real(0.01)));
+
+    const int BricksPerColumn = 4;
+    const int numColumns = (n + BricksPerColumn-1) / BricksPerColumn;
+    int side = 1;
+    while (side*side < numColumns) ++side;
+    const Real overlap = Real(1e-4); // so that the bricks are in contact
+    for (int i=0; i < n; ++i) {
+        const int column = i / BricksPerColumn, level = i % BricksPerColumn;
+        const Vec3 p(3*halfDims[0]*(column%side),
+                     (2*level+1)*(halfDims[1] - overlap),
+                     3*halfDims[2]*(column/side));
+        MobilizedBody::Free brick(model->matter.Ground(), p, body, Vec3(0));
+    }
+    model->finish();
+    return model;
+}
+
+// A chain of pin-jointed links with a cable spring from each link to the one
+// two beyond it. Each cable passes through a via point on the link between
+// and then over a sphere at the next joint, which it touches only when that
+// joint bends toward the cable. Cables alternate sides of the chain.
+std::unique_ptr<BenchmarkModel> buildCablesModel(int n) {
+    std::unique_ptr<BenchmarkModel> model(new BenchmarkModel("cables", n));
+    model->cables.reset(new CableTrackerSubsystem(model->system));
+    const Body::Rigid body = linkBody();
+    std::vector<MobilizedBody> links;
+    MobilizedBody parent = model->matter.Ground();
+    for (int i=0; i < n; ++i) {
+        MobilizedBody::Pin link(parent, Vec3(i ? LinkLength : 0, 0, 0),
+                                body, Vec3(0));
+        link.setDefaultAngle(Real(0.2)*std::sin(Real(i)));
+        links.push_back(link);
+        parent = link;
+    }
+
+    const Real offset = Real(0.05), sphereRadius = Real(0.04);
+    const ContactGeometry::Sphere sphere(sphereRadius);
+    for (int i=0; i+2 < n; ++i) {
+        const Vec3 station(LinkLength/2, i%2 ? -offset : offset, 0);
+        CablePath path(*model->cables, links[i], station, links[i+2], station);
+        CableObstacle::ViaPoint via(path, links[i+1], station);
+        CableObstacle::Surface wrap(path, links[i+2], Transform(), sphere);
+        wrap.setContactPointHints(Vec3(-sphereRadius, station[1], 0),
+                                  Vec3(sphereRadius, station[1], 0));
+        CableSpring(model->forces, path, 100, Real(1.9)*LinkLength, Real(0.1));
+    }
+    model->finish();
+    return model;
+}
+
+namespace {
+struct ModelBuilder {
+    const char* name;
+    std::unique_ptr<BenchmarkModel> (*build)(int);
+};
+
+const ModelBuilder Builders[] = {
+    {"chain",       buildChainModel},
+    {"tree",        buildTreeModel},
+    {"randomTree",  buildRandomTreeModel},
+    {"closedChain", buildClosedChainModel},
+    {"humanoids",   buildHumanoidsModel},
+    {"swarm",       buildSwarmModel},
+    {"bricks",      buildBricksModel},
+    {"cables",      buildCablesModel}
+};
+}
+
+const std::vector<std::string>& getBenchmarkModelNames() {
+    static const std::vector<std::string> names = []{
+        std::vector<std::string> names;
+        for (const ModelBuilder& builder : Builders)
+            names.push_back(builder.name);
+        return names;
+    }();
+    return names;
+}
+
+std::unique_ptr<BenchmarkModel>
+buildBenchmarkModel(const std::string& name, int numBodies) {
+    for (const ModelBuilder& builder : Builders)
+        if (name == builder.name)
+            return builder.build(numBodies);
+    SimTK_ERRCHK1_ALWAYS(false, "buildBenchmarkModel()",
+                         "There is no benchmark model named '%s'.",
+                         name.c_str());
+    return nullptr;
+}
@@ -0,0 +1,94 @@
+#ifndef SimTK_SIMBODY_BENCHMARK_MODELS_H_
+#define SimTK_SIMBODY_BENCHMARK_MODELS_H_
+
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Synthetic models of adjustable size for measuring how Simbody scales. Each
+builder takes a size that is roughly the number of bodies, so that the same
+size gives comparable models; the builders are deterministic (any randomness
+is seeded) so that results can be compared from run to run. Models of 10,000
+bodies or more are practical for everything except the dense mass matrix
+operations.
+
+    chain        serial chain of pin joints
+    tree         balanced binary tree of ball joints
+    randomTree   tree of ball joints with randomly chosen parents
+    closedChain  chain of ball joints closed into a loop by a constraint
+    humanoids    row of free-floating 13-body humanoid skeletons
+    swarm        particles with contact spheres above a ground plane
+    bricks       columns of stacked mesh bricks in compliant contact
+    cables       chain spanned by overlapping cable springs that pass through
+                 via points and over wrapping spheres
+*/
+
+#include "SimTKsimbody.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace SimTK;
+
+/* A synthetic model, with its State realized through Acceleration. The
+contact and cable subsystems are present only in models that use them. */
+class BenchmarkModel {
+public:
+    BenchmarkModel(const std::string& name, int size);
+
+    /* Call this once all the elements have been added. */
+    void finish();
+
+    bool hasContact() const {return tracker != nullptr;}
+    bool hasCables() const {return cables != nullptr;}
+    bool hasConstraints() const {return matter.getNumConstraints() > 0;}
+
+    const std::string       name;
+    const int               size;
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter;
+    GeneralForceSubsystem   forces;
+    Force::Gravity          gravity;
+    std::unique_ptr<ContactTrackerSubsystem>    tracker;
+    std::unique_ptr<CompliantContactSubsystem>  contact;
+    std::unique_ptr<CableTrackerSubsystem>      cables;
+    State                   state;
+};
+
+std::unique_ptr<BenchmarkModel> buildChainModel(int numBodies);
+std::unique_ptr<BenchmarkModel> buildTreeModel(int numBodies);
+std::unique_ptr<BenchmarkModel> buildRandomTreeModel(int numBodies);
+std::unique_ptr<BenchmarkModel> buildClosedChainModel(int numBodies);
+std::unique_ptr<BenchmarkModel> buildHumanoidsModel(int numBodies);
+std::unique_ptr<BenchmarkModel> buildSwarmModel(int numBodies);
+std::unique_ptr<BenchmarkModel> buildBricksModel(int numBodies);
+std::unique_ptr<BenchmarkModel> buildCablesModel(int numBodies);
+
+/* The names of all the models above, in the order listed there. */
+const std::vector<std::string>& getBenchmarkModelNames();
+
+/* Build a model by name; throws if there is no model with this name. */
+std::unique_ptr<BenchmarkModel>
+buildBenchmarkModel(const std::string& name, int numBodies);
+
+#endif // SimTK_SIMBODY_BENCHMARK_MODELS_H_
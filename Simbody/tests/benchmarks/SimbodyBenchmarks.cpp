@@ -0,0 +1,308 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2016 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* This program times the core dynamics operations on synthetic models whose
+size can be scaled, so that performance can be tracked from one release to the
+next. Each benchmark is run on each model at each size, repeating the operation
+until enough time has been spent to give a stable mean. Results are printed as
+a table, and optionally written as JSON for comparison by other tools.
+
+Usage: SimbodyBenchmarks [options]
+    --sizes n1,n2,...       model sizes (roughly the number of bodies)
+    --models m1,m2,...      only these models (see BenchmarkModels.h)
+    --benchmarks b1,b2,...  only these benchmarks (see the table of results)
+    --min-time seconds      minimum time to spend on each measurement
+    --json file             also write the results to this file
+    --quick                 run everything once on tiny models; this is what
+                            the regression test does to keep this working
+*/
+
+#include "BenchmarkModels.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+//==============================================================================
+//                                MEASUREMENT
+//==============================================================================
+struct Options {
+    std::vector<int>            sizes;
+    std::vector<std::string>    models, benchmarks;
+    double                      minTime;
+    std::string                 jsonFile;
+};
+
+struct Result {
+    std::string benchmark, model;
+    int         size, nu, reps;
+    double      meanTime, minTime; // seconds per operation
+};
+
+// Time an operation, calling setup before each repetition without timing it.
+// One untimed repetition warms up the caches first. Then we repeat until we
+// have spent the requested time, or done a million repetitions.
+Result measure(const std::string& benchmark, const BenchmarkModel& model,
+               const Options& opts,
+               const std::function<void()>& setup,
+               const std::function<void()>& op) {
+    setup(); op();
+    long long totalInNs = 0, minInNs = 0;
+    int reps = 0;
+    do {
+        setup();
+        const long long startInNs = realTimeInNs();
+        op();
+        const long long elapsedInNs = realTimeInNs() - startInNs;
+        totalInNs += elapsedInNs;
+        if (reps == 0 || elapsedInNs < minInNs) minInNs = elapsedInNs;
+        ++reps;
+    } while (nsToSec(totalInNs) < opts.minTime && reps < 1000000);
+
+    Result result;
+    result.benchmark = benchmark; result.model = model.name;
+    result.size = model.size; result.nu = model.state.getNU();
+    result.reps = reps;
+    result.meanTime = nsToSec(totalInNs)/reps;
+    result.minTime = nsToSec(minInNs);
+    return result;
+}
+
+
+
+//==============================================================================
+//                                BENCHMARKS
+//==============================================================================
+// Each benchmark may decline to run on a model it doesn't apply to. The
+// mass matrix benchmarks form an nu X nu matrix so are skipped for large nu.
+const int MaxDenseSize = 2000;
+
+void benchRealizeAcceleration(BenchmarkModel& m, const Options& opts,
+                              std::vector<Result>& results) {
+    results.push_back(measure("realizeAcceleration", m, opts,
+        [&]{m.state.invalidateAllCacheAtOrAbove(Stage::Position);},
+        [&]{m.system.realize(m.state, Stage::Acceleration);}));
+}
+
+void benchCalcM(BenchmarkModel& m, const Options& opts, std::vector<Result>& results) {
+    if (m.state.getNU() > MaxDenseSize) return;
+    Matrix M;
+    results.push_back(measure("calcM", m, opts, []{},
+        [&]{m.matter.calcM(m.state, M);}));
+}
+
+void benchCalcMInv(BenchmarkModel& m, const Options& opts,
+                   std::vector<Result>& results) {
+    if (m.state.getNU() > MaxDenseSize) return;
+    Matrix MInv;
+    results.push_back(measure("calcMInv", m, opts, []{},
+        [&]{m.matter.calcMInv(m.state, MInv);}));
+}
+
+void benchMultiplyByMInv(BenchmarkModel& m, const Options& opts,
+                         std::vector<Result>& results) {
+    const Vector f(m.state.getNU(), Real(1));
+    Vector udot;
+    results.push_back(measure("multiplyByMInv", m, opts, []{},
+        [&]{m.matter.multiplyByMInv(m.state, f, udot);}));
+}
+
+// Project after a small perturbation of every q.
+void benchProjectQ(BenchmarkModel& m, const Options& opts,
+                   std::vector<Result>& results) {
+    if (!m.hasConstraints()) return;
+    const Vector q0 = m.state.getQ();
+    Vector perturbation(q0.size());
+    for (int i=0; i < q0.size(); ++i)
+        perturbation[i] = Real(1e-3)*std::sin(Real(i));
+    results.push_back(measure("projectQ", m, opts,
+        [&]{m.state.updQ() = q0 + perturbation;},
+        [&]{m.system.projectQ(m.state, Real(1e-6));}));
+    m.state.updQ() = q0;
+    m.system.realize(m.state, Stage::Acceleration);
+}
+
+// Broad and narrow phase together: find the contacts given positions that
+// are already realized.
+void benchContactTracking(BenchmarkModel& m, const Options& opts,
+                          std::vector<Result>& results) {
+    if (!m.hasContact()) return;
+    results.push_back(measure("contactTracking", m, opts,
+        [&]{m.state.invalidateAllCacheAtOrAbove(Stage::Position);
+            m.system.realize(m.state, Stage::Position);},
+        [&]{m.tracker->getActiveContacts(m.state);}));
+}
+
+// The time for one internal step of an error-controlled explicit integrator.
+void benchIntegrate(BenchmarkModel& m, const Options& opts,
+                    std::vector<Result>& results) {
+    RungeKuttaMersonIntegrator integ(m.system);
+    integ.setAccuracy(Real(1e-3));
+    integ.setReturnEveryInternalStep(true);
+    integ.initialize(m.state);
+    results.push_back(measure("integrateStep", m, opts, []{},
+        [&]{integ.stepTo(Infinity);}));
+}
+
+struct Benchmark {
+    const char* name;
+    void (*run)(BenchmarkModel&, const Options&, std::vector<Result>&);
+};
+
+const Benchmark Benchmarks[] = {
+    {"realizeAcceleration", benchRealizeAcceleration},
+    {"calcM",               benchCalcM},
+    {"calcMInv",            benchCalcMInv},
+    {"multiplyByMInv",      benchMultiplyByMInv},
+    {"projectQ",            benchProjectQ},
+    {"contactTracking",     benchContactTracking},
+    {"integrateStep",       benchIntegrate}
+};
+
+
+
+//==============================================================================
+//                                  OUTPUT
+//==============================================================================
+void writeJson(std::ostream& o, const std::vector<Result>& results) {
+    int major, minor, build;
+    SimTK_version_simbody(&major, &minor, &build);
+    o << "{\"simbody_version\":\"" << major << "." << minor << "." << build
+      << "\",\"precision\":\"" << (sizeof(Real)==sizeof(double) ? "double"
+                                                                : "float")
+      << "\",\"results\":[";
+    for (unsigned i=0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        o << (i ? ",\n" : "\n")
+          << "{\"benchmark\":\"" << r.benchmark
+          << "\",\"model\":\"" << r.model
+          << "\",\"size\":" << r.size << ",\"nu\":" << r.nu
+          << ",\"reps\":" << r.reps
+          << ",\"mean_us\":" << 1e6*r.meanTime
+          << ",\"min_us\":" << 1e6*r.minTime << "}";
+    }
+    o << "\n]}\n";
+}
+
+bool contains(const std::vector<std::string>& names, const char* name) {
+    if (names.empty()) return true;
+    for (const std::string& n : names)
+        if (n == name) return true;
+    return false;
+}
+
+std::vector<std::string> splitList(const char* list) {
+    std::vector<std::string> items;
+    std::string item;
+    for (const char* p = list; ; ++p) {
+        if (*p == ',' || *p == '\0') {
+            if (!item.empty()) items.push_back(item);
+            item.clear();
+            if (*p == '\0') break;
+        } else item += *p;
+    }
+    return items;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+  try {
+    // CablePath still writes debugging output to std::cout. Disable the
+    // stream so that this neither swamps our results (which are printed with
+    // printf) nor gets timed; a failed stream skips the formatting too.
+    std::cout.setstate(std::ios::badbit);
+
+    Options opts;
+    opts.sizes = {16, 128, 1024};
+    opts.minTime = 0.25;
+    for (int i=1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i+1 < argc;
+        if (arg == "--quick") {
+            opts.sizes = {4};
+            opts.minTime = 0;
+        } else if (arg == "--sizes" && hasValue) {
+            opts.sizes.clear();
+            for (const std::string& s : splitList(argv[++i]))
+                opts.sizes.push_back(std::atoi(s.c_str()));
+        } else if (arg == "--models" && hasValue) {
+            opts.models = splitList(argv[++i]);
+        } else if (arg == "--benchmarks" && hasValue) {
+            opts.benchmarks = splitList(argv[++i]);
+        } else if (arg == "--min-time" && hasValue) {
+            opts.minTime = std::atof(argv[++i]);
+        } else if (arg == "--json" && hasValue) {
+            opts.jsonFile = argv[++i];
+        } else {
+            std::printf("Unrecognized argument '%s'; see the comment at the "
+                        "top of SimbodyBenchmarks.cpp for usage.\n", argv[i]);
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+    std::printf("%-20s %-12s %7s %7s %9s %12s %12s\n", "benchmark", "model",
+                "size", "nu", "reps", "mean (us)", "min (us)");
+    for (const std::string& name : getBenchmarkModelNames()) {
+        if (!contains(opts.models, name.c_str())) continue;
+        for (int size : opts.sizes) {
+            std::unique_ptr<BenchmarkModel> model =
+                buildBenchmarkModel(name, size);
+            for (const Benchmark& bench : Benchmarks) {
+                if (!contains(opts.benchmarks, bench.name)) continue;
+                const unsigned first = (unsigned)results.size();
+                bench.run(*model, opts, results);
+                for (unsigned r = first; r < results.size(); ++r) {
+                    const Result& res = results[r];
+                    std::printf("%-20s %-12s %7d %7d %9d %12.3f %12.3f\n",
+                        res.benchmark.c_str(), res.model.c_str(), res.size,
+                        res.nu, res.reps, 1e6*res.meanTime, 1e6*res.minTime);
+                    std::fflush(stdout);
+                }
+            }
+        }
+    }
+
+    if (!opts.jsonFile.empty()) {
+        std::ofstream json(opts.jsonFile.c_str());
+        writeJson(json, results);
+        if (!json) {
+            std::printf("Couldn't write '%s'.\n", opts.jsonFile.c_str());
+            return 1;
+        }
+    }
+    return 0;
+  }
+  catch (const std::exception& e) {
+    std::printf("EXCEPTION THROWN: %s\n", e.what());
+    return 1;
+  }
+}